@@ -141,3 +141,9 @@ gams::algorithms::BaseAlgorithm::get_algorithm_status(void)
 {
   return &status_;
 }
+
+int
+gams::algorithms::BaseAlgorithm::get_phases(void) const
+{
+  return PHASE_ALL;
+}
@@ -88,6 +88,19 @@ namespace gams
       FINISHED        = 0x00000010
     };
 
+    /**
+     * Phases of the MAPE loop that an algorithm implements, as returnable
+     * by get_phases()
+     **/
+    enum AlgorithmPhases
+    {
+      PHASE_NONE      = 0x00000000,
+      PHASE_ANALYZE   = 0x00000001,
+      PHASE_PLAN      = 0x00000002,
+      PHASE_EXECUTE   = 0x00000004,
+      PHASE_ALL       = 0x00000007
+    };
+
     /**
     * The base class that algorithms in GAMS use
     **/
@@ -141,6 +154,16 @@ namespace gams
        * @return bitmask status of the platform. @see AlgorithmAnalyzeStatus
        **/
       virtual int plan(void) = 0;
+
+      /**
+       * Returns the phases this algorithm does work in. The controller
+       * does not call phases that are not listed. Override this if any
+       * of analyze, plan or execute is a no-op that returns 0, and mark
+       * that no-op final, so that a subclass cannot override a phase
+       * that would never be called.
+       * @return bitmask of phases. @see AlgorithmPhases
+       **/
+      virtual int get_phases(void) const;
       
       /**
        * Sets the list of agents in the swarm
@@ -355,3 +355,10 @@ gams::algorithms::Follow::plan(void)
 {
   return 0;
 }
+
+int
+gams::algorithms::Follow::get_phases(void) const
+{
+  // plan is a no-op
+  return PHASE_ANALYZE | PHASE_EXECUTE;
+}
@@ -52,16 +52,19 @@
 #include "gams/algorithms/FormationSync.h"
 #include "gams/algorithms/AlgorithmFactoryRepository.h"
 #include "madara/knowledge/containers/StringVector.h"
+#include "madara/knowledge/containers/NativeDoubleVector.h"
 #include "madara/utility/Utility.h"
 
 #include <sstream>
 #include <string>
 #include <iostream>
 #include <cmath>
+#include <unordered_map>
 
 #include "gams/algorithms/AlgorithmFactory.h"
 
 #include "gams/utility/ArgumentParser.h"
+#include "gams/variables/AgentNames.h"
 
 namespace engine = madara::knowledge;
 namespace containers = engine::containers;
@@ -69,6 +72,34 @@ namespace containers = engine::containers;
 typedef madara::knowledge::KnowledgeRecord::Integer  Integer;
 typedef madara::knowledge::KnowledgeMap    KnowledgeMap;
 
+namespace
+{
+  /**
+   * Computes a key of a member list that is the same on every agent, so a
+   * published assignment can be matched to the members it was solved for
+   * (64-bit FNV-1a over the names in order)
+   **/
+  Integer member_key(const gams::groups::AgentVector & members)
+  {
+    uint64_t hash = 14695981039346656037ULL;
+
+    for (size_t i = 0; i < members.size(); ++i)
+    {
+      for (size_t j = 0; j < members[i].size(); ++j)
+      {
+        hash ^= (unsigned char)members[i][j];
+        hash *= 1099511628211ULL;
+      }
+
+      // separate the names so that "a.1","0" and "a.10" differ
+      hash ^= 0xff;
+      hash *= 1099511628211ULL;
+    }
+
+    return (Integer)hash;
+  }
+}
+
 gams::algorithms::BaseAlgorithm *
 gams::algorithms::FormationSyncFactory::create(
 const KnowledgeMap & args,
@@ -94,6 +125,8 @@ variables::Agents * /*agents*/)
     double buffer = 5.0;
     std::string group = "";
     std::string barrier = "barrier.formation_sync";
+    int fan_in = 0;
+    int assignment = formations::ASSIGN_BY_INDEX;
 
     for (KnowledgeMap::const_iterator i = args.begin(); i != args.end(); ++i)
     {
@@ -102,6 +135,37 @@ variables::Agents * /*agents*/)
 
       switch(i->first[0])
       {
+      case 'a':
+        if (i->first == "assignment")
+        {
+          std::string assignment_str = i->second.to_string();
+
+          madara::utility::upper(assignment_str);
+
+          if (assignment_str == "TOTAL")
+          {
+            assignment = formations::ASSIGN_MIN_TOTAL;
+          }
+          else if (assignment_str == "MAX")
+          {
+            assignment = formations::ASSIGN_MIN_MAX;
+          }
+          else if (assignment_str == "INDEX")
+          {
+            assignment = formations::ASSIGN_BY_INDEX;
+          }
+          else if (i->second.is_integer_type())
+          {
+            assignment = (int)i->second.to_integer();
+          }
+
+          madara_logger_ptr_log(gams::loggers::global_logger.get(),
+            gams::loggers::LOG_DETAILED,
+            "gams::algorithms::FormationSyncFactory:" \
+            " setting assignment to %d\n", assignment);
+          break;
+        }
+        goto unknown;
       case 'b':
         if (i->first == "barrier")
         {
@@ -143,7 +207,17 @@ variables::Agents * /*agents*/)
         }
         goto unknown;
       case 'f':
-        if (i->first == "formation")
+        if (i->first == "fan_in")
+        {
+          fan_in = (int)i->second.to_integer();
+
+          madara_logger_ptr_log(gams::loggers::global_logger.get(),
+            gams::loggers::LOG_DETAILED,
+            "gams::algorithms::FormationSyncFactory:" \
+            " setting fan_in to %d\n", fan_in);
+          break;
+        }
+        else if (i->first == "formation")
         {
           std::string formation_str = i->second.to_string();
 
@@ -267,8 +341,8 @@ variables::Agents * /*agents*/)
     }
 
     result = new FormationSync(start, end, group, buffer,
-      formation_type, barrier,
-      knowledge, platform, sensors, self);
+      formation_type, barrier, knowledge, platform, sensors, self,
+      fan_in, assignment);
   }
 
   return result;
@@ -284,12 +358,17 @@ gams::algorithms::FormationSync::FormationSync(
   madara::knowledge::KnowledgeBase * knowledge,
   platforms::BasePlatform * platform,
   variables::Sensors * sensors,
-  variables::Self * self) :
+  variables::Self * self,
+  int fan_in,
+  int assignment) :
   BaseAlgorithm(knowledge, platform, sensors, self), start_(start),
   end_(end),
   group_factory_(knowledge),
-  group_(0),
-  buffer_(buffer), formation_(formation)
+  group_(0), members_version_(0),
+  buffer_(buffer), formation_(formation),
+  assignment_(assignment), assignment_name_(barrier_name + ".assignment"),
+  solver_(assignment), solved_version_(0),
+  slot_(-1), barrier_name_(barrier_name), fan_in_(fan_in)
 {
   status_.init_vars(*knowledge, "formation_sync", self->agent.prefix);
   status_.init_variable_values();
@@ -305,10 +384,10 @@ gams::algorithms::FormationSync::FormationSync(
 
   if (group_)
   {
-    // fill the group member lists with current contents
-    // we can sync the group and call get_members again if we want to support
-    // changing group member lists(even with fixed list groups)
+    // fill the group member lists with current contents. analyze
+    // restarts the formation if they change.
     group_->get_members(group_members_);
+    members_version_ = group_->get_version();
   }
   else
   {
@@ -347,7 +426,7 @@ gams::algorithms::FormationSync::FormationSync(
   if (position_ >= 0)
   {
     barrier_.set_name(barrier_name, *knowledge,
-      position_,(int)group_members_.size());
+      position_,(int)group_members_.size(), fan_in);
     barrier_.set(0);
     //barrier_.next();
   }
@@ -363,71 +442,15 @@ gams::algorithms::FormationSync::FormationSync(
   }
 }
 
-void
-gams::algorithms::FormationSync::generate_plan(int formation)
+gams::utility::Position
+gams::algorithms::FormationSync::get_slot_offset(int slot, int formation,
+  double latitude_move, double longitude_move) const
 {
-  madara_logger_ptr_log(gams::loggers::global_logger.get(),
-    gams::loggers::LOG_MAJOR,
-    "gams::algorithms::FormationSync::constructor:" \
-    " Generating plan\n");
-
-  position_ = groups::find_member_index(
-    self_->agent.prefix, group_members_);
+  // a cartesian movement offset
+  utility::Position movement;
 
-  madara_logger_ptr_log(gams::loggers::global_logger.get(),
-    gams::loggers::LOG_MINOR,
-    "gams::algorithms::FormationSync::constructor:" \
-    " %s is position %d in member list\n",
-    self_->agent.prefix.c_str(), position_);
-
-  if (position_ >= 0)
+  if (slot >= 0)
   {
-    /**
-     * the offset in the line has an open space between each process
-     * [0] [ ] [1] [ ] [2] [ ] [3] [ ] [4] [ ] [5] ...
-     * initial position will be ref + position * buffer
-     **/
-
-    /**
-     * First step, figure out how many steps we need. Distances
-     * will contain the latitude(x) and longitude(y) differences
-     * between the points in meters.
-     **/
-    pose::ReferenceFrame start_frame(start_);
-    pose::Position distances = end_.transform_to(start_frame);
-
-    /**
-     * the number of moves is sum of the the horizontal and
-     * vertical distances divided by the buffer
-     **/
-    int x_moves =(int)(std::abs(distances.x() / buffer_)) + 1;
-    int y_moves =(int)(std::abs(distances.y() / buffer_)) + 1;
-    int total_moves = x_moves + y_moves;
-
-    madara_logger_ptr_log(gams::loggers::global_logger.get(),
-      gams::loggers::LOG_DETAILED,
-      "gams::algorithms::FormationSync::constructor:" \
-      " Formation will move %.3f m lat, %.3f m long in %d moves\n",
-      distances.x(), distances.y(), total_moves);
-
-    // the type of movement will be based on sign of distance
-    double latitude_move = distances.x() < 0 ? -buffer_ : buffer_;
-    double longitude_move = distances.y() < 0 ? -buffer_ : buffer_;
-
-    madara_logger_ptr_log(gams::loggers::global_logger.get(),
-      gams::loggers::LOG_DETAILED,
-      "gams::algorithms::FormationSync::constructor:" \
-      " Will execute %.3f m in %d latitude moves and then" \
-      " %.3f m in %d longitude moves\n",
-      latitude_move, x_moves, longitude_move, y_moves);
-
-    // a cartesian movement offset
-    utility::Position movement;
-
-    // the initial position for this specific agent
-    pose::Position init(platform_->get_frame());
-    pose::Position position_end(platform_->get_frame());
-
     if (formation == TRIANGLE)
     {
       madara_logger_ptr_log(gams::loggers::global_logger.get(),
@@ -455,7 +478,7 @@ gams::algorithms::FormationSync::generate_plan(int formation)
       // num_cols = 4
       // 
       // base = 0
-      // position_ = 3
+      // slot = 3
       // 0 + 4 <= 3 ? col = 3 - 0
       // 
       // base = 0
@@ -487,9 +510,9 @@ gams::algorithms::FormationSync::generate_plan(int formation)
 
       for (row = 0; row < num_rows; ++row)
       {
-        if (position_ < base + num_cols || num_cols <= 1)
+        if (slot < base + num_cols || num_cols <= 1)
         {
-          col = position_ - base;
+          col = slot - base;
           break;
         }
 
@@ -508,7 +531,7 @@ gams::algorithms::FormationSync::generate_plan(int formation)
         " Formation type is PYRAMID\n");
 
       // the initial position where the first two moves will be for this agent
-      movement.x = position_ * latitude_move * 2;
+      movement.x = slot * latitude_move * 2;
       movement.y = 0;
     }
     else if (formation == RECTANGLE)
@@ -529,8 +552,8 @@ gams::algorithms::FormationSync::generate_plan(int formation)
       double num_rows = std::sqrt((double)group_members_.size());
       int column(0), row(0);
 
-      column = position_ %(int)num_rows;
-      row = position_ /(int)num_rows;
+      column = slot %(int)num_rows;
+      row = slot /(int)num_rows;
 
       // the initial position where the first two moves will be for this agent
       if (row % 2 == 0)
@@ -552,7 +575,7 @@ gams::algorithms::FormationSync::generate_plan(int formation)
         " Formation type is CIRCLE\n");
 
       // the initial position where the first two moves will be for this agent
-      movement.x = position_ * latitude_move * 2;
+      movement.x = slot * latitude_move * 2;
       movement.y = 0;
     }
     else if (formation == WING)
@@ -601,21 +624,21 @@ gams::algorithms::FormationSync::generate_plan(int formation)
          * [4][ ][ ] pos = 4, row = 4, col = 3 - 4 % 3 - 2 = 3 - 1 - 2 = 0
          **/
         int cols =(int)group_members_.size() / 2 + 1;
-        if (position_ >= cols)
+        if (slot >= cols)
         {
-          col = cols - position_ % cols - 2;
+          col = cols - slot % cols - 2;
         }
         else
         {
-          col = position_ % cols;
+          col = slot % cols;
         }
-        row = position_;
+        row = slot;
       }
       // if size is even
       else
       {
         // handle everything before last position first
-        if (position_ !=(int)group_members_.size() - 1)
+        if (slot !=(int)group_members_.size() - 1)
         {
           /**
           * size = 6, cols = 3
@@ -626,15 +649,15 @@ gams::algorithms::FormationSync::generate_plan(int formation)
           * [4][ ][ ] pos = 4, row = 4, col = 3 - 4 % 3 - 2 = 3 - 1 - 2 = 0
           **/
           int cols =(int)group_members_.size() / 2;
-          row = position_;
+          row = slot;
 
-          if (position_ >= cols)
+          if (slot >= cols)
           {
-            col = cols - position_ % cols - 2;
+            col = cols - slot % cols - 2;
           }
           else
           {
-            col = position_ % cols;
+            col = slot % cols;
           }
         }
         // handle the last position. 2 and 4 are outliers
@@ -686,9 +709,95 @@ gams::algorithms::FormationSync::generate_plan(int formation)
         " Formation type is LINE\n");
 
       // the initial position where the first two moves will be for this agent
-      movement.x = position_ * latitude_move * 2;
+      movement.x = slot * latitude_move * 2;
       movement.y = 0;
     }
+  }
+
+  return movement;
+}
+
+void
+gams::algorithms::FormationSync::generate_plan(int formation)
+{
+  madara_logger_ptr_log(gams::loggers::global_logger.get(),
+    gams::loggers::LOG_MAJOR,
+    "gams::algorithms::FormationSync::constructor:" \
+    " Generating plan\n");
+
+  position_ = groups::find_member_index(
+    self_->agent.prefix, group_members_);
+
+  madara_logger_ptr_log(gams::loggers::global_logger.get(),
+    gams::loggers::LOG_MINOR,
+    "gams::algorithms::FormationSync::constructor:" \
+    " %s is position %d in member list\n",
+    self_->agent.prefix.c_str(), position_);
+
+  if (position_ >= 0)
+  {
+    /**
+     * the offset in the line has an open space between each process
+     * [0] [ ] [1] [ ] [2] [ ] [3] [ ] [4] [ ] [5] ...
+     * initial position will be ref + position * buffer
+     **/
+
+    /**
+     * First step, figure out how many steps we need. Distances
+     * will contain the latitude(x) and longitude(y) differences
+     * between the points in meters.
+     **/
+    pose::ReferenceFrame start_frame(start_);
+    pose::Position distances = end_.transform_to(start_frame);
+
+    /**
+     * the number of moves is sum of the the horizontal and
+     * vertical distances divided by the buffer
+     **/
+    int x_moves =(int)(std::abs(distances.x() / buffer_)) + 1;
+    int y_moves =(int)(std::abs(distances.y() / buffer_)) + 1;
+    int total_moves = x_moves + y_moves;
+
+    madara_logger_ptr_log(gams::loggers::global_logger.get(),
+      gams::loggers::LOG_DETAILED,
+      "gams::algorithms::FormationSync::constructor:" \
+      " Formation will move %.3f m lat, %.3f m long in %d moves\n",
+      distances.x(), distances.y(), total_moves);
+
+    // the type of movement will be based on sign of distance
+    double latitude_move = distances.x() < 0 ? -buffer_ : buffer_;
+    double longitude_move = distances.y() < 0 ? -buffer_ : buffer_;
+
+    madara_logger_ptr_log(gams::loggers::global_logger.get(),
+      gams::loggers::LOG_DETAILED,
+      "gams::algorithms::FormationSync::constructor:" \
+      " Will execute %.3f m in %d latitude moves and then" \
+      " %.3f m in %d longitude moves\n",
+      latitude_move, x_moves, longitude_move, y_moves);
+
+    // a cartesian movement offset
+    utility::Position movement;
+
+    // the initial position for this specific agent
+    pose::Position init(platform_->get_frame());
+    pose::Position position_end(platform_->get_frame());
+
+    // the barrier still uses position_, but the formation uses slot_
+    slot_ = assign_slot(formation, start_frame, latitude_move, longitude_move);
+
+    if (slot_ < 0)
+    {
+      madara_logger_ptr_log(gams::loggers::global_logger.get(),
+        gams::loggers::LOG_MINOR,
+        "gams::algorithms::FormationSync::constructor:" \
+        " %s is waiting for the slot assignment in %s\n",
+        self_->agent.prefix.c_str(), assignment_name_.c_str());
+
+      return;
+    }
+
+    movement = get_slot_offset(
+      slot_, formation, latitude_move, longitude_move);
 
     // the initial position for this specific agent
     pose::Position move_start = movement.to_pos(start_frame);
@@ -763,6 +872,230 @@ gams::algorithms::FormationSync::generate_plan(int formation)
   }
 }
 
+int
+gams::algorithms::FormationSync::assign_slot(int formation,
+  const pose::ReferenceFrame & start_frame,
+  double latitude_move, double longitude_move)
+{
+  if (assignment_ == formations::ASSIGN_BY_INDEX)
+  {
+    return position_;
+  }
+
+  // every member must use the same assignment, so the first member
+  // solves it and publishes the key of the member list followed by the
+  // slot of each member. An assignment for other members, e.g., from an
+  // earlier run or before a membership change, is never used.
+  const Integer key = member_key(group_members_);
+  std::vector <Integer> published =
+    knowledge_->get(assignment_name_).to_integers();
+  bool current = published.size() == group_members_.size() + 1 &&
+    published[0] == key;
+
+  // the leader solves at least once, so an assignment left by an earlier
+  // run with the same members is replaced as well
+  if (position_ == 0 && (!current || solved_members_.empty()))
+  {
+    std::vector <pose::Position> locations;
+    std::vector <pose::Position> slots;
+
+    locations.reserve(group_members_.size());
+    slots.reserve(group_members_.size());
+
+    for (size_t i = 0; i < group_members_.size(); ++i)
+    {
+      containers::NativeDoubleVector location(
+        variables::agent_names().intern_name(group_members_[i]).location,
+        *knowledge_);
+
+      // solve only once the locations of all members are known
+      if (location.size() < 2)
+      {
+        madara_logger_ptr_log(gams::loggers::global_logger.get(),
+          gams::loggers::LOG_MINOR,
+          "gams::algorithms::FormationSync::assign_slot:" \
+          " location of %s is unknown. Waiting to assign slots.\n",
+          group_members_[i].c_str());
+
+        return -1;
+      }
+
+      pose::Position current(platform_->get_frame());
+      current.from_container(location);
+      locations.push_back(current);
+
+      pose::Position slot = get_slot_offset((int)i, formation,
+        latitude_move, longitude_move).to_pos(start_frame);
+      slots.push_back(slot.transform_to(platform_->get_frame()));
+    }
+
+    std::vector <int> result;
+
+    if (!reassign(locations, slots, result))
+    {
+      solver_.set_objective(assignment_);
+      result = solver_.solve(locations, slots);
+      solved_members_ = group_members_;
+    }
+    solved_version_ = members_version_;
+
+    published.assign(1, key);
+    published.insert(published.end(), result.begin(), result.end());
+    knowledge_->set(assignment_name_, published);
+    current = true;
+
+    madara_logger_ptr_log(gams::loggers::global_logger.get(),
+      gams::loggers::LOG_MAJOR,
+      "gams::algorithms::FormationSync::assign_slot:" \
+      " published slots for %d members" \
+      " (total distance %.2f, max distance %.2f)\n",
+      (int)result.size(), solver_.get_total_cost(), solver_.get_max_cost());
+  }
+
+  if (!current)
+  {
+    return -1;
+  }
+
+  madara_logger_ptr_log(gams::loggers::global_logger.get(),
+    gams::loggers::LOG_MAJOR,
+    "gams::algorithms::FormationSync::assign_slot:" \
+    " %s assigned slot %d\n",
+    self_->agent.prefix.c_str(), (int)published[position_ + 1]);
+
+  adopted_ = published;
+
+  return (int)published[position_ + 1];
+}
+
+bool
+gams::algorithms::FormationSync::reassign(
+  const std::vector <pose::Position> & locations,
+  const std::vector <pose::Position> & slots,
+  std::vector <int> & result)
+{
+  groups::AgentVector added, removed;
+
+  // the slots depend on the member count, so only an unchanged count
+  // lets the last solve be patched
+  if (!group_ || solved_members_.empty() ||
+    solved_members_.size() != group_members_.size() ||
+    group_->get_version() != members_version_ ||
+    !group_->get_changes(solved_version_, added, removed))
+  {
+    return false;
+  }
+
+  // check everything before solver_ is changed
+  for (size_t i = 0; i < removed.size(); ++i)
+  {
+    if (groups::find_member_index(removed[i], solved_members_) < 0)
+    {
+      return false;
+    }
+  }
+
+  for (size_t i = 0; i < added.size(); ++i)
+  {
+    if (groups::find_member_index(added[i], group_members_) < 0)
+    {
+      return false;
+    }
+  }
+
+  madara_logger_ptr_log(gams::loggers::global_logger.get(),
+    gams::loggers::LOG_MAJOR,
+    "gams::algorithms::FormationSync::reassign:" \
+    " %d members left and %d joined since the last solve\n",
+    (int)removed.size(), (int)added.size());
+
+  for (size_t i = 0; i < removed.size(); ++i)
+  {
+    int index = groups::find_member_index(removed[i], solved_members_);
+
+    solver_.remove_agent((size_t)index);
+    solved_members_.erase(solved_members_.begin() + index);
+  }
+
+  for (size_t i = 0; i < added.size(); ++i)
+  {
+    const pose::Position & location =
+      locations[groups::find_member_index(added[i], group_members_)];
+
+    std::vector <double> costs(slots.size());
+    for (size_t j = 0; j < slots.size(); ++j)
+    {
+      costs[j] = location.distance_to(slots[j]);
+    }
+
+    solver_.add_agent(costs);
+    solved_members_.push_back(added[i]);
+  }
+
+  // the solver keeps its own agent order, so map it to the group order
+  std::unordered_map <std::string, size_t> solved_index;
+  for (size_t i = 0; i < solved_members_.size(); ++i)
+  {
+    solved_index[solved_members_[i]] = i;
+  }
+
+  const std::vector <int> & assignment = solver_.get_assignment();
+  result.resize(group_members_.size());
+
+  for (size_t i = 0; i < group_members_.size(); ++i)
+  {
+    result[i] = assignment[solved_index[group_members_[i]]];
+  }
+
+  return true;
+}
+
+void
+gams::algorithms::FormationSync::refresh_members(void)
+{
+  if (!group_)
+  {
+    return;
+  }
+
+  group_->sync();
+
+  if (group_->get_version() == members_version_)
+  {
+    return;
+  }
+
+  group_->get_members(group_members_);
+  members_version_ = group_->get_version();
+
+  position_ = gams::groups::find_member_index(
+    self_->agent.prefix, group_members_);
+
+  madara_logger_ptr_log(gams::loggers::global_logger.get(),
+    gams::loggers::LOG_MAJOR,
+    "gams::algorithms::FormationSync::refresh_members:" \
+    " group now has %d members, %s is position %d." \
+    " Restarting the formation.\n",
+    (int)group_members_.size(), self_->agent.prefix.c_str(), position_);
+
+  restart();
+}
+
+void
+gams::algorithms::FormationSync::restart(void)
+{
+  slot_ = -1;
+  plan_.clear();
+  adopted_.clear();
+
+  if (position_ >= 0)
+  {
+    barrier_.set_name(barrier_name_, *knowledge_,
+      position_, (int)group_members_.size(), fan_in_);
+    barrier_.set(0);
+  }
+}
+
 gams::pose::Position
 gams::algorithms::FormationSync::generate_position(pose::Position reference,
 double angle, double distance)
@@ -795,8 +1128,19 @@ gams::algorithms::FormationSync::operator=(const FormationSync & rhs)
       group_ = group_factory_.create(rhs.group_->get_prefix());
     }
     group_members_ = rhs.group_members_;
+    members_version_ = rhs.members_version_;
     buffer_ = rhs.buffer_;
+    assignment_ = rhs.assignment_;
+    solver_ = rhs.solver_;
+
+    // the new group has its own versions, so the next solve is complete
+    solved_members_.clear();
+    solved_version_ = 0;
+    slot_ = rhs.slot_;
+    adopted_ = rhs.adopted_;
     barrier_ = rhs.barrier_;
+    barrier_name_ = rhs.barrier_name_;
+    fan_in_ = rhs.fan_in_;
   }
 }
 
@@ -810,7 +1154,30 @@ gams::algorithms::FormationSync::analyze(void)
 
   if (platform_ && *platform_->get_platform_status()->movement_available)
   {
-    if (position_ >= 0)
+    // a membership change restarts the formation, and the plan waits
+    // for the published slot assignment
+    refresh_members();
+
+    // the leader replaces assignments left by earlier runs, so a changed
+    // assignment restarts the formation as well
+    if (slot_ >= 0 && assignment_ != formations::ASSIGN_BY_INDEX &&
+      knowledge_->get(assignment_name_).to_integers() != adopted_)
+    {
+      madara_logger_ptr_log(gams::loggers::global_logger.get(),
+        gams::loggers::LOG_MAJOR,
+        "gams::algorithms::FormationSync::analyze:" \
+        " %s slot assignment changed. Restarting the formation.\n",
+        self_->agent.prefix.c_str());
+
+      restart();
+    }
+
+    if (position_ >= 0 && slot_ < 0)
+    {
+      generate_plan(formation_);
+    }
+
+    if (position_ >= 0 && slot_ >= 0)
     {
       int round =(int)barrier_.get_round() / 2;
       int state =(int)barrier_.get_round() % 2;
@@ -868,7 +1235,8 @@ gams::algorithms::FormationSync::analyze(void)
             madara_logger_ptr_log(gams::loggers::global_logger.get(),
               gams::loggers::LOG_MINOR,
               "gams::algorithms::FormationSync::analyze:" \
-              " %d: waiting barrier complete, ready to move.\n", position_);
+              " %d: waiting barrier complete after %.4fs, ready to move.\n",
+              position_, barrier_.get_last_wait());
 
             barrier_.next();
           }
@@ -896,7 +1264,7 @@ gams::algorithms::FormationSync::analyze(void)
           position_, round,(int)plan_.size());
       }
     }
-    else
+    else if (position_ < 0)
     {
       madara_logger_ptr_log(gams::loggers::global_logger.get(),
         gams::loggers::LOG_MINOR,
@@ -927,7 +1295,14 @@ gams::algorithms::FormationSync::execute(void)
 
   if (platform_ && *platform_->get_platform_status()->movement_available)
   {
-    if (position_ >= 0)
+    if (position_ >= 0 && slot_ < 0)
+    {
+      madara_logger_ptr_log(gams::loggers::global_logger.get(),
+        gams::loggers::LOG_MINOR,
+        "gams::algorithms::FormationSync::execute:" \
+        " %d: waiting for the slot assignment.\n", position_);
+    }
+    else if (position_ >= 0)
     {
       // move is index of move in the list
       int move =(int)barrier_.get_round() / 2;
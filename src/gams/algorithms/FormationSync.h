@@ -64,8 +64,10 @@
 #include "gams/algorithms/BaseAlgorithm.h"
 #include "gams/algorithms/AlgorithmFactory.h"
 #include "madara/knowledge/containers/Integer.h"
-#include "madara/knowledge/containers/Barrier.h"
 #include "gams/groups/GroupFactoryRepository.h"
+#include "gams/formations/FormationAssignment.h"
+#include "gams/utility/Position.h"
+#include "gams/utility/TreeBarrier.h"
 
 namespace gams
 {
@@ -105,6 +107,10 @@ namespace gams
        * @param  platform     the underlying platform the algorithm will use
        * @param  sensors      map of sensor names to sensor information
        * @param  self         self-referencing variables
+       * @param  fan_in       children per node in a tree barrier. 0 uses a
+       *                      flat barrier.
+       * @param  assignment   how agents are assigned to formation slots
+       *                      (@see formations::AssignmentObjectives)
        **/
       FormationSync(
         pose::Position & start,
@@ -116,7 +122,9 @@ namespace gams
         madara::knowledge::KnowledgeBase * knowledge = 0,
         platforms::BasePlatform * platform = 0,
         variables::Sensors * sensors = 0,
-        variables::Self * self = 0);
+        variables::Self * self = 0,
+        int fan_in = 0,
+        int assignment = formations::ASSIGN_BY_INDEX);
 
       /**
        * Destructor
@@ -154,6 +162,62 @@ namespace gams
        **/
       void generate_plan(int formation);
 
+      /**
+       * Chooses this agent's formation slot
+       * @param formation       the type of formation. @see FormationTypes
+       * @param start_frame     the frame at the formation start
+       * @param latitude_move   the signed latitude step in meters
+       * @param longitude_move  the signed longitude step in meters
+       * The first group member solves the assignment once every member's
+       * location is known and publishes it, so all members agree on it.
+       * The published assignment is keyed to the member list and solved
+       * again when the members change. The leader always solves once, so
+       * an assignment left by an earlier run is replaced.
+       * @return  the slot for this agent, or -1 while the published
+       *          assignment is not yet available
+       **/
+      int assign_slot(int formation,
+        const pose::ReferenceFrame & start_frame,
+        double latitude_move, double longitude_move);
+
+      /**
+       * Applies the membership changes since the last solve to solver_
+       * by removing the agents that left and adding the agents that
+       * joined. Only possible if the member count, and with it the
+       * slots, did not change.
+       * @param locations  member locations, in group_members_ order
+       * @param slots      slot positions
+       * @param result     the slot of each member, in group_members_ order
+       * @return  false if the assignment must be solved from scratch
+       **/
+      bool reassign(const std::vector <pose::Position> & locations,
+        const std::vector <pose::Position> & slots,
+        std::vector <int> & result);
+
+      /**
+       * Rereads the group members if the group changed. If they did, the
+       * formation restarts: the barrier is rejoined with the new members
+       * and the plan waits for the slot assignment of the new members.
+       **/
+      void refresh_members(void);
+
+      /**
+       * Restarts the formation: rejoins the barrier and waits for the
+       * slot assignment of the current members
+       **/
+      void restart(void);
+
+      /**
+       * Computes the offset of a slot from the formation reference
+       * @param slot            the slot in the formation
+       * @param formation       the type of formation. @see FormationTypes
+       * @param latitude_move   the signed latitude step in meters
+       * @param longitude_move  the signed longitude step in meters
+       * @return  the cartesian offset of the slot
+       **/
+      utility::Position get_slot_offset(int slot, int formation,
+        double latitude_move, double longitude_move) const;
+
       /**
        * Generates a position at an angle and distance
        * @param reference  the reference position
@@ -179,6 +243,9 @@ namespace gams
       /// a convenience list of all current group members
       groups::AgentVector group_members_;
 
+      /// the group version that group_members_ reflects
+      uint64_t members_version_;
+
       /// the buffer between cells in the formation
       double buffer_;
 
@@ -191,11 +258,39 @@ namespace gams
       /// position in member assignment
       int position_;
 
+      /// slot assignment objective. @see formations::AssignmentObjectives
+      int assignment_;
+
+      /// the variable holding the member list key and the published slot
+      /// of each member
+      std::string assignment_name_;
+
+      /// the last assignment solved by this agent, if it is member 0
+      formations::FormationAssignment solver_;
+
+      /// the members that solver_'s agents correspond to
+      groups::AgentVector solved_members_;
+
+      /// the group version that solved_members_ reflects
+      uint64_t solved_version_;
+
+      /// this agent's slot in the formation
+      int slot_;
+
+      /// the published assignment that slot_ was taken from
+      std::vector <madara::knowledge::KnowledgeRecord::Integer> adopted_;
+
       /// the move total before a pivot. Used for debugging
       int move_pivot_;
 
       /// movement barrier
-      madara::knowledge::containers::Barrier barrier_;
+      utility::TreeBarrier barrier_;
+
+      /// the name of barrier_
+      std::string barrier_name_;
+
+      /// children per node in barrier_
+      int fan_in_;
     };
     
     /**
@@ -216,7 +311,12 @@ namespace gams
        *                    buffer = buffer of the formation in meters<br>
        *                    formation = enum
        *                    @see FormationSync::FormationTypes<br>
-       *                    barrier = unused variable to serve as barrier
+       *                    barrier = unused variable to serve as barrier<br>
+       *                    fan_in = children per node for a tree barrier.
+       *                             0 (default) uses a flat barrier<br>
+       *                    assignment = INDEX (default), TOTAL to minimize
+       *                             total distance to slots, or MAX to
+       *                             minimize the longest distance
        * @param   knowledge the knowledge base to use
        * @param   platform  the platform. This will be set by the
        *                    controller in init_vars.
@@ -32,6 +32,7 @@
 
 #include "madara/utility/Timer.h"
 #include "gams/utility/ArgumentParser.h"
+#include "gams/variables/AgentNames.h"
 #include "gams/auctions/AuctionMinimumDistance.h"
 
 using std::stringstream;
@@ -424,7 +425,8 @@ gams::algorithms::Greet::analyze(void)
         for (size_t i = 0; i < targets.size(); ++i)
         {
           containers::NativeDoubleVector target_container(
-            targets[i] + ".location", *knowledge_);
+            variables::agent_names().intern_name(targets[i]).location,
+            *knowledge_);
           target_location.from_container(target_container);
           target_location.z(0);
 
@@ -449,8 +451,8 @@ gams::algorithms::Greet::analyze(void)
           distance_auctions[i].bid(KnowledgeRecord(
              xy_location.distance_to(target_location)));
           // distance_auctions[i].calculate_bids();
-          distance_auctions[i].get_bids(distance_bids[i]);
-          auctions::sort_ascending(distance_bids[i]);
+          // only the closest bidders matter, so avoid a full sort
+          distance_auctions[i].get_top_bids(distance_bids[i], 1);
         }
 
         overall_timer.stop();
@@ -576,7 +578,8 @@ gams::algorithms::Greet::analyze(void)
           for (auto target : targets)
           {
             containers::NativeDoubleVector target_container(
-              target + ".location", *knowledge_);
+              variables::agent_names().intern_name(target).location,
+              *knowledge_);
             target_location.from_container(target_container);
             target_location.z(0);
 
@@ -636,11 +639,9 @@ gams::algorithms::Greet::analyze(void)
             follow_group_->sync();
           }
 
-          follow_group_->get_members(followers);
-
-          if (groups::find_member_index(self_->agent.prefix, followers) < 0)
+          if (follow_group_->get_member_index(self_->agent.prefix) < 0)
           {
-            if (followers.size() < (size_t)follow_max_agents_)
+            if (follow_group_->size() < (size_t)follow_max_agents_)
             {
               madara_logger_ptr_log(gams::loggers::global_logger.get(),
                 gams::loggers::LOG_MINOR,
@@ -648,9 +649,8 @@ gams::algorithms::Greet::analyze(void)
                 " Adding self prefix (%s) to group (%s). Size is %zu.\n",
                 self_->agent.prefix.c_str(),
                 new_group.c_str(),
-                followers.size());
+                follow_group_->size());
 
-              followers.clear();
               followers.push_back(self_->agent.prefix);
               follow_group_->add_members (followers);
 
@@ -660,7 +660,7 @@ gams::algorithms::Greet::analyze(void)
                 " Finished adding self %s to group %s. New size is %zu.\n",
                 self_->agent.prefix.c_str(),
                 new_group.c_str(),
-                followers.size());
+                follow_group_->size());
 
               is_following_ = true;
               is_guarding_ = false;
@@ -671,7 +671,7 @@ gams::algorithms::Greet::analyze(void)
                 gams::loggers::LOG_MINOR,
                 "gams::algorithms::Greet::analyze:"
                 " Already have enough followers (%zu) for group %s.\n",
-                followers.size(), follow_group_->get_prefix().c_str()
+                follow_group_->size(), follow_group_->get_prefix().c_str()
               );
             }
           }
@@ -693,7 +693,8 @@ gams::algorithms::Greet::analyze(void)
         for (auto target : targets)
         {
           containers::NativeDoubleVector target_container(
-            target + ".location", *knowledge_);
+            variables::agent_names().intern_name(target).location,
+            *knowledge_);
           target_location.from_container(target_container);
           target_location.z(0);
 
@@ -778,10 +779,7 @@ gams::algorithms::Greet::execute(void)
 
       pose::ReferenceFrame cur_frame(target_.prefix, target);
 
-      groups::AgentVector followers;
-      follow_group_->get_members(followers);
-      
-      int found = groups::find_member_index(self_->agent.prefix, followers);
+      int found = follow_group_->get_member_index(self_->agent.prefix);
 
       gams::pose::Position next_pos (cur_frame,
         0, 0, target.z() + 10.0 + found);
@@ -866,3 +864,10 @@ gams::algorithms::Greet::plan(void)
 {
   return 0;
 }
+
+int
+gams::algorithms::Greet::get_phases(void) const
+{
+  // plan is a no-op
+  return PHASE_ANALYZE | PHASE_EXECUTE;
+}
@@ -121,7 +121,13 @@ namespace gams
        * Plans the next execution of the algorithm
        * @return bitmask status of the platform. @see Status.
        **/
-      virtual int plan(void);
+      virtual int plan(void) final;
+
+      /**
+       * Returns the phases this algorithm does work in
+       * @return bitmask of phases. @see AlgorithmPhases
+       **/
+      virtual int get_phases(void) const;
       
     protected:
       /// location of agent to follow
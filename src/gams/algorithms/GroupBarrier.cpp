@@ -94,6 +94,7 @@ variables::Agents * agents)
     std::string group = "";
     std::string barrier = "barrier.group_barrier";
     double interval = 1.0;
+    int fan_in = 0;
 
     ArgumentParser argp(args);
 
@@ -124,6 +125,19 @@ variables::Agents * agents)
           continue;
         }
         goto unknown;
+      case 'f':
+        if (name == "fan_in")
+        {
+          fan_in = (int)i.value().to_integer();
+
+          madara_logger_ptr_log(gams::loggers::global_logger.get(),
+            gams::loggers::LOG_DETAILED,
+            "gams::algorithms::GroupBarrierFactory:" \
+            " setting fan_in to %d\n", fan_in);
+
+          continue;
+        }
+        goto unknown;
       case 'i':
         if (i.value() == "interval")
         {
@@ -184,7 +198,7 @@ variables::Agents * agents)
     }
 
     result = new GroupBarrier(members, barrier, interval,
-      knowledge, platform, sensors, self);
+      knowledge, platform, sensors, self, fan_in);
   }
 
   return result;
@@ -197,7 +211,8 @@ gams::algorithms::GroupBarrier::GroupBarrier(
   madara::knowledge::KnowledgeBase * knowledge,
   platforms::BasePlatform * platform,
   variables::Sensors * sensors,
-  variables::Self * self) :
+  variables::Self * self,
+  int fan_in) :
   BaseAlgorithm(knowledge, platform, sensors, self),
   members_(members), enforcer_(interval, interval)
 {
@@ -208,8 +223,8 @@ gams::algorithms::GroupBarrier::GroupBarrier(
     gams::loggers::LOG_MAJOR,
     "gams::algorithms::GroupBarrier::constructor:" \
     " Creating algorithm with args: " \
-    " barrier=%s\n",
-    barrier_name.c_str());
+    " barrier=%s, fan_in=%d\n",
+    barrier_name.c_str(), fan_in);
 
   madara::knowledge::KnowledgeRecord temp("agent.");
   temp += madara::knowledge::KnowledgeRecord(self_->id.to_string());
@@ -218,7 +233,8 @@ gams::algorithms::GroupBarrier::GroupBarrier(
 
   if (position_ >= 0)
   {
-    barrier_.set_name(barrier_name, *knowledge, position_,(int)members.size());
+    barrier_.set_name(barrier_name, *knowledge, position_,
+      (int)members.size(), fan_in);
     barrier_.set(0);
     barrier_.next();
   }
@@ -288,8 +304,9 @@ gams::algorithms::GroupBarrier::analyze(void)
       madara_logger_ptr_log(gams::loggers::global_logger.get(),
         gams::loggers::LOG_MINOR,
         "gams::algorithms::GroupBarrier::analyze:" \
-        " %d: Round %d: Proceeding to next barrier round\n",
-        position_, round);
+        " %d: Round %d: Proceeding to next barrier round" \
+        " (waited %.4fs, max %.4fs)\n",
+        position_, round, barrier_.get_last_wait(), barrier_.get_max_wait());
 
       if (enforcer_.has_reached_next())
       {
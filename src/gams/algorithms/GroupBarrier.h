@@ -65,8 +65,8 @@
 #include "gams/utility/GPSPosition.h"
 #include "gams/algorithms/AlgorithmFactory.h"
 #include "madara/knowledge/containers/Integer.h"
-#include "madara/knowledge/containers/Barrier.h"
 #include "madara/utility/EpochEnforcer.h"
+#include "gams/utility/TreeBarrier.h"
 
 namespace gams
 {
@@ -88,6 +88,8 @@ namespace gams
        * @param  platform     the underlying platform the algorithm will use
        * @param  sensors      map of sensor names to sensor information
        * @param  self         self-referencing variables
+       * @param  fan_in       children per node in a tree barrier. 0 uses a
+       *                      flat barrier.
        **/
       GroupBarrier(
         const std::vector<std::string> & members,
@@ -96,7 +98,8 @@ namespace gams
         madara::knowledge::KnowledgeBase * knowledge = 0,
         platforms::BasePlatform * platform = 0,
         variables::Sensors * sensors = 0,
-        variables::Self * self = 0);
+        variables::Self * self = 0,
+        int fan_in = 0);
 
       /**
        * Destructor
@@ -144,7 +147,7 @@ namespace gams
       int position_;
 
       /// movement barrier
-      madara::knowledge::containers::Barrier barrier_;
+      utility::TreeBarrier barrier_;
 
       /// enforcer of barrier times
       madara::utility::EpochEnforcer<std::chrono::steady_clock> enforcer_;
@@ -163,7 +166,9 @@ namespace gams
        *                    name of an arg. The second arg is the value
        *                    of the arg.<br>
        *                    group = name of the group in group.{name}.members<br>
-       *                    barrier = unused variable to serve as barrier
+       *                    barrier = unused variable to serve as barrier<br>
+       *                    fan_in = children per node for a tree barrier.
+       *                             0 (default) uses a flat barrier<br>
        *                    interval = interval in seconds to wait before
        *                               moving between barrier rounds
        * @param   knowledge the knowledge base to use
@@ -225,3 +225,10 @@ gams::algorithms::Hold::plan(void)
 {
   return 0;
 }
+
+int
+gams::algorithms::Hold::get_phases(void) const
+{
+  // plan is a no-op
+  return PHASE_ANALYZE | PHASE_EXECUTE;
+}
@@ -181,3 +181,10 @@ gams::algorithms::Home::plan(void)
 {
   return 0;
 }
+
+int
+gams::algorithms::Home::get_phases(void) const
+{
+  // plan is a no-op
+  return PHASE_ANALYZE | PHASE_EXECUTE;
+}
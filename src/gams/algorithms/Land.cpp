@@ -151,3 +151,10 @@ gams::algorithms::Land::plan(void)
 {
   return 0;
 }
+
+int
+gams::algorithms::Land::get_phases(void) const
+{
+  // plan is a no-op
+  return PHASE_ANALYZE | PHASE_EXECUTE;
+}
@@ -208,6 +208,13 @@ gams::algorithms::MessageProfiling::plan(void)
   return 0;
 }
 
+int
+gams::algorithms::MessageProfiling::get_phases(void) const
+{
+  // plan is a no-op
+  return PHASE_ANALYZE | PHASE_EXECUTE;
+}
+
 gams::algorithms::MessageProfiling::MessageFilter::~MessageFilter()
 {
 }
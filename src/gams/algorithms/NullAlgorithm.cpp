@@ -122,3 +122,10 @@ gams::algorithms::NullAlgorithm::plan(void)
 {
   return 0;
 }
+
+int
+gams::algorithms::NullAlgorithm::get_phases(void) const
+{
+  // plan and execute are no-ops
+  return PHASE_ANALYZE;
+}
@@ -161,3 +161,10 @@ gams::algorithms::Takeoff::plan(void)
 {
   return 0;
 }
+
+int
+gams::algorithms::Takeoff::get_phases(void) const
+{
+  // plan is a no-op
+  return PHASE_ANALYZE | PHASE_EXECUTE;
+}
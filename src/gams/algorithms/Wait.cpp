@@ -159,3 +159,10 @@ gams::algorithms::Wait::plan(void)
 {
   return 0;
 }
+
+int
+gams::algorithms::Wait::get_phases(void) const
+{
+  // plan is a no-op
+  return PHASE_ANALYZE | PHASE_EXECUTE;
+}
@@ -57,9 +57,11 @@
 #include <string>
 #include <iostream>
 #include <cmath>
+#include <unordered_map>
 
 #include "gams/algorithms/AlgorithmFactory.h"
 #include "gams/pose/CartesianFrame.h"
+#include "gams/variables/AgentNames.h"
 #include "madara/utility/Utility.h"
 
 namespace engine = madara::knowledge;
@@ -205,6 +207,8 @@ gams::algorithms::ZoneCoverage::ZoneCoverage(
   variables::Self * self) :
   BaseAlgorithm(knowledge, platform, sensors, self),
   group_factory_(knowledge),
+  protectors_(0), assets_(0), enemies_(0),
+  assets_version_(0), enemies_version_(0),
   formation_(formation), buffer_(buffer), distance_(distance),
   index_(-1),
   form_func_(get_form_func(formation)),
@@ -354,10 +358,10 @@ gams::algorithms::ZoneCoverage::ZoneCoverage(
 
       if (assets_)
       {
-        // fill the group member lists with current contents
-        // we can sync the group and call get_members again if we want to support
-        // changing group member lists(even with fixed list groups)
+        // fill the group member lists with current contents. analyze
+        // applies later membership changes from the group's deltas
         assets_->get_members(assets_members_);
+        assets_version_ = assets_->get_version();
       }
       else
       {
@@ -423,10 +427,10 @@ gams::algorithms::ZoneCoverage::ZoneCoverage(
 
       if (enemies_)
       {
-        // fill the group member lists with current contents
-        // we can sync the group and call get_members again if we want to support
-        // changing group member lists(even with fixed list groups)
+        // fill the group member lists with current contents. analyze
+        // applies later membership changes from the group's deltas
         enemies_->get_members(enemies_members_);
+        enemies_version_ = enemies_->get_version();
       }
       else
       {
@@ -496,8 +500,78 @@ gams::algorithms::ZoneCoverage::update_arrays(
   arrays.resize(names.size());
   for (size_t i = 0; i < names.size(); ++i)
   {
-    arrays[i].set_name(names[i] + ".location", *knowledge_, 3);
+    arrays[i].set_name(
+      variables::agent_names().intern_name(names[i]).location, *knowledge_, 3);
+  }
+}
+
+void
+gams::algorithms::ZoneCoverage::sync_arrays(
+  gams::groups::GroupBase *group,
+  gams::groups::AgentVector &names,
+  MadaraArrayVec &arrays,
+  uint64_t &version) const
+{
+  if (!group)
+  {
+    return;
+  }
+
+  group->sync();
+
+  if (group->get_version() == version)
+  {
+    return;
+  }
+
+  gams::groups::AgentVector added, removed;
+
+  if (group->get_changes(version, added, removed))
+  {
+    madara_logger_ptr_log(gams::loggers::global_logger.get(),
+      gams::loggers::LOG_MAJOR,
+      "gams::algorithms::ZoneCoverage::sync_arrays:" \
+      " %s changed: %i joined, %i left\n",
+      group->get_prefix().c_str(), (int)added.size(), (int)removed.size());
+
+    // the form functions use element 0 as the reference point, so keep
+    // the group order and only bind the arrays of new members
+    std::unordered_map<std::string, size_t> previous;
+    for (size_t i = 0; i < names.size(); ++i)
+    {
+      previous.insert(std::make_pair(names[i], i));
+    }
+
+    gams::groups::AgentVector members;
+    group->get_members(members);
+
+    MadaraArrayVec reordered(members.size());
+    for (size_t i = 0; i < members.size(); ++i)
+    {
+      auto found = previous.find(members[i]);
+
+      if (found != previous.end())
+      {
+        reordered[i] = arrays[found->second];
+      }
+      else
+      {
+        reordered[i].set_name(
+          variables::agent_names().intern_name(members[i]).location,
+          *knowledge_, 3);
+      }
+    }
+
+    names.swap(members);
+    arrays.swap(reordered);
   }
+  else
+  {
+    group->get_members(names);
+    update_arrays(names, arrays);
+  }
+
+  version = group->get_version();
 }
 
 void
@@ -536,6 +610,9 @@ gams::algorithms::ZoneCoverage::analyze(void)
     "gams::algorithms::ZoneCoverage::analyze:" \
     " entering analyze method\n");
 
+  sync_arrays(assets_, assets_members_, asset_loc_cont_, assets_version_);
+  sync_arrays(enemies_, enemies_members_, enemy_loc_cont_, enemies_version_);
+
   update_locs(asset_loc_cont_, asset_locs_);
   update_locs(enemy_loc_cont_, enemy_locs_);
   return OK;
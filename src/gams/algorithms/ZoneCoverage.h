@@ -154,6 +154,12 @@ namespace gams
       gams::groups::AgentVector assets_members_;
       gams::groups::AgentVector enemies_members_;
 
+      /// assets_ membership version reflected in asset_loc_cont_
+      uint64_t assets_version_;
+
+      /// enemies_ membership version reflected in enemy_loc_cont_
+      uint64_t enemies_version_;
+
       std::string formation_;
 
       double buffer_;
@@ -184,6 +190,10 @@ namespace gams
     private:
       void update_arrays(const gams::groups::AgentVector &names,
                          MadaraArrayVec &arrays) const;
+      void sync_arrays(gams::groups::GroupBase *group,
+                       gams::groups::AgentVector &names,
+                       MadaraArrayVec &arrays,
+                       uint64_t &version) const;
       void update_locs(const MadaraArrayVec &arrays,
                        std::vector<pose::Position> &locs) const;
     };
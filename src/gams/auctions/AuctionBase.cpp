@@ -45,6 +45,7 @@
 **/
 
 #include "AuctionBase.h"
+#include "gams/loggers/GlobalLogger.h"
 #include <sstream>
 
 gams::auctions::AuctionBase::AuctionBase(const std::string & auction_prefix,
@@ -53,7 +54,9 @@ gams::auctions::AuctionBase::AuctionBase(const std::string & auction_prefix,
   : knowledge_(knowledge),
     auction_prefix_(auction_prefix),
     agent_prefix_(agent_prefix),
-    round_(0)
+    round_(0),
+    bids_stale_(true),
+    bidders_version_(0)
 {
   reset_bids_pointer();
 }
@@ -68,6 +71,7 @@ gams::auctions::AuctionBase::add_group(groups::GroupBase * group)
   groups::AgentVector members;
   group->get_members(members);
 
+  // new members are interned by refresh_bids from the group's changes
   group_.add_members(members);
 }
 
@@ -75,6 +79,7 @@ void
 gams::auctions::AuctionBase::clear_group(void)
 {
   group_.clear_members();
+  bids_stale_ = true;
 }
 
 bool
@@ -127,6 +132,7 @@ void
 gams::auctions::AuctionBase::sync(void)
 {
   bids_.sync_keys();
+  bids_stale_ = true;
 }
 
 void
@@ -134,6 +140,14 @@ gams::auctions::AuctionBase::bid(const std::string & agent,
   const madara::knowledge::KnowledgeRecord & amount)
 {
   bids_.set(agent, amount.to_double());
+
+  if (knowledge_ && !bids_stale_)
+  {
+    madara::knowledge::ContextGuard guard(*knowledge_);
+
+    bid_index_.set_amount(bid_index_.add_bidder(agent, *knowledge_),
+      madara::knowledge::KnowledgeRecord(amount.to_double()));
+  }
 }
 
 void gams::auctions::AuctionBase::advance_round(void)
@@ -154,42 +168,115 @@ void gams::auctions::AuctionBase::set_round(int round)
   reset_bids_pointer();
 }
 
-void gams::auctions::AuctionBase::get_bids(
-  AuctionBids & bids, bool strip_prefix, bool include_all_members) const
+void gams::auctions::AuctionBase::refresh_bids(void) const
 {
   if (knowledge_)
   {
-    // get all bids
-    madara::knowledge::VariableReferences bid_refs;
-    knowledge_->get_matches(get_auction_round_prefix(), "", bid_refs);
+    madara::knowledge::ContextGuard guard(*knowledge_);
 
-    // the bids should be same size as bid references
-    bids.resize(bid_refs.size());
+    if (!bids_stale_ && bidders_version_ != group_.get_version())
+    {
+      groups::AgentVector added, removed;
 
-    // keep track of actual bids
-    size_t actuals = 0;
+      // joins only need interning. Departed members may still hold slots
+      // and must be dropped by a full reindex.
+      if (group_.get_changes(bidders_version_, added, removed) &&
+        removed.size() == 0)
+      {
+        for (size_t i = 0; i < added.size(); ++i)
+        {
+          bid_index_.add_bidder(added[i], *knowledge_);
+        }
+
+        bidders_version_ = group_.get_version();
+      }
+      else
+      {
+        bids_stale_ = true;
+      }
+    }
 
-    for (size_t i = 0; i < bid_refs.size(); ++i)
+    if (bids_stale_)
     {
-      bids[actuals].amount = knowledge_->get(bid_refs[i]);
+      madara_logger_ptr_log(gams::loggers::global_logger.get(),
+        gams::loggers::LOG_DETAILED,
+        "gams::auctions::AuctionBase::refresh_bids:" \
+        " indexing bids in %s\n", get_auction_round_prefix().c_str());
 
-      // if we're including all member bids or if the bid is real
-      if (include_all_members || bids[actuals].amount.is_valid())
+      bid_index_.index(get_auction_round_prefix(), *knowledge_);
+
+      // intern expected participants so their bids are seen as they arrive
+      groups::AgentVector members;
+      group_.get_members(members);
+
+      for (size_t i = 0; i < members.size(); ++i)
       {
-        // set bidder to full name(includes round number)
-        bids[actuals].bidder = bid_refs[i].get_name();
-        ++actuals;
+        bid_index_.add_bidder(members[i], *knowledge_);
       }
-    } // end for loop over bid references
 
-    // resize the bids to smaller if necessary
-    if (actuals != bids.size())
-      bids.resize(actuals);
-
-    // strip the prefixes if necessary
-    if (strip_prefix)
+      bidders_version_ = group_.get_version();
+      bids_stale_ = false;
+    }
+    else
     {
-      strip_prefix_fast(get_auction_round_prefix() + ".", bids);
+      bid_index_.update(*knowledge_);
     }
+  }
+}
+
+void gams::auctions::AuctionBase::get_bids(
+  AuctionBids & bids, bool strip_prefix, bool include_all_members) const
+{
+  if (knowledge_)
+  {
+    madara::knowledge::ContextGuard guard(*knowledge_);
+
+    refresh_bids();
+    bid_index_.get_bids(bids, strip_prefix, include_all_members);
   } // end if knowledge base is valid
 }
+
+bool gams::auctions::AuctionBase::get_best_bid(
+  AuctionBid & best, bool ascending, bool strip_prefix) const
+{
+  bool result = false;
+
+  if (knowledge_)
+  {
+    madara::knowledge::ContextGuard guard(*knowledge_);
+
+    refresh_bids();
+    result = bid_index_.get_best(best, ascending, strip_prefix);
+  }
+
+  return result;
+}
+
+void gams::auctions::AuctionBase::get_top_bids(
+  AuctionBids & bids, size_t k, bool ascending, bool strip_prefix) const
+{
+  bids.clear();
+
+  if (knowledge_)
+  {
+    madara::knowledge::ContextGuard guard(*knowledge_);
+
+    refresh_bids();
+    bid_index_.get_top(bids, k, ascending, strip_prefix);
+  }
+}
+
+void gams::auctions::AuctionBase::get_bids_within(
+  AuctionBids & bids, double threshold, bool ascending,
+  bool strip_prefix) const
+{
+  bids.clear();
+
+  if (knowledge_)
+  {
+    madara::knowledge::ContextGuard guard(*knowledge_);
+
+    refresh_bids();
+    bid_index_.get_within(bids, threshold, ascending, strip_prefix);
+  }
+}
@@ -67,6 +67,7 @@
 #include "gams/GamsExport.h"
 
 #include "gams/auctions/AuctionBid.h"
+#include "gams/auctions/AuctionBidIndex.h"
 
 namespace gams
 {
@@ -142,7 +143,8 @@ namespace gams
         madara::knowledge::KnowledgeBase * knowledge);
 
       /**
-      * Syncs the auction information from the knowledge base
+      * Syncs the auction information from the knowledge base. Bidders
+      * that are not group members are indexed on the next bid query.
       **/
       virtual void sync(void);
 
@@ -199,12 +201,44 @@ namespace gams
        * Returns the list of bids in this round
        * @param bids                the map of bidders to bid amount
        * @param strip_prefix        if true, strips auction prefix from bidder 
-       * @param include_all_members if true, includes empty bids from  
+       * @param include_all_members if true, includes bid variables that
+       *                            exist without a valid bid
        **/
       virtual void get_bids(AuctionBids & bids,
         bool strip_prefix = true,
         bool include_all_members = false) const;
 
+      /**
+       * Returns the best bid in this round without sorting
+       * @param best          the best bid, if one exists
+       * @param ascending     if true, the lowest bid is best
+       * @param strip_prefix  if true, strips auction prefix from bidder
+       * @return true if a valid bid exists
+       **/
+      virtual bool get_best_bid(AuctionBid & best,
+        bool ascending = true, bool strip_prefix = true) const;
+
+      /**
+       * Returns the k best bids in this round, best first
+       * @param bids          the best bids
+       * @param k             the maximum number of bids to return
+       * @param ascending     if true, the lowest bids are best
+       * @param strip_prefix  if true, strips auction prefix from bidder
+       **/
+      virtual void get_top_bids(AuctionBids & bids, size_t k,
+        bool ascending = true, bool strip_prefix = true) const;
+
+      /**
+       * Returns the bids in this round that meet a threshold
+       * @param bids          the bids that meet the threshold
+       * @param threshold     the worst acceptable bid
+       * @param ascending     if true, returns bids <= threshold. Otherwise,
+       *                      returns bids >= threshold.
+       * @param strip_prefix  if true, strips auction prefix from bidder
+       **/
+      virtual void get_bids_within(AuctionBids & bids, double threshold,
+        bool ascending = true, bool strip_prefix = true) const;
+
       /**
       * Proceeds to the next auction round in a multi-round
       * auction
@@ -244,6 +278,15 @@ namespace gams
        **/
       void reset_bids_pointer(void);
 
+      /**
+       * Brings the bid index up to date with the knowledge base. The
+       * round prefix is only fully scanned, and group members only
+       * interned, when the index is stale(first use, sync, group or round
+       * changes). Otherwise, only the bids reported by the knowledge
+       * base's KeyFeed are applied.
+       **/
+      void refresh_bids(void) const;
+
       /**
       * The knowledge base to use as a data plane
       **/
@@ -273,6 +316,21 @@ namespace gams
        * the expected participant group
        **/
       groups::GroupFixedList group_;
+
+      /**
+       * bids indexed by bidder slot
+       **/
+      mutable AuctionBidIndex bid_index_;
+
+      /**
+       * if true, bid_index_ must be rebuilt before use
+       **/
+      mutable bool bids_stale_;
+
+      /**
+       * the group_ membership version that bid_index_ reflects
+       **/
+      mutable uint64_t bidders_version_;
     };
   }
 }
@@ -77,6 +77,8 @@ gams::auctions::AuctionBase::get_auction_prefix(void) const
 inline void
 gams::auctions::AuctionBase::reset_bids_pointer(void)
 {
+  bids_stale_ = true;
+
   if (knowledge_ && auction_prefix_ != "")
   {
     bids_.set_name(get_auction_round_prefix(), *knowledge_);
@@ -0,0 +1,400 @@
+/**
+* Copyright(c) 2016 Carnegie Mellon University. All Rights Reserved.
+*
+* Redistribution and use in source and binary forms, with or without
+* modification, are permitted provided that the following conditions are met:
+*
+* 1. Redistributions of source code must retain the above copyright notice,
+*    this list of conditions and the following acknowledgments and disclaimers.
+*
+* 2. Redistributions in binary form must reproduce the above copyright notice,
+*    this list of conditions and the following disclaimer in the documentation
+*    and/or other materials provided with the distribution.
+*
+* 3. The names "Carnegie Mellon University," "SEI" and/or "Software
+*    Engineering Institute" shall not be used to endorse or promote products
+*    derived from this software without prior written permission. For written
+*    permission, please contact permission@sei.cmu.edu.
+*
+* 4. Products derived from this software may not be called "SEI" nor may "SEI"
+*    appear in their names without prior written permission of
+*    permission@sei.cmu.edu.
+*
+* 5. Redistributions of any form whatsoever must retain the following
+*    acknowledgment:
+*
+*      This material is based upon work funded and supported by the Department
+*      of Defense under Contract No. FA8721-05-C-0003 with Carnegie Mellon
+*      University for the operation of the Software Engineering Institute, a
+*      federally funded research and development center. Any opinions,
+*      findings and conclusions or recommendations expressed in this material
+*      are those of the author(s) and do not necessarily reflect the views of
+*      the United States Department of Defense.
+*
+*      NO WARRANTY. THIS CARNEGIE MELLON UNIVERSITY AND SOFTWARE ENGINEERING
+*      INSTITUTE MATERIAL IS FURNISHED ON AN "AS-IS" BASIS. CARNEGIE MELLON
+*      UNIVERSITY MAKES NO WARRANTIES OF ANY KIND, EITHER EXPRESSED OR
+*      IMPLIED, AS TO ANY MATTER INCLUDING, BUT NOT LIMITED TO, WARRANTY OF
+*      FITNESS FOR PURPOSE OR MERCHANTABILITY, EXCLUSIVITY, OR RESULTS
+*      OBTAINED FROM USE OF THE MATERIAL. CARNEGIE MELLON UNIVERSITY DOES
+*      NOT MAKE ANY WARRANTY OF ANY KIND WITH RESPECT TO FREEDOM FROM PATENT,
+*      TRADEMARK, OR COPYRIGHT INFRINGEMENT.
+*
+*      This material has been approved for public release and unlimited
+*      distribution.
+**/
+
+#include <algorithm>
+
+#include "AuctionBidIndex.h"
+
+namespace
+{
+  /**
+  * Orders slots by bid value, breaking ties by slot
+  **/
+  class SlotOrder
+  {
+  public:
+    SlotOrder(const std::vector<double> & values, bool ascending)
+      : values_(values), ascending_(ascending)
+    {
+    }
+
+    bool operator()(size_t lhs, size_t rhs) const
+    {
+      if (values_[lhs] != values_[rhs])
+      {
+        return ascending_ ?
+          values_[lhs] < values_[rhs] : values_[lhs] > values_[rhs];
+      }
+
+      return lhs < rhs;
+    }
+
+  private:
+    const std::vector<double> & values_;
+    bool ascending_;
+  };
+}
+
+gams::auctions::AuctionBidIndex::AuctionBidIndex()
+  : feed_(0), subscription_(0)
+{
+}
+
+gams::auctions::AuctionBidIndex::AuctionBidIndex(
+  const AuctionBidIndex & source)
+  : prefix_(source.prefix_), bidders_(source.bidders_),
+  slots_(source.slots_), amounts_(source.amounts_),
+  values_(source.values_), valid_(source.valid_),
+  present_(source.present_), feed_(0), subscription_(0)
+{
+}
+
+gams::auctions::AuctionBidIndex::~AuctionBidIndex()
+{
+  if (feed_)
+  {
+    feed_->unsubscribe(subscription_);
+  }
+}
+
+gams::auctions::AuctionBidIndex &
+gams::auctions::AuctionBidIndex::operator=(const AuctionBidIndex & source)
+{
+  if (this != &source)
+  {
+    if (feed_)
+    {
+      feed_->unsubscribe(subscription_);
+      feed_ = 0;
+    }
+
+    prefix_ = source.prefix_;
+    bidders_ = source.bidders_;
+    slots_ = source.slots_;
+    amounts_ = source.amounts_;
+    values_ = source.values_;
+    valid_ = source.valid_;
+    present_ = source.present_;
+  }
+
+  return *this;
+}
+
+void
+gams::auctions::AuctionBidIndex::clear(void)
+{
+  bidders_.clear();
+  slots_.clear();
+  amounts_.clear();
+  values_.clear();
+  valid_.clear();
+  present_.clear();
+}
+
+void
+gams::auctions::AuctionBidIndex::index(const std::string & prefix,
+  madara::knowledge::KnowledgeBase & knowledge)
+{
+  clear();
+
+  prefix_ = prefix + ".";
+
+  subscribe_(knowledge);
+  scan_(knowledge);
+}
+
+void
+gams::auctions::AuctionBidIndex::subscribe_(
+  madara::knowledge::KnowledgeBase & knowledge)
+{
+  // subscribe before scanning so no bid falls between the two
+  if (feed_)
+  {
+    feed_->unsubscribe(subscription_);
+  }
+
+  feed_ = &utility::KeyFeed::get(knowledge);
+  subscription_ = feed_->subscribe(prefix_);
+}
+
+void
+gams::auctions::AuctionBidIndex::scan_(
+  madara::knowledge::KnowledgeBase & knowledge)
+{
+  // bids that are no longer in the knowledge base are not found again
+  for (size_t i = 0; i < bidders_.size(); ++i)
+  {
+    set_amount(i, madara::knowledge::KnowledgeRecord());
+    present_[i] = 0;
+  }
+
+  madara::knowledge::VariableReferences bid_refs;
+  knowledge.get_matches(prefix_, "", bid_refs);
+
+  for (size_t i = 0; i < bid_refs.size(); ++i)
+  {
+    apply_(bid_refs[i].get_name() + prefix_.size(), true,
+      knowledge.get(bid_refs[i]));
+  }
+}
+
+void
+gams::auctions::AuctionBidIndex::apply_(const std::string & bidder,
+  bool present, const madara::knowledge::KnowledgeRecord & amount)
+{
+  std::unordered_map<std::string, size_t>::const_iterator found =
+    slots_.find(bidder);
+  size_t slot;
+
+  if (found != slots_.end())
+  {
+    slot = found->second;
+  }
+  else if (present)
+  {
+    slot = add_slot_(bidder);
+  }
+  else
+  {
+    return;
+  }
+
+  present_[slot] = present ? 1 : 0;
+  set_amount(slot, amount);
+}
+
+size_t
+gams::auctions::AuctionBidIndex::add_bidder(const std::string & bidder,
+  madara::knowledge::KnowledgeBase & knowledge)
+{
+  std::unordered_map<std::string, size_t>::const_iterator found =
+    slots_.find(bidder);
+
+  if (found != slots_.end())
+  {
+    return found->second;
+  }
+
+  size_t slot = add_slot_(bidder);
+
+  // get_ref would create an empty variable for bidders that never bid
+  std::string name(prefix_ + bidder);
+
+  if (knowledge.exists(name))
+  {
+    present_[slot] = 1;
+    set_amount(slot, knowledge.get(name));
+  }
+
+  return slot;
+}
+
+size_t
+gams::auctions::AuctionBidIndex::add_slot_(const std::string & bidder)
+{
+  size_t slot = bidders_.size();
+
+  slots_[bidder] = slot;
+  bidders_.push_back(bidder);
+  amounts_.push_back(madara::knowledge::KnowledgeRecord());
+  values_.push_back(0);
+  valid_.push_back(0);
+  present_.push_back(0);
+
+  return slot;
+}
+
+int
+gams::auctions::AuctionBidIndex::get_slot(const std::string & bidder) const
+{
+  std::unordered_map<std::string, size_t>::const_iterator found =
+    slots_.find(bidder);
+
+  return found != slots_.end() ? (int)found->second : -1;
+}
+
+void
+gams::auctions::AuctionBidIndex::update(
+  madara::knowledge::KnowledgeBase & knowledge)
+{
+  std::vector<std::string> changed;
+
+  if (!feed_ || !feed_->take(subscription_, changed))
+  {
+    subscribe_(knowledge);
+    scan_(knowledge);
+  }
+  else if (!feed_->is_attached())
+  {
+    // without a feed on the transports, a scan is the only way to find
+    // bids placed by other agents
+    scan_(knowledge);
+  }
+  else
+  {
+    // only the bids that were received or sent since the last update
+    for (size_t i = 0; i < changed.size(); ++i)
+    {
+      apply_(changed[i].substr(prefix_.size()),
+        knowledge.exists(changed[i]), knowledge.get(changed[i]));
+    }
+  }
+}
+
+void
+gams::auctions::AuctionBidIndex::set_amount(size_t slot,
+  const madara::knowledge::KnowledgeRecord & amount)
+{
+  amounts_[slot] = amount;
+  valid_[slot] = amount.is_valid() ? 1 : 0;
+  values_[slot] = valid_[slot] ? amount.to_double() : 0;
+}
+
+size_t
+gams::auctions::AuctionBidIndex::size(void) const
+{
+  return bidders_.size();
+}
+
+void
+gams::auctions::AuctionBidIndex::get_bids(AuctionBids & bids,
+  bool strip_prefix, bool include_all) const
+{
+  bids.clear();
+  bids.reserve(bidders_.size());
+
+  for (size_t i = 0; i < bidders_.size(); ++i)
+  {
+    if (valid_[i] || (include_all && present_[i]))
+    {
+      bids.push_back(AuctionBid());
+      fill_bid_(i, strip_prefix, bids.back());
+    }
+  }
+}
+
+bool
+gams::auctions::AuctionBidIndex::get_best(AuctionBid & best,
+  bool ascending, bool strip_prefix) const
+{
+  SlotOrder order(values_, ascending);
+  size_t best_slot = bidders_.size();
+
+  for (size_t i = 0; i < bidders_.size(); ++i)
+  {
+    if (valid_[i] && (best_slot == bidders_.size() || order(i, best_slot)))
+    {
+      best_slot = i;
+    }
+  }
+
+  if (best_slot != bidders_.size())
+  {
+    fill_bid_(best_slot, strip_prefix, best);
+    return true;
+  }
+
+  return false;
+}
+
+void
+gams::auctions::AuctionBidIndex::get_top(AuctionBids & bids, size_t k,
+  bool ascending, bool strip_prefix) const
+{
+  bids.clear();
+
+  std::vector<size_t> slots;
+  slots.reserve(bidders_.size());
+
+  for (size_t i = 0; i < bidders_.size(); ++i)
+  {
+    if (valid_[i])
+    {
+      slots.push_back(i);
+    }
+  }
+
+  if (k > slots.size())
+  {
+    k = slots.size();
+  }
+
+  // only the first k slots need to be ordered
+  std::partial_sort(slots.begin(), slots.begin() + k, slots.end(),
+    SlotOrder(values_, ascending));
+
+  bids.resize(k);
+
+  for (size_t i = 0; i < k; ++i)
+  {
+    fill_bid_(slots[i], strip_prefix, bids[i]);
+  }
+}
+
+void
+gams::auctions::AuctionBidIndex::get_within(AuctionBids & bids,
+  double threshold, bool ascending, bool strip_prefix) const
+{
+  bids.clear();
+
+  for (size_t i = 0; i < bidders_.size(); ++i)
+  {
+    if (valid_[i] &&
+      (ascending ? values_[i] <= threshold : values_[i] >= threshold))
+    {
+      bids.push_back(AuctionBid());
+      fill_bid_(i, strip_prefix, bids.back());
+    }
+  }
+}
+
+void
+gams::auctions::AuctionBidIndex::fill_bid_(size_t slot, bool strip_prefix,
+  AuctionBid & bid) const
+{
+  bid.bidder = strip_prefix ? bidders_[slot] : prefix_ + bidders_[slot];
+  bid.amount = amounts_[slot];
+}
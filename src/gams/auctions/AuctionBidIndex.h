@@ -0,0 +1,270 @@
+/**
+* Copyright(c) 2016 Carnegie Mellon University. All Rights Reserved.
+*
+* Redistribution and use in source and binary forms, with or without
+* modification, are permitted provided that the following conditions are met:
+*
+* 1. Redistributions of source code must retain the above copyright notice,
+*    this list of conditions and the following acknowledgments and disclaimers.
+*
+* 2. Redistributions in binary form must reproduce the above copyright notice,
+*    this list of conditions and the following disclaimer in the documentation
+*    and/or other materials provided with the distribution.
+*
+* 3. The names "Carnegie Mellon University," "SEI" and/or "Software
+*    Engineering Institute" shall not be used to endorse or promote products
+*    derived from this software without prior written permission. For written
+*    permission, please contact permission@sei.cmu.edu.
+*
+* 4. Products derived from this software may not be called "SEI" nor may "SEI"
+*    appear in their names without prior written permission of
+*    permission@sei.cmu.edu.
+*
+* 5. Redistributions of any form whatsoever must retain the following
+*    acknowledgment:
+*
+*      This material is based upon work funded and supported by the Department
+*      of Defense under Contract No. FA8721-05-C-0003 with Carnegie Mellon
+*      University for the operation of the Software Engineering Institute, a
+*      federally funded research and development center. Any opinions,
+*      findings and conclusions or recommendations expressed in this material
+*      are those of the author(s) and do not necessarily reflect the views of
+*      the United States Department of Defense.
+*
+*      NO WARRANTY. THIS CARNEGIE MELLON UNIVERSITY AND SOFTWARE ENGINEERING
+*      INSTITUTE MATERIAL IS FURNISHED ON AN "AS-IS" BASIS. CARNEGIE MELLON
+*      UNIVERSITY MAKES NO WARRANTIES OF ANY KIND, EITHER EXPRESSED OR
+*      IMPLIED, AS TO ANY MATTER INCLUDING, BUT NOT LIMITED TO, WARRANTY OF
+*      FITNESS FOR PURPOSE OR MERCHANTABILITY, EXCLUSIVITY, OR RESULTS
+*      OBTAINED FROM USE OF THE MATERIAL. CARNEGIE MELLON UNIVERSITY DOES
+*      NOT MAKE ANY WARRANTY OF ANY KIND WITH RESPECT TO FREEDOM FROM PATENT,
+*      TRADEMARK, OR COPYRIGHT INFRINGEMENT.
+*
+*      This material has been approved for public release and unlimited
+*      distribution.
+**/
+
+/**
+* @file AuctionBidIndex.h
+* @author James Edmondson <jedmondson@gmail.com>
+*
+* This file contains the definition of an index of auction bids by
+* bidder slot
+**/
+
+#ifndef   _GAMS_AUCTIONS_AUCTION_BID_INDEX_H_
+#define   _GAMS_AUCTIONS_AUCTION_BID_INDEX_H_
+
+#include <string>
+#include <vector>
+#include <unordered_map>
+
+#include "madara/knowledge/KnowledgeBase.h"
+
+#include "gams/GamsExport.h"
+#include "gams/auctions/AuctionBid.h"
+#include "gams/utility/KeyFeed.h"
+
+namespace gams
+{
+  namespace auctions
+  {
+    /**
+    * An index of the bids in an auction round. Each bidder is interned into
+    * an integer slot once, so selecting leaders does no string work until
+    * results are produced. After the round is indexed, updates only apply
+    * the bids that the knowledge base's KeyFeed reports as changed.
+    **/
+    class GAMS_EXPORT AuctionBidIndex
+    {
+    public:
+      /**
+      * Constructor
+      **/
+      AuctionBidIndex();
+
+      /**
+      * Copy constructor. The copy subscribes to the feed on its first
+      * update.
+      * @param  source  the index to copy
+      **/
+      AuctionBidIndex(const AuctionBidIndex & source);
+
+      /**
+      * Destructor
+      **/
+      ~AuctionBidIndex();
+
+      /**
+      * Assignment operator. The copy subscribes to the feed on its first
+      * update.
+      * @param  source  the index to copy
+      * @return this index
+      **/
+      AuctionBidIndex & operator=(const AuctionBidIndex & source);
+
+      /**
+      * Removes all bidders from the index
+      **/
+      void clear(void);
+
+      /**
+      * Clears the index, subscribes to bid changes and scans the knowledge
+      * base for existing bids
+      * @param  prefix     the auction round prefix(e.g. auction.task.0)
+      * @param  knowledge  the knowledge base holding bids
+      **/
+      void index(const std::string & prefix,
+        madara::knowledge::KnowledgeBase & knowledge);
+
+      /**
+      * Adds a bidder to the index if it has not been interned already.
+      * A bid variable that does not exist yet is not created. Its bid is
+      * applied once update sees it.
+      * @param  bidder     the bidder id without auction prefix(e.g. agent.0)
+      * @param  knowledge  the knowledge base holding bids
+      * @return the slot of the bidder
+      **/
+      size_t add_bidder(const std::string & bidder,
+        madara::knowledge::KnowledgeBase & knowledge);
+
+      /**
+      * Gets the slot of a bidder
+      * @param  bidder  the bidder id without auction prefix(e.g. agent.0)
+      * @return the slot of the bidder or -1 if not indexed
+      **/
+      int get_slot(const std::string & bidder) const;
+
+      /**
+      * Applies the bids that were received or sent since the last update,
+      * indexing new bidders(e.g. agents outside the expected group) and
+      * invalidating bids whose variables were deleted. If no KeyFeed is
+      * attached to the transports, the prefix is rescanned instead.
+      * @param  knowledge  the knowledge base holding bids
+      **/
+      void update(madara::knowledge::KnowledgeBase & knowledge);
+
+      /**
+      * Sets the cached amount of a bidder
+      * @param  slot    the slot of the bidder
+      * @param  amount  the bid amount
+      **/
+      void set_amount(size_t slot,
+        const madara::knowledge::KnowledgeRecord & amount);
+
+      /**
+      * Returns the number of indexed bidders
+      * @return the number of bidders, including those without bids
+      **/
+      size_t size(void) const;
+
+      /**
+      * Gets all bids in slot order
+      * @param  bids          the resulting bids
+      * @param  strip_prefix  if true, bidders do not include auction prefix
+      * @param  include_all   if true, includes bid variables that exist
+      *                      without a valid bid. Interned bidders without
+      *                      a bid variable are never included.
+      **/
+      void get_bids(AuctionBids & bids, bool strip_prefix = true,
+        bool include_all = false) const;
+
+      /**
+      * Gets the best bid in a single pass
+      * @param  best          the best bid, if one exists
+      * @param  ascending     if true, the lowest bid is best
+      * @param  strip_prefix  if true, bidder does not include auction prefix
+      * @return true if a valid bid exists
+      **/
+      bool get_best(AuctionBid & best, bool ascending = true,
+        bool strip_prefix = true) const;
+
+      /**
+      * Gets the k best bids in order, using a partial sort
+      * @param  bids          the best bids, best first
+      * @param  k             the maximum number of bids to return
+      * @param  ascending     if true, the lowest bids are best
+      * @param  strip_prefix  if true, bidders do not include auction prefix
+      **/
+      void get_top(AuctionBids & bids, size_t k, bool ascending = true,
+        bool strip_prefix = true) const;
+
+      /**
+      * Gets bids that are at least as good as a threshold, in slot order
+      * @param  bids          the bids within the threshold
+      * @param  threshold     the worst acceptable bid amount
+      * @param  ascending     if true, bids <= threshold are returned.
+      *                       Otherwise, bids >= threshold are returned.
+      * @param  strip_prefix  if true, bidders do not include auction prefix
+      **/
+      void get_within(AuctionBids & bids, double threshold,
+        bool ascending = true, bool strip_prefix = true) const;
+
+    private:
+      /**
+      * Adds a slot for a bidder
+      * @param  bidder  the bidder id without auction prefix
+      * @return the slot of the bidder
+      **/
+      size_t add_slot_(const std::string & bidder);
+
+      /**
+      * Subscribes to changes under prefix_
+      * @param  knowledge  the knowledge base holding bids
+      **/
+      void subscribe_(madara::knowledge::KnowledgeBase & knowledge);
+
+      /**
+      * Reapplies every bid under prefix_
+      * @param  knowledge  the knowledge base holding bids
+      **/
+      void scan_(madara::knowledge::KnowledgeBase & knowledge);
+
+      /**
+      * Applies a bid, indexing the bidder if its variable exists
+      * @param  bidder   the bidder id without auction prefix
+      * @param  present  true if the bid variable exists
+      * @param  amount   the bid amount
+      **/
+      void apply_(const std::string & bidder, bool present,
+        const madara::knowledge::KnowledgeRecord & amount);
+
+      /**
+      * Fills a bid from a slot
+      * @param  slot          the slot of the bidder
+      * @param  strip_prefix  if true, bidder does not include auction prefix
+      * @param  bid           the bid to fill
+      **/
+      void fill_bid_(size_t slot, bool strip_prefix, AuctionBid & bid) const;
+
+      /// the auction round prefix, including trailing "."
+      std::string prefix_;
+
+      /// bidder ids by slot
+      std::vector<std::string> bidders_;
+
+      /// bidder id to slot
+      std::unordered_map<std::string, size_t> slots_;
+
+      /// bid amounts by slot
+      std::vector<madara::knowledge::KnowledgeRecord> amounts_;
+
+      /// bid amounts as doubles by slot for selection
+      std::vector<double> values_;
+
+      /// nonzero if the slot has a valid bid
+      std::vector<char> valid_;
+
+      /// nonzero if the slot's bid variable exists
+      std::vector<char> present_;
+
+      /// reports the bids that changed since the last update
+      utility::KeyFeed * feed_;
+
+      /// the subscription to prefix_ in feed_
+      utility::KeyFeed::Subscription subscription_;
+    };
+  }
+}
+
+#endif // _GAMS_AUCTIONS_AUCTION_BID_INDEX_H_
@@ -0,0 +1,600 @@
+/**
+* Copyright(c) 2016 Carnegie Mellon University. All Rights Reserved.
+*
+* Redistribution and use in source and binary forms, with or without
+* modification, are permitted provided that the following conditions are met:
+*
+* 1. Redistributions of source code must retain the above copyright notice,
+*    this list of conditions and the following acknowledgments and disclaimers.
+*
+* 2. Redistributions in binary form must reproduce the above copyright notice,
+*    this list of conditions and the following disclaimer in the documentation
+*    and/or other materials provided with the distribution.
+*
+* 3. The names "Carnegie Mellon University," "SEI" and/or "Software
+*    Engineering Institute" shall not be used to endorse or promote products
+*    derived from this software without prior written permission. For written
+*    permission, please contact permission@sei.cmu.edu.
+*
+* 4. Products derived from this software may not be called "SEI" nor may "SEI"
+*    appear in their names without prior written permission of
+*    permission@sei.cmu.edu.
+*
+* 5. Redistributions of any form whatsoever must retain the following
+*    acknowledgment:
+*
+*      This material is based upon work funded and supported by the Department
+*      of Defense under Contract No. FA8721-05-C-0003 with Carnegie Mellon
+*      University for the operation of the Software Engineering Institute, a
+*      federally funded research and development center. Any opinions,
+*      findings and conclusions or recommendations expressed in this material
+*      are those of the author(s) and do not necessarily reflect the views of
+*      the United States Department of Defense.
+*
+*      NO WARRANTY. THIS CARNEGIE MELLON UNIVERSITY AND SOFTWARE ENGINEERING
+*      INSTITUTE MATERIAL IS FURNISHED ON AN "AS-IS" BASIS. CARNEGIE MELLON
+*      UNIVERSITY MAKES NO WARRANTIES OF ANY KIND, EITHER EXPRESSED OR
+*      IMPLIED, AS TO ANY MATTER INCLUDING, BUT NOT LIMITED TO, WARRANTY OF
+*      FITNESS FOR PURPOSE OR MERCHANTABILITY, EXCLUSIVITY, OR RESULTS
+*      OBTAINED FROM USE OF THE MATERIAL. CARNEGIE MELLON UNIVERSITY DOES
+*      NOT MAKE ANY WARRANTY OF ANY KIND WITH RESPECT TO FREEDOM FROM PATENT,
+*      TRADEMARK, OR COPYRIGHT INFRINGEMENT.
+*
+*      This material has been approved for public release and unlimited
+*      distribution.
+**/
+
+#include <algorithm>
+#include <sstream>
+
+#include "AuctionCBBA.h"
+#include "gams/loggers/GlobalLogger.h"
+
+namespace knowledge = madara::knowledge;
+
+typedef knowledge::KnowledgeRecord::Integer Integer;
+
+gams::auctions::AuctionCBBAFactory::AuctionCBBAFactory()
+{
+}
+
+gams::auctions::AuctionCBBAFactory::~AuctionCBBAFactory()
+{
+}
+
+gams::auctions::AuctionBase *
+gams::auctions::AuctionCBBAFactory::create(
+const std::string & auction_prefix,
+const std::string & agent_prefix,
+madara::knowledge::KnowledgeBase * knowledge)
+{
+  madara_logger_ptr_log(gams::loggers::global_logger.get(),
+    gams::loggers::LOG_MAJOR,
+    "gams::auctions::AuctionCBBAFactory::create:" \
+    " creating auction from %s\n", auction_prefix.c_str());
+
+  return new AuctionCBBA(auction_prefix, agent_prefix, knowledge);
+}
+
+gams::auctions::AuctionCBBA::AuctionCBBA(
+  const std::string & auction_prefix,
+  const std::string & agent_prefix,
+  madara::knowledge::KnowledgeBase * knowledge)
+  : AuctionBase(auction_prefix, agent_prefix, knowledge),
+    self_(-1), max_bundle_size_(0), convergence_iterations_(2),
+    stable_iterations_(0), published_(false)
+{
+}
+
+gams::auctions::AuctionCBBA::~AuctionCBBA()
+{
+}
+
+void
+gams::auctions::AuctionCBBA::add_group(groups::GroupBase * group)
+{
+  AuctionBase::add_group(group);
+  reset_allocation();
+}
+
+void
+gams::auctions::AuctionCBBA::clear_group(void)
+{
+  AuctionBase::clear_group();
+  reset_allocation();
+}
+
+void
+gams::auctions::AuctionCBBA::set_tasks(const std::vector<std::string> & tasks)
+{
+  tasks_ = tasks;
+  task_index_.clear();
+
+  for (size_t i = 0; i < tasks_.size(); ++i)
+  {
+    task_index_[tasks_[i]] = i;
+  }
+
+  reset_allocation();
+}
+
+const std::vector<std::string> &
+gams::auctions::AuctionCBBA::get_tasks(void) const
+{
+  return tasks_;
+}
+
+void
+gams::auctions::AuctionCBBA::set_score(const std::string & task, double score)
+{
+  fixed_scores_[task] = score;
+
+  std::map<std::string, size_t>::const_iterator found = task_index_.find(task);
+
+  if (found != task_index_.end())
+  {
+    scores_[found->second] = score;
+  }
+}
+
+void
+gams::auctions::AuctionCBBA::set_score_function(const ScoreFunction & scorer)
+{
+  scorer_ = scorer;
+}
+
+void
+gams::auctions::AuctionCBBA::set_max_bundle_size(size_t max_bundle_size)
+{
+  max_bundle_size_ = max_bundle_size;
+}
+
+void
+gams::auctions::AuctionCBBA::set_convergence_iterations(int iterations)
+{
+  convergence_iterations_ = iterations;
+}
+
+bool
+gams::auctions::AuctionCBBA::iterate(void)
+{
+  bool changed = false;
+
+  if (!knowledge_ || self_ < 0 || tasks_.size() == 0)
+  {
+    madara_logger_ptr_log(gams::loggers::global_logger.get(),
+      gams::loggers::LOG_MINOR,
+      "gams::auctions::AuctionCBBA::iterate:" \
+      " %s is not ready(tasks=%d, member=%s)\n",
+      agent_prefix_.c_str(), (int)tasks_.size(),
+      self_ >= 0 ? "true" : "false");
+
+    return changed;
+  }
+
+  knowledge::ContextGuard guard(*knowledge_);
+
+  // consensus phase: resolve conflicts with every other participant
+  for (size_t k = 0; k < agents_.size(); ++k)
+  {
+    if ((int)k == self_)
+    {
+      continue;
+    }
+
+    std::string sender_prefix = get_consensus_prefix(agents_[k]);
+
+    std::vector<double> bids =
+      knowledge_->get(sender_prefix + ".winning_bids").to_doubles();
+    std::vector<Integer> winners =
+      knowledge_->get(sender_prefix + ".winners").to_integers();
+    std::vector<double> timestamps =
+      knowledge_->get(sender_prefix + ".timestamps").to_doubles();
+
+    // skip agents that have not published state for these tasks yet
+    if (bids.size() == tasks_.size() && winners.size() == tasks_.size() &&
+      timestamps.size() == agents_.size())
+    {
+      changed = resolve((int)k, bids, winners, timestamps) || changed;
+    }
+  }
+
+  changed = release_outbid() || changed;
+
+  // bundle phase: greedily add tasks that we can win
+  changed = build_bundle() || changed;
+
+  if (changed || !published_)
+  {
+    publish();
+  }
+
+  stable_iterations_ = changed ? 0 : stable_iterations_ + 1;
+
+  madara_logger_ptr_log(gams::loggers::global_logger.get(),
+    gams::loggers::LOG_MINOR,
+    "gams::auctions::AuctionCBBA::iterate:" \
+    " %s: %s holds %d tasks, changed=%s\n",
+    auction_prefix_.c_str(), agent_prefix_.c_str(),
+    (int)bundle_.size(), changed ? "true" : "false");
+
+  return changed;
+}
+
+bool
+gams::auctions::AuctionCBBA::is_converged(void) const
+{
+  return published_ && stable_iterations_ >= convergence_iterations_;
+}
+
+const gams::auctions::AuctionCBBA::Bundle &
+gams::auctions::AuctionCBBA::get_bundle(void) const
+{
+  return bundle_;
+}
+
+std::string
+gams::auctions::AuctionCBBA::get_winner(const std::string & task) const
+{
+  std::string winner;
+  std::map<std::string, size_t>::const_iterator found = task_index_.find(task);
+
+  if (found != task_index_.end() && winners_[found->second] >= 0)
+  {
+    winner = agents_[(size_t)winners_[found->second]];
+  }
+
+  return winner;
+}
+
+void
+gams::auctions::AuctionCBBA::get_assignments(
+  std::map<std::string, std::string> & assignments) const
+{
+  assignments.clear();
+
+  for (size_t i = 0; i < tasks_.size(); ++i)
+  {
+    if (winners_[i] >= 0)
+    {
+      assignments[tasks_[i]] = agents_[(size_t)winners_[i]];
+    }
+  }
+}
+
+std::string
+gams::auctions::AuctionCBBA::get_leader(void)
+{
+  std::string leader;
+
+  if (tasks_.size() > 0)
+  {
+    leader = get_winner(tasks_[0]);
+  }
+
+  madara_logger_ptr_log(gams::loggers::global_logger.get(),
+    gams::loggers::LOG_MAJOR,
+    "gams::auctions::AuctionCBBA::get_leader:" \
+    " final leader is %s\n", leader.c_str());
+
+  return leader;
+}
+
+void
+gams::auctions::AuctionCBBA::advance_round(void)
+{
+  AuctionBase::advance_round();
+  reset_allocation();
+}
+
+void
+gams::auctions::AuctionCBBA::reset_round(void)
+{
+  AuctionBase::reset_round();
+  reset_allocation();
+}
+
+void
+gams::auctions::AuctionCBBA::reset_allocation(void)
+{
+  groups::AgentVector members;
+  group_.get_members(members);
+
+  // slots must agree across agents, so order them by name
+  agents_ = members;
+  std::sort(agents_.begin(), agents_.end());
+
+  self_ = -1;
+  for (size_t i = 0; i < agents_.size(); ++i)
+  {
+    if (agents_[i] == agent_prefix_)
+    {
+      self_ = (int)i;
+      break;
+    }
+  }
+
+  scores_.assign(tasks_.size(), 0);
+  for (size_t i = 0; i < tasks_.size(); ++i)
+  {
+    std::map<std::string, double>::const_iterator found =
+      fixed_scores_.find(tasks_[i]);
+
+    if (found != fixed_scores_.end())
+    {
+      scores_[i] = found->second;
+    }
+  }
+
+  winning_bids_.assign(tasks_.size(), 0);
+  winners_.assign(tasks_.size(), -1);
+  timestamps_.assign(agents_.size(), 0);
+  bundle_.clear();
+  bundle_tasks_.clear();
+  stable_iterations_ = 0;
+  published_ = false;
+}
+
+double
+gams::auctions::AuctionCBBA::get_score(size_t task) const
+{
+  return scorer_ ? scorer_(tasks_[task], bundle_) : scores_[task];
+}
+
+bool
+gams::auctions::AuctionCBBA::outbids(double bid, int winner,
+  double current, int current_winner)
+{
+  if (bid != current)
+  {
+    return bid > current;
+  }
+
+  // ties go to the lower agent slot
+  return winner >= 0 && (current_winner < 0 || winner < current_winner);
+}
+
+bool
+gams::auctions::AuctionCBBA::resolve(int sender,
+  const std::vector<double> & bids,
+  const std::vector<Integer> & winners,
+  const std::vector<double> & timestamps)
+{
+  bool changed = false;
+  const int i = self_;
+  const int k = sender;
+
+  for (size_t j = 0; j < tasks_.size(); ++j)
+  {
+    const int zk = (int)winners[j];
+    const int zi = (int)winners_[j];
+    const double yk = bids[j];
+    const double yi = winning_bids_[j];
+
+    bool update = false;
+    bool reset = false;
+
+    // ignore winners outside of the current group
+    if (zk >= (int)agents_.size())
+    {
+      continue;
+    }
+
+    // sender's and receiver's info timestamps on the sender's winner
+    const double s_km = zk >= 0 ? timestamps[zk] : 0;
+    const double s_im = zk >= 0 ? timestamps_[zk] : 0;
+
+    if (zk == k)
+    {
+      if (zi == i)
+      {
+        update = outbids(yk, zk, yi, zi);
+      }
+      else if (zi == k || zi < 0)
+      {
+        update = true;
+      }
+      else
+      {
+        update = timestamps[zi] > timestamps_[zi] || outbids(yk, zk, yi, zi);
+      }
+    }
+    else if (zk == i)
+    {
+      if (zi == k)
+      {
+        reset = true;
+      }
+      else if (zi >= 0 && zi != i)
+      {
+        reset = timestamps[zi] > timestamps_[zi];
+      }
+    }
+    else if (zk >= 0)
+    {
+      // the sender believes a third agent m won the task
+      if (zi == i)
+      {
+        update = s_km > s_im && outbids(yk, zk, yi, zi);
+      }
+      else if (zi == k)
+      {
+        update = s_km > s_im;
+        reset = !update;
+      }
+      else if (zi == zk)
+      {
+        update = s_km > s_im;
+      }
+      else if (zi >= 0)
+      {
+        const double s_kn = timestamps[zi];
+        const double s_in = timestamps_[zi];
+
+        if (s_km > s_im && s_kn > s_in)
+        {
+          update = true;
+        }
+        else if (s_km > s_im && outbids(yk, zk, yi, zi))
+        {
+          update = true;
+        }
+        else if (s_kn > s_in && s_im > s_km)
+        {
+          reset = true;
+        }
+      }
+      else
+      {
+        update = s_km > s_im;
+      }
+    }
+    else
+    {
+      // the sender believes nobody won the task
+      if (zi == k)
+      {
+        update = true;
+      }
+      else if (zi >= 0 && zi != i)
+      {
+        update = timestamps[zi] > timestamps_[zi];
+      }
+    }
+
+    if (update && (zi != zk || yi != yk))
+    {
+      winning_bids_[j] = yk;
+      winners_[j] = zk;
+      changed = true;
+    }
+    else if (reset && zi >= 0)
+    {
+      winning_bids_[j] = 0;
+      winners_[j] = -1;
+      changed = true;
+    }
+  }
+
+  // merge timestamps after resolution, which must use the prior values
+  timestamps_[k] = std::max(timestamps_[k], timestamps[k]);
+
+  for (size_t m = 0; m < agents_.size(); ++m)
+  {
+    if ((int)m != i && (int)m != k)
+    {
+      timestamps_[m] = std::max(timestamps_[m], timestamps[m]);
+    }
+  }
+
+  return changed;
+}
+
+bool
+gams::auctions::AuctionCBBA::release_outbid(void)
+{
+  for (size_t n = 0; n < bundle_tasks_.size(); ++n)
+  {
+    if (winners_[bundle_tasks_[n]] != self_)
+    {
+      // later tasks were scored assuming this task, so they are released
+      for (size_t m = n + 1; m < bundle_tasks_.size(); ++m)
+      {
+        size_t task = bundle_tasks_[m];
+
+        if (winners_[task] == self_)
+        {
+          winning_bids_[task] = 0;
+          winners_[task] = -1;
+        }
+      }
+
+      madara_logger_ptr_log(gams::loggers::global_logger.get(),
+        gams::loggers::LOG_MINOR,
+        "gams::auctions::AuctionCBBA::release_outbid:" \
+        " %s was outbid on %s, releasing %d tasks\n",
+        agent_prefix_.c_str(), bundle_[n].c_str(),
+        (int)(bundle_.size() - n));
+
+      bundle_tasks_.resize(n);
+      bundle_.resize(n);
+
+      return true;
+    }
+  }
+
+  return false;
+}
+
+bool
+gams::auctions::AuctionCBBA::build_bundle(void)
+{
+  bool changed = false;
+
+  while (max_bundle_size_ == 0 || bundle_tasks_.size() < max_bundle_size_)
+  {
+    int best = -1;
+    double best_score = 0;
+
+    for (size_t j = 0; j < tasks_.size(); ++j)
+    {
+      if (std::find(bundle_tasks_.begin(), bundle_tasks_.end(), j) !=
+        bundle_tasks_.end())
+      {
+        continue;
+      }
+
+      double score = get_score(j);
+
+      if (score > 0 &&
+        outbids(score, self_, winning_bids_[j], (int)winners_[j]) &&
+        (best < 0 || score > best_score))
+      {
+        best = (int)j;
+        best_score = score;
+      }
+    }
+
+    if (best < 0)
+    {
+      break;
+    }
+
+    bundle_tasks_.push_back((size_t)best);
+    bundle_.push_back(tasks_[(size_t)best]);
+    winning_bids_[(size_t)best] = best_score;
+    winners_[(size_t)best] = self_;
+    changed = true;
+  }
+
+  return changed;
+}
+
+std::string
+gams::auctions::AuctionCBBA::get_consensus_prefix(
+  const std::string & agent) const
+{
+  std::stringstream buffer;
+  buffer << auction_prefix_;
+  buffer << ".cbba.";
+  buffer << round_;
+  buffer << ".";
+  buffer << agent;
+
+  return buffer.str();
+}
+
+void
+gams::auctions::AuctionCBBA::publish(void)
+{
+  std::string prefix = get_consensus_prefix(agent_prefix_);
+
+  // a new version tells other agents that our information is newer
+  timestamps_[(size_t)self_] += 1;
+
+  knowledge_->set(prefix + ".winning_bids", winning_bids_);
+  knowledge_->set(prefix + ".winners", winners_);
+  knowledge_->set(prefix + ".timestamps", timestamps_);
+
+  published_ = true;
+}
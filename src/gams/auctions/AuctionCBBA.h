@@ -0,0 +1,360 @@
+/**
+* Copyright(c) 2016 Carnegie Mellon University. All Rights Reserved.
+*
+* Redistribution and use in source and binary forms, with or without
+* modification, are permitted provided that the following conditions are met:
+*
+* 1. Redistributions of source code must retain the above copyright notice,
+*    this list of conditions and the following acknowledgments and disclaimers.
+*
+* 2. Redistributions in binary form must reproduce the above copyright notice,
+*    this list of conditions and the following disclaimer in the documentation
+*    and/or other materials provided with the distribution.
+*
+* 3. The names "Carnegie Mellon University," "SEI" and/or "Software
+*    Engineering Institute" shall not be used to endorse or promote products
+*    derived from this software without prior written permission. For written
+*    permission, please contact permission@sei.cmu.edu.
+*
+* 4. Products derived from this software may not be called "SEI" nor may "SEI"
+*    appear in their names without prior written permission of
+*    permission@sei.cmu.edu.
+*
+* 5. Redistributions of any form whatsoever must retain the following
+*    acknowledgment:
+*
+*      This material is based upon work funded and supported by the Department
+*      of Defense under Contract No. FA8721-05-C-0003 with Carnegie Mellon
+*      University for the operation of the Software Engineering Institute, a
+*      federally funded research and development center. Any opinions,
+*      findings and conclusions or recommendations expressed in this material
+*      are those of the author(s) and do not necessarily reflect the views of
+*      the United States Department of Defense.
+*
+*      NO WARRANTY. THIS CARNEGIE MELLON UNIVERSITY AND SOFTWARE ENGINEERING
+*      INSTITUTE MATERIAL IS FURNISHED ON AN "AS-IS" BASIS. CARNEGIE MELLON
+*      UNIVERSITY MAKES NO WARRANTIES OF ANY KIND, EITHER EXPRESSED OR
+*      IMPLIED, AS TO ANY MATTER INCLUDING, BUT NOT LIMITED TO, WARRANTY OF
+*      FITNESS FOR PURPOSE OR MERCHANTABILITY, EXCLUSIVITY, OR RESULTS
+*      OBTAINED FROM USE OF THE MATERIAL. CARNEGIE MELLON UNIVERSITY DOES
+*      NOT MAKE ANY WARRANTY OF ANY KIND WITH RESPECT TO FREEDOM FROM PATENT,
+*      TRADEMARK, OR COPYRIGHT INFRINGEMENT.
+*
+*      This material has been approved for public release and unlimited
+*      distribution.
+**/
+
+/**
+* @file AuctionCBBA.h
+* @author James Edmondson <jedmondson@gmail.com>
+*
+* This file contains the definition of a consensus-based bundle auction
+**/
+
+#ifndef   _GAMS_AUCTIONS_AUCTION_CBBA_H_
+#define   _GAMS_AUCTIONS_AUCTION_CBBA_H_
+
+#include <vector>
+#include <string>
+#include <map>
+#include <functional>
+
+#include "AuctionBase.h"
+#include "AuctionFactory.h"
+
+namespace gams
+{
+  namespace auctions
+  {
+    /**
+    * A multi-item auction that implements the consensus-based bundle
+    * algorithm(CBBA). Each agent greedily builds a bundle of tasks with
+    * its marginal scores, publishes its winning bids, winners and info
+    * timestamps to the knowledge base, and resolves conflicts against
+    * the published state of other group members. A full allocation of
+    * all tasks usually converges in a handful of iterations, and each
+    * agent publishes O(tasks + agents) values per iteration.
+    *
+    * Published state for agent.0 in round 0 of auction.tasks:
+    *   auction.tasks.cbba.0.agent.0.winning_bids: winning bid per task
+    *   auction.tasks.cbba.0.agent.0.winners:      winner slot per task
+    *                                              (-1: none)
+    *   auction.tasks.cbba.0.agent.0.timestamps:   info version per agent
+    *
+    * The state is kept outside of the round prefix(auction.tasks.0) so
+    * that it is not reported as bids by the inherited bid accessors.
+    *
+    * Agent slots are indices into the sorted members of the auction group.
+    **/
+    class GAMS_EXPORT AuctionCBBA : public AuctionBase
+    {
+    public:
+      /// an ordered list of tasks, in the order they were added
+      typedef std::vector<std::string> Bundle;
+
+      /**
+      * A function that returns the marginal score of adding a task to the
+      * end of a bundle. Scores <= 0 indicate the task should not be bid on.
+      **/
+      typedef std::function<double(const std::string & task,
+        const Bundle & bundle)> ScoreFunction;
+
+      /**
+      * Constructor
+      * @param auction_prefix the name of the auction(e.g. auction.tasks)
+      * @param agent_prefix   the name of this bidder(e.g. agent.0)
+      * @param knowledge      the knowledge base to use for syncing
+      **/
+      AuctionCBBA(const std::string & auction_prefix = "",
+        const std::string & agent_prefix = "",
+        madara::knowledge::KnowledgeBase * knowledge = 0);
+
+      /**
+      * Destructor
+      **/
+      virtual ~AuctionCBBA();
+
+      /**
+      * Adds a group of auction participants
+      * @param  group  a group of bidders joining the auction
+      **/
+      virtual void add_group(groups::GroupBase * group);
+
+      /**
+      * Clears the underlying auction participants group
+      **/
+      virtual void clear_group(void);
+
+      /**
+      * Sets the tasks being auctioned. All agents must use the same tasks
+      * in the same order. Resets the allocation.
+      * @param  tasks  the task ids(e.g. region.0, region.1)
+      **/
+      void set_tasks(const std::vector<std::string> & tasks);
+
+      /**
+      * Gets the tasks being auctioned
+      * @return the task ids
+      **/
+      const std::vector<std::string> & get_tasks(void) const;
+
+      /**
+      * Sets a fixed score for a task. Used when no score function is set.
+      * @param  task   the task id
+      * @param  score  the score of the task for this agent
+      **/
+      void set_score(const std::string & task, double score);
+
+      /**
+      * Sets the marginal score function. Scores should not increase as the
+      * bundle grows(diminishing marginal gains) for CBBA to converge.
+      * @param  scorer  the marginal score function
+      **/
+      void set_score_function(const ScoreFunction & scorer);
+
+      /**
+      * Sets the maximum number of tasks this agent may win
+      * @param  max_bundle_size  the maximum bundle size(0 is unlimited)
+      **/
+      void set_max_bundle_size(size_t max_bundle_size);
+
+      /**
+      * Sets how many consecutive unchanged iterations count as converged
+      * @param  iterations  the number of stable iterations(default 2)
+      **/
+      void set_convergence_iterations(int iterations);
+
+      /**
+      * Performs one CBBA iteration: resolves conflicts with the published
+      * state of other agents, rebuilds the bundle, and publishes changes.
+      * @return true if the local allocation changed
+      **/
+      bool iterate(void);
+
+      /**
+      * Checks if the allocation has been stable for the configured number
+      * of consecutive iterations
+      * @return true if the allocation is converged
+      **/
+      bool is_converged(void) const;
+
+      /**
+      * Gets the tasks won by this agent, in the order they were added
+      * @return the bundle of this agent
+      **/
+      const Bundle & get_bundle(void) const;
+
+      /**
+      * Gets the believed winner of a task
+      * @param  task  the task id
+      * @return the agent prefix of the winner or empty string if none
+      **/
+      std::string get_winner(const std::string & task) const;
+
+      /**
+      * Gets the believed winner of every task that has one
+      * @param  assignments  map of task ids to agent prefixes
+      **/
+      void get_assignments(
+        std::map<std::string, std::string> & assignments) const;
+
+      /**
+      * Returns the winner of the first task
+      * @return the agent prefix of the leader of the auction
+      **/
+      virtual std::string get_leader(void);
+
+      /**
+      * Proceeds to the next auction round and resets the allocation
+      **/
+      virtual void advance_round(void);
+
+      /**
+      * Resets the round and the allocation
+      **/
+      virtual void reset_round(void);
+
+    protected:
+
+      /**
+      * Returns the prefix of an agent's published state in this round
+      * @param  agent  the agent prefix(e.g. agent.0)
+      * @return the prefix(e.g. auction.tasks.cbba.0.agent.0)
+      **/
+      std::string get_consensus_prefix(const std::string & agent) const;
+
+      /**
+      * Clears the local allocation and sizes it for the tasks and agents
+      **/
+      void reset_allocation(void);
+
+      /**
+      * Computes the marginal score of a task given the current bundle
+      * @param  task  the task index
+      * @return the marginal score
+      **/
+      double get_score(size_t task) const;
+
+      /**
+      * Checks if a bid beats another, breaking ties by lower agent slot
+      * @param  bid      the challenging bid
+      * @param  winner   the challenger slot
+      * @param  current  the current winning bid
+      * @param  current_winner  the current winner slot(-1 for none)
+      * @return true if the challenger wins
+      **/
+      static bool outbids(double bid, int winner,
+        double current, int current_winner);
+
+      /**
+      * Resolves conflicts against another agent's published state
+      * @param  sender      the slot of the sending agent
+      * @param  bids        the sender's winning bids
+      * @param  winners     the sender's winners
+      * @param  timestamps  the sender's info timestamps
+      * @return true if the local allocation changed
+      **/
+      bool resolve(int sender, const std::vector<double> & bids,
+        const std::vector<madara::knowledge::KnowledgeRecord::Integer> &
+          winners,
+        const std::vector<double> & timestamps);
+
+      /**
+      * Releases bundle tasks that were outbid, along with every task
+      * added after them
+      * @return true if the bundle changed
+      **/
+      bool release_outbid(void);
+
+      /**
+      * Greedily adds tasks to the bundle
+      * @return true if the bundle changed
+      **/
+      bool build_bundle(void);
+
+      /**
+      * Publishes the local allocation to the knowledge base
+      **/
+      void publish(void);
+
+      /// the tasks being auctioned
+      std::vector<std::string> tasks_;
+
+      /// task id to index
+      std::map<std::string, size_t> task_index_;
+
+      /// fixed scores by task id
+      std::map<std::string, double> fixed_scores_;
+
+      /// fixed scores by task index
+      std::vector<double> scores_;
+
+      /// the marginal score function, if set
+      ScoreFunction scorer_;
+
+      /// the sorted agent prefixes of the group
+      std::vector<std::string> agents_;
+
+      /// the slot of this agent in agents_(-1 if not a member)
+      int self_;
+
+      /// winning bid per task(y)
+      std::vector<double> winning_bids_;
+
+      /// winning agent slot per task(z)
+      std::vector<madara::knowledge::KnowledgeRecord::Integer> winners_;
+
+      /// latest info version per agent slot(s)
+      std::vector<double> timestamps_;
+
+      /// the tasks won by this agent, in order added
+      Bundle bundle_;
+
+      /// task indices of bundle_
+      std::vector<size_t> bundle_tasks_;
+
+      /// maximum bundle size(0 is unlimited)
+      size_t max_bundle_size_;
+
+      /// stable iterations needed for convergence
+      int convergence_iterations_;
+
+      /// consecutive iterations without changes
+      int stable_iterations_;
+
+      /// true if the allocation has been published this round
+      bool published_;
+    };
+
+    /**
+    * Factory for creating consensus-based bundle auctions
+    **/
+    class GAMS_EXPORT AuctionCBBAFactory : public AuctionFactory
+    {
+    public:
+
+      /**
+      * Constructor
+      **/
+      AuctionCBBAFactory();
+
+      /**
+      * Destructor
+      **/
+      virtual ~AuctionCBBAFactory();
+
+      /**
+      * Creates a consensus-based bundle auction
+      * @param auction_prefix the name of the auction(e.g. auction.tasks)
+      * @param agent_prefix   the name of this bidder(e.g. agent.0)
+      * @param knowledge      the knowledge base to use for syncing
+      * @return  the new auction
+      **/
+      virtual AuctionBase * create(const std::string & auction_prefix = "",
+        const std::string & agent_prefix = "",
+        madara::knowledge::KnowledgeBase * knowledge = 0);
+    };
+  }
+}
+
+#endif // _GAMS_AUCTIONS_AUCTION_CBBA_H_
@@ -52,6 +52,7 @@
 #include "gams/auctions/AuctionFactoryRepository.h"
 #include "gams/auctions/AuctionMaximumBid.h"
 #include "gams/auctions/AuctionMinimumBid.h"
+#include "gams/auctions/AuctionCBBA.h"
 
 inline void
 gams::auctions::AuctionFactoryRepository::add(AuctionType type,
@@ -126,6 +127,9 @@ inline void
 gams::auctions::AuctionFactoryRepository::init(void)
 {
   // create appropriate default factories
+  factory_map_[AUCTION_MAXIMUM_BID] = new AuctionMaximumBidFactory();
+  factory_map_[AUCTION_MINIMUM_BID] = new AuctionMinimumBidFactory();
+  factory_map_[AUCTION_CBBA] = new AuctionCBBAFactory();
 
   // set the knowledge base for each factory
   for (AuctionFactoryMap::iterator i = factory_map_.begin();
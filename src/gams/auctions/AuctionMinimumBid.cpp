@@ -97,54 +97,20 @@ gams::auctions::AuctionMinimumBid::get_leader(void)
     " getting leader from %s\n", auction_prefix_.c_str());
 
   std::string leader;
+  AuctionBid best;
 
-  if (knowledge_)
+  // a single pass over the indexed bids, with no name parsing or sorting
+  if (get_best_bid(best, true))
   {
-    madara::knowledge::ContextGuard guard(*knowledge_);
-
-    madara::knowledge::VariableReferences bids;
-    knowledge_->get_matches(get_auction_round_prefix(), "", bids);
-
-    double leader_bid = -1;
-
-    if (bids.size() > 0)
-    {
-      leader_bid = knowledge_->get(bids[0]).to_double();
-      leader = bids[0].get_name();
-    }
+    leader = best.bidder;
 
     madara_logger_ptr_log(gams::loggers::global_logger.get(),
       gams::loggers::LOG_MINOR,
       "gams::auctions::AuctionMinimumBid::get_leader:" \
-      " iterating through bids from %s\n",
-      auction_prefix_.c_str());
-
-    for (size_t i = 1; i < bids.size(); ++i)
-    {
-      double current_bid = knowledge_->get(bids[i]).to_double();
-
-      madara_logger_ptr_log(gams::loggers::global_logger.get(),
-        gams::loggers::LOG_DETAILED,
-        "gams::auctions::AuctionMinimumBid::get_leader:" \
-        " %s: bid from %s is %f\n",
-        auction_prefix_.c_str(), bids[i].get_name(), current_bid);
-
-      if (current_bid < leader_bid)
-      {
-        leader_bid = current_bid;
-        leader = bids[i].get_name();
-
-        madara_logger_ptr_log(gams::loggers::global_logger.get(),
-          gams::loggers::LOG_MINOR,
-          "gams::auctions::AuctionMinimumBid::get_leader:" \
-          " %s: %s is new leader of auction\n",
-          auction_prefix_.c_str(), bids[i].get_name());
-      }
-    }
+      " %s: %s is leader of auction with bid %f\n",
+      auction_prefix_.c_str(), leader.c_str(), best.amount.to_double());
   }
 
-  leader = leader.substr(bids_.get_name().size() + 1);
-
   madara_logger_ptr_log(gams::loggers::global_logger.get(),
     gams::loggers::LOG_MAJOR,
     "gams::auctions::AuctionMinimumBid::get_leader:" \
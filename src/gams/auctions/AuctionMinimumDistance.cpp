@@ -45,6 +45,7 @@
 **/
 
 #include <algorithm>
+#include <cmath>
 
 #include "madara/knowledge/containers/Integer.h"
 #include "madara/knowledge/containers/NativeDoubleVector.h"
@@ -52,10 +53,46 @@
 #include "AuctionMinimumDistance.h"
 #include "gams/loggers/GlobalLogger.h"
 #include "gams/variables/Agent.h"
+#include "gams/pose/CartesianFrame.h"
 
 namespace knowledge = madara::knowledge;
 namespace containers = knowledge::containers;
 
+namespace
+{
+  /**
+  * Computes Euclidean distances from contiguous coordinate buffers. The
+  * loop has no branches or calls so that the compiler can vectorize it.
+  **/
+  void cartesian_distances(const double * xs, const double * ys,
+    const double * zs, size_t count,
+    double tx, double ty, double tz, double * distances)
+  {
+    for (size_t i = 0; i < count; ++i)
+    {
+      double dx = xs[i] - tx;
+      double dy = ys[i] - ty;
+      double dz = zs[i] - tz;
+
+      distances[i] = std::sqrt(dx * dx + dy * dy + dz * dz);
+    }
+  }
+
+  /**
+  * Computes distances with a frame type's distance function(e.g., GPS)
+  **/
+  void frame_distances(const gams::pose::ReferenceFrameType * type,
+    const double * xs, const double * ys, const double * zs, size_t count,
+    double tx, double ty, double tz, double * distances)
+  {
+    for (size_t i = 0; i < count; ++i)
+    {
+      distances[i] = type->calc_distance(type, xs[i], ys[i], zs[i],
+        tx, ty, tz);
+    }
+  }
+}
+
 gams::auctions::AuctionMinimumDistanceFactory::AuctionMinimumDistanceFactory()
 {
 }
@@ -84,7 +121,7 @@ gams::auctions::AuctionMinimumDistance::AuctionMinimumDistance(
   madara::knowledge::KnowledgeBase * knowledge,
   platforms::BasePlatform * platform)
   : AuctionBase(auction_prefix, agent_prefix, knowledge),
-    platform_(platform)
+    platform_(platform), members_version_(0)
 {
 }
 
@@ -102,14 +139,11 @@ gams::auctions::AuctionMinimumDistance::get_leader(void)
     " getting leader from %s\n", auction_prefix_.c_str());
 
   std::string leader;
+  AuctionBid best;
 
-  AuctionBids bids;
-  get_bids(bids);
-  sort_ascending(bids);
-
-  if (bids.size() > 0)
+  if (get_best_bid(best))
   {
-    leader = bids[0].bidder;
+    leader = best.bidder;
   }
 
   madara_logger_ptr_log(gams::loggers::global_logger.get(),
@@ -120,6 +154,101 @@ gams::auctions::AuctionMinimumDistance::get_leader(void)
   return leader;
 }
 
+void gams::auctions::AuctionMinimumDistance::resolve_references(void)
+{
+  std::string round_prefix = get_auction_round_prefix();
+
+  if (members_version_ != group_.get_version())
+  {
+    groups::AgentVector added, removed;
+
+    if (group_.get_changes(members_version_, added, removed))
+    {
+      madara_logger_ptr_log(gams::loggers::global_logger.get(),
+        gams::loggers::LOG_MINOR,
+        "gams::auctions::AuctionMinimumDistance::resolve_references:" \
+        " patching references: %d joined, %d left.\n",
+        (int)added.size(), (int)removed.size());
+
+      // bids are keyed by member, so order is free to change
+      for (size_t i = 0; i < removed.size(); ++i)
+      {
+        std::vector<std::string>::iterator found =
+          std::find(members_.begin(), members_.end(), removed[i]);
+
+        if (found != members_.end())
+        {
+          size_t index = (size_t)(found - members_.begin());
+          size_t last = members_.size() - 1;
+
+          members_[index] = members_[last];
+          location_refs_[index] = location_refs_[last];
+          members_.pop_back();
+          location_refs_.pop_back();
+
+          if (bid_refs_.size() > last)
+          {
+            bid_refs_[index] = bid_refs_[last];
+            bid_refs_.pop_back();
+          }
+        }
+      }
+
+      for (size_t i = 0; i < added.size(); ++i)
+      {
+        members_.push_back(added[i]);
+        location_refs_.push_back(knowledge_->get_ref(
+          variables::agent_names().intern_name(added[i]).location));
+
+        if (bid_refs_prefix_ != "")
+        {
+          bid_refs_.push_back(
+            knowledge_->get_ref(bid_refs_prefix_ + "." + added[i]));
+        }
+      }
+    }
+    else
+    {
+      madara_logger_ptr_log(gams::loggers::global_logger.get(),
+        gams::loggers::LOG_MINOR,
+        "gams::auctions::AuctionMinimumDistance::resolve_references:" \
+        " resolving member location references.\n");
+
+      std::vector<variables::AgentId> ids;
+      group_.get_members(members_);
+      group_.get_member_ids(ids);
+
+      location_refs_.resize(members_.size());
+      for (size_t i = 0; i < members_.size(); ++i)
+      {
+        location_refs_[i] = knowledge_->get_ref(
+          variables::agent_names().get(ids[i]).location);
+      }
+
+      // bid references are tied to the member list as well
+      bid_refs_prefix_ = "";
+    }
+
+    xs_.resize(members_.size());
+    ys_.resize(members_.size());
+    zs_.resize(members_.size());
+    distances_.resize(members_.size());
+
+    members_version_ = group_.get_version();
+  }
+
+  if (bid_refs_prefix_ != round_prefix)
+  {
+    bid_refs_.resize(members_.size());
+    for (size_t i = 0; i < members_.size(); ++i)
+    {
+      bid_refs_[i] = knowledge_->get_ref(round_prefix + "." + members_[i]);
+    }
+
+    bid_refs_prefix_ = round_prefix;
+  }
+}
+
 void gams::auctions::AuctionMinimumDistance::calculate_bids(void)
 {
   madara_logger_ptr_log(gams::loggers::global_logger.get(),
@@ -129,31 +258,59 @@ void gams::auctions::AuctionMinimumDistance::calculate_bids(void)
 
   if (knowledge_ && platform_)
   {
-    // initialize the agent list within the group
-    // variables::Agents agents;
-    // variables::init_vars(agents, *knowledge_, group_);
-    std::vector<std::string> agents;
-    group_.get_members(agents);
+    const pose::ReferenceFrame & frame = platform_->get_frame();
+
+    if (!(target_.frame() == frame))
+    {
+      // distances across frames need per-member transforms
+      calculate_bids_by_member();
+      return;
+    }
+
+    knowledge::ContextGuard guard(*knowledge_);
+
+    resolve_references();
+
+    // gather member locations into contiguous buffers
+    for (size_t i = 0; i < location_refs_.size(); ++i)
+    {
+      knowledge::KnowledgeRecord location = knowledge_->get(location_refs_[i]);
 
-    for (size_t i = 0; i < agents.size(); ++i)
+      xs_[i] = location.retrieve_index(0).to_double();
+      ys_[i] = location.retrieve_index(1).to_double();
+      zs_[i] = location.retrieve_index(2).to_double();
+    }
+
+    const pose::ReferenceFrameType * type = frame.type();
+
+    if (type == pose::Cartesian)
+    {
+      cartesian_distances(xs_.data(), ys_.data(), zs_.data(), xs_.size(),
+        target_.x(), target_.y(), target_.z(), distances_.data());
+    }
+    else
     {
-      // import the agents's location into the GAMS Pose system
-      containers::NativeDoubleVector agent_location(
-        agents[i] + ".location", *knowledge_);
-      gams::pose::Position location(platform_->get_frame());
-      location.from_container(agent_location);
+      frame_distances(type, xs_.data(), ys_.data(), zs_.data(), xs_.size(),
+        target_.x(), target_.y(), target_.z(), distances_.data());
+    }
 
-      double distance = location.distance_to(target_);
+    // write all bids under the lock and send them together
+    knowledge::EvalSettings settings;
+    settings.delay_sending_modifieds = true;
 
+    for (size_t i = 0; i < bid_refs_.size(); ++i)
+    {
       madara_logger_ptr_log(gams::loggers::global_logger.get(),
         gams::loggers::LOG_DETAILED,
         "gams::auctions::AuctionMinimumDistance::calculate_bids:" \
         " agent %s distance is %f. Bidding distance.\n",
-        agents[i].c_str(), distance);
+        members_[i].c_str(), distances_[i]);
 
-      // bid for the agent using their distance to the target
-      bids_.set(agents[i], distance);
+      knowledge_->set(bid_refs_[i], distances_[i], settings);
     }
+
+    knowledge_->send_modifieds(
+      "gams::auctions::AuctionMinimumDistance::calculate_bids");
   }
   else
   {
@@ -176,6 +333,45 @@ void gams::auctions::AuctionMinimumDistance::calculate_bids(void)
   }
 }
 
+void
+gams::auctions::AuctionMinimumDistance::calculate_bids_by_member(void)
+{
+  knowledge::ContextGuard guard(*knowledge_);
+
+  // the member list and references follow the group deltas, so only the
+  // frame transform is done per member
+  resolve_references();
+
+  const pose::ReferenceFrame & frame = platform_->get_frame();
+
+  knowledge::EvalSettings settings;
+  settings.delay_sending_modifieds = true;
+
+  for (size_t i = 0; i < location_refs_.size(); ++i)
+  {
+    // import the agents's location into the GAMS Pose system
+    knowledge::KnowledgeRecord record = knowledge_->get(location_refs_[i]);
+    gams::pose::Position location(frame,
+      record.retrieve_index(0).to_double(),
+      record.retrieve_index(1).to_double(),
+      record.retrieve_index(2).to_double());
+
+    distances_[i] = location.distance_to(target_);
+
+    madara_logger_ptr_log(gams::loggers::global_logger.get(),
+      gams::loggers::LOG_DETAILED,
+      "gams::auctions::AuctionMinimumDistance::calculate_bids:" \
+      " agent %s distance is %f. Bidding distance.\n",
+      members_[i].c_str(), distances_[i]);
+
+    // bid for the agent using their distance to the target
+    knowledge_->set(bid_refs_[i], distances_[i], settings);
+  }
+
+  knowledge_->send_modifieds(
+    "gams::auctions::AuctionMinimumDistance::calculate_bids");
+}
+
 void
 gams::auctions::AuctionMinimumDistance::set_target(
   utility::GPSPosition target)
@@ -119,12 +119,65 @@ namespace gams
       void set_platform(platforms::BasePlatform * platform);
 
       /**
-       * Calculate bids using current agent locations
+       * Calculate bids using current agent locations. When the target is
+       * in the platform frame, member locations are gathered into
+       * contiguous buffers through cached references, all distances are
+       * computed in one pass, and bids are written under a single lock
+       * with one send.
        **/
       void calculate_bids(void);
 
     protected:
 
+      /**
+       * Resolves member location and bid references if the group or
+       * auction round has changed since they were last resolved. Group
+       * changes are applied as deltas when the change history allows.
+       **/
+      void resolve_references(void);
+
+      /**
+       * Calculates bids one member at a time, transforming frames as
+       * needed. Used when the target is not in the platform frame. Uses
+       * the same cached member list and references as calculate_bids.
+       **/
+      void calculate_bids_by_member(void);
+
+      /**
+       * Member agent prefixes, in the order of the cached references
+       **/
+      std::vector<std::string> members_;
+
+      /**
+       * Cached references to member locations(e.g. agent.0.location)
+       **/
+      std::vector<madara::knowledge::VariableReference> location_refs_;
+
+      /**
+       * Cached references to member bids in bid_refs_prefix_
+       **/
+      std::vector<madara::knowledge::VariableReference> bid_refs_;
+
+      /**
+       * The auction round prefix that bid_refs_ were resolved for
+       **/
+      std::string bid_refs_prefix_;
+
+      /**
+       * The group_ membership version that members_ reflects
+       **/
+      uint64_t members_version_;
+
+      /**
+       * Member location components, one contiguous buffer per axis
+       **/
+      std::vector<double> xs_, ys_, zs_;
+
+      /**
+       * Distances from members to the target, in member order
+       **/
+      std::vector<double> distances_;
+
       /**
        * The location that distance will be calculated to
        **/
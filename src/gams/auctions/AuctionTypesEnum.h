@@ -74,7 +74,8 @@ namespace gams
       // fixed list is default
       AUCTION_MAXIMUM_BID = 0,
       AUCTION_MINIMUM_BID = 1,
-      NUM_AUCTION_TYPES = 2
+      AUCTION_CBBA = 2,
+      NUM_AUCTION_TYPES = 3
     };
 
     /// convenience typedef for AuctionType
@@ -0,0 +1,124 @@
+/**
+ * Copyright(c) 2017 Carnegie Mellon University. All Rights Reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ * 
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following acknowledgments and disclaimers.
+ * 
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ * 
+ * 3. The names "Carnegie Mellon University," "SEI" and/or "Software
+ *    Engineering Institute" shall not be used to endorse or promote products
+ *    derived from this software without prior written permission. For written
+ *    permission, please contact permission@sei.cmu.edu.
+ * 
+ * 4. Products derived from this software may not be called "SEI" nor may "SEI"
+ *    appear in their names without prior written permission of
+ *    permission@sei.cmu.edu.
+ * 
+ * 5. Redistributions of any form whatsoever must retain the following
+ *    acknowledgment:
+ * 
+ *      This material is based upon work funded and supported by the Department
+ *      of Defense under Contract No. FA8721-05-C-0003 with Carnegie Mellon
+ *      University for the operation of the Software Engineering Institute, a
+ *      federally funded research and development center. Any opinions,
+ *      findings and conclusions or recommendations expressed in this material
+ *      are those of the author(s) and do not necessarily reflect the views of
+ *      the United States Department of Defense.
+ * 
+ *      NO WARRANTY. THIS CARNEGIE MELLON UNIVERSITY AND SOFTWARE ENGINEERING
+ *      INSTITUTE MATERIAL IS FURNISHED ON AN "AS-IS" BASIS. CARNEGIE MELLON
+ *      UNIVERSITY MAKES NO WARRANTIES OF ANY KIND, EITHER EXPRESSED OR
+ *      IMPLIED, AS TO ANY MATTER INCLUDING, BUT NOT LIMITED TO, WARRANTY OF
+ *      FITNESS FOR PURPOSE OR MERCHANTABILITY, EXCLUSIVITY, OR RESULTS
+ *      OBTAINED FROM USE OF THE MATERIAL. CARNEGIE MELLON UNIVERSITY DOES
+ *      NOT MAKE ANY WARRANTY OF ANY KIND WITH RESPECT TO FREEDOM FROM PATENT,
+ *      TRADEMARK, OR COPYRIGHT INFRINGEMENT.
+ * 
+ *      This material has been approved for public release and unlimited
+ *      distribution.
+ **/
+
+/**
+ * @file AdaptiveRate.cpp
+ * @author James Edmondson <jedmondson@gmail.com>
+ *
+ * This file contains a policy for adapting controller loop and send rates
+ * to measured load
+ **/
+
+#include <algorithm>
+
+#include "AdaptiveRate.h"
+
+gams::controllers::AdaptiveRate::AdaptiveRate(
+  const ControllerSettings & settings)
+: settings_(settings),
+  loop_hz_(settings.max_loop_hertz),
+  send_hz_(settings.max_send_hertz)
+{
+}
+
+void
+gams::controllers::AdaptiveRate::update(double execution_time,
+  size_t send_records, bool active)
+{
+  average_execution_ += settings_.adaptive_smoothing *
+    (execution_time - average_execution_);
+
+  if (send_records > 0)
+  {
+    average_records_ += settings_.adaptive_smoothing *
+      ((double)send_records - average_records_);
+  }
+
+  double loop_target = active ?
+    settings_.max_loop_hertz : settings_.min_loop_hertz;
+  double send_target = active ?
+    settings_.max_send_hertz : settings_.min_send_hertz;
+
+  // don't let the MAPE loop take more than its share of each period
+  if (average_execution_ > 0 && settings_.cpu_budget > 0)
+  {
+    loop_target = std::min(loop_target,
+      settings_.cpu_budget / average_execution_);
+  }
+
+  // don't send more records per second than the radio can handle
+  if (average_records_ > 0 && settings_.max_send_records_per_second > 0)
+  {
+    send_target = std::min(send_target,
+      settings_.max_send_records_per_second / average_records_);
+  }
+
+  // speed up immediately for responsiveness, slow down gradually
+  loop_hz_ = loop_target >= loop_hz_ ?
+    loop_target : std::max(loop_target, loop_hz_ * settings_.adaptive_decay);
+  send_hz_ = send_target >= send_hz_ ?
+    send_target : std::max(send_target, send_hz_ * settings_.adaptive_decay);
+
+  loop_hz_ = std::min(std::max(loop_hz_, settings_.min_loop_hertz),
+    settings_.max_loop_hertz);
+  send_hz_ = std::min(std::max(send_hz_, settings_.min_send_hertz),
+    settings_.max_send_hertz);
+
+  // the controller cannot send faster than it loops
+  send_hz_ = std::min(send_hz_, loop_hz_);
+}
+
+double
+gams::controllers::AdaptiveRate::get_loop_hz(void) const
+{
+  return loop_hz_;
+}
+
+double
+gams::controllers::AdaptiveRate::get_send_hz(void) const
+{
+  return send_hz_;
+}
@@ -0,0 +1,120 @@
+/**
+ * Copyright(c) 2017 Carnegie Mellon University. All Rights Reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ * 
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following acknowledgments and disclaimers.
+ * 
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ * 
+ * 3. The names "Carnegie Mellon University," "SEI" and/or "Software
+ *    Engineering Institute" shall not be used to endorse or promote products
+ *    derived from this software without prior written permission. For written
+ *    permission, please contact permission@sei.cmu.edu.
+ * 
+ * 4. Products derived from this software may not be called "SEI" nor may "SEI"
+ *    appear in their names without prior written permission of
+ *    permission@sei.cmu.edu.
+ * 
+ * 5. Redistributions of any form whatsoever must retain the following
+ *    acknowledgment:
+ * 
+ *      This material is based upon work funded and supported by the Department
+ *      of Defense under Contract No. FA8721-05-C-0003 with Carnegie Mellon
+ *      University for the operation of the Software Engineering Institute, a
+ *      federally funded research and development center. Any opinions,
+ *      findings and conclusions or recommendations expressed in this material
+ *      are those of the author(s) and do not necessarily reflect the views of
+ *      the United States Department of Defense.
+ * 
+ *      NO WARRANTY. THIS CARNEGIE MELLON UNIVERSITY AND SOFTWARE ENGINEERING
+ *      INSTITUTE MATERIAL IS FURNISHED ON AN "AS-IS" BASIS. CARNEGIE MELLON
+ *      UNIVERSITY MAKES NO WARRANTIES OF ANY KIND, EITHER EXPRESSED OR
+ *      IMPLIED, AS TO ANY MATTER INCLUDING, BUT NOT LIMITED TO, WARRANTY OF
+ *      FITNESS FOR PURPOSE OR MERCHANTABILITY, EXCLUSIVITY, OR RESULTS
+ *      OBTAINED FROM USE OF THE MATERIAL. CARNEGIE MELLON UNIVERSITY DOES
+ *      NOT MAKE ANY WARRANTY OF ANY KIND WITH RESPECT TO FREEDOM FROM PATENT,
+ *      TRADEMARK, OR COPYRIGHT INFRINGEMENT.
+ * 
+ *      This material has been approved for public release and unlimited
+ *      distribution.
+ **/
+
+/**
+ * @file AdaptiveRate.h
+ * @author James Edmondson <jedmondson@gmail.com>
+ *
+ * This file contains a policy for adapting controller loop and send rates
+ * to measured load
+ **/
+
+#ifndef   _GAMS_CONTROLLERS_ADAPTIVERATE_H_
+#define   _GAMS_CONTROLLERS_ADAPTIVERATE_H_
+
+#include <stddef.h>
+
+#include "gams/GamsExport.h"
+#include "ControllerSettings.h"
+
+namespace gams { namespace controllers {
+
+/**
+ * Chooses loop and send hertz within the bounds of ControllerSettings.
+ * Rates jump to the maximum when the platform is active (moving or
+ * rotating) and decay toward the minimum when it is holding. Loop hertz
+ * is capped so the MAPE loop stays within cpu_budget of each period, and
+ * send hertz is capped by max_send_records_per_second.
+ **/
+class GAMS_EXPORT AdaptiveRate
+{
+public:
+  /**
+   * Constructor
+   * @param  settings  the controller settings containing rate bounds
+   **/
+  AdaptiveRate(const ControllerSettings & settings);
+
+  /**
+   * Updates the policy with measurements from one loop iteration
+   * @param  execution_time  seconds spent executing the loop iteration
+   * @param  send_records    records sent this iteration (0 if no send)
+   * @param  active          true if the platform is moving or rotating
+   **/
+  void update(double execution_time, size_t send_records, bool active);
+
+  /**
+   * Returns the recommended loop hertz
+   * @return the loop hertz
+   **/
+  double get_loop_hz(void) const;
+
+  /**
+   * Returns the recommended send hertz
+   * @return the send hertz
+   **/
+  double get_send_hz(void) const;
+
+private:
+  /// the bounds and budgets
+  ControllerSettings settings_;
+
+  /// moving average of loop execution time in seconds
+  double average_execution_ = 0;
+
+  /// moving average of records per send
+  double average_records_ = 0;
+
+  /// the current loop hertz
+  double loop_hz_;
+
+  /// the current send hertz
+  double send_hz_;
+};
+
+} }
+
+#endif // _GAMS_CONTROLLERS_ADAPTIVERATE_H_
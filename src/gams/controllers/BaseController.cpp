@@ -48,6 +48,7 @@
 
 #include <iostream>
 #include <sstream>
+#include <chrono>
 
 #include "madara/utility/Utility.h"
 #include "gams/algorithms/AlgorithmFactoryRepository.h"
@@ -363,214 +364,229 @@ gams::controllers::BaseController::analyze(void)
       " Platform undefined. Unable to call platform_->analyze()\n");
   }
 
-  if (algorithm_)
+  check_pipeline_();
+
+  return_value |= run_pipeline_(analyze_pipeline_,
+    &algorithms::BaseAlgorithm::analyze, "analyze");
+
+  return return_value;
+}
+
+int
+gams::controllers::BaseController::plan(void)
+{
+  check_pipeline_();
+
+  return run_pipeline_(plan_pipeline_,
+    &algorithms::BaseAlgorithm::plan, "plan");
+}
+
+int
+gams::controllers::BaseController::execute(void)
+{
+  check_pipeline_();
+
+  return run_pipeline_(execute_pipeline_,
+    &algorithms::BaseAlgorithm::execute, "execute");
+}
+
+void
+gams::controllers::BaseController::build_pipeline(void)
+{
+  analyze_pipeline_.clear();
+  plan_pipeline_.clear();
+  execute_pipeline_.clear();
+
+  if (algorithm_ == 0)
   {
     madara_logger_ptr_log(gams::loggers::global_logger.get(),
-      gams::loggers::LOG_MAJOR,
-      "gams::controllers::BaseController::analyze:" \
-      " calling algorithm_->analyze()\n");
-
-    try {
-      return_value |= algorithm_->analyze();
-    } catch(std::exception &e) {
-      madara_logger_ptr_log(gams::loggers::global_logger.get(),
-        gams::loggers::LOG_ERROR,
-        "gams::controllers::BaseController::analyze:" \
-        " exception in algorithm_->analyze(): %s\n", e.what());
-    }
+      gams::loggers::LOG_WARNING,
+      "gams::controllers::BaseController::build_pipeline:" \
+      " Algorithm undefined. Only accents will be called.\n");
   }
-  else
+
+  // the primary algorithm runs before any accents in each phase
+  algorithms::Algorithms stages;
+  stages.reserve(accents_.size() + 1);
+
+  if (algorithm_)
   {
-    madara_logger_ptr_log(gams::loggers::global_logger.get(),
-      gams::loggers::LOG_MAJOR,
-      "gams::controllers::BaseController::analyze:" \
-      " Algorithm undefined. Unable to call algorithm_->analyze()\n");
+    stages.push_back(algorithm_);
   }
 
+  stages.insert(stages.end(), accents_.begin(), accents_.end());
 
-  if (accents_.size() > 0)
+  for (auto algorithm : stages)
   {
-    madara_logger_ptr_log(gams::loggers::global_logger.get(),
-      gams::loggers::LOG_MAJOR,
-      "gams::controllers::BaseController::analyze:" \
-      " calling analyze on accents\n");
-    for (algorithms::Algorithms::iterator i = accents_.begin();
-      i != accents_.end(); ++i)
+    if (algorithm == 0)
+    {
+      continue;
+    }
+
+    PipelineStage stage;
+    stage.algorithm = algorithm;
+    stage.primary = algorithm == algorithm_;
+
+    int phases = algorithm->get_phases();
+
+    if (phases & algorithms::PHASE_ANALYZE)
+    {
+      analyze_pipeline_.push_back(stage);
+    }
+
+    if (phases & algorithms::PHASE_PLAN)
+    {
+      plan_pipeline_.push_back(stage);
+    }
+
+    if (phases & algorithms::PHASE_EXECUTE)
     {
-    (*i)->analyze();
+      execute_pipeline_.push_back(stage);
     }
   }
 
-  return return_value;
+  pipeline_algorithm_ = algorithm_;
+  pipeline_accents_ = accents_.size();
+  pipeline_built_ = true;
+
+  madara_logger_ptr_log(gams::loggers::global_logger.get(),
+    gams::loggers::LOG_MAJOR,
+    "gams::controllers::BaseController::build_pipeline:" \
+    " %zu analyze, %zu plan and %zu execute stages\n",
+    analyze_pipeline_.size(), plan_pipeline_.size(),
+    execute_pipeline_.size());
 }
 
-int
-gams::controllers::BaseController::plan(void)
+const gams::controllers::BaseController::Pipeline &
+gams::controllers::BaseController::get_pipeline(int phase) const
 {
-  int return_value(0);
-
-  if (algorithm_)
+  if (phase == algorithms::PHASE_PLAN)
   {
-    madara_logger_ptr_log(gams::loggers::global_logger.get(),
-      gams::loggers::LOG_MAJOR,
-      "gams::controllers::BaseController::plan:" \
-      " calling algorithm_->plan()\n");
-
-    try {
-      return_value |= algorithm_->plan();
-    } catch(std::exception &e) {
-      madara_logger_ptr_log(gams::loggers::global_logger.get(),
-        gams::loggers::LOG_ERROR,
-        "gams::controllers::BaseController::analyze:" \
-        " exception in algorithm_->plan(): %s\n", e.what());
-    }
+    return plan_pipeline_;
   }
-  else
+  else if (phase == algorithms::PHASE_EXECUTE)
   {
-    madara_logger_ptr_log(gams::loggers::global_logger.get(),
-      gams::loggers::LOG_MAJOR,
-      "gams::controllers::BaseController::plan:" \
-      " Algorithm undefined. Unable to call algorithm_->plan()\n");
+    return execute_pipeline_;
   }
 
-  if (accents_.size() > 0)
-  {
-    madara_logger_ptr_log(gams::loggers::global_logger.get(),
-      gams::loggers::LOG_MAJOR,
-      "gams::controllers::BaseController::plan:" \
-      " calling plan on accents\n");
+  return analyze_pipeline_;
+}
 
-    for (algorithms::Algorithms::iterator i = accents_.begin();
-      i != accents_.end(); ++i)
+void
+gams::controllers::BaseController::log_pipeline_profile(void) const
+{
+  const char * phases[] = { "analyze", "plan", "execute" };
+  const Pipeline * pipelines[] = {
+    &analyze_pipeline_, &plan_pipeline_, &execute_pipeline_ };
+
+  for (size_t i = 0; i < 3; ++i)
+  {
+    for (size_t j = 0; j < pipelines[i]->size(); ++j)
     {
-    (*i)->plan();
+      const PipelineStage & stage = (*pipelines[i])[j];
+
+      madara_logger_ptr_log(gams::loggers::global_logger.get(),
+        gams::loggers::LOG_ALWAYS,
+        "gams::controllers::BaseController::log_pipeline_profile:" \
+        " %s stage %zu (%s): %zu calls, %.6fs total, %.6fs last\n",
+        phases[i], j, stage.primary ? "algorithm" : "accent",
+        stage.calls, stage.total_duration, stage.last_duration);
     }
   }
+}
 
-  return return_value;
+void
+gams::controllers::BaseController::check_pipeline_(void)
+{
+  if (!pipeline_built_ || pipeline_algorithm_ != algorithm_ ||
+      pipeline_accents_ != accents_.size())
+  {
+    build_pipeline();
+  }
 }
 
 int
-gams::controllers::BaseController::execute(void)
+gams::controllers::BaseController::run_pipeline_(Pipeline & pipeline,
+  int (algorithms::BaseAlgorithm::*method)(void), const char * phase)
 {
   int return_value(0);
+  bool profile = settings_.profile_pipeline;
+  madara::utility::TimeValue start;
 
-  if (algorithm_)
+  for (auto & stage : pipeline)
   {
-    madara_logger_ptr_log(gams::loggers::global_logger.get(),
-      gams::loggers::LOG_MAJOR,
-      "gams::controllers::BaseController::execute:" \
-      " calling algorithm_->execute()\n");
+    if (profile)
+    {
+      start = madara::utility::Clock::now();
+    }
 
     try {
-      return_value |= algorithm_->execute();
+      int result = (stage.algorithm->*method)();
+
+      if (stage.primary)
+      {
+        return_value |= result;
+      }
     } catch(std::exception &e) {
       madara_logger_ptr_log(gams::loggers::global_logger.get(),
         gams::loggers::LOG_ERROR,
-        "gams::controllers::BaseController::analyze:" \
-        " exception in algorithm_->execute(): %s\n", e.what());
+        "gams::controllers::BaseController::%s:" \
+        " exception in %s(): %s\n", phase,
+        stage.primary ? "algorithm" : "accent", e.what());
     }
-  }
-  else
-  {
-    madara_logger_ptr_log(gams::loggers::global_logger.get(),
-      gams::loggers::LOG_WARNING,
-      "gams::controllers::BaseController::execute:" \
-      " Algorithm undefined. Unable to call algorithm_->execute()\n");
-  }
 
-  if (accents_.size() > 0)
-  {
-    for (algorithms::Algorithms::iterator i = accents_.begin();
-      i != accents_.end(); ++i)
+    if (profile)
     {
-    (*i)->execute();
+      stage.last_duration = std::chrono::duration<double>(
+        madara::utility::Clock::now() - start).count();
+      stage.total_duration += stage.last_duration;
     }
+
+    ++stage.calls;
   }
 
   return return_value;
 }
 
+void
+gams::controllers::BaseController::log_modifieds_(const char * phase)
+{
+  // check once rather than formatting several messages that are dropped
+  if (gams::loggers::global_logger->get_level() >= gams::loggers::LOG_MAJOR)
+  {
+    madara_logger_ptr_log(gams::loggers::global_logger.get(),
+      gams::loggers::LOG_MAJOR,
+      "gams::controllers::BaseController::run:" \
+      " after %s(), %d modifications to send\n", phase,
+    (int)knowledge_.get_context().get_modifieds().size());
+
+    madara_logger_ptr_log(gams::loggers::global_logger.get(),
+      gams::loggers::LOG_DETAILED,
+      "gams::controllers::BaseController::run: modifieds=%s\n",
+      knowledge_.debug_modifieds().c_str());
+  }
+}
+
 int
 gams::controllers::BaseController::run_once_(void)
 {
   // return value
   int return_value(0);
 
-  madara_logger_ptr_log(gams::loggers::global_logger.get(),
-    gams::loggers::LOG_MAJOR,
-    "gams::controllers::BaseController::run:" \
-    " calling monitor()\n");
-
   // lock the context from any external updates
   madara::knowledge::ContextGuard guard(knowledge_);
 
   return_value |= monitor();
-
-  madara_logger_ptr_log(gams::loggers::global_logger.get(),
-    gams::loggers::LOG_MAJOR,
-    "gams::controllers::BaseController::run:" \
-    " after monitor(), %d modifications to send\n",
-  (int)knowledge_.get_context().get_modifieds().size());
-
-  madara_logger_ptr_log(gams::loggers::global_logger.get(),
-    gams::loggers::LOG_DETAILED,
-    "%s\n",
-    knowledge_.debug_modifieds().c_str());
-
-  madara_logger_ptr_log(gams::loggers::global_logger.get(),
-    gams::loggers::LOG_MAJOR,
-    "gams::controllers::BaseController::run:" \
-    " calling analyze()\n");
+  log_modifieds_("monitor");
 
   return_value |= analyze();
-
-  madara_logger_ptr_log(gams::loggers::global_logger.get(),
-    gams::loggers::LOG_MAJOR,
-    "gams::controllers::BaseController::run:" \
-    " after analyze(), %d modifications to send\n",
-  (int)knowledge_.get_context().get_modifieds().size());
-
-  madara_logger_ptr_log(gams::loggers::global_logger.get(),
-    gams::loggers::LOG_DETAILED,
-    "%s\n",
-    knowledge_.debug_modifieds().c_str());
-
-  madara_logger_ptr_log(gams::loggers::global_logger.get(),
-    gams::loggers::LOG_MAJOR,
-    "gams::controllers::BaseController::run:" \
-    " calling plan()\n");
+  log_modifieds_("analyze");
 
   return_value |= plan();
-
-  madara_logger_ptr_log(gams::loggers::global_logger.get(),
-    gams::loggers::LOG_MAJOR,
-    "gams::controllers::BaseController::run:" \
-    " after plan(), %d modifications to send\n",
-  (int)knowledge_.get_context().get_modifieds().size());
-
-  madara_logger_ptr_log(gams::loggers::global_logger.get(),
-    gams::loggers::LOG_DETAILED,
-    "%s\n",
-    knowledge_.debug_modifieds().c_str());
-
-  madara_logger_ptr_log(gams::loggers::global_logger.get(),
-    gams::loggers::LOG_MAJOR,
-    "gams::controllers::BaseController::run:" \
-    " calling execute()\n");
+  log_modifieds_("plan");
 
   return_value |= execute();
-
-  madara_logger_ptr_log(gams::loggers::global_logger.get(),
-    gams::loggers::LOG_MAJOR,
-    "gams::controllers::BaseController::run:" \
-    " after execute(), %d modifications to send\n",
-  (int)knowledge_.get_context().get_modifieds().size());
-
-  madara_logger_ptr_log(gams::loggers::global_logger.get(),
-    gams::loggers::LOG_DETAILED,
-    "gams::controllers::BaseController::run: modifieds=%s\n",
-    knowledge_.debug_modifieds().c_str());
+  log_modifieds_("execute");
 
   return return_value;
 }
@@ -710,6 +726,16 @@ gams::controllers::BaseController::run(double loop_period,
   int return_value(0);
   bool first_execute(true);
 
+  // optional policy for adapting rates to load
+  AdaptiveRate adaptive(settings_);
+  size_t send_records(0);
+
+  if (settings_.adaptive_rates && loop_period > 0.0)
+  {
+    loop_period = 1.0 / adaptive.get_loop_hz();
+    send_period = 1.0 / adaptive.get_send_hz();
+  }
+
   // for checking for potential user commands
   double loop_hz = 1.0 / loop_period;
   double send_hz = 1.0 / send_period;
@@ -752,6 +778,9 @@ gams::controllers::BaseController::run(double loop_period,
     //unsigned int iterations = 0;
     while(first_execute || max_runtime < 0 || current < end_time)
     {
+      madara::utility::TimeValue loop_start = madara::utility::Clock::now();
+      send_records = 0;
+
       // return value should be last return value of mape loop
       return_value = run_once_();
 
@@ -781,6 +810,11 @@ gams::controllers::BaseController::run(double loop_period,
           save_checkpoint();
         }
 
+        if (settings_.adaptive_rates)
+        {
+          send_records = knowledge_.get_context().get_modifieds().size();
+        }
+
         // send modified values through network
         knowledge_.send_modifieds("BaseController::run",
             settings_.eval_settings);
@@ -797,6 +831,30 @@ gams::controllers::BaseController::run(double loop_period,
 
       current = madara::utility::Clock::now();
 
+      if (settings_.adaptive_rates)
+      {
+        bool active = platform_ &&
+          (*platform_->get_platform_status()->moving ||
+           *platform_->get_platform_status()->rotating);
+
+        adaptive.update(
+          std::chrono::duration<double>(current - loop_start).count(),
+          send_records, active);
+
+        // publish new rates. The checks below apply them to the epochs.
+        if (!madara::utility::approx_equal(
+          adaptive.get_loop_hz(), self_.agent.loop_hz.to_double(), 0.01))
+        {
+          self_.agent.loop_hz = adaptive.get_loop_hz();
+        }
+
+        if (!madara::utility::approx_equal(
+          adaptive.get_send_hz(), self_.agent.send_hz.to_double(), 0.01))
+        {
+          self_.agent.send_hz = adaptive.get_send_hz();
+        }
+      }
+
       // check to see if we need to sleep for next loop epoch
       if (loop_period > 0.0 &&(max_runtime < 0 || current < end_time))
       {
@@ -805,7 +863,13 @@ gams::controllers::BaseController::run(double loop_period,
           "gams::controllers::BaseController::run:" \
           " sleeping until next epoch\n");
 
-        std::this_thread::sleep_until(next_loop);
+        {
+          // sleep until the next epoch unless a platform wakes us early
+          std::unique_lock<std::mutex> guard(wake_lock_);
+          wake_condition_.wait_until(guard, next_loop,
+            [this] { return wake_requested_; });
+          wake_requested_ = false;
+        }
 
         current = madara::utility::Clock::now();
         while(next_loop <= current)
@@ -876,6 +940,11 @@ gams::controllers::BaseController::run(double loop_period,
     }
   }
 
+  if (settings_.profile_pipeline)
+  {
+    log_pipeline_profile();
+  }
+
   return return_value;
 }
 
@@ -917,6 +986,7 @@ const madara::knowledge::KnowledgeMap & args)
     if (new_accent)
     {
       accents_.push_back(new_accent);
+      build_pipeline();
     }
     else
     {
@@ -941,6 +1011,7 @@ void gams::controllers::BaseController::clear_accents(void)
   }
 
   accents_.clear();
+  build_pipeline();
 }
 void
 gams::controllers::BaseController::init_algorithm(
@@ -986,6 +1057,7 @@ gams::controllers::BaseController::init_algorithm(
 
     algorithm_ = algorithms::global_algorithm_factory()->create(
       algorithm, args);
+    build_pipeline();
 
     if (algorithm_ == 0)
     {
@@ -1140,6 +1212,7 @@ void gams::controllers::BaseController::init_algorithm(
 
   delete algorithm_;
   algorithm_ = algorithm;
+  build_pipeline();
 
   if (algorithm_)
   {
@@ -1242,6 +1315,7 @@ void gams::controllers::BaseController::init_algorithm(jobject algorithm)
     " creating new Java algorithm\n");
 
   algorithm_ = new gams::algorithms::JavaAlgorithm(algorithm);
+  build_pipeline();
 
   if (algorithm_)
   {
@@ -1417,6 +1491,7 @@ gams::controllers::BaseController::init_vars(
   platform.knowledge_ = &knowledge_;
   platform.self_ = &self_;
   platform.sensors_ = &sensors_;
+  platform.set_wake_handler([this] { wake(); });
 
   algorithms::global_algorithm_factory()->set_platform(&platform);
 }
@@ -1438,6 +1513,17 @@ gams::controllers::BaseController::init_vars(
   algorithm.sensors_ = &sensors_;
 }
 
+void
+gams::controllers::BaseController::wake(void)
+{
+  {
+    std::lock_guard<std::mutex> guard(wake_lock_);
+    wake_requested_ = true;
+  }
+
+  wake_condition_.notify_one();
+}
+
 gams::algorithms::BaseAlgorithm *
 gams::controllers::BaseController::get_algorithm(void)
 {
@@ -54,7 +54,11 @@
 #ifndef   _GAMS_BASE_CONTROLLER_H_
 #define   _GAMS_BASE_CONTROLLER_H_
 
+#include <mutex>
+#include <condition_variable>
+
 #include "ControllerSettings.h"
+#include "AdaptiveRate.h"
 
 #include "gams/GamsExport.h"
 #include "gams/variables/Agent.h"
@@ -139,6 +143,13 @@ namespace gams
        **/
       int run_once(void);
 
+      /**
+       * Ends the current sleep of run, so the next MAPE loop iteration
+       * starts immediately. Thread-safe. Platforms call this through
+       * BasePlatform::wake_controller when new data arrives.
+       **/
+      void wake(void);
+
       /**
        * Runs iterations of the MAPE loop with specified periods
        * @param  loop_period  time(in seconds) between executions of the loop.
@@ -324,6 +335,51 @@ namespace gams
        **/
       void init_vars(algorithms::BaseAlgorithm & algorithm);
 
+      /**
+       * A stage of the compiled MAPE loop pipeline
+       **/
+      struct PipelineStage
+      {
+        /// the algorithm or accent to call
+        algorithms::BaseAlgorithm * algorithm = 0;
+
+        /// true if this is the primary algorithm, whose status is returned
+        bool primary = false;
+
+        /// seconds taken by the last call (if settings profile_pipeline)
+        double last_duration = 0;
+
+        /// seconds taken by all calls (if settings profile_pipeline)
+        double total_duration = 0;
+
+        /// number of calls
+        size_t calls = 0;
+      };
+
+      /// the stages called during a phase of the MAPE loop
+      typedef std::vector<PipelineStage> Pipeline;
+
+      /**
+       * Rebuilds the per-phase pipelines from the algorithm and accents,
+       * skipping phases that algorithms declare as no-ops. This is done
+       * automatically when the algorithm or accents change.
+       **/
+      void build_pipeline(void);
+
+      /**
+       * Gets the pipeline for a phase, including per-stage timing
+       * @param  phase  the phase. @see algorithms::AlgorithmPhases
+       * @return the stages called during the phase
+       **/
+      const Pipeline & get_pipeline(int phase) const;
+
+      /**
+       * Logs the call count and timing of every pipeline stage. Timing
+       * is only recorded if settings profile_pipeline is true, in which
+       * case run also logs the profile when it finishes.
+       **/
+      void log_pipeline_profile(void) const;
+
       /**
        * Gets the current algorithm
        * @return the algorithm
@@ -384,10 +440,55 @@ namespace gams
 
       /// keeps track of the checkpoints saved in the control loop
       int checkpoint_count_;
+
+      /// guards wake_requested_ between wake and the run loop's sleep
+      std::mutex wake_lock_;
+
+      /// signaled by wake to end the run loop's sleep between iterations
+      std::condition_variable wake_condition_;
+
+      /// true if wake was called since the run loop last slept, so a
+      /// wake that arrives before the sleep starts is not lost
+      bool wake_requested_ = false;
+
     private:
 
       /// Code shared between run and run_once
       int run_once_(void);
+
+      /**
+       * Calls a phase method on every stage of a pipeline
+       * @param  pipeline  the stages to call
+       * @param  method    the phase method to call on each algorithm
+       * @param  phase     the name of the phase for logging
+       * @return the status of the primary algorithm
+       **/
+      int run_pipeline_(Pipeline & pipeline,
+        int (algorithms::BaseAlgorithm::*method)(void), const char * phase);
+
+      /// Rebuilds the pipelines if algorithm_ or accents_ changed
+      void check_pipeline_(void);
+
+      /// Logs modification counts after a phase, if logging is enabled
+      void log_modifieds_(const char * phase);
+
+      /// stages called during analyze
+      Pipeline analyze_pipeline_;
+
+      /// stages called during plan
+      Pipeline plan_pipeline_;
+
+      /// stages called during execute
+      Pipeline execute_pipeline_;
+
+      /// the algorithm the pipelines were built for
+      algorithms::BaseAlgorithm * pipeline_algorithm_ = 0;
+
+      /// the number of accents the pipelines were built for
+      size_t pipeline_accents_ = 0;
+
+      /// true if the pipelines have been built
+      bool pipeline_built_ = false;
     };
   }
 }
@@ -140,6 +140,44 @@ public:
 
   /// include a shared memory transport when managing multiple controllers
   bool shared_memory_transport = true;
+
+  /**
+   * if true, the loop and send hertz are adjusted at runtime according to
+   * measured load and whether the platform is moving. The hertz bounds
+   * below are used instead of loop_hertz and send_hertz. Values written
+   * to agent.X.loop_hz or agent.X.send_hz will be overridden.
+   **/
+  bool adaptive_rates = false;
+
+  /// the slowest loop hertz the adaptive rate policy may choose
+  double min_loop_hertz = 1.0;
+
+  /// the fastest loop hertz the adaptive rate policy may choose
+  double max_loop_hertz = 20.0;
+
+  /// the slowest send hertz the adaptive rate policy may choose
+  double min_send_hertz = 0.5;
+
+  /// the fastest send hertz the adaptive rate policy may choose
+  double max_send_hertz = 10.0;
+
+  /// max fraction of each loop period the MAPE loop may spend executing
+  double cpu_budget = 0.5;
+
+  /// max modified records per second to send (0 means unlimited)
+  double max_send_records_per_second = 0;
+
+  /// fraction of the rate the adaptive policy keeps each loop when slowing
+  double adaptive_decay = 0.9;
+
+  /// weight of the newest load sample in the adaptive policy's averages
+  double adaptive_smoothing = 0.2;
+
+  /**
+   * if true, time each algorithm and accent call in the MAPE pipeline and
+   * log the timing when the controller stops running
+   **/
+  bool profile_pipeline = false;
 };
 
 } }
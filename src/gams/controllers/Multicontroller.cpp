@@ -53,6 +53,7 @@
 #include "gams/algorithms/AlgorithmFactoryRepository.h"
 #include "gams/platforms/PlatformFactoryRepository.h"
 #include "gams/loggers/GlobalLogger.h"
+#include "gams/utility/KeyFeed.h"
 #include "madara/utility/EpochEnforcer.h"
 
 // Java-specific header includes
@@ -147,7 +148,11 @@ gams::controllers::Multicontroller::add_transports (
   // need to update this for unicast host:port splitting
   for (size_t i = 0; i < kbs_.size(); ++i)
   {
-    kbs_[i].attach_transport(kbs_[i].get(".prefix").to_string(), settings);
+    // let elections, auctions and groups index only the changed keys
+    madara::transport::QoSTransportSettings kb_settings (settings);
+    utility::KeyFeed::get(kbs_[i]).attach(kb_settings);
+
+    kbs_[i].attach_transport(kbs_[i].get(".prefix").to_string(), kb_settings);
   }
 }
 
@@ -470,8 +475,12 @@ void gams::controllers::Multicontroller::resize (size_t num_controllers)
         // only add shared memory transport if more than 1 controller
         if (settings_.shared_memory_transport && num_controllers > 1)
         {
+          madara::transport::QoSTransportSettings kb_settings (
+            transport_settings);
+          utility::KeyFeed::get(kbs_[i]).attach(kb_settings);
+
           transports_[i] = new madara::transport::SharedMemoryPush(
-            kbs_[i].get_id(), transport_settings, kbs_[i]);
+            kbs_[i].get_id(), kb_settings, kbs_[i]);
 
           transports_[i]->set(kbs_);
 
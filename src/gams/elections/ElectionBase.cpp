@@ -45,6 +45,7 @@
 **/
 
 #include "ElectionBase.h"
+#include "gams/loggers/GlobalLogger.h"
 #include <sstream>
 
 // create shortcuts
@@ -58,13 +59,20 @@ gams::elections::ElectionBase::ElectionBase(
   : knowledge_(knowledge),
   election_prefix_(election_prefix),
   agent_prefix_(agent_prefix),
-  round_(0)
+  round_(0),
+  ballots_stale_(true),
+  feed_(0),
+  subscription_(0)
 {
   reset_votes_pointer();
 }
 
 gams::elections::ElectionBase::~ElectionBase()
 {
+  if (feed_)
+  {
+    feed_->unsubscribe(subscription_);
+  }
 }
 
 bool
@@ -72,16 +80,12 @@ gams::elections::ElectionBase::has_voted(const std::string & agent_prefix)
 {
   bool result(false);
 
-  if (knowledge_)
+  if (knowledge_ && election_prefix_ != "")
   {
     knowledge::ContextGuard guard(*knowledge_);
 
-    // create a list of votes for quick reference
-    knowledge::VariableReferences votes;
-    knowledge_->get_matches(
-      votes_.get_name() + "." + agent_prefix + "->", "", votes);
-
-    result = votes.size() != 0;
+    refresh_tally();
+    result = tally_.has_voted(agent_prefix);
   }
 
   return result;
@@ -94,25 +98,10 @@ gams::elections::ElectionBase::get_votes(CandidateVotes & results)
 
   if (knowledge_ && election_prefix_ != "")
   {
-    // create a list of votes for quick reference
-    knowledge::VariableReferences votes;
-    knowledge_->get_matches(votes_.get_name(), "", votes);
-
-    // tally the votes
-    for (knowledge::VariableReferences::const_iterator i = votes.begin();
-      i != votes.end(); ++i)
-    {
-      std::string ballot_string = i->get_name();
-      std::string::size_type delimiter_pos = ballot_string.find("->");
-
-      if (delimiter_pos != std::string::npos)
-      {
-        std::string candidate = ballot_string.substr(delimiter_pos + 2);
+    knowledge::ContextGuard guard(*knowledge_);
 
-        // add the votes to the results
-        results[candidate] += knowledge_->get(*i).to_integer();
-      }
-    }
+    refresh_tally();
+    tally_.get_votes(results);
   }
 }
 
@@ -124,29 +113,111 @@ gams::elections::ElectionBase::get_votes(
 
   if (knowledge_ && election_prefix_ != "")
   {
-    // create a list of votes for quick reference
+    knowledge::ContextGuard guard(*knowledge_);
+
+    refresh_tally();
+    tally_.get_votes(group, results);
+  }
+}
+
+void
+gams::elections::ElectionBase::refresh_tally(void)
+{
+  if (!knowledge_ || election_prefix_ == "")
+  {
+    return;
+  }
+
+  knowledge::ContextGuard guard(*knowledge_);
+
+  std::vector<std::string> changed;
+
+  if (!ballots_stale_ && feed_->is_attached() &&
+    feed_->take(subscription_, changed))
+  {
+    // only the ballots that were received or sent since the last query
+    for (std::vector<std::string>::const_iterator i = changed.begin();
+      i != changed.end(); ++i)
+    {
+      apply_ballot(*i, knowledge_->get(*i));
+    }
+  }
+  else
+  {
+    if (ballots_stale_ || !feed_->take(subscription_, changed))
+    {
+      // subscribe before scanning so no ballot falls between the two
+      if (feed_)
+      {
+        feed_->unsubscribe(subscription_);
+      }
+
+      feed_ = &utility::KeyFeed::get(*knowledge_);
+      subscription_ = feed_->subscribe(votes_.get_name() + ".");
+    }
+
+    // without a feed on the transports, a scan is the only way to find
+    // ballots cast by other agents
+    madara_logger_ptr_log(gams::loggers::global_logger.get(),
+      gams::loggers::LOG_DETAILED,
+      "gams::elections::ElectionBase::refresh_tally:" \
+      " indexing ballots in %s\n", votes_.get_name().c_str());
+
+    tally_.clear();
+    ballots_.clear();
+
     knowledge::VariableReferences votes;
-    knowledge_->get_matches(votes_.get_name(), "", votes);
+    knowledge_->get_matches(votes_.get_name() + ".", "", votes);
 
-    // tally the votes
     for (knowledge::VariableReferences::const_iterator i = votes.begin();
       i != votes.end(); ++i)
     {
-      std::string ballot_string = i->get_name();
-      std::string::size_type delimiter_pos = ballot_string.find("->");
+      apply_ballot(i->get_name(), knowledge_->get(*i));
+    }
 
-      if (delimiter_pos != std::string::npos)
-      {
-        std::string candidate = ballot_string.substr(delimiter_pos + 2);
-        std::string voter = ballot_string.substr(
-          votes_.get_name().size() + 1, delimiter_pos);
-
-        if (group->is_member(voter))
-        {
-          // add the votes to the results
-          results[candidate] += knowledge_->get(*i).to_integer();
-        }
-      }
+    ballots_stale_ = false;
+  }
+}
+
+gams::elections::CandidateList
+gams::elections::ElectionBase::get_tallied_leaders(int num_leaders) const
+{
+  return tally_.get_leaders(num_leaders);
+}
+
+void
+gams::elections::ElectionBase::apply_ballot(const std::string & ballot_name,
+  const KnowledgeRecord & record)
+{
+  BallotIndex::iterator found = ballots_.find(ballot_name);
+
+  if (found != ballots_.end())
+  {
+    if (!record.exists())
+    {
+      tally_.remove_ballot(found->second.voter, found->second.candidate);
+      ballots_.erase(found);
+    }
+    else if (record.to_integer() != found->second.votes)
+    {
+      found->second.votes = record.to_integer();
+      tally_.set_ballot(found->second.voter, found->second.candidate,
+        found->second.votes);
+    }
+  }
+  else if (record.exists())
+  {
+    std::string::size_type delimiter_pos = ballot_name.find("->");
+    std::string::size_type voter_pos = votes_.get_name().size() + 1;
+
+    if (delimiter_pos != std::string::npos && delimiter_pos > voter_pos)
+    {
+      BallotReference & ballot = ballots_[ballot_name];
+      ballot.voter = ballot_name.substr(voter_pos, delimiter_pos - voter_pos);
+      ballot.candidate = ballot_name.substr(delimiter_pos + 2);
+      ballot.votes = record.to_integer();
+
+      tally_.set_ballot(ballot.voter, ballot.candidate, ballot.votes);
     }
   }
 }
@@ -171,6 +242,7 @@ void
 gams::elections::ElectionBase::sync(void)
 {
   votes_.sync_keys();
+  ballots_stale_ = true;
 }
 
 void
@@ -182,6 +254,15 @@ const std::string & candidate, int votes)
   buffer << "->";
   buffer << candidate;
   votes_.set(buffer.str(), KnowledgeRecord::Integer(votes));
+
+  // keep the tally current for ballots cast through this election
+  if (knowledge_ && election_prefix_ != "" && !ballots_stale_)
+  {
+    knowledge::ContextGuard guard(*knowledge_);
+
+    apply_ballot(votes_.get_name() + "." + buffer.str(),
+      KnowledgeRecord(KnowledgeRecord::Integer(votes)));
+  }
 }
 
 void gams::elections::ElectionBase::advance_round(void)
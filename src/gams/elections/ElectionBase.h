@@ -62,20 +62,15 @@
 #include "madara/knowledge/containers/Map.h"
 
 #include "ElectionTypesEnum.h"
+#include "VoteTally.h"
 #include "gams/groups/GroupBase.h"
+#include "gams/utility/KeyFeed.h"
 #include "gams/GamsExport.h"
 
 namespace gams
 {
   namespace elections
   {
-    /// list of candidates
-    typedef  std::vector<std::string> CandidateList;
-
-    /// candidate vote tally
-    typedef std::map <std::string,
-      madara::knowledge::KnowledgeRecord::Integer> CandidateVotes;
-
     /**
     * Base class for an election
     **/
@@ -138,7 +133,10 @@ namespace gams
         madara::knowledge::KnowledgeBase * knowledge);
 
       /**
-      * Syncs the election information from the knowledge base
+      * Syncs the election information from the knowledge base and
+      * reindexes all ballots on the next vote query. Needed after ballots
+      * are deleted or written without being sent. Ballots of other
+      * agents are picked up by each query.
       **/
       virtual void sync(void);
 
@@ -197,6 +195,25 @@ namespace gams
       **/
       virtual void reset_round(void);
 
+      /**
+      * Brings the vote tally up to date with the knowledge base. The
+      * ballots are only scanned when the index is stale(first use, sync,
+      * or round/prefix changes). Otherwise, only the ballots that the
+      * knowledge base's KeyFeed reports as received or sent since the
+      * last query are applied. If no KeyFeed is attached to the
+      * transports, every query rescans the ballots.
+      **/
+      void refresh_tally(void);
+
+      /**
+      * Returns the leaders from the tally as of the last refresh_tally
+      * call. Does not access the knowledge base, so elections can be
+      * evaluated concurrently once their tallies are refreshed.
+      * @param  num_leaders maximum leaders to return
+      * @return the leaders of the election up to num_leaders
+      **/
+      virtual CandidateList get_tallied_leaders(int num_leaders = 1) const;
+
     protected:
 
       /**
@@ -205,6 +222,32 @@ namespace gams
       **/
       void reset_votes_pointer(void);
 
+      /**
+      * A ballot in the knowledge base that has been indexed into the tally
+      **/
+      struct BallotReference
+      {
+        /// the voter prefix(e.g. agent.0)
+        std::string voter;
+
+        /// the candidate the ballot was cast for
+        std::string candidate;
+
+        /// the last value applied to the tally
+        VoteTally::Integer votes;
+      };
+
+      /// indexed ballots by ballot variable name
+      typedef std::map<std::string, BallotReference> BallotIndex;
+
+      /**
+      * Adds, changes or removes a ballot in the index and tally
+      * @param  ballot_name  the full ballot variable name
+      * @param  record       the ballot value(removed if it does not exist)
+      **/
+      void apply_ballot(const std::string & ballot_name,
+        const madara::knowledge::KnowledgeRecord & record);
+
       /**
       * The knowledge base to use as a data plane
       **/
@@ -229,6 +272,31 @@ namespace gams
       * convenience class for bids
       **/
       madara::knowledge::containers::Map votes_;
+
+      /**
+      * live tally of the indexed ballots
+      **/
+      VoteTally tally_;
+
+      /**
+      * ballots that have been indexed into the tally
+      **/
+      BallotIndex ballots_;
+
+      /**
+      * if true, ballot names must be rescanned from the knowledge base
+      **/
+      bool ballots_stale_;
+
+      /**
+      * reports the ballots that changed since the last query
+      **/
+      utility::KeyFeed * feed_;
+
+      /**
+      * the subscription to the ballot prefix in feed_
+      **/
+      utility::KeyFeed::Subscription subscription_;
     };
   }
 }
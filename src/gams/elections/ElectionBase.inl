@@ -77,6 +77,8 @@ gams::elections::ElectionBase::get_election_prefix(void) const
 inline void
 gams::elections::ElectionBase::reset_votes_pointer(void)
 {
+  ballots_stale_ = true;
+
   if (knowledge_ && election_prefix_ != "")
   {
     std::stringstream buffer;
@@ -107,27 +107,8 @@ gams::elections::ElectionCumulative::get_leaders(int num_leaders)
   {
     knowledge::ContextGuard guard(*knowledge_);
 
-    typedef std::map <KnowledgeRecord::Integer, CandidateList> Leaderboard;
-
-    CandidateVotes candidates;
-    Leaderboard leaderboard;
-
-    get_votes(candidates);
-
-    // construct the leaderboard
-    for (CandidateVotes::iterator i = candidates.begin();
-      i != candidates.end(); ++i)
-    {
-      leaderboard[i->second].push_back(i->first);
-    }
-
-    // leaderboard is in ascending order, so grab from the back
-    for (Leaderboard::reverse_iterator i = leaderboard.rbegin();
-      i != leaderboard.rend() &&(int) leaders.size() < num_leaders; ++i)
-    {
-      // if it is a tie, we could provide more than num_leaders
-      leaders.insert(leaders.end(), i->second.begin(), i->second.end());
-    }
+    refresh_tally();
+    leaders = get_tallied_leaders(num_leaders);
   }
 
   return leaders;
@@ -142,11 +123,13 @@ gams::elections::ElectionCumulative::get_leader(void)
     " getting leader from %s\n", election_prefix_.c_str());
 
   std::string leader;
-  CandidateList leaders = get_leaders();
 
-  if (leaders.size() > 0)
+  if (knowledge_)
   {
-    leader = leaders[0];
+    knowledge::ContextGuard guard(*knowledge_);
+
+    refresh_tally();
+    leader = tally_.get_leader();
   }
 
   return leader;
@@ -83,6 +83,8 @@ gams::elections::ElectionPlurality::ElectionPlurality(
   madara::knowledge::KnowledgeBase * knowledge)
   : ElectionBase(election_prefix, agent_prefix, knowledge)
 {
+  // plurality votes only allow one vote per voter
+  tally_.set_one_vote_per_voter(true);
 }
 
 /**
@@ -107,52 +109,8 @@ gams::elections::ElectionPlurality::get_leaders(int num_leaders)
   {
     knowledge::ContextGuard guard(*knowledge_);
 
-    // create a list of votes for quick reference
-    knowledge::VariableReferences votes;
-    knowledge_->get_matches(votes_.get_name(), "", votes);
-
-    typedef std::map <KnowledgeRecord::Integer, CandidateList> Leaderboard;
-
-    CandidateVotes candidates;
-    Leaderboard leaderboard;
-    std::string last_voter;
-
-    // tally the votes
-    for (knowledge::VariableReferences::const_iterator i = votes.begin();
-      i != votes.end(); ++i)
-    {
-      std::string ballot_string = i->get_name();
-      std::string::size_type delimiter_pos = ballot_string.find("->");
-
-      if (delimiter_pos != std::string::npos)
-      {
-        std::string candidate = ballot_string.substr(delimiter_pos + 2);
-        std::string voter = ballot_string.substr(
-          votes_.get_name().size() + 1, delimiter_pos);
-
-        // plurality votes only allow one vote per voter
-        if (voter != last_voter)
-        {
-          candidates[candidate] += 1;
-          last_voter = voter;
-        }
-      }
-    }
-
-    // construct the leaderboard
-    for (CandidateVotes::iterator i = candidates.begin();
-      i != candidates.end(); ++i)
-    {
-      leaderboard[i->second].push_back(i->first);
-    }
-
-    // leaderboard is in ascending order, so grab from the back
-    for (Leaderboard::reverse_iterator i = leaderboard.rbegin();
-      i != leaderboard.rend() &&(int) leaders.size() < num_leaders; ++i)
-    {
-      // if it is a tie, we could provide more than num_leaders
-      leaders.insert(leaders.end(), i->second.begin(), i->second.end());
-    }
+    refresh_tally();
+    leaders = get_tallied_leaders(num_leaders);
   }
 
   return leaders;
@@ -167,11 +125,13 @@ gams::elections::ElectionPlurality::get_leader(void)
     " getting leader from %s\n", election_prefix_.c_str());
 
   std::string leader;
-  CandidateList leaders = get_leaders();
 
-  if (leaders.size() > 0)
+  if (knowledge_)
   {
-    leader = leaders[0];
+    knowledge::ContextGuard guard(*knowledge_);
+
+    refresh_tally();
+    leader = tally_.get_leader();
   }
 
   return leader;
@@ -0,0 +1,228 @@
+/**
+* Copyright(c) 2016 Carnegie Mellon University. All Rights Reserved.
+*
+* Redistribution and use in source and binary forms, with or without
+* modification, are permitted provided that the following conditions are met:
+*
+* 1. Redistributions of source code must retain the above copyright notice,
+*    this list of conditions and the following acknowledgments and disclaimers.
+*
+* 2. Redistributions in binary form must reproduce the above copyright notice,
+*    this list of conditions and the following disclaimer in the documentation
+*    and/or other materials provided with the distribution.
+*
+* 3. The names "Carnegie Mellon University," "SEI" and/or "Software
+*    Engineering Institute" shall not be used to endorse or promote products
+*    derived from this software without prior written permission. For written
+*    permission, please contact permission@sei.cmu.edu.
+*
+* 4. Products derived from this software may not be called "SEI" nor may "SEI"
+*    appear in their names without prior written permission of
+*    permission@sei.cmu.edu.
+*
+* 5. Redistributions of any form whatsoever must retain the following
+*    acknowledgment:
+*
+*      This material is based upon work funded and supported by the Department
+*      of Defense under Contract No. FA8721-05-C-0003 with Carnegie Mellon
+*      University for the operation of the Software Engineering Institute, a
+*      federally funded research and development center. Any opinions,
+*      findings and conclusions or recommendations expressed in this material
+*      are those of the author(s) and do not necessarily reflect the views of
+*      the United States Department of Defense.
+*
+*      NO WARRANTY. THIS CARNEGIE MELLON UNIVERSITY AND SOFTWARE ENGINEERING
+*      INSTITUTE MATERIAL IS FURNISHED ON AN "AS-IS" BASIS. CARNEGIE MELLON
+*      UNIVERSITY MAKES NO WARRANTIES OF ANY KIND, EITHER EXPRESSED OR
+*      IMPLIED, AS TO ANY MATTER INCLUDING, BUT NOT LIMITED TO, WARRANTY OF
+*      FITNESS FOR PURPOSE OR MERCHANTABILITY, EXCLUSIVITY, OR RESULTS
+*      OBTAINED FROM USE OF THE MATERIAL. CARNEGIE MELLON UNIVERSITY DOES
+*      NOT MAKE ANY WARRANTY OF ANY KIND WITH RESPECT TO FREEDOM FROM PATENT,
+*      TRADEMARK, OR COPYRIGHT INFRINGEMENT.
+*
+*      This material has been approved for public release and unlimited
+*      distribution.
+**/
+
+/**
+* @file ElectionService.cpp
+* @author James Edmondson <jedmondson@gmail.com>
+*
+* This file contains the implementation of the election service
+**/
+
+#include "ElectionService.h"
+#include "gams/loggers/GlobalLogger.h"
+
+namespace knowledge = madara::knowledge;
+
+gams::elections::ElectionService::ElectionService(
+  knowledge::KnowledgeBase * knowledge)
+  : knowledge_(knowledge),
+  leaderboard_(std::make_shared <const Leaderboard>()), evaluations_(0)
+{
+}
+
+gams::elections::ElectionService::~ElectionService()
+{
+}
+
+void
+gams::elections::ElectionService::add(ElectionBase * election,
+  int num_leaders)
+{
+  if (election)
+  {
+    Entry entry;
+    entry.election = election;
+    entry.num_leaders = num_leaders;
+
+    std::lock_guard <std::mutex> guard(mutex_);
+
+    const std::string & prefix = election->get_election_prefix();
+    std::map <std::string, size_t>::iterator found =
+      entry_index_.find(prefix);
+
+    if (found != entry_index_.end())
+    {
+      entries_[found->second] = entry;
+    }
+    else
+    {
+      entry_index_[prefix] = entries_.size();
+      entries_.push_back(entry);
+    }
+
+    madara_logger_ptr_log(gams::loggers::global_logger.get(),
+      gams::loggers::LOG_MINOR,
+      "gams::elections::ElectionService::add:" \
+      " registered %s for %d leaders (%d elections)\n",
+      prefix.c_str(), num_leaders, (int)entries_.size());
+  }
+}
+
+void
+gams::elections::ElectionService::remove(const std::string & election_prefix)
+{
+  std::lock_guard <std::mutex> guard(mutex_);
+
+  std::map <std::string, size_t>::iterator found =
+    entry_index_.find(election_prefix);
+
+  if (found != entry_index_.end())
+  {
+    // move the last entry into the hole to keep entries_ dense
+    size_t position = found->second;
+    entry_index_.erase(found);
+
+    if (position != entries_.size() - 1)
+    {
+      entries_[position] = entries_.back();
+      entry_index_[entries_[position].election->get_election_prefix()] =
+        position;
+    }
+
+    entries_.pop_back();
+  }
+}
+
+void
+gams::elections::ElectionService::clear(void)
+{
+  std::lock_guard <std::mutex> guard(mutex_);
+
+  entries_.clear();
+  entry_index_.clear();
+}
+
+size_t
+gams::elections::ElectionService::size(void) const
+{
+  std::lock_guard <std::mutex> guard(mutex_);
+
+  return entries_.size();
+}
+
+void
+gams::elections::ElectionService::set_knowledge_base(
+  knowledge::KnowledgeBase * knowledge)
+{
+  std::lock_guard <std::mutex> guard(mutex_);
+
+  knowledge_ = knowledge;
+}
+
+void
+gams::elections::ElectionService::evaluate(void)
+{
+  std::lock_guard <std::mutex> guard(mutex_);
+
+  if (!knowledge_)
+  {
+    return;
+  }
+
+  madara_logger_ptr_log(gams::loggers::global_logger.get(),
+    gams::loggers::LOG_MAJOR,
+    "gams::elections::ElectionService::evaluate:" \
+    " evaluating %d elections\n", (int)entries_.size());
+
+  {
+    // every tally is refreshed under one lock rather than one per query.
+    // Each refresh only applies the ballots its feed subscription
+    // received since the last evaluation.
+    knowledge::ContextGuard context_guard(*knowledge_);
+
+    for (size_t i = 0; i < entries_.size(); ++i)
+    {
+      entries_[i].election->refresh_tally();
+    }
+  }
+
+  // tallies keep their rankings current, so ranking is O(leaders)
+  std::shared_ptr <Leaderboard> leaderboard =
+    std::make_shared <Leaderboard>();
+
+  for (size_t i = 0; i < entries_.size(); ++i)
+  {
+    (*leaderboard)[entries_[i].election->get_election_prefix()] =
+      entries_[i].election->get_tallied_leaders(entries_[i].num_leaders);
+  }
+
+  std::atomic_store(&leaderboard_,
+    std::shared_ptr <const Leaderboard>(leaderboard));
+  ++evaluations_;
+}
+
+std::shared_ptr <const gams::elections::Leaderboard>
+gams::elections::ElectionService::get_leaderboard(void) const
+{
+  return std::atomic_load(&leaderboard_);
+}
+
+gams::elections::CandidateList
+gams::elections::ElectionService::get_leaders(
+  const std::string & election_prefix) const
+{
+  std::shared_ptr <const Leaderboard> leaderboard = get_leaderboard();
+  Leaderboard::const_iterator found = leaderboard->find(election_prefix);
+
+  return found != leaderboard->end() ? found->second : CandidateList();
+}
+
+std::string
+gams::elections::ElectionService::get_leader(
+  const std::string & election_prefix) const
+{
+  std::shared_ptr <const Leaderboard> leaderboard = get_leaderboard();
+  Leaderboard::const_iterator found = leaderboard->find(election_prefix);
+
+  return found != leaderboard->end() && found->second.size() > 0 ?
+    found->second[0] : std::string();
+}
+
+uint64_t
+gams::elections::ElectionService::get_evaluations(void) const
+{
+  return evaluations_;
+}
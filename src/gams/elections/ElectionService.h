@@ -0,0 +1,201 @@
+/**
+* Copyright(c) 2016 Carnegie Mellon University. All Rights Reserved.
+*
+* Redistribution and use in source and binary forms, with or without
+* modification, are permitted provided that the following conditions are met:
+*
+* 1. Redistributions of source code must retain the above copyright notice,
+*    this list of conditions and the following acknowledgments and disclaimers.
+*
+* 2. Redistributions in binary form must reproduce the above copyright notice,
+*    this list of conditions and the following disclaimer in the documentation
+*    and/or other materials provided with the distribution.
+*
+* 3. The names "Carnegie Mellon University," "SEI" and/or "Software
+*    Engineering Institute" shall not be used to endorse or promote products
+*    derived from this software without prior written permission. For written
+*    permission, please contact permission@sei.cmu.edu.
+*
+* 4. Products derived from this software may not be called "SEI" nor may "SEI"
+*    appear in their names without prior written permission of
+*    permission@sei.cmu.edu.
+*
+* 5. Redistributions of any form whatsoever must retain the following
+*    acknowledgment:
+*
+*      This material is based upon work funded and supported by the Department
+*      of Defense under Contract No. FA8721-05-C-0003 with Carnegie Mellon
+*      University for the operation of the Software Engineering Institute, a
+*      federally funded research and development center. Any opinions,
+*      findings and conclusions or recommendations expressed in this material
+*      are those of the author(s) and do not necessarily reflect the views of
+*      the United States Department of Defense.
+*
+*      NO WARRANTY. THIS CARNEGIE MELLON UNIVERSITY AND SOFTWARE ENGINEERING
+*      INSTITUTE MATERIAL IS FURNISHED ON AN "AS-IS" BASIS. CARNEGIE MELLON
+*      UNIVERSITY MAKES NO WARRANTIES OF ANY KIND, EITHER EXPRESSED OR
+*      IMPLIED, AS TO ANY MATTER INCLUDING, BUT NOT LIMITED TO, WARRANTY OF
+*      FITNESS FOR PURPOSE OR MERCHANTABILITY, EXCLUSIVITY, OR RESULTS
+*      OBTAINED FROM USE OF THE MATERIAL. CARNEGIE MELLON UNIVERSITY DOES
+*      NOT MAKE ANY WARRANTY OF ANY KIND WITH RESPECT TO FREEDOM FROM PATENT,
+*      TRADEMARK, OR COPYRIGHT INFRINGEMENT.
+*
+*      This material has been approved for public release and unlimited
+*      distribution.
+**/
+
+/**
+* @file ElectionService.h
+* @author James Edmondson <jedmondson@gmail.com>
+*
+* This file contains the definition of a service that evaluates many
+* elections per tick and caches their leaders
+**/
+
+#ifndef   _GAMS_ELECTIONS_ELECTION_SERVICE_H_
+#define   _GAMS_ELECTIONS_ELECTION_SERVICE_H_
+
+#include <vector>
+#include <string>
+#include <map>
+#include <memory>
+#include <cstdint>
+#include <atomic>
+#include <mutex>
+
+#include "madara/knowledge/KnowledgeBase.h"
+
+#include "ElectionBase.h"
+#include "gams/GamsExport.h"
+
+namespace gams
+{
+  namespace elections
+  {
+    /// election prefix to the leaders of that election
+    typedef std::map <std::string, CandidateList> Leaderboard;
+
+    /**
+    * Evaluates registered elections together. Each evaluate call refreshes
+    * every tally under a single knowledge base lock. Ballots are indexed
+    * as they arrive: the knowledge base's KeyFeed routes each received
+    * ballot key once to the election whose prefix it falls under, so a
+    * refresh only applies the ballots that changed since the last call.
+    * The elections are then ranked and a new leaderboard is published.
+    * The leaderboard can be read from any thread without taking the
+    * knowledge base lock.
+    *
+    * Registration and evaluation may happen on different threads.
+    * Elections are not owned by the service.
+    **/
+    class GAMS_EXPORT ElectionService
+    {
+    public:
+      /**
+      * Constructor
+      * @param  knowledge   the knowledge base the elections use
+      **/
+      ElectionService(madara::knowledge::KnowledgeBase * knowledge = 0);
+
+      /**
+      * Destructor
+      **/
+      ~ElectionService();
+
+      /**
+      * Registers an election, replacing any with the same prefix
+      * @param  election     the election to evaluate
+      * @param  num_leaders  the number of leaders to keep
+      **/
+      void add(ElectionBase * election, int num_leaders = 1);
+
+      /**
+      * Unregisters an election
+      * @param  election_prefix  the prefix of the election to remove
+      **/
+      void remove(const std::string & election_prefix);
+
+      /**
+      * Unregisters all elections
+      **/
+      void clear(void);
+
+      /**
+      * Gets the number of registered elections
+      * @return  the number of elections
+      **/
+      size_t size(void) const;
+
+      /**
+      * Sets the knowledge base to lock during evaluation
+      * @param  knowledge   the knowledge base the elections use
+      **/
+      void set_knowledge_base(madara::knowledge::KnowledgeBase * knowledge);
+
+      /**
+      * Refreshes all tallies, ranks all elections and publishes the
+      * leaderboard
+      **/
+      void evaluate(void);
+
+      /**
+      * Gets the last published leaderboard. Safe to call from any thread.
+      * @return  the leaderboard, never null
+      **/
+      std::shared_ptr <const Leaderboard> get_leaderboard(void) const;
+
+      /**
+      * Gets the leaders of an election from the last leaderboard
+      * @param  election_prefix  the prefix of the election
+      * @return  the leaders, or an empty list if not evaluated
+      **/
+      CandidateList get_leaders(const std::string & election_prefix) const;
+
+      /**
+      * Gets the leader of an election from the last leaderboard
+      * @param  election_prefix  the prefix of the election
+      * @return  the leader, or an empty string if there is none
+      **/
+      std::string get_leader(const std::string & election_prefix) const;
+
+      /**
+      * Gets the number of completed evaluations
+      * @return  the number of evaluate calls that published a leaderboard
+      **/
+      uint64_t get_evaluations(void) const;
+
+    protected:
+      /**
+      * A registered election
+      **/
+      struct Entry
+      {
+        /// the election to evaluate
+        ElectionBase * election;
+
+        /// the number of leaders to keep
+        int num_leaders;
+      };
+
+      /// guards entries_ and entry_index_
+      mutable std::mutex mutex_;
+
+      /// the knowledge base to lock during evaluation
+      madara::knowledge::KnowledgeBase * knowledge_;
+
+      /// registered elections
+      std::vector <Entry> entries_;
+
+      /// election prefix to position in entries_
+      std::map <std::string, size_t> entry_index_;
+
+      /// the last published leaderboard, swapped atomically
+      std::shared_ptr <const Leaderboard> leaderboard_;
+
+      /// the number of published leaderboards
+      std::atomic <uint64_t> evaluations_;
+    };
+  }
+}
+
+#endif // _GAMS_ELECTIONS_ELECTION_SERVICE_H_
@@ -0,0 +1,273 @@
+/**
+* Copyright(c) 2016 Carnegie Mellon University. All Rights Reserved.
+*
+* Redistribution and use in source and binary forms, with or without
+* modification, are permitted provided that the following conditions are met:
+*
+* 1. Redistributions of source code must retain the above copyright notice,
+*    this list of conditions and the following acknowledgments and disclaimers.
+*
+* 2. Redistributions in binary form must reproduce the above copyright notice,
+*    this list of conditions and the following disclaimer in the documentation
+*    and/or other materials provided with the distribution.
+*
+* 3. The names "Carnegie Mellon University," "SEI" and/or "Software
+*    Engineering Institute" shall not be used to endorse or promote products
+*    derived from this software without prior written permission. For written
+*    permission, please contact permission@sei.cmu.edu.
+*
+* 4. Products derived from this software may not be called "SEI" nor may "SEI"
+*    appear in their names without prior written permission of
+*    permission@sei.cmu.edu.
+*
+* 5. Redistributions of any form whatsoever must retain the following
+*    acknowledgment:
+*
+*      This material is based upon work funded and supported by the Department
+*      of Defense under Contract No. FA8721-05-C-0003 with Carnegie Mellon
+*      University for the operation of the Software Engineering Institute, a
+*      federally funded research and development center. Any opinions,
+*      findings and conclusions or recommendations expressed in this material
+*      are those of the author(s) and do not necessarily reflect the views of
+*      the United States Department of Defense.
+*
+*      NO WARRANTY. THIS CARNEGIE MELLON UNIVERSITY AND SOFTWARE ENGINEERING
+*      INSTITUTE MATERIAL IS FURNISHED ON AN "AS-IS" BASIS. CARNEGIE MELLON
+*      UNIVERSITY MAKES NO WARRANTIES OF ANY KIND, EITHER EXPRESSED OR
+*      IMPLIED, AS TO ANY MATTER INCLUDING, BUT NOT LIMITED TO, WARRANTY OF
+*      FITNESS FOR PURPOSE OR MERCHANTABILITY, EXCLUSIVITY, OR RESULTS
+*      OBTAINED FROM USE OF THE MATERIAL. CARNEGIE MELLON UNIVERSITY DOES
+*      NOT MAKE ANY WARRANTY OF ANY KIND WITH RESPECT TO FREEDOM FROM PATENT,
+*      TRADEMARK, OR COPYRIGHT INFRINGEMENT.
+*
+*      This material has been approved for public release and unlimited
+*      distribution.
+**/
+
+#include "VoteTally.h"
+
+gams::elections::VoteTally::VoteTally(bool one_vote_per_voter)
+  : one_vote_per_voter_(one_vote_per_voter)
+{
+}
+
+void
+gams::elections::VoteTally::set_one_vote_per_voter(bool one_vote_per_voter)
+{
+  if (one_vote_per_voter != one_vote_per_voter_)
+  {
+    for (VoterBallots::const_iterator i = voters_.begin();
+      i != voters_.end(); ++i)
+    {
+      apply_ballots_(i->second, -1);
+    }
+
+    one_vote_per_voter_ = one_vote_per_voter;
+
+    for (VoterBallots::const_iterator i = voters_.begin();
+      i != voters_.end(); ++i)
+    {
+      apply_ballots_(i->second, 1);
+    }
+  }
+}
+
+void
+gams::elections::VoteTally::clear(void)
+{
+  voters_.clear();
+  candidates_.clear();
+  ranking_.clear();
+}
+
+void
+gams::elections::VoteTally::set_ballot(const std::string & voter,
+  const std::string & candidate, Integer votes)
+{
+  Ballots & ballots = voters_[voter];
+
+  if (!one_vote_per_voter_)
+  {
+    // cumulative ballots are independent, so only apply the difference
+    Ballots::iterator found = ballots.find(candidate);
+
+    if (found == ballots.end())
+    {
+      ballots[candidate] = votes;
+      update_candidate_(candidate, votes, 1);
+    }
+    else if (found->second != votes)
+    {
+      update_candidate_(candidate, votes - found->second, 0);
+      found->second = votes;
+    }
+  }
+  else
+  {
+    // a new ballot may change which candidate receives the voter's vote
+    apply_ballots_(ballots, -1);
+    ballots[candidate] = votes;
+    apply_ballots_(ballots, 1);
+  }
+}
+
+void
+gams::elections::VoteTally::remove_ballot(const std::string & voter,
+  const std::string & candidate)
+{
+  VoterBallots::iterator voter_found = voters_.find(voter);
+
+  if (voter_found != voters_.end() &&
+    voter_found->second.find(candidate) != voter_found->second.end())
+  {
+    apply_ballots_(voter_found->second, -1);
+    voter_found->second.erase(candidate);
+    apply_ballots_(voter_found->second, 1);
+
+    if (voter_found->second.size() == 0)
+    {
+      voters_.erase(voter_found);
+    }
+  }
+}
+
+bool
+gams::elections::VoteTally::has_voted(const std::string & voter) const
+{
+  return voters_.find(voter) != voters_.end();
+}
+
+gams::elections::VoteTally::Integer
+gams::elections::VoteTally::get_votes(const std::string & candidate) const
+{
+  std::map <std::string, CandidateRecord>::const_iterator found =
+    candidates_.find(candidate);
+
+  return found != candidates_.end() ? found->second.votes : 0;
+}
+
+void
+gams::elections::VoteTally::get_votes(CandidateVotes & results) const
+{
+  results.clear();
+
+  for (std::map <std::string, CandidateRecord>::const_iterator i =
+    candidates_.begin(); i != candidates_.end(); ++i)
+  {
+    results[i->first] = i->second.votes;
+  }
+}
+
+void
+gams::elections::VoteTally::get_votes(
+  groups::GroupBase * group, CandidateVotes & results) const
+{
+  results.clear();
+
+  for (VoterBallots::const_iterator i = voters_.begin();
+    i != voters_.end(); ++i)
+  {
+    if (i->second.size() != 0 && group->is_member(i->first))
+    {
+      if (one_vote_per_voter_)
+      {
+        results[i->second.begin()->first] += 1;
+      }
+      else
+      {
+        for (Ballots::const_iterator ballot = i->second.begin();
+          ballot != i->second.end(); ++ballot)
+        {
+          results[ballot->first] += ballot->second;
+        }
+      }
+    }
+  }
+}
+
+gams::elections::CandidateList
+gams::elections::VoteTally::get_leaders(int num_leaders) const
+{
+  CandidateList leaders;
+  Integer last_votes = 0;
+
+  for (Ranking::const_iterator i = ranking_.begin(); i != ranking_.end(); ++i)
+  {
+    // if it is a tie, we could provide more than num_leaders
+    if ((int)leaders.size() >= num_leaders &&
+      (leaders.size() == 0 || i->first != last_votes))
+    {
+      break;
+    }
+
+    leaders.push_back(i->second);
+    last_votes = i->first;
+  }
+
+  return leaders;
+}
+
+std::string
+gams::elections::VoteTally::get_leader(void) const
+{
+  return ranking_.size() != 0 ? ranking_.begin()->second : "";
+}
+
+const gams::elections::VoteTally::VoterBallots &
+gams::elections::VoteTally::get_ballots(void) const
+{
+  return voters_;
+}
+
+void
+gams::elections::VoteTally::apply_ballots_(const Ballots & ballots, int sign)
+{
+  for (Ballots::const_iterator i = ballots.begin(); i != ballots.end(); ++i)
+  {
+    Integer votes;
+
+    if (one_vote_per_voter_)
+    {
+      // plurality: the voter's first candidate receives its only vote
+      votes = i == ballots.begin() ? 1 : 0;
+    }
+    else
+    {
+      votes = i->second;
+    }
+
+    update_candidate_(i->first, sign * votes, sign);
+  }
+}
+
+void
+gams::elections::VoteTally::update_candidate_(const std::string & candidate,
+  Integer votes_delta, int ballots_delta)
+{
+  std::map <std::string, CandidateRecord>::iterator found =
+    candidates_.find(candidate);
+
+  if (found == candidates_.end())
+  {
+    CandidateRecord record;
+    record.votes = 0;
+    record.ballots = 0;
+    found = candidates_.insert(std::make_pair(candidate, record)).first;
+  }
+  else
+  {
+    ranking_.erase(std::make_pair(found->second.votes, candidate));
+  }
+
+  found->second.votes += votes_delta;
+  found->second.ballots += ballots_delta;
+
+  if (found->second.ballots == 0)
+  {
+    candidates_.erase(found);
+  }
+  else
+  {
+    ranking_.insert(std::make_pair(found->second.votes, candidate));
+  }
+}
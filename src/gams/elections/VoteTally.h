@@ -0,0 +1,239 @@
+/**
+* Copyright(c) 2016 Carnegie Mellon University. All Rights Reserved.
+*
+* Redistribution and use in source and binary forms, with or without
+* modification, are permitted provided that the following conditions are met:
+*
+* 1. Redistributions of source code must retain the above copyright notice,
+*    this list of conditions and the following acknowledgments and disclaimers.
+*
+* 2. Redistributions in binary form must reproduce the above copyright notice,
+*    this list of conditions and the following disclaimer in the documentation
+*    and/or other materials provided with the distribution.
+*
+* 3. The names "Carnegie Mellon University," "SEI" and/or "Software
+*    Engineering Institute" shall not be used to endorse or promote products
+*    derived from this software without prior written permission. For written
+*    permission, please contact permission@sei.cmu.edu.
+*
+* 4. Products derived from this software may not be called "SEI" nor may "SEI"
+*    appear in their names without prior written permission of
+*    permission@sei.cmu.edu.
+*
+* 5. Redistributions of any form whatsoever must retain the following
+*    acknowledgment:
+*
+*      This material is based upon work funded and supported by the Department
+*      of Defense under Contract No. FA8721-05-C-0003 with Carnegie Mellon
+*      University for the operation of the Software Engineering Institute, a
+*      federally funded research and development center. Any opinions,
+*      findings and conclusions or recommendations expressed in this material
+*      are those of the author(s) and do not necessarily reflect the views of
+*      the United States Department of Defense.
+*
+*      NO WARRANTY. THIS CARNEGIE MELLON UNIVERSITY AND SOFTWARE ENGINEERING
+*      INSTITUTE MATERIAL IS FURNISHED ON AN "AS-IS" BASIS. CARNEGIE MELLON
+*      UNIVERSITY MAKES NO WARRANTIES OF ANY KIND, EITHER EXPRESSED OR
+*      IMPLIED, AS TO ANY MATTER INCLUDING, BUT NOT LIMITED TO, WARRANTY OF
+*      FITNESS FOR PURPOSE OR MERCHANTABILITY, EXCLUSIVITY, OR RESULTS
+*      OBTAINED FROM USE OF THE MATERIAL. CARNEGIE MELLON UNIVERSITY DOES
+*      NOT MAKE ANY WARRANTY OF ANY KIND WITH RESPECT TO FREEDOM FROM PATENT,
+*      TRADEMARK, OR COPYRIGHT INFRINGEMENT.
+*
+*      This material has been approved for public release and unlimited
+*      distribution.
+**/
+
+/**
+* @file VoteTally.h
+* @author James Edmondson <jedmondson@gmail.com>
+*
+* This file contains the definition of an incrementally maintained
+* election tally
+**/
+
+#ifndef   _GAMS_ELECTIONS_VOTE_TALLY_H_
+#define   _GAMS_ELECTIONS_VOTE_TALLY_H_
+
+#include <vector>
+#include <string>
+#include <map>
+#include <set>
+#include <utility>
+
+#include "madara/knowledge/KnowledgeRecord.h"
+
+#include "gams/groups/GroupBase.h"
+#include "gams/GamsExport.h"
+
+namespace gams
+{
+  namespace elections
+  {
+    /// list of candidates
+    typedef  std::vector<std::string> CandidateList;
+
+    /// candidate vote tally
+    typedef std::map <std::string,
+      madara::knowledge::KnowledgeRecord::Integer> CandidateVotes;
+
+    /**
+    * A live tally of ballots (voter -> candidate -> votes) that keeps
+    * candidate totals and a ranking up to date as individual ballots
+    * change. Leader queries are O(1) and top-k queries are O(k).
+    **/
+    class GAMS_EXPORT VoteTally
+    {
+    public:
+      /// integer type used for vote counts
+      typedef madara::knowledge::KnowledgeRecord::Integer Integer;
+
+      /// the ballots of a single voter, indexed by candidate
+      typedef std::map <std::string, Integer> Ballots;
+
+      /// the ballots of all voters, indexed by voter
+      typedef std::map <std::string, Ballots> VoterBallots;
+
+      /**
+      * Constructor
+      * @param one_vote_per_voter  if true, each voter contributes a single
+      *                            vote to its first candidate(plurality).
+      *                            Otherwise, ballots are summed(cumulative).
+      **/
+      VoteTally(bool one_vote_per_voter = false);
+
+      /**
+      * Changes how voter ballots contribute to candidate totals. The
+      * tally is recomputed from the existing ballots.
+      * @param one_vote_per_voter  true for plurality, false for cumulative
+      **/
+      void set_one_vote_per_voter(bool one_vote_per_voter);
+
+      /**
+      * Removes all ballots and totals
+      **/
+      void clear(void);
+
+      /**
+      * Sets or changes a ballot
+      * @param  voter      the voter prefix(e.g. agent.0)
+      * @param  candidate  the candidate receiving votes
+      * @param  votes      the number of votes cast
+      **/
+      void set_ballot(const std::string & voter,
+        const std::string & candidate, Integer votes);
+
+      /**
+      * Removes a ballot
+      * @param  voter      the voter prefix(e.g. agent.0)
+      * @param  candidate  the candidate the ballot was cast for
+      **/
+      void remove_ballot(const std::string & voter,
+        const std::string & candidate);
+
+      /**
+      * Checks if a voter has cast any ballots
+      * @param  voter      the voter prefix(e.g. agent.0)
+      * @return true if the voter has at least one ballot in the tally
+      **/
+      bool has_voted(const std::string & voter) const;
+
+      /**
+      * Gets the total votes for a candidate
+      * @param  candidate  the candidate of interest
+      * @return the votes for the candidate(0 if unknown)
+      **/
+      Integer get_votes(const std::string & candidate) const;
+
+      /**
+      * Copies the candidate totals
+      * @param  results  the results of the vote
+      **/
+      void get_votes(CandidateVotes & results) const;
+
+      /**
+      * Tallies the votes cast by members of a group. Membership is
+      * checked once per voter rather than once per ballot.
+      * @param  group    the group that is of interest
+      * @param  results  the results of the vote
+      **/
+      void get_votes(groups::GroupBase * group, CandidateVotes & results) const;
+
+      /**
+      * Returns the leaders in order of votes. Ties are broken by candidate
+      * name and, as with the leaderboard-based elections, a tie at the
+      * cutoff returns every tied candidate.
+      * @param  num_leaders maximum leaders to return
+      * @return the leaders of the election up to num_leaders
+      **/
+      CandidateList get_leaders(int num_leaders = 1) const;
+
+      /**
+      * Returns the candidate with the most votes
+      * @return the leader or an empty string if there are no candidates
+      **/
+      std::string get_leader(void) const;
+
+      /**
+      * Returns the ballots of all voters
+      * @return the ballots indexed by voter
+      **/
+      const VoterBallots & get_ballots(void) const;
+
+    private:
+      /// the total votes and number of ballots for a candidate
+      struct CandidateRecord
+      {
+        /// votes for the candidate
+        Integer votes;
+
+        /// ballots that name the candidate
+        size_t ballots;
+      };
+
+      /// sorts rankings by descending votes, then ascending candidate
+      struct RankOrder
+      {
+        bool operator() (const std::pair<Integer, std::string> & lhs,
+          const std::pair<Integer, std::string> & rhs) const
+        {
+          return lhs.first != rhs.first ?
+            lhs.first > rhs.first : lhs.second < rhs.second;
+        }
+      };
+
+      /// candidates ordered by rank
+      typedef std::set <std::pair<Integer, std::string>, RankOrder> Ranking;
+
+      /**
+      * Adds or removes the contribution of a voter's ballots to the totals
+      * @param  ballots   the ballots of the voter
+      * @param  sign      1 to add the contribution, -1 to remove it
+      **/
+      void apply_ballots_(const Ballots & ballots, int sign);
+
+      /**
+      * Changes the totals of a candidate and updates the ranking
+      * @param  candidate    the candidate to change
+      * @param  votes_delta  the change in votes
+      * @param  ballots_delta  the change in ballots naming the candidate
+      **/
+      void update_candidate_(const std::string & candidate,
+        Integer votes_delta, int ballots_delta);
+
+      /// the ballots of each voter
+      VoterBallots voters_;
+
+      /// candidate totals
+      std::map <std::string, CandidateRecord> candidates_;
+
+      /// candidates in rank order
+      Ranking ranking_;
+
+      /// plurality(true) or cumulative(false) contribution of ballots
+      bool one_vote_per_voter_;
+    };
+  }
+}
+
+#endif // _GAMS_ELECTIONS_VOTE_TALLY_H_
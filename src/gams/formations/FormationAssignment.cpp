@@ -0,0 +1,425 @@
+/**
+* Copyright(c) 2016 Carnegie Mellon University. All Rights Reserved.
+*
+* Redistribution and use in source and binary forms, with or without
+* modification, are permitted provided that the following conditions are met:
+*
+* 1. Redistributions of source code must retain the above copyright notice,
+*    this list of conditions and the following acknowledgments and disclaimers.
+*
+* 2. Redistributions in binary form must reproduce the above copyright notice,
+*    this list of conditions and the following disclaimer in the documentation
+*    and/or other materials provided with the distribution.
+*
+* 3. The names "Carnegie Mellon University," "SEI" and/or "Software
+*    Engineering Institute" shall not be used to endorse or promote products
+*    derived from this software without prior written permission. For written
+*    permission, please contact permission@sei.cmu.edu.
+*
+* 4. Products derived from this software may not be called "SEI" nor may "SEI"
+*    appear in their names without prior written permission of
+*    permission@sei.cmu.edu.
+*
+* 5. Redistributions of any form whatsoever must retain the following
+*    acknowledgment:
+*
+*      This material is based upon work funded and supported by the Department
+*      of Defense under Contract No. FA8721-05-C-0003 with Carnegie Mellon
+*      University for the operation of the Software Engineering Institute, a
+*      federally funded research and development center. Any opinions,
+*      findings and conclusions or recommendations expressed in this material
+*      are those of the author(s) and do not necessarily reflect the views of
+*      the United States Department of Defense.
+*
+*      NO WARRANTY. THIS CARNEGIE MELLON UNIVERSITY AND SOFTWARE ENGINEERING
+*      INSTITUTE MATERIAL IS FURNISHED ON AN "AS-IS" BASIS. CARNEGIE MELLON
+*      UNIVERSITY MAKES NO WARRANTIES OF ANY KIND, EITHER EXPRESSED OR
+*      IMPLIED, AS TO ANY MATTER INCLUDING, BUT NOT LIMITED TO, WARRANTY OF
+*      FITNESS FOR PURPOSE OR MERCHANTABILITY, EXCLUSIVITY, OR RESULTS
+*      OBTAINED FROM USE OF THE MATERIAL. CARNEGIE MELLON UNIVERSITY DOES
+*      NOT MAKE ANY WARRANTY OF ANY KIND WITH RESPECT TO FREEDOM FROM PATENT,
+*      TRADEMARK, OR COPYRIGHT INFRINGEMENT.
+*
+*      This material has been approved for public release and unlimited
+*      distribution.
+**/
+
+/**
+* @file FormationAssignment.cpp
+* @author James Edmondson <jedmondson@gmail.com>
+*
+* This file contains the implementation of the formation slot assignment
+**/
+
+#include <algorithm>
+#include <limits>
+
+#include "FormationAssignment.h"
+#include "gams/loggers/GlobalLogger.h"
+
+namespace
+{
+  /**
+   * Tries to match an agent to a slot with cost at most threshold,
+   * displacing earlier matches along an augmenting path
+   **/
+  bool try_match(size_t agent, const gams::formations::CostMatrix & costs,
+    size_t slots, size_t columns, double threshold,
+    std::vector<char> & visited, std::vector<long> & owner)
+  {
+    for (size_t j = 0; j < columns; ++j)
+    {
+      if (!visited[j] && (j >= slots || costs[agent][j] <= threshold))
+      {
+        visited[j] = 1;
+
+        if (owner[j] < 0 || try_match((size_t)owner[j], costs, slots,
+          columns, threshold, visited, owner))
+        {
+          owner[j] = (long)agent;
+          return true;
+        }
+      }
+    }
+
+    return false;
+  }
+}
+
+gams::formations::FormationAssignment::FormationAssignment(int objective)
+  : objective_(objective), slots_(0), columns_(0),
+  threshold_(0), penalty_(0), total_cost_(0), max_cost_(0)
+{
+}
+
+gams::formations::FormationAssignment::~FormationAssignment()
+{
+}
+
+void
+gams::formations::FormationAssignment::set_objective(int objective)
+{
+  objective_ = objective;
+}
+
+int
+gams::formations::FormationAssignment::get_objective(void) const
+{
+  return objective_;
+}
+
+const std::vector<int> &
+gams::formations::FormationAssignment::solve(const CostMatrix & costs)
+{
+  costs_ = costs;
+  slots_ = costs_.size() > 0 ? costs_[0].size() : 0;
+
+  solve_all();
+
+  return assignment_;
+}
+
+const std::vector<int> &
+gams::formations::FormationAssignment::solve(
+  const std::vector<pose::Position> & agents,
+  const std::vector<pose::Position> & slots)
+{
+  CostMatrix costs(agents.size(), std::vector<double>(slots.size()));
+
+  for (size_t i = 0; i < agents.size(); ++i)
+  {
+    for (size_t j = 0; j < slots.size(); ++j)
+    {
+      costs[i][j] = agents[i].distance_to(slots[j]);
+    }
+  }
+
+  return solve(costs);
+}
+
+int
+gams::formations::FormationAssignment::add_agent(
+  const std::vector<double> & costs)
+{
+  if (costs_.size() == 0)
+  {
+    slots_ = costs.size();
+  }
+
+  costs_.push_back(costs);
+
+  size_t agents = costs_.size();
+
+  // potentials stay feasible for a new row, so one augmentation suffices
+  if (objective_ == ASSIGN_MIN_TOTAL &&
+    agents <= columns_ && u_.size() == agents)
+  {
+    u_.push_back(0);
+    augment(agents);
+    update_assignment();
+  }
+  else
+  {
+    solve_all();
+  }
+
+  madara_logger_ptr_log(gams::loggers::global_logger.get(),
+    gams::loggers::LOG_MINOR,
+    "gams::formations::FormationAssignment::add_agent:" \
+    " agent %d assigned to slot %d\n",
+    (int)agents - 1, assignment_.back());
+
+  return assignment_.back();
+}
+
+void
+gams::formations::FormationAssignment::remove_agent(size_t agent)
+{
+  if (agent < costs_.size())
+  {
+    costs_.erase(costs_.begin() + agent);
+
+    // a freed slot can invalidate the potentials, so reassign everyone
+    solve_all();
+  }
+}
+
+const std::vector<int> &
+gams::formations::FormationAssignment::get_assignment(void) const
+{
+  return assignment_;
+}
+
+double
+gams::formations::FormationAssignment::get_total_cost(void) const
+{
+  return total_cost_;
+}
+
+double
+gams::formations::FormationAssignment::get_max_cost(void) const
+{
+  return max_cost_;
+}
+
+double
+gams::formations::FormationAssignment::cost(size_t agent, size_t slot) const
+{
+  if (slot >= slots_)
+  {
+    return 0;
+  }
+
+  double result = costs_[agent][slot];
+
+  if (objective_ == ASSIGN_MIN_MAX && result > threshold_)
+  {
+    result += penalty_;
+  }
+
+  return result;
+}
+
+double
+gams::formations::FormationAssignment::find_bottleneck(void) const
+{
+  std::vector<double> values;
+  values.reserve(costs_.size() * slots_);
+
+  for (size_t i = 0; i < costs_.size(); ++i)
+  {
+    values.insert(values.end(), costs_[i].begin(), costs_[i].end());
+  }
+
+  std::sort(values.begin(), values.end());
+  values.erase(std::unique(values.begin(), values.end()), values.end());
+
+  if (values.size() == 0)
+  {
+    return 0;
+  }
+
+  // every agent can be matched at the largest cost, so search below it
+  size_t low = 0;
+  size_t high = values.size() - 1;
+
+  std::vector<char> visited(columns_);
+  std::vector<long> owner(columns_);
+
+  while (low < high)
+  {
+    size_t middle = low + (high - low) / 2;
+    bool matched = true;
+
+    std::fill(owner.begin(), owner.end(), -1);
+
+    for (size_t i = 0; matched && i < costs_.size(); ++i)
+    {
+      std::fill(visited.begin(), visited.end(), 0);
+      matched = try_match(i, costs_, slots_, columns_,
+        values[middle], visited, owner);
+    }
+
+    if (matched)
+    {
+      high = middle;
+    }
+    else
+    {
+      low = middle + 1;
+    }
+  }
+
+  return values[low];
+}
+
+void
+gams::formations::FormationAssignment::solve_all(void)
+{
+  size_t agents = costs_.size();
+  columns_ = std::max(slots_, agents);
+
+  u_.clear();
+  v_.clear();
+  owner_.clear();
+
+  if (objective_ == ASSIGN_BY_INDEX)
+  {
+    assignment_.resize(agents);
+    total_cost_ = 0;
+    max_cost_ = 0;
+
+    for (size_t i = 0; i < agents; ++i)
+    {
+      assignment_[i] = i < slots_ ? (int)i : -1;
+
+      if (i < slots_)
+      {
+        total_cost_ += costs_[i][i];
+        max_cost_ = std::max(max_cost_, costs_[i][i]);
+      }
+    }
+
+    return;
+  }
+
+  if (objective_ == ASSIGN_MIN_MAX)
+  {
+    threshold_ = find_bottleneck();
+
+    // the penalty must outweigh any sum of unpenalized costs
+    double max_cost = 0;
+    for (size_t i = 0; i < agents; ++i)
+    {
+      for (size_t j = 0; j < slots_; ++j)
+      {
+        max_cost = std::max(max_cost, costs_[i][j]);
+      }
+    }
+    penalty_ = (max_cost + 1) * (agents + 1);
+  }
+
+  u_.resize(agents + 1, 0);
+  v_.resize(columns_ + 1, 0);
+  owner_.resize(columns_ + 1, 0);
+
+  for (size_t i = 1; i <= agents; ++i)
+  {
+    augment(i);
+  }
+
+  update_assignment();
+
+  madara_logger_ptr_log(gams::loggers::global_logger.get(),
+    gams::loggers::LOG_MINOR,
+    "gams::formations::FormationAssignment::solve_all:" \
+    " assigned %d agents to %d slots. total=%.2f, max=%.2f\n",
+    (int)agents, (int)slots_, total_cost_, max_cost_);
+}
+
+void
+gams::formations::FormationAssignment::augment(size_t agent)
+{
+  const double infinity = std::numeric_limits<double>::max();
+
+  std::vector<double> min_slack(columns_ + 1, infinity);
+  std::vector<char> used(columns_ + 1, 0);
+  std::vector<size_t> way(columns_ + 1, 0);
+
+  // column 0 is a virtual slot holding the agent being assigned
+  owner_[0] = agent;
+  size_t j0 = 0;
+
+  // grow a shortest path tree until it reaches a free slot
+  do
+  {
+    used[j0] = 1;
+    size_t i0 = owner_[j0];
+    double delta = infinity;
+    size_t j1 = 0;
+
+    for (size_t j = 1; j <= columns_; ++j)
+    {
+      if (!used[j])
+      {
+        double slack = cost(i0 - 1, j - 1) - u_[i0] - v_[j];
+
+        if (slack < min_slack[j])
+        {
+          min_slack[j] = slack;
+          way[j] = j0;
+        }
+
+        if (min_slack[j] < delta)
+        {
+          delta = min_slack[j];
+          j1 = j;
+        }
+      }
+    }
+
+    for (size_t j = 0; j <= columns_; ++j)
+    {
+      if (used[j])
+      {
+        u_[owner_[j]] += delta;
+        v_[j] -= delta;
+      }
+      else
+      {
+        min_slack[j] -= delta;
+      }
+    }
+
+    j0 = j1;
+  } while (owner_[j0] != 0);
+
+  // flip the assignments along the path
+  do
+  {
+    size_t j1 = way[j0];
+    owner_[j0] = owner_[j1];
+    j0 = j1;
+  } while (j0 != 0);
+}
+
+void
+gams::formations::FormationAssignment::update_assignment(void)
+{
+  assignment_.assign(costs_.size(), -1);
+  total_cost_ = 0;
+  max_cost_ = 0;
+
+  for (size_t j = 1; j <= columns_ && j <= slots_; ++j)
+  {
+    if (owner_[j] != 0)
+    {
+      size_t agent = owner_[j] - 1;
+      double value = costs_[agent][j - 1];
+
+      assignment_[agent] = (int)j - 1;
+      total_cost_ += value;
+      max_cost_ = std::max(max_cost_, value);
+    }
+  }
+}
@@ -0,0 +1,236 @@
+/**
+* Copyright(c) 2016 Carnegie Mellon University. All Rights Reserved.
+*
+* Redistribution and use in source and binary forms, with or without
+* modification, are permitted provided that the following conditions are met:
+*
+* 1. Redistributions of source code must retain the above copyright notice,
+*    this list of conditions and the following acknowledgments and disclaimers.
+*
+* 2. Redistributions in binary form must reproduce the above copyright notice,
+*    this list of conditions and the following disclaimer in the documentation
+*    and/or other materials provided with the distribution.
+*
+* 3. The names "Carnegie Mellon University," "SEI" and/or "Software
+*    Engineering Institute" shall not be used to endorse or promote products
+*    derived from this software without prior written permission. For written
+*    permission, please contact permission@sei.cmu.edu.
+*
+* 4. Products derived from this software may not be called "SEI" nor may "SEI"
+*    appear in their names without prior written permission of
+*    permission@sei.cmu.edu.
+*
+* 5. Redistributions of any form whatsoever must retain the following
+*    acknowledgment:
+*
+*      This material is based upon work funded and supported by the Department
+*      of Defense under Contract No. FA8721-05-C-0003 with Carnegie Mellon
+*      University for the operation of the Software Engineering Institute, a
+*      federally funded research and development center. Any opinions,
+*      findings and conclusions or recommendations expressed in this material
+*      are those of the author(s) and do not necessarily reflect the views of
+*      the United States Department of Defense.
+*
+*      NO WARRANTY. THIS CARNEGIE MELLON UNIVERSITY AND SOFTWARE ENGINEERING
+*      INSTITUTE MATERIAL IS FURNISHED ON AN "AS-IS" BASIS. CARNEGIE MELLON
+*      UNIVERSITY MAKES NO WARRANTIES OF ANY KIND, EITHER EXPRESSED OR
+*      IMPLIED, AS TO ANY MATTER INCLUDING, BUT NOT LIMITED TO, WARRANTY OF
+*      FITNESS FOR PURPOSE OR MERCHANTABILITY, EXCLUSIVITY, OR RESULTS
+*      OBTAINED FROM USE OF THE MATERIAL. CARNEGIE MELLON UNIVERSITY DOES
+*      NOT MAKE ANY WARRANTY OF ANY KIND WITH RESPECT TO FREEDOM FROM PATENT,
+*      TRADEMARK, OR COPYRIGHT INFRINGEMENT.
+*
+*      This material has been approved for public release and unlimited
+*      distribution.
+**/
+
+/**
+* @file FormationAssignment.h
+* @author James Edmondson <jedmondson@gmail.com>
+*
+* This file contains the definition of an agent-to-slot assignment solver
+* for formations
+**/
+
+#ifndef   _GAMS_FORMATIONS_FORMATION_ASSIGNMENT_H_
+#define   _GAMS_FORMATIONS_FORMATION_ASSIGNMENT_H_
+
+#include <vector>
+
+#include "gams/GamsExport.h"
+#include "gams/pose/Position.h"
+
+namespace gams
+{
+  namespace formations
+  {
+    /**
+    * Objectives for assigning agents to formation slots
+    **/
+    enum AssignmentObjectives
+    {
+      /// agent i takes slot i, the historical behavior
+      ASSIGN_BY_INDEX = 0,
+      /// minimize the sum of agent-to-slot distances
+      ASSIGN_MIN_TOTAL = 1,
+      /// minimize the longest distance, then the sum of distances
+      ASSIGN_MIN_MAX = 2
+    };
+
+    /// costs indexed by [agent][slot]
+    typedef std::vector<std::vector<double> > CostMatrix;
+
+    /**
+    * Assigns agents to formation slots with a Hungarian (shortest
+    * augmenting path) solver. Agents with no slot are assigned -1.
+    **/
+    class GAMS_EXPORT FormationAssignment
+    {
+    public:
+      /**
+      * Constructor
+      * @param  objective   the objective (@see AssignmentObjectives)
+      **/
+      FormationAssignment(int objective = ASSIGN_MIN_TOTAL);
+
+      /**
+      * Destructor
+      **/
+      ~FormationAssignment();
+
+      /**
+      * Sets the objective for later solves
+      * @param  objective   the objective (@see AssignmentObjectives)
+      **/
+      void set_objective(int objective);
+
+      /**
+      * Gets the objective
+      * @return  the objective (@see AssignmentObjectives)
+      **/
+      int get_objective(void) const;
+
+      /**
+      * Solves the assignment for a cost matrix
+      * @param  costs   non-negative costs indexed by [agent][slot]. Every
+      *                 row must have the same number of slots.
+      * @return  the slot of each agent, or -1 for agents without a slot
+      **/
+      const std::vector<int> & solve(const CostMatrix & costs);
+
+      /**
+      * Solves the assignment using distances between agents and slots
+      * @param  agents  current agent locations
+      * @param  slots   formation slot locations
+      * @return  the slot of each agent, or -1 for agents without a slot
+      **/
+      const std::vector<int> & solve(
+        const std::vector<pose::Position> & agents,
+        const std::vector<pose::Position> & slots);
+
+      /**
+      * Adds an agent to the last solved problem. With ASSIGN_MIN_TOTAL
+      * and a free slot, this is a single augmentation rather than a
+      * full solve.
+      * @param  costs   the agent's non-negative cost to each slot
+      * @return  the slot assigned to the new agent, or -1
+      **/
+      int add_agent(const std::vector<double> & costs);
+
+      /**
+      * Removes an agent from the last solved problem and reassigns
+      * the remaining agents. Later agents' indices shift down by one.
+      * @param  agent   the index of the agent to remove
+      **/
+      void remove_agent(size_t agent);
+
+      /**
+      * Gets the slot of each agent from the last solve
+      * @return  the slot of each agent, or -1 for agents without a slot
+      **/
+      const std::vector<int> & get_assignment(void) const;
+
+      /**
+      * Gets the sum of assigned costs from the last solve
+      * @return  the total cost
+      **/
+      double get_total_cost(void) const;
+
+      /**
+      * Gets the largest assigned cost from the last solve
+      * @return  the maximum cost
+      **/
+      double get_max_cost(void) const;
+
+    protected:
+      /**
+      * Gets the working cost of an agent and slot, including padding
+      * slots and bottleneck penalties
+      * @param  agent   the agent index
+      * @param  slot    the slot index, possibly a padding slot
+      * @return  the cost used by the solver
+      **/
+      double cost(size_t agent, size_t slot) const;
+
+      /**
+      * Finds the smallest cost threshold that still assigns every agent
+      * @return  the bottleneck cost
+      **/
+      double find_bottleneck(void) const;
+
+      /**
+      * Resets the potentials and assigns every agent
+      **/
+      void solve_all(void);
+
+      /**
+      * Assigns one agent along a shortest augmenting path
+      * @param  agent   the agent index
+      **/
+      void augment(size_t agent);
+
+      /**
+      * Rebuilds the assignment and cost summaries from the solver state
+      **/
+      void update_assignment(void);
+
+      /// the assignment objective
+      int objective_;
+
+      /// costs indexed by [agent][slot]
+      CostMatrix costs_;
+
+      /// the number of real slots
+      size_t slots_;
+
+      /// real plus padding slots, so there is a slot for every agent
+      size_t columns_;
+
+      /// costs above this are penalized with ASSIGN_MIN_MAX
+      double threshold_;
+
+      /// penalty for costs above the bottleneck threshold
+      double penalty_;
+
+      /// agent potentials, 1-indexed
+      std::vector<double> u_;
+
+      /// slot potentials, 1-indexed
+      std::vector<double> v_;
+
+      /// agent assigned to each slot, 1-indexed with 0 meaning none
+      std::vector<size_t> owner_;
+
+      /// slot of each agent
+      std::vector<int> assignment_;
+
+      /// sum of assigned costs
+      double total_cost_;
+
+      /// largest assigned cost
+      double max_cost_;
+    };
+  }
+}
+
+#endif // _GAMS_FORMATIONS_FORMATION_ASSIGNMENT_H_
@@ -45,10 +45,13 @@
 **/
 
 #include "GroupBase.h"
+#include "gams/loggers/GlobalLogger.h"
 
 gams::groups::GroupBase::GroupBase(const std::string & prefix,
   madara::knowledge::KnowledgeBase * knowledge)
-  : knowledge_(knowledge), prefix_(prefix)
+  : version_(0), member_ids_version_(0),
+    history_size_(32), last_subscriber_(0),
+    knowledge_(knowledge), prefix_(prefix)
 {
 }
 
@@ -63,3 +66,221 @@ madara::knowledge::KnowledgeBase * knowledge)
   knowledge_ = knowledge;
   prefix_ = prefix;
 }
+
+void
+gams::groups::GroupBase::get_member_ids(
+  std::vector<variables::AgentId> & ids) const
+{
+  if (member_ids_version_ != version_)
+  {
+    AgentVector members;
+    get_members(members);
+
+    variables::agent_names().intern(members, member_ids_);
+    member_ids_version_ = version_;
+  }
+
+  ids = member_ids_;
+}
+
+void
+gams::groups::GroupBase::rebuild_member_index(const AgentVector & members)
+{
+  std::unordered_map<std::string, int> previous;
+  previous.swap(member_index_);
+  member_index_.reserve(members.size());
+
+  AgentVector added, removed;
+
+  // like find_member_index, duplicates resolve to the first occurrence
+  for (size_t i = 0; i < members.size(); ++i)
+  {
+    if (member_index_.insert(std::make_pair(members[i], (int)i)).second &&
+      previous.find(members[i]) == previous.end())
+    {
+      added.push_back(members[i]);
+    }
+  }
+
+  for (std::unordered_map<std::string, int>::const_iterator i =
+    previous.begin(); i != previous.end(); ++i)
+  {
+    if (member_index_.find(i->first) == member_index_.end())
+    {
+      removed.push_back(i->first);
+    }
+  }
+
+  madara_logger_ptr_log(gams::loggers::global_logger.get(),
+    gams::loggers::LOG_MINOR,
+    "gams::groups::GroupBase:rebuild_member_index" \
+    " %s has %d members at version %d\n",
+    prefix_.c_str(), (int)members.size(), (int)version_ + 1);
+
+  record_change(added, removed);
+}
+
+bool
+gams::groups::GroupBase::update_member_index(const AgentVector & members)
+{
+  bool changed = false;
+  size_t distinct = 0;
+
+  // hash lookups are cheaper than copying and comparing member lists
+  for (size_t i = 0; !changed && i < members.size(); ++i)
+  {
+    int index = get_member_index(members[i]);
+
+    if (index == (int)i)
+    {
+      ++distinct;
+    }
+    else if (index < 0 || index > (int)i)
+    {
+      changed = true;
+    }
+    // otherwise, this is a duplicate of an earlier member
+  }
+
+  if (changed || distinct != member_index_.size())
+  {
+    rebuild_member_index(members);
+    changed = true;
+  }
+
+  return changed;
+}
+
+void
+gams::groups::GroupBase::record_change(const AgentVector & added,
+  const AgentVector & removed)
+{
+  ++version_;
+
+  madara_logger_ptr_log(gams::loggers::global_logger.get(),
+    gams::loggers::LOG_DETAILED,
+    "gams::groups::GroupBase:record_change" \
+    " %s version %d: %d added, %d removed\n",
+    prefix_.c_str(), (int)version_, (int)added.size(), (int)removed.size());
+
+  MembershipChange change;
+  change.version = version_;
+  change.added = added;
+  change.removed = removed;
+
+  if (history_size_ > 0)
+  {
+    changes_.push_back(change);
+
+    while (changes_.size() > history_size_)
+    {
+      changes_.pop_front();
+    }
+  }
+
+  // copy so that callbacks may subscribe or unsubscribe
+  std::vector<std::pair<size_t, MembershipCallback> > subscribers(
+    subscribers_);
+
+  for (size_t i = 0; i < subscribers.size(); ++i)
+  {
+    subscribers[i].second(*this, change);
+  }
+}
+
+bool
+gams::groups::GroupBase::get_changes(uint64_t version,
+  AgentVector & added, AgentVector & removed) const
+{
+  added.clear();
+  removed.clear();
+
+  if (version >= version_)
+  {
+    return version == version_;
+  }
+
+  // changes_ holds consecutive versions ending at version_
+  if (changes_.empty() ||
+    changes_.front().version > version + 1)
+  {
+    madara_logger_ptr_log(gams::loggers::global_logger.get(),
+      gams::loggers::LOG_MINOR,
+      "gams::groups::GroupBase:get_changes" \
+      " %s version %d is older than the change history\n",
+      prefix_.c_str(), (int)version);
+
+    return false;
+  }
+
+  // net effect per member: 1 is joined, -1 is left, 0 is unchanged
+  std::map<std::string, int> net;
+
+  for (std::deque<MembershipChange>::const_iterator change =
+    changes_.begin(); change != changes_.end(); ++change)
+  {
+    if (change->version <= version)
+    {
+      continue;
+    }
+
+    for (size_t i = 0; i < change->added.size(); ++i)
+    {
+      ++net[change->added[i]];
+    }
+
+    for (size_t i = 0; i < change->removed.size(); ++i)
+    {
+      --net[change->removed[i]];
+    }
+  }
+
+  for (std::map<std::string, int>::const_iterator i = net.begin();
+    i != net.end(); ++i)
+  {
+    if (i->second > 0)
+    {
+      added.push_back(i->first);
+    }
+    else if (i->second < 0)
+    {
+      removed.push_back(i->first);
+    }
+  }
+
+  return true;
+}
+
+size_t
+gams::groups::GroupBase::subscribe(const MembershipCallback & callback)
+{
+  subscribers_.push_back(std::make_pair(++last_subscriber_, callback));
+
+  return last_subscriber_;
+}
+
+bool
+gams::groups::GroupBase::unsubscribe(size_t id)
+{
+  for (size_t i = 0; i < subscribers_.size(); ++i)
+  {
+    if (subscribers_[i].first == id)
+    {
+      subscribers_.erase(subscribers_.begin() + i);
+      return true;
+    }
+  }
+
+  return false;
+}
+
+void
+gams::groups::GroupBase::set_history_size(size_t size)
+{
+  history_size_ = size;
+
+  while (changes_.size() > history_size_)
+  {
+    changes_.pop_front();
+  }
+}
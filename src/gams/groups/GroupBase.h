@@ -57,10 +57,15 @@
 #include <vector>
 #include <string>
 #include <map>
+#include <deque>
+#include <functional>
+#include <unordered_map>
+#include <cstdint>
 
 #include "madara/knowledge/KnowledgeBase.h"
 
 #include "gams/GamsExport.h"
+#include "gams/variables/AgentNames.h"
 #include "GroupTypesEnum.h"
 
 namespace gams
@@ -84,6 +89,41 @@ namespace gams
     int find_member_index(const std::string & prefix,
       const AgentVector & members);
 
+    class GroupBase;
+
+    /**
+     * A membership delta between two consecutive group versions
+     **/
+    struct MembershipChange
+    {
+      /// the membership version after the change
+      uint64_t version;
+
+      /// members that joined the group
+      AgentVector added;
+
+      /// members that left the group
+      AgentVector removed;
+    };
+
+    /**
+     * Callback invoked after the membership of a group changes. The change
+     * may have no added or removed members if only the order changed.
+     **/
+    typedef std::function<void(const GroupBase &, const MembershipChange &)>
+      MembershipCallback;
+
+    /**
+     * Finds the index of the member prefix in a group's member listing
+     * using the group's member index(O(1))
+     * @param prefix   the prefix of the agent(e.g. "agent.0")
+     * @param group    the group of interest
+     * @return 0+ is the index of the prefix in the get_members listing. If
+     *            member does not exist in the group, then -1 is returned.
+     **/
+    int find_member_index(const std::string & prefix,
+      const GroupBase & group);
+
     /**
     * Base class for a group of agents
     **/
@@ -120,6 +160,13 @@ namespace gams
       **/
       virtual void get_members(AgentVector & members) const = 0;
 
+      /**
+      * Retrieves the interned ids of the members, in get_members order.
+      * The ids are cached until the membership version changes.
+      * @param  ids    the ids of the members in variables::agent_names
+      **/
+      void get_member_ids(std::vector<variables::AgentId> & ids) const;
+
       /**
       * Checks if the agent is a  member of the formation
       * @param  id     the agent id(e.g. agent.0 or agent.leader). If null,
@@ -170,8 +217,125 @@ namespace gams
       **/
       const std::string & get_prefix(void) const;
 
+      /**
+      * Returns the index of a member in the get_members listing in O(1)
+      * @param  id     the agent id(e.g. agent.0)
+      * @return 0+ is the index of the member. -1 if not a member.
+      **/
+      int get_member_index(const std::string & id) const;
+
+      /**
+      * Returns the membership version. The version increases every time
+      * the membership changes, whether locally or from a sync, so callers
+      * can skip recomputation when the group is unchanged.
+      * @return  the membership version
+      **/
+      uint64_t get_version(void) const;
+
+      /**
+      * Gets the net membership delta since a prior version. Members that
+      * joined and then left(or vice versa) in between are not reported.
+      * @param  version  a version previously returned by get_version
+      * @param  added    members that joined since the version
+      * @param  removed  members that left since the version
+      * @return  true if the delta is known. false if the version is older
+      *          than the change history, in which case callers should
+      *          rebuild from get_members
+      **/
+      bool get_changes(uint64_t version,
+        AgentVector & added, AgentVector & removed) const;
+
+      /**
+      * Registers a callback for membership changes. Callbacks are invoked
+      * from whichever call changed the membership(e.g. sync).
+      * @param  callback  the function to call after each change
+      * @return  an id for unsubscribe
+      **/
+      size_t subscribe(const MembershipCallback & callback);
+
+      /**
+      * Removes a membership callback
+      * @param  id     the id returned by subscribe
+      * @return  true if the callback was registered
+      **/
+      bool unsubscribe(size_t id);
+
+      /**
+      * Sets the number of membership changes kept for get_changes
+      * @param  size   the maximum number of changes to keep
+      **/
+      void set_history_size(size_t size);
+
+      /**
+      * Gets the number of membership changes kept for get_changes
+      * @return  the maximum number of changes kept
+      **/
+      size_t get_history_size(void) const;
+
     protected:
 
+      /**
+      * Increments the membership version, records the delta in the change
+      * history and notifies subscribers
+      * @param  added    members that joined the group
+      * @param  removed  members that left the group
+      **/
+      void record_change(const AgentVector & added,
+        const AgentVector & removed);
+
+      /**
+      * Rebuilds the member index and increments the membership version
+      * @param  members  the member listing, in get_members order
+      **/
+      void rebuild_member_index(const AgentVector & members);
+
+      /**
+      * Rebuilds the member index only if the listing differs from it
+      * @param  members  the member listing, in get_members order
+      * @return  true if the membership changed
+      **/
+      bool update_member_index(const AgentVector & members);
+
+      /**
+      * member id to index in the get_members listing
+      **/
+      std::unordered_map<std::string, int> member_index_;
+
+      /**
+      * the membership version
+      **/
+      uint64_t version_;
+
+      /**
+      * interned member ids, valid if member_ids_version_ == version_
+      **/
+      mutable std::vector<variables::AgentId> member_ids_;
+
+      /**
+      * the membership version that member_ids_ reflects
+      **/
+      mutable uint64_t member_ids_version_;
+
+      /**
+      * recent membership changes, oldest first
+      **/
+      std::deque<MembershipChange> changes_;
+
+      /**
+      * the maximum number of changes kept in changes_
+      **/
+      size_t history_size_;
+
+      /**
+      * membership callbacks and their subscription ids
+      **/
+      std::vector<std::pair<size_t, MembershipCallback> > subscribers_;
+
+      /**
+      * the last subscription id handed out
+      **/
+      size_t last_subscriber_;
+
       /**
       * The knowledge base to use as a data plane
       **/
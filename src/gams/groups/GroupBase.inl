@@ -74,4 +74,31 @@ inline int gams::groups::find_member_index(
   return index;
 }
 
+inline int gams::groups::find_member_index(
+  const std::string & prefix, const GroupBase & group)
+{
+  return group.get_member_index(prefix);
+}
+
+inline int
+gams::groups::GroupBase::get_member_index(const std::string & id) const
+{
+  std::unordered_map<std::string, int>::const_iterator found =
+    member_index_.find(id);
+
+  return found != member_index_.end() ? found->second : -1;
+}
+
+inline uint64_t
+gams::groups::GroupBase::get_version(void) const
+{
+  return version_;
+}
+
+inline size_t
+gams::groups::GroupBase::get_history_size(void) const
+{
+  return history_size_;
+}
+
 #endif // _GAMS_GROUPS_GROUP_BASE_INL_
@@ -102,9 +102,29 @@ gams::groups::GroupFixedList::add_members(const AgentVector & members)
     "gams::groups::GroupFixedList:add_members" \
     " adding %d members\n",(int)members.size());
 
-  // add the members to the fast list
-  fast_members_.insert(
-    fast_members_.end(), members.begin(), members.end());
+  AgentVector added;
+
+  // add the members to the fast list and index
+  for (size_t i = 0; i < members.size(); ++i)
+  {
+    if (member_index_.insert(
+      std::make_pair(members[i], (int)fast_members_.size())).second)
+    {
+      added.push_back(members[i]);
+    }
+    fast_members_.push_back(members[i]);
+  }
+
+  // duplicates do not change membership, but they extend the listing,
+  // so the cached member ids are rebuilt from it on next use
+  if (!added.empty())
+  {
+    record_change(added, AgentVector());
+  }
+  else if (members.size() != 0)
+  {
+    member_ids_version_ = version_ - 1;
+  }
 
   if (knowledge_)
   {
@@ -138,6 +158,7 @@ gams::groups::GroupFixedList::clear_members(void)
 
   fast_members_.clear();
   members_.resize(0);
+  update_member_index(fast_members_);
 }
 
 void
@@ -156,10 +177,7 @@ gams::groups::GroupFixedList::get_members(AgentVector & members) const
 bool
 gams::groups::GroupFixedList::is_member(const std::string & id) const
 {
-  AgentVector::const_iterator found =
-    std::find(fast_members_.begin(), fast_members_.end(), id);
-
-  return found != fast_members_.end();
+  return get_member_index(id) >= 0;
 }
 
 void
@@ -172,18 +190,38 @@ gams::groups::GroupFixedList::remove_members(const AgentVector & members)
 
   size_t earliest = fast_members_.size();
   // note that this is not thread safe
+  std::vector<char> removed(fast_members_.size(), 0);
   for (auto member : members)
   {
-    if (member != "")
+    int index = get_member_index(member);
+
+    if (member != "" && index >= 0)
     {
-      AgentVector::iterator found = std::find(
-        fast_members_.begin(), fast_members_.end(), member);
-      
-      size_t i = std::distance(fast_members_.begin(), found);
+      size_t i = (size_t)index;
       earliest = i < earliest ? i : earliest;
 
-      fast_members_.erase(found);
+      removed[i] = 1;
+    }
+  }
+
+  // compact the list in one pass rather than erasing per member
+  if (earliest != fast_members_.size())
+  {
+    size_t kept = earliest;
+    for (size_t i = earliest; i < fast_members_.size(); ++i)
+    {
+      if (!removed[i])
+      {
+        if (kept != i)
+        {
+          fast_members_[kept] = fast_members_[i];
+        }
+        ++kept;
+      }
     }
+    fast_members_.resize(kept);
+
+    rebuild_member_index(fast_members_);
   }
 
   if (knowledge_)
@@ -200,7 +238,8 @@ gams::groups::GroupFixedList::remove_members(const AgentVector & members)
         madara_logger_ptr_log(gams::loggers::global_logger.get(),
           gams::loggers::LOG_MINOR,
           "gams::groups::GroupFixedList:remove_members" \
-          " adding member %s to %s\n", members[i].c_str(), prefix_.c_str());
+          " adding member %s to %s\n", fast_members_[i].c_str(),
+          prefix_.c_str());
 
         members_.set(i, fast_members_[i]);
       }
@@ -270,6 +309,9 @@ gams::groups::GroupFixedList::sync(void)
       fast_members_[i] = members_[i];
     }
   }
+
+  // only changes in membership bump the version
+  update_member_index(fast_members_);
 }
 
 void
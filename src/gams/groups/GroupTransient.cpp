@@ -82,7 +82,8 @@ madara::knowledge::KnowledgeBase * knowledge)
 
 gams::groups::GroupTransient::GroupTransient(const std::string & prefix,
   madara::knowledge::KnowledgeBase * knowledge)
-  : GroupBase(prefix, knowledge)
+  : GroupBase(prefix, knowledge),
+  members_stale_(true), feed_(0), subscription_(0)
 {
   if (knowledge && prefix != "")
   {
@@ -94,8 +95,39 @@ gams::groups::GroupTransient::GroupTransient(const std::string & prefix,
   }
 }
 
+gams::groups::GroupTransient::GroupTransient(const GroupTransient & source)
+  : GroupBase(source), members_(source.members_),
+  fast_members_(source.fast_members_),
+  members_stale_(true), feed_(0), subscription_(0)
+{
+}
+
 gams::groups::GroupTransient::~GroupTransient()
 {
+  if (feed_)
+  {
+    feed_->unsubscribe(subscription_);
+  }
+}
+
+gams::groups::GroupTransient &
+gams::groups::GroupTransient::operator=(const GroupTransient & source)
+{
+  if (this != &source)
+  {
+    if (feed_)
+    {
+      feed_->unsubscribe(subscription_);
+      feed_ = 0;
+    }
+
+    GroupBase::operator=(source);
+    members_ = source.members_;
+    fast_members_ = source.fast_members_;
+    members_stale_ = true;
+  }
+
+  return *this;
 }
 
 void
@@ -110,6 +142,7 @@ gams::groups::GroupTransient::add_members(const AgentVector & members)
    (knowledge::KnowledgeRecord::Integer)time(NULL);
 
   bool update_knowledge = knowledge_ && prefix_ != "";
+  bool added = false;
 
   // add the members to the underlying knowledge base
   for (size_t i = 0; i < members.size(); ++i)
@@ -121,7 +154,17 @@ gams::groups::GroupTransient::add_members(const AgentVector & members)
       "gams::groups::GroupTransient:add_members" \
       " adding member %s to fast map\n", id.c_str());
 
-    fast_members_[id] = cur_time;
+    std::pair<AgentMap::iterator, bool> result =
+      fast_members_.insert(std::make_pair(id, cur_time));
+
+    if (result.second)
+    {
+      added = true;
+    }
+    else
+    {
+      result.first->second = cur_time;
+    }
 
     if (update_knowledge)
     {
@@ -133,6 +176,12 @@ gams::groups::GroupTransient::add_members(const AgentVector & members)
       members_.set(id, cur_time);
     }
   }
+
+  // refreshed timestamps do not change membership
+  if (added)
+  {
+    reindex_members();
+  }
 }
 
 void
@@ -144,7 +193,14 @@ gams::groups::GroupTransient::clear_members(void)
     " clearing all %d members\n",(int)fast_members_.size());
 
   fast_members_.clear();
+
+  // members applied from the feed are not cached by the map yet
+  if (knowledge_ && prefix_ != "")
+  {
+    members_.sync_keys();
+  }
   members_.clear();
+  reindex_members();
 }
 
 void
@@ -186,11 +242,35 @@ gams::groups::GroupTransient::remove_members(const AgentVector & members)
     "gams::groups::GroupTransient:remove_members" \
     " removing %d members\n",(int)members.size());
 
+  bool removed = false;
+
+  // members applied from the feed are not cached by the map yet
+  if (knowledge_ && prefix_ != "")
+  {
+    members_.sync_keys();
+  }
+
   for (auto member: members)
   {
-    fast_members_.erase(member);
+    if (fast_members_.erase(member) != 0)
+    {
+      removed = true;
+    }
     members_.erase(member);
   }
+
+  if (removed)
+  {
+    reindex_members();
+  }
+}
+
+void
+gams::groups::GroupTransient::reindex_members(void)
+{
+  AgentVector members;
+  get_members(members);
+  rebuild_member_index(members);
 }
 
 void
@@ -207,10 +287,17 @@ gams::groups::GroupTransient::set_prefix(const std::string & prefix,
   if (knowledge && prefix != "")
   {
     members_.set_name(prefix + ".members", *knowledge);
+    members_stale_ = true;
     sync();
   }
 }
 
+void
+gams::groups::GroupTransient::resync(void)
+{
+  members_stale_ = true;
+}
+
 void
 gams::groups::GroupTransient::sync(void)
 {
@@ -223,23 +310,122 @@ gams::groups::GroupTransient::sync(void)
   {
     knowledge::ContextGuard guard(*knowledge_);
 
-    // sync with map is always expensive. Sync and clear
+    std::vector<std::string> changed_keys;
+
+    if (!members_stale_ && feed_->is_attached() &&
+      feed_->take(subscription_, changed_keys))
+    {
+      // only the members that were received or sent since the last sync
+      const std::string::size_type id_pos = members_.get_name().size() + 1;
+      bool changed = false;
+
+      for (size_t i = 0; i < changed_keys.size(); ++i)
+      {
+        const std::string id = changed_keys[i].substr(id_pos);
+        knowledge::KnowledgeRecord::Integer value =
+          knowledge_->get(changed_keys[i]).to_integer();
+        AgentMap::iterator found = fast_members_.find(id);
+
+        if (value != 0)
+        {
+          if (found != fast_members_.end())
+          {
+            found->second = value;
+          }
+          else
+          {
+            fast_members_.insert(std::make_pair(id, value));
+            changed = true;
+          }
+        }
+        else if (found != fast_members_.end())
+        {
+          fast_members_.erase(found);
+          changed = true;
+        }
+      }
+
+      if (changed)
+      {
+        reindex_members();
+      }
+
+      return;
+    }
+
+    if (members_stale_ || !feed_->take(subscription_, changed_keys))
+    {
+      // subscribe before scanning so no member falls between the two
+      if (feed_)
+      {
+        feed_->unsubscribe(subscription_);
+      }
+
+      feed_ = &utility::KeyFeed::get(*knowledge_);
+      subscription_ = feed_->subscribe(members_.get_name() + ".");
+    }
+
+    // without a feed on the transports, a scan is the only way to find
+    // members added by other agents
     members_.sync_keys();
-    fast_members_.clear();
+    members_stale_ = false;
 
     // get the new list of keys
     std::vector <std::string> keys;
     members_.keys(keys);
-    
-    // add the keys with values to the AgentMap fast_members_
+
+    if (!std::is_sorted(keys.begin(), keys.end()))
+    {
+      std::sort(keys.begin(), keys.end());
+    }
+
+    bool changed = false;
+    AgentMap::iterator next = fast_members_.begin();
+
+    // keys and the fast map are both sorted, so merge them in one pass
     for (size_t i = 0; i < keys.size(); ++i)
     {
-      const std::string key = keys[i];
+      const std::string & key = keys[i];
+
+      while (next != fast_members_.end() && next->first < key)
+      {
+        next = fast_members_.erase(next);
+        changed = true;
+      }
+
+      knowledge::KnowledgeRecord::Integer value = members_[key].to_integer();
+      bool present = next != fast_members_.end() && next->first == key;
 
-      if (members_[key].to_integer() != 0)
+      if (value != 0)
       {
-        fast_members_[key] = members_[key].to_integer();
+        if (present)
+        {
+          next->second = value;
+          ++next;
+        }
+        else
+        {
+          fast_members_.insert(next, std::make_pair(key, value));
+          changed = true;
+        }
       }
+      else if (present)
+      {
+        next = fast_members_.erase(next);
+        changed = true;
+      }
+    }
+
+    if (next != fast_members_.end())
+    {
+      fast_members_.erase(next, fast_members_.end());
+      changed = true;
+    }
+
+    // only changes in membership bump the version
+    if (changed)
+    {
+      reindex_members();
     }
   }
 }
@@ -62,6 +62,8 @@
 
 #include "madara/knowledge/containers/Map.h"
 
+#include "gams/utility/KeyFeed.h"
+
 #include "GroupBase.h"
 #include "GroupFactory.h"
 
@@ -85,11 +87,24 @@ namespace gams
       GroupTransient(const std::string & prefix = "",
         madara::knowledge::KnowledgeBase * knowledge = 0);
 
+      /**
+      * Copy constructor. The copy rescans the members on its first sync.
+      * @param source    the group to copy
+      **/
+      GroupTransient(const GroupTransient & source);
+
       /**
       * Constructor
       **/
       virtual ~GroupTransient();
 
+      /**
+      * Assignment operator. The group rescans the members on its next sync.
+      * @param source    the group to copy
+      * @return  this group
+      **/
+      GroupTransient & operator=(const GroupTransient & source);
+
       /**
       * Adds the members to the group
       * @param  members  list of members to add to formation
@@ -147,12 +162,27 @@ namespace gams
       virtual size_t size(void);
 
       /**
-      * Syncs the list to the knowledge base
+      * Syncs the list to the knowledge base. The members are only scanned
+      * on the first sync and after resync. Otherwise, only the members
+      * that the knowledge base's KeyFeed reports as received or sent
+      * since the last sync are applied. If no KeyFeed is attached to the
+      * transports, every sync rescans the members.
       **/
       virtual void sync(void);
 
+      /**
+      * Rescans the members on the next sync. Needed after members are
+      * deleted or written without being sent by another group instance.
+      **/
+      void resync(void);
+
     protected:
 
+      /**
+      * Rebuilds the member index from the fast member map
+      **/
+      void reindex_members(void);
+
       /**
       * The source member list in the knowledge base
       **/
@@ -162,6 +192,21 @@ namespace gams
       * member list for fast access
       **/
       AgentMap fast_members_;
+
+      /**
+      * if true, the members must be rescanned from the knowledge base
+      **/
+      bool members_stale_;
+
+      /**
+      * reports the members that changed since the last sync
+      **/
+      utility::KeyFeed * feed_;
+
+      /**
+      * the subscription to the member prefix in feed_
+      **/
+      utility::KeyFeed::Subscription subscription_;
     };
 
     /**
@@ -328,3 +328,22 @@ gams::platforms::BasePlatform::get_frame(void) const
   return pose::default_frame();
 }
 
+
+void
+gams::platforms::BasePlatform::set_wake_handler(
+  const std::function<void()> & handler)
+{
+  std::lock_guard<std::mutex> guard(wake_lock_);
+  wake_handler_ = handler;
+}
+
+void
+gams::platforms::BasePlatform::wake_controller(void)
+{
+  std::lock_guard<std::mutex> guard(wake_lock_);
+
+  if (wake_handler_)
+  {
+    wake_handler_();
+  }
+}
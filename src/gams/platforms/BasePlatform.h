@@ -55,6 +55,8 @@
 #define   _GAMS_PLATFORM_BASE_H_
 
 #include <string>
+#include <functional>
+#include <mutex>
 
 #include "gams/variables/Self.h"
 #include "gams/variables/Sensor.h"
@@ -431,7 +433,26 @@ namespace gams
        **/
       virtual const pose::ReferenceFrame & get_frame(void) const;
 
+      /**
+       * Sets the function used by wake_controller. The controller sets
+       * this when the platform is initialized.
+       * @param  handler  function that wakes the controller loop early
+       **/
+      void set_wake_handler(const std::function<void()> & handler);
+
     protected:
+      /**
+       * Wakes the controller loop before its next scheduled iteration,
+       * e.g., when new sensor data arrives on an I/O thread. Thread-safe.
+       **/
+      void wake_controller(void);
+
+      /// guards wake_handler_, which may be used from I/O threads
+      std::mutex wake_lock_;
+
+      /// function that wakes the controller loop early
+      std::function<void()> wake_handler_;
+
       /// movement speed for platform in meters/second
       double move_speed_;
 
@@ -450,6 +450,13 @@ gams::platforms::OscJoystickPlatform::build_prefixes(void)
     yaw_velocity_prefix_ += "/velocity/yaw";
     position_prefix_ += "/pos";
     rotation_prefix_ += "/rot";
+
+    // resolve address layouts once rather than on every pack/unpack
+    osc_.register_address(xy_velocity_prefix_);
+    osc_.register_address(z_velocity_prefix_);
+    osc_.register_address(yaw_velocity_prefix_);
+    osc_.register_address(position_prefix_);
+    osc_.register_address(rotation_prefix_);
   }
 }
 
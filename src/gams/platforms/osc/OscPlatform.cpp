@@ -124,11 +124,22 @@ gams::platforms::OscPlatform::OscPlatform(
       settings_.type = madara::transport::UDP;
     }
 
+    bool shared = knowledge->get(".osc.transport.shared").is_true();
+
+    // agents sharing a transport use the base port, others base + id
+    knowledge::KnowledgeRecord::Integer base_port = 8000;
+    if (knowledge->exists(".osc.local.port"))
+    {
+      base_port = knowledge->get(".osc.local.port").to_integer();
+    }
+    knowledge::KnowledgeRecord::Integer local_port =
+      shared ? base_port : *(self_->id) + base_port;
+
     if (settings_.hosts[0] == "")
     {
       std::stringstream buffer;
       buffer << "127.0.0.1:";
-      buffer <<(*(self_->id) + 8000);
+      buffer << local_port;
       settings_.hosts[0] = buffer.str();
     }
 
@@ -162,7 +173,16 @@ gams::platforms::OscPlatform::OscPlatform(
     json_buffer << "{\"id\":";
     json_buffer << *(self_->id);
     json_buffer << ",\"port\":";
-    json_buffer <<(*(self_->id) + 8000);
+    if (shared)
+    {
+      // the simulator must send all agents' updates to the shared port
+      json_buffer << settings_.hosts[0].substr(
+        settings_.hosts[0].rfind(':') + 1);
+    }
+    else
+    {
+      json_buffer << local_port;
+    }
     json_buffer << ",\"location\":{";
     json_buffer << "\"x\": " <<
       initial_pose.retrieve_index(0).to_double() << ",";
@@ -190,7 +210,50 @@ gams::platforms::OscPlatform::OscPlatform(
       self_->agent.prefix.c_str(),
       json_creation_.c_str());
 
-    osc_.create_socket(settings_);
+    if (shared)
+    {
+      osc_mux_ = utility::OscUdpMux::get(settings_);
+      osc_mux_id_ = osc_mux_->add_participant(
+        {position_prefix_, rotation_prefix_});
+
+      madara::knowledge::KnowledgeRecord max_bundle_size =
+        knowledge->get(".osc.transport.max_bundle_size");
+      if (max_bundle_size.to_integer() > 0)
+      {
+        osc_mux_->set_max_bundle_size(
+          (size_t)max_bundle_size.to_integer());
+      }
+
+      madara::knowledge::KnowledgeRecord flush_period =
+        knowledge->get(".osc.transport.flush_period");
+      if (flush_period.to_double() > 0)
+      {
+        osc_mux_->set_flush_period(flush_period.to_double());
+      }
+    }
+    else
+    {
+      osc_.create_socket(settings_);
+
+      if (knowledge->get(".osc.reactor").is_true())
+      {
+        // the reactor thread only receives, which does not read the
+        // address cache, so sends may use it without locking
+        osc_.register_address("/spawn/" + type_);
+        wake_on_receive_ = knowledge->get(".osc.reactor.wake").is_true();
+
+        use_reactor_ = utility::IoReactor::instance().add_handler(
+          osc_.get_socket_handle(),
+          [this] (int) { handle_osc_readable(); });
+
+        madara_logger_ptr_log(gams::loggers::global_logger.get(),
+          gams::loggers::LOG_MAJOR,
+          "gams::platforms::OscPlatform::const:" \
+          " %s: event-driven receive %s\n",
+          self_->agent.prefix.c_str(),
+          use_reactor_ ? "enabled" : "unavailable, polling in sense");
+      }
+    }
 
     // instead of spawning, let's only spawn later in sense
     // utility::OscUdp::OscMap values;
@@ -218,7 +281,7 @@ gams::platforms::OscPlatform::OscPlatform(
       std::string address = "/spawn/" + type_;
       values[address] = KnowledgeRecord(json_creation_);
 
-      osc_.send(values);
+      send_osc(values);
     }
 
     status_.movement_available = 1;
@@ -229,6 +292,87 @@ gams::platforms::OscPlatform::OscPlatform(
 // Destructor
 gams::platforms::OscPlatform::~OscPlatform()
 {
+  if (use_reactor_)
+  {
+    utility::IoReactor::instance().remove_handler(osc_.get_socket_handle());
+  }
+
+  if (osc_mux_)
+  {
+    osc_mux_->remove_participant(osc_mux_id_,
+      {position_prefix_, rotation_prefix_});
+  }
+}
+
+void
+gams::platforms::OscPlatform::send_osc(
+  const utility::OscUdp::OscMap & values)
+{
+  if (osc_mux_)
+  {
+    osc_mux_->send(osc_mux_id_, values);
+  }
+  else
+  {
+    osc_.send(values);
+  }
+}
+
+void
+gams::platforms::OscPlatform::receive_osc(utility::OscUdp::OscMap & values)
+{
+  if (osc_mux_)
+  {
+    osc_mux_->receive(values);
+  }
+  else if (use_reactor_)
+  {
+    // the reactor has already received and decoded the latest values
+    std::vector<double> latest;
+
+    if (latest_position_.read(latest))
+    {
+      values[position_prefix_] = latest;
+    }
+
+    if (latest_rotation_.read(latest))
+    {
+      values[rotation_prefix_] = latest;
+    }
+  }
+  else
+  {
+    osc_.receive(values);
+  }
+}
+
+void
+gams::platforms::OscPlatform::handle_osc_readable(void)
+{
+  utility::OscUdp::OscMap values;
+  values[position_prefix_];
+  values[rotation_prefix_];
+
+  osc_.receive(values, 0.0);
+
+  bool updated = false;
+
+  if (values[position_prefix_].size() == 3)
+  {
+    latest_position_.write(values[position_prefix_].to_doubles());
+    updated = true;
+  }
+
+  if (values[rotation_prefix_].size() == 3)
+  {
+    latest_rotation_.write(values[rotation_prefix_].to_doubles());
+    updated = true;
+  }
+
+  if (updated && wake_on_receive_)
+  {
+    wake_controller();
+  }
 }
 
 void
@@ -254,6 +398,13 @@ gams::platforms::OscPlatform::build_prefixes(void)
     yaw_velocity_prefix_ += "/velocity/yaw";
     position_prefix_ += "/pos";
     rotation_prefix_ += "/rot";
+
+    // resolve address layouts once rather than on every pack/unpack
+    osc_.register_address(xy_velocity_prefix_);
+    osc_.register_address(z_velocity_prefix_);
+    osc_.register_address(yaw_velocity_prefix_);
+    osc_.register_address(position_prefix_);
+    osc_.register_address(rotation_prefix_);
   }
 }
 
@@ -333,7 +484,7 @@ gams::platforms::OscPlatform::sense(void)
     "%s: entering receive on OSC UDP\n",
     self_->agent.prefix.c_str());
 
-  osc_.receive(values);
+  receive_osc(values);
 
   madara_logger_ptr_log(gams::loggers::global_logger.get(),
     gams::loggers::LOG_MINOR,
@@ -462,7 +613,7 @@ gams::platforms::OscPlatform::sense(void)
 
     record.resize(1);
     values[z_velocity_prefix_] = record;
-    osc_.send(values);
+    send_osc(values);
 
     // restart the timer
     last_thrust_timer_.start();
@@ -499,7 +650,7 @@ gams::platforms::OscPlatform::sense(void)
       std::string address = "/spawn/" + type_;
       values[address] = KnowledgeRecord(json_creation_);
 
-      osc_.send(values);
+      send_osc(values);
     }
   }
 
@@ -664,7 +815,7 @@ gams::platforms::OscPlatform::move(const pose::Position & target,
   values[xy_velocity_prefix_] = xy_velocity;
   values[z_velocity_prefix_] = z_velocity;
 
-  osc_.send(values);
+  send_osc(values);
 
   return result;
 }
@@ -691,7 +842,7 @@ gams::platforms::OscPlatform::orient(const pose::Orientation & target,
   std::vector<double> yaw_velocity;
   yaw_velocity.push_back(0);
   values[yaw_velocity_prefix_] = yaw_velocity;
-  osc_.send(values);
+  send_osc(values);
 
   // we're not changing orientation. this has to be done for move alg to work
   return PLATFORM_ARRIVED;
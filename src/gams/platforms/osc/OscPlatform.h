@@ -16,6 +16,9 @@
 #include "gams/pose/CartesianFrame.h"
 
 #include "gams/utility/OscUdp.h"
+#include "gams/utility/OscUdpMux.h"
+#include "gams/utility/IoReactor.h"
+#include "gams/utility/LatestValue.h"
 
 namespace gams { namespace platforms
 {        
@@ -173,9 +176,45 @@ namespace gams { namespace platforms
       const pose::Position & current, const pose::Position & target,
       bool & finished);
 
+    /**
+     * Sends OSC messages over the private or shared transport
+     * @param values   the values to send
+     **/
+    void send_osc(const utility::OscUdp::OscMap & values);
+
+    /**
+     * Receives OSC messages over the private or shared transport
+     * @param values   the addresses to fill with received values
+     **/
+    void receive_osc(utility::OscUdp::OscMap & values);
+
+    /**
+     * Receives OSC messages on the IoReactor thread when the socket is
+     * readable and publishes them for the next sense call
+     **/
+    void handle_osc_readable(void);
+
     /// handle to OSC UDP utility class
     gams::utility::OscUdp osc_;
 
+    /// true if receives are driven by the IoReactor (.osc.reactor)
+    bool use_reactor_ = false;
+
+    /// true if reactor receives should wake the controller (.osc.reactor.wake)
+    bool wake_on_receive_ = false;
+
+    /// latest position published by the IoReactor thread
+    gams::utility::LatestValue<std::vector<double>> latest_position_;
+
+    /// latest rotation published by the IoReactor thread
+    gams::utility::LatestValue<std::vector<double>> latest_rotation_;
+
+    /// process-wide OSC transport, if .osc.transport.shared is true
+    std::shared_ptr<gams::utility::OscUdpMux> osc_mux_;
+
+    /// this agent's participant id in osc_mux_
+    size_t osc_mux_id_ = 0;
+
     /// transport settings for OSC
     madara::transport::QoSTransportSettings settings_;
 
@@ -2,6 +2,7 @@
 #include "madara/knowledge/KnowledgeBase.h"
 #include "madara/knowledge/Any.h"
 #include "gams/types/PointCloudXYZ.capnp.h"
+#include "gams/utility/ros/RosPlugin.h"
 
 
 #ifdef __GNUC__
@@ -77,3 +78,41 @@ extern "C" void parse(const rosbag::MessageInstance* m,
     buffer);
   kb->set_any(container_name, any);
 }
+
+extern "C" unsigned int parse_points_flags()
+{
+  return gams::utility::ros::PLUGIN_TYPED_OUTPUT |
+    gams::utility::ros::PLUGIN_THREAD_SAFE;
+}
+
+extern "C" void parse_points(const topic_tools::ShapeShifter* m,
+  gams::utility::ros::PluginOutput * output,
+  const std::string & container_name)
+{
+  // Same conversion as parse, but the points are returned as one flat
+  // x, y, z array so the plugin can run on any parser thread
+  boost::shared_ptr<sensor_msgs::PointCloud2> pointcloud =
+    m->instantiate<sensor_msgs::PointCloud2>();
+
+  pcl::PCLPointCloud2 pcl_pc2;
+  pcl_conversions::toPCL(*pointcloud, pcl_pc2);
+  pcl::PointCloud<pcl::PointXYZ> cloud;
+  pcl::fromPCLPointCloud2(pcl_pc2, cloud);
+
+  std::vector<double> points;
+  points.reserve(cloud.size() * 3);
+  for (const pcl::PointXYZ & point : cloud)
+  {
+    points.push_back(point.x);
+    points.push_back(point.y);
+    points.push_back(point.z);
+  }
+
+  output->set(container_name + ".points", std::move(points));
+  output->set(container_name + ".tov",
+    (int64_t)pointcloud->header.stamp.toNSec());
+  output->set(container_name + ".frame_id", pointcloud->header.frame_id);
+  output->set(container_name + ".width", (int64_t)pointcloud->width);
+  output->set(container_name + ".height", (int64_t)pointcloud->height);
+  output->set(container_name + ".is_dense", (int64_t)pointcloud->is_dense);
+}
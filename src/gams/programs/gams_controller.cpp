@@ -125,6 +125,15 @@ void print_usage(const char * prog_name, const char * arg = "")
 "   Agent controller for gams. Options are:\n" 
 " [-A |--algorithm type]        algorithm to start with\n" 
 " [-a |--accent type]           accent algorithm to start with\n" 
+" [-ar|--adaptive-rates]        adapt loop and send hertz to load/movement\n" 
+" [--adaptive-cpu-budget frac]  max fraction of a loop period spent executing\n"
+" [--adaptive-decay frac]       fraction of the rate kept per loop when slowing\n"
+" [--adaptive-max-loop-hertz hz] fastest adaptive loop hertz\n"
+" [--adaptive-max-records num]  max records sent per second(0 is unlimited)\n"
+" [--adaptive-max-send-hertz hz] fastest adaptive send hertz\n"
+" [--adaptive-min-loop-hertz hz] slowest adaptive loop hertz\n"
+" [--adaptive-min-send-hertz hz] slowest adaptive send hertz\n"
+" [--adaptive-smoothing frac]   weight of the newest load sample\n"
 " [-b |--broadcast ip:port]     the broadcast ip to send and listen to\n" 
 " [--checkpoint-on-loop]        save checkpoint after each control loop\n" 
 " [--checkpoint-on-send]        save checkpoint before send of updates\n" 
@@ -152,6 +161,8 @@ void print_usage(const char * prog_name, const char * arg = "")
 " [-o |--host hostname]         the hostname of this process(def:localhost)\n" 
 " [-p |--platform type]         platform for loop(vrep, dronerk)\n" 
 " [-P |--period period]         time, in seconds, between control loop executions\n" 
+" [-pp|--profile-pipeline]      time algorithms and accents and log the\n"
+"                               timing when the loop ends\n"
 " [-q |--queue-length length]   length of transport queue in bytes\n" 
 " [-r |--reduced]               use the reduced message header\n" 
 " [-rhz|--read-hz hz]           hertz rate of read threads\n"
@@ -203,6 +214,122 @@ void handle_arguments(int argc, char ** argv)
 
       ++i;
     }
+    else if (arg1 == "-ar" || arg1 == "--adaptive-rates")
+    {
+      controller_settings.adaptive_rates = true;
+    }
+    else if (arg1 == "--adaptive-cpu-budget")
+    {
+      if (i + 1 < argc && argv[i + 1][0] != '-')
+      {
+        std::stringstream buffer(argv[i + 1]);
+        buffer >> controller_settings.cpu_budget;
+      }
+      else
+      {
+        print_usage(argv[0], argv[i]);
+      }
+
+      ++i;
+    }
+    else if (arg1 == "--adaptive-decay")
+    {
+      if (i + 1 < argc && argv[i + 1][0] != '-')
+      {
+        std::stringstream buffer(argv[i + 1]);
+        buffer >> controller_settings.adaptive_decay;
+      }
+      else
+      {
+        print_usage(argv[0], argv[i]);
+      }
+
+      ++i;
+    }
+    else if (arg1 == "--adaptive-max-loop-hertz")
+    {
+      if (i + 1 < argc && argv[i + 1][0] != '-')
+      {
+        std::stringstream buffer(argv[i + 1]);
+        buffer >> controller_settings.max_loop_hertz;
+      }
+      else
+      {
+        print_usage(argv[0], argv[i]);
+      }
+
+      ++i;
+    }
+    else if (arg1 == "--adaptive-max-records")
+    {
+      if (i + 1 < argc && argv[i + 1][0] != '-')
+      {
+        std::stringstream buffer(argv[i + 1]);
+        buffer >> controller_settings.max_send_records_per_second;
+      }
+      else
+      {
+        print_usage(argv[0], argv[i]);
+      }
+
+      ++i;
+    }
+    else if (arg1 == "--adaptive-max-send-hertz")
+    {
+      if (i + 1 < argc && argv[i + 1][0] != '-')
+      {
+        std::stringstream buffer(argv[i + 1]);
+        buffer >> controller_settings.max_send_hertz;
+      }
+      else
+      {
+        print_usage(argv[0], argv[i]);
+      }
+
+      ++i;
+    }
+    else if (arg1 == "--adaptive-min-loop-hertz")
+    {
+      if (i + 1 < argc && argv[i + 1][0] != '-')
+      {
+        std::stringstream buffer(argv[i + 1]);
+        buffer >> controller_settings.min_loop_hertz;
+      }
+      else
+      {
+        print_usage(argv[0], argv[i]);
+      }
+
+      ++i;
+    }
+    else if (arg1 == "--adaptive-min-send-hertz")
+    {
+      if (i + 1 < argc && argv[i + 1][0] != '-')
+      {
+        std::stringstream buffer(argv[i + 1]);
+        buffer >> controller_settings.min_send_hertz;
+      }
+      else
+      {
+        print_usage(argv[0], argv[i]);
+      }
+
+      ++i;
+    }
+    else if (arg1 == "--adaptive-smoothing")
+    {
+      if (i + 1 < argc && argv[i + 1][0] != '-')
+      {
+        std::stringstream buffer(argv[i + 1]);
+        buffer >> controller_settings.adaptive_smoothing;
+      }
+      else
+      {
+        print_usage(argv[0], argv[i]);
+      }
+
+      ++i;
+    }
     else if (arg1 == "-b" || arg1 == "--broadcast")
     {
       if (i + 1 < argc && argv[i + 1][0] != '-')
@@ -491,6 +618,10 @@ void handle_arguments(int argc, char ** argv)
 
       ++i;
     }
+    else if (arg1 == "-pp" || arg1 == "--profile-pipeline")
+    {
+      controller_settings.profile_pipeline = true;
+    }
     else if (arg1 == "-P" || arg1 == "--period")
     {
       if (i + 1 < argc && argv[i + 1][0] != '-')
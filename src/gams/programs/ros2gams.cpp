@@ -8,6 +8,12 @@
 #include <iostream>
 #include <string>
 #include <fstream>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
 
 #include "boost/filesystem.hpp"
 #include "yaml-cpp/yaml.h"
@@ -26,6 +32,7 @@
 #include "gams/pose/Pose.h"
 #include "gams/pose/Quaternion.h"
 #include "gams/utility/ros/RosParser.h"
+#include "gams/utility/IndexedStream.h"
 
 
 
@@ -90,11 +97,18 @@ std::string stream_file = "";
 //path to the manifest file
 std::string manifest_file = "";
 
+//path to the indexed stream file
+std::string indexed_stream_file = "";
+
 // save as a karl or binary file
 bool save_as_karl = false;
 bool save_as_json = false;
 bool save_as_binary = false;
 bool save_as_stream = false;
+bool save_as_indexed_stream = false;
+
+// seconds between keyframes of the indexed stream
+double keyframe_interval = 1.0;
 
 //Metadata in the checkpoints
 bool store_metadata = false;
@@ -116,6 +130,12 @@ bool same_file = false;
 // Delete existing files
 bool delete_existing = false;
 
+// number of parser threads (0 parses every message on the main thread)
+int parser_threads = 0;
+
+// maximum number of messages read ahead of the checkpoint writer
+size_t pipeline_depth = 1024;
+
 
 //Function definitions
 void delete_existing_file(std::string path, bool delete_existing);
@@ -123,6 +143,277 @@ int save_checkpoint(knowledge::KnowledgeBase *knowledge,
   knowledge::CheckpointSettings *settings, std::string meta_prefix="meta");
 std::string get_agent_var_prefix(std::string ros_topic_name);
 std::string gams::utility::ros::ros_to_gams_name(std::string topic_name);
+void prepare_parser(gams::utility::ros::RosParser & parser,
+  rosbag::View & view,
+  const std::map<std::string, std::map<std::string, std::string>> &
+    name_substitution_map,
+  const std::vector<std::string> & schema_files);
+bool drops_messages(const gams::utility::ros::TopicPolicy & policy);
+
+
+/**
+* A message read from the bag which waits to be committed to the knowledge
+* base in bag order
+**/
+struct PendingMessage
+{
+  PendingMessage(const rosbag::MessageInstance & m,
+    const std::string & name)
+    : message(m), topic(m.getTopic()), datatype(m.getDataType()),
+      container_name(name), parallel(false), plugin(false), stateless(false),
+      failed(false), done(false)
+  {
+  }
+
+  rosbag::MessageInstance message;
+  std::string topic;
+  std::string datatype;
+  std::string container_name;
+
+  // true if the message is converted by a parser worker
+  bool parallel;
+
+  // true if the message is converted by a thread safe plugin
+  bool plugin;
+
+  // true if the message has a built-in type that is parsed without
+  // reading the knowledge base
+  bool stateless;
+
+  // serialized message and the value converted by the parser worker
+  std::vector<uint8_t> buffer;
+  knowledge::KnowledgeRecord value;
+
+  // message and the values converted by a plugin or a stateless parser
+  topic_tools::ShapeShifter::ConstPtr shape;
+  gams::utility::ros::PluginOutput output;
+
+  // true if the worker could not convert the message
+  bool failed;
+  bool done;
+};
+
+typedef std::shared_ptr<PendingMessage> PendingMessagePtr;
+
+
+/**
+* Pool of parser threads which convert Any types, stateless built-in types
+* and run thread safe plugins in parallel. Every Any topic is bound to a
+* single worker, so the per topic state of a parser is never shared between
+* threads. Plugin and stateless messages have no parser state and are spread
+* over all workers, which parse them into their own knowledge base. The bag
+* is only read by the submitting thread.
+**/
+class ParserPool
+{
+public:
+  ParserPool(size_t threads, rosbag::View & view,
+    const std::map<std::string, std::string> & schema_map,
+    const std::map<std::string, std::pair<std::string, std::string>> &
+      plugin_map,
+    const std::map<std::string, std::map<std::string, std::string>> &
+      name_substitution_map,
+    const std::vector<std::string> & schema_files,
+    const std::map<std::string, gams::utility::ros::TopicPolicy> &
+      topic_policies);
+  ~ParserPool();
+
+  /**
+  * Serializes the message and queues it at the worker of its topic, or at
+  * the next worker if it is converted by a plugin or a stateless parser
+  **/
+  void submit(const PendingMessagePtr & message);
+
+  /**
+  * Checks if a submitted message was converted
+  **/
+  bool is_done(const PendingMessage & message);
+
+  /**
+  * Blocks until a submitted message was converted
+  **/
+  void wait(const PendingMessage & message);
+
+private:
+  struct Worker
+  {
+    knowledge::KnowledgeBase kb;
+    std::unique_ptr<gams::utility::ros::RosParser> parser;
+    std::deque<PendingMessagePtr> queue;
+    std::condition_variable queued;
+    std::thread thread;
+  };
+
+  void run(Worker & worker);
+
+  std::vector<std::unique_ptr<Worker>> workers_;
+  size_t next_worker_;
+  std::mutex mutex_;
+  std::condition_variable converted_;
+  bool terminated_;
+};
+
+
+ParserPool::ParserPool(size_t threads, rosbag::View & view,
+  const std::map<std::string, std::string> & schema_map,
+  const std::map<std::string, std::pair<std::string, std::string>> &
+    plugin_map,
+  const std::map<std::string, std::map<std::string, std::string>> &
+    name_substitution_map,
+  const std::vector<std::string> & schema_files,
+  const std::map<std::string, gams::utility::ros::TopicPolicy> &
+    topic_policies)
+  : next_worker_(0), terminated_(false)
+{
+  for (size_t i = 0; i < threads; ++i)
+  {
+    std::unique_ptr<Worker> worker(new Worker());
+
+    // the workers only convert Any types and stateless built-in types
+    // into their own knowledge base and run plugins with typed output.
+    // The policies only provide voxel sizes, messages are admitted by
+    // the main thread.
+    worker->parser.reset(new gams::utility::ros::RosParser(&worker->kb,
+      "", "", schema_map, plugin_map));
+    prepare_parser(*worker->parser, view, name_substitution_map,
+      schema_files);
+    worker->parser->set_topic_policies(topic_policies);
+    worker->parser->register_schemas();
+
+    // load the plugins before they are run from the thread
+    for (auto & plugin : plugin_map)
+    {
+      worker->parser->get_plugin_flags(plugin.first);
+    }
+
+    workers_.push_back(std::move(worker));
+  }
+
+  // start the threads once all schemas are registered
+  for (auto & worker : workers_)
+  {
+    worker->thread = std::thread(&ParserPool::run, this,
+      std::ref(*worker));
+  }
+}
+
+ParserPool::~ParserPool()
+{
+  {
+    std::lock_guard<std::mutex> guard(mutex_);
+    terminated_ = true;
+    for (auto & worker : workers_)
+    {
+      worker->queued.notify_one();
+    }
+  }
+
+  for (auto & worker : workers_)
+  {
+    worker->thread.join();
+  }
+}
+
+void ParserPool::submit(const PendingMessagePtr & message)
+{
+  message->parallel = true;
+  size_t index;
+  if (message->plugin || message->stateless)
+  {
+    message->shape =
+      message->message.instantiate<topic_tools::ShapeShifter>();
+    index = next_worker_++ % workers_.size();
+  }
+  else
+  {
+    message->buffer.resize(message->message.size());
+    ros::serialization::OStream stream(message->buffer.data(),
+      message->buffer.size());
+    message->message.write(stream);
+    index = std::hash<std::string>()(message->topic) % workers_.size();
+  }
+
+  Worker & worker = *workers_[index];
+
+  std::lock_guard<std::mutex> guard(mutex_);
+  worker.queue.push_back(message);
+  worker.queued.notify_one();
+}
+
+bool ParserPool::is_done(const PendingMessage & message)
+{
+  std::lock_guard<std::mutex> guard(mutex_);
+  return message.done;
+}
+
+void ParserPool::wait(const PendingMessage & message)
+{
+  std::unique_lock<std::mutex> lock(mutex_);
+  converted_.wait(lock, [&message] { return message.done; });
+}
+
+void ParserPool::run(Worker & worker)
+{
+  std::unique_lock<std::mutex> lock(mutex_);
+  while (true)
+  {
+    worker.queued.wait(lock,
+      [this, &worker] { return terminated_ || !worker.queue.empty(); });
+    if (worker.queue.empty())
+    {
+      // terminated and drained
+      return;
+    }
+    PendingMessagePtr message = worker.queue.front();
+    worker.queue.pop_front();
+    lock.unlock();
+
+    // the output is only read by the committing thread once done is set.
+    // A message that cannot be converted is skipped instead of ending
+    // the conversion.
+    knowledge::KnowledgeRecord value;
+    bool failed = false;
+    try
+    {
+      if (message->plugin)
+      {
+        worker.parser->run_plugin(message->datatype, *message->shape,
+          message->container_name, message->output);
+      }
+      else if (message->stateless)
+      {
+        worker.parser->parse_stateless(message->shape,
+          message->container_name, message->topic, message->output);
+      }
+      else
+      {
+        worker.parser->parse_any(message->datatype, message->topic,
+          message->buffer, message->container_name);
+        value = worker.kb.get(message->container_name);
+      }
+    }
+    catch (const std::exception & e)
+    {
+      std::cerr << "Skipping " << message->datatype << " message on " <<
+        message->topic << ": " << e.what() << std::endl;
+      failed = true;
+    }
+    catch (...)
+    {
+      std::cerr << "Skipping " << message->datatype << " message on " <<
+        message->topic << ": unknown exception" << std::endl;
+      failed = true;
+    }
+    message->shape.reset();
+    std::vector<uint8_t>().swap(message->buffer);
+
+    lock.lock();
+    message->value = value;
+    message->failed = failed;
+    message->done = true;
+    converted_.notify_all();
+  }
+}
 
 
 // handle command line arguments
@@ -163,6 +454,24 @@ void handle_arguments(int argc, char ** argv)
       }
       i++;
     }
+    else if (arg1 == "-is" || arg1 == "--indexed-stream")
+    {
+      if (i + 1 < argc)
+      {
+        indexed_stream_file = argv[i + 1];
+        save_as_indexed_stream = true;
+      }
+      i++;
+    }
+    else if (arg1 == "-kf" || arg1 == "--keyframe-interval")
+    {
+      if (i + 1 < argc)
+      {
+        std::stringstream buffer(argv[i + 1]);
+        buffer >> keyframe_interval;
+      }
+      i++;
+    }
     else if (arg1 == "-mp" || arg1 == "--manifest-path")
     {
       if (i + 1 < argc)
@@ -215,6 +524,22 @@ void handle_arguments(int argc, char ** argv)
       }
       ++i;
     }
+    else if (arg1 == "-t" || arg1 == "--threads")
+    {
+      if (i + 1 < argc)
+      {
+        parser_threads = std::stoi(argv[i + 1]);
+      }
+      i++;
+    }
+    else if (arg1 == "-pd" || arg1 == "--pipeline-depth")
+    {
+      if (i + 1 < argc)
+      {
+        pipeline_depth = std::stoul(argv[i + 1]);
+      }
+      i++;
+    }
     else if (arg1 == "-h" || arg1 == "--help")
     {
       std::cout << "\nProgram summary for ros2gams [options] [Logic]:\n\n" \
@@ -244,11 +569,23 @@ void handle_arguments(int argc, char ** argv)
       "                                       file - only for binary checkpoints\n" \
       "  [-ss|--save-size bytes]              size of buffer needed for file saves\n" \
       "  [-stk|--stream file]                 stream checkpoints to file\n"\
+      "  [-is|--indexed-stream file]          append checkpoints to a single\n" \
+      "                                       file with a keyframe index\n" \
+      "  [-kf|--keyframe-interval s]          seconds between keyframes of\n" \
+      "                                       the indexed stream (default: 1)\n" \
+      "  [-t|--threads n]                     parse mapped capnp types and\n" \
+      "                                       built-in types other than tf\n" \
+      "                                       and run thread safe plugins\n" \
+      "                                       with n parser threads\n" \
+      "                                       (default: 0)\n" \
+      "  [-pd|--pipeline-depth n]             messages read ahead of the\n" \
+      "                                       checkpoint writer (default: 1024)\n" \
       "  [-de|--delete-existing]              delete existing output files\n";
       exit(0);
     }
   }
-  if ( !save_as_binary && !save_as_json && !save_as_karl && !save_as_stream)
+  if ( !save_as_binary && !save_as_json && !save_as_karl && !save_as_stream &&
+    !save_as_indexed_stream)
   {
     // if no output format is selected -> save in karl format
     save_as_karl = true;
@@ -277,6 +614,7 @@ int main(int argc, char ** argv)
   std::map<std::string, std::string> schema_map;
   std::map<std::string, std::pair<std::string, std::string>> plugin_map;
   std::map<std::string, int> circular_variables;
+  std::map<std::string, gams::utility::ros::TopicPolicy> topic_policies;
   std::map<std::string, std::map<std::string, std::string>> name_substitution_map;
   std::string default_frame_prefix = ".gams.frames";
 
@@ -317,6 +655,34 @@ int main(int argc, char ** argv)
           circular_variables[var_name] =
             it->second["circular_buffer_size"].as<int>();
         }
+        if (it->second["policy"])
+        {
+          // Downsampling and rate limiting of this topic
+          YAML::Node node = it->second["policy"];
+          gams::utility::ros::TopicPolicy policy;
+          if (node["latest_only"])
+          {
+            policy.latest_only = node["latest_only"].as<bool>();
+          }
+          if (node["decimation"])
+          {
+            policy.decimation = node["decimation"].as<unsigned int>();
+          }
+          if (node["rate"] && node["rate"].as<double>() > 0)
+          {
+            policy.min_period =
+              uint64_t(1000000000 / node["rate"].as<double>());
+          }
+          if (node["voxel_size"])
+          {
+            policy.voxel_size = node["voxel_size"].as<double>();
+          }
+          if (node["average"])
+          {
+            policy.average = node["average"].as<bool>();
+          }
+          topic_policies[topic_name] = policy;
+        }
 
         selected_topics.push_back(topic_name);
         topic_map[topic_name] = var_name;
@@ -413,27 +779,24 @@ int main(int argc, char ** argv)
 
   gams::utility::ros::RosParser parser(&kb, world_frame, base_frame,
     schema_map, plugin_map, circular_variables);
+  prepare_parser(parser, view, name_substitution_map, schema_files);
+  parser.set_topic_policies(topic_policies);
+  parser.print_schemas();
 
-  // Register ros message types to prepare the parser's introspection features
-  for (const rosbag::ConnectionInfo* connection: view.getConnections() )
+  // Parse mapped capnp types, thread safe plugins and stateless built-in
+  // types in parallel if requested. TF messages and circular buffers
+  // depend on the state of the knowledge base and stay on the main thread,
+  // as do topics with a policy that drops messages before parsing.
+  std::unique_ptr<ParserPool> pool;
+  if (parser_threads > 0)
   {
-    const std::string  topic_name =  connection->topic;
-    const std::string  datatype   =  connection->datatype;
-    const std::string  definition =  connection->msg_def;
-    // register the type using the topic_name as identifier.
-    parser.registerMessageDefinition(topic_name,
-      RosIntrospection::ROSType(datatype), definition);
+    parser.register_schemas();
+    pool.reset(new ParserPool(parser_threads, view, schema_map,
+      plugin_map, name_substitution_map, schema_files, topic_policies));
+    std::cout << "Parsing with " << parser_threads << " threads." <<
+      std::endl;
   }
 
-  parser.register_rename_rules(name_substitution_map);
-
-  // Load the capnproto schemas
-  for (std::string path : schema_files)
-  {
-    parser.load_capn_schema(madara::utility::expand_envs(path));
-  }
-  parser.print_schemas();
-
   // Iterate the messages
   settings.initial_lamport_clock = 0;
   settings.last_lamport_clock = 0;
@@ -468,33 +831,52 @@ int main(int argc, char ** argv)
       madara::knowledge::CheckpointStreamer>(stream_settings, kb));
   }
 
-  // Iterate through all topics in the bagfile
-  std::cout << "Converting...\n";
-  float progress;
-  int message_index = 0;
-  int progress_bar_width = 70;
-  for (const rosbag::MessageInstance m: view)
+  // Attach the indexed stream, the knowledge base takes ownership
+  gams::utility::IndexedStreamWriter * indexed_stream = 0;
+  std::string indexed_stream_path = indexed_stream_file + ".gstk";
+  if (save_as_indexed_stream)
   {
-    std::string topic = m.getTopic();
-    ros::Time time = m.getTime();
-    std::string callerid = m.getCallerId();
-
-    //Check if topic is in the topic mapping
-    std::map<std::string, std::string>::iterator it = topic_map.find(topic);
-    std::string container_name;
+    if (save_as_stream)
+    {
+      std::cout << "Only one of -stk and -is can be used!" << std::endl;
+      exit(-1);
+    }
+    delete_existing_file(indexed_stream_path, delete_existing);
 
-    if (it != topic_map.end())
+    std::unique_ptr<gams::utility::IndexedStreamWriter> writer(
+      new gams::utility::IndexedStreamWriter(indexed_stream_path,
+        uint64_t(keyframe_interval * 1000000000), write_buffer_size));
+    if (!writer->is_open())
     {
-      container_name = it->second;
+      std::cout << "Failed to open " << indexed_stream_path << "!" <<
+        std::endl;
+      exit(-1);
     }
-    else
+    indexed_stream = writer.get();
+    kb.attach_streamer(std::move(writer));
+  }
+
+  // Writes the checkpoint files and appends a frame to the indexed stream
+  auto write_checkpoint = [&](uint64_t stamp)
+  {
+    int ret = save_checkpoint(&kb, &settings);
+    if (indexed_stream && indexed_stream->write_frame(stamp) == -1)
     {
-      container_name = get_agent_var_prefix(topic) + "." +
-        gams::utility::ros::ros_to_gams_name(topic);
+      ret = -1;
     }
-    parser.parse_message(m, container_name);
+    return ret;
+  };
 
+  // Iterate through all topics in the bagfile
+  std::cout << "Converting...\n";
+  float progress;
+  int message_index = 0;
+  int progress_bar_width = 70;
+  int last_percentage = -1;
 
+  // Writes the checkpoint of a message, or a final one if forced
+  auto checkpoint = [&](ros::Time time, bool force)
+  {
     //kb.print();
     std::stringstream id_ss;
     id_ss << std::setw(id_digit_count) << std::setfill('0') <<
@@ -519,19 +901,21 @@ int main(int argc, char ** argv)
       settings.initial_timestamp = settings.last_timestamp;
     }
 
-    // Save checkpoint
+    // Save checkpoint, latest_only topics are written with it
     int ret = 0;
     if ( checkpoint_frequency == 0 )
     {
       // Save checkpoint with each message
-      ret = save_checkpoint(&kb, &settings);
+      parser.flush_held();
+      ret = write_checkpoint(stamp);
       checkpoint_id++;
     }
     else if (last_checkpoint_timestamp + checkpoint_intervall < stamp ||
-      last_checkpoint_timestamp == 0)
+      last_checkpoint_timestamp == 0 || force)
     {
       // Save checkpoint with a given frequency
-      ret = save_checkpoint(&kb, &settings);
+      parser.flush_held();
+      ret = write_checkpoint(stamp);
       last_checkpoint_timestamp = stamp;
       checkpoint_id++;
     }
@@ -543,11 +927,47 @@ int main(int argc, char ** argv)
       exit(-1);
     }
     settings.last_lamport_clock += 1;
+  };
+
+  // Applies a message to the knowledge base and writes its checkpoint.
+  // Messages dropped by their topic policy write no checkpoint.
+  auto commit = [&](PendingMessage & message)
+  {
+    ros::Time time = message.message.getTime();
+
+    bool written = true;
+    if (message.failed)
+    {
+      written = false;
+    }
+    else if (message.plugin || message.stateless)
+    {
+      parser.apply_plugin_output(time, message.output);
+    }
+    else if (message.parallel)
+    {
+      parser.apply_parsed(time, message.container_name, message.value);
+    }
+    else
+    {
+      written = parser.parse_message(message.message,
+        message.container_name);
+    }
+
+    if (written)
+    {
+      checkpoint(time, false);
+    }
 
-    // Printing the progress bar
+    // Printing the progress bar, redrawn only if the percentage changes
     // See https://stackoverflow.com/questions/14539867/how-to-display-a-progress-indicator-in-pure-c-c-cout-printf
     message_index++;
     progress = message_index / float(view.size());
+    if (int(progress * 100.0) == last_percentage)
+    {
+      return;
+    }
+    last_percentage = int(progress * 100.0);
     std::cout << "[";
     int pos = progress_bar_width * progress;
     for (int i = 0; i < progress_bar_width; ++i) {
@@ -564,9 +984,97 @@ int main(int argc, char ** argv)
           std::cout << " ";
         }
     }
-    std::cout << "] " << int(progress * 100.0) << " % " << message_index << "/"
+    std::cout << "] " << last_percentage << " % " << message_index << "/"
       << view.size() << "\r";
     std::cout.flush();
+  };
+
+  // Messages are committed in bag order. Messages converted by the parser
+  // pool are committed as soon as they and all their predecessors are done.
+  std::deque<PendingMessagePtr> pending;
+  for (const rosbag::MessageInstance m: view)
+  {
+    std::string topic = m.getTopic();
+
+    //Check if topic is in the topic mapping
+    std::map<std::string, std::string>::iterator it = topic_map.find(topic);
+    std::string container_name;
+
+    if (it != topic_map.end())
+    {
+      container_name = it->second;
+    }
+    else
+    {
+      container_name = get_agent_var_prefix(topic) + "." +
+        gams::utility::ros::ros_to_gams_name(topic);
+    }
+
+    PendingMessagePtr message(new PendingMessage(m, container_name));
+    auto policy = topic_policies.find(topic);
+    if (pool &&
+      circular_variables.find(container_name) == circular_variables.end() &&
+      (policy == topic_policies.end() || !drops_messages(policy->second)))
+    {
+      const unsigned int parallel_plugin =
+        gams::utility::ros::PLUGIN_TYPED_OUTPUT |
+        gams::utility::ros::PLUGIN_THREAD_SAFE;
+      // mapped capnp types take precedence over plugins, which take
+      // precedence over built-in types
+      const bool mapped =
+        schema_map.find(message->datatype) != schema_map.end();
+      message->plugin = !mapped &&
+        (parser.get_plugin_flags(message->datatype) & parallel_plugin) ==
+          parallel_plugin;
+      message->stateless = !mapped &&
+        plugin_map.find(message->datatype) == plugin_map.end() &&
+        gams::utility::ros::RosParser::is_stateless(message->datatype);
+
+      if (mapped || message->plugin || message->stateless)
+      {
+        pool->submit(message);
+      }
+    }
+    pending.push_back(message);
+
+    while (!pending.empty())
+    {
+      PendingMessage & next = *pending.front();
+      if (next.parallel && !pool->is_done(next))
+      {
+        if (pending.size() <= pipeline_depth)
+        {
+          break;
+        }
+        pool->wait(next);
+      }
+      commit(next);
+      pending.pop_front();
+    }
+  }
+
+  // Commit the remaining messages
+  for (PendingMessagePtr & message : pending)
+  {
+    if (message->parallel)
+    {
+      pool->wait(*message);
+    }
+    commit(*message);
+  }
+  pending.clear();
+  pool.reset();
+
+  // write the messages still held by latest_only topics
+  if (parser.has_held())
+  {
+    checkpoint(view.getEndTime(), true);
+  }
+
+  if (indexed_stream && indexed_stream->close() == -1)
+  {
+    std::cout << "Failed to write " << indexed_stream_path << "!" << std::endl;
+    exit(-1);
   }
   std::cout << std::endl << "done" << std::endl;
   
@@ -591,6 +1099,12 @@ int main(int argc, char ** argv)
       manifest.set("size", 
         boost::filesystem::file_size(stream_settings.filename));
     }
+    if (indexed_stream)
+    {
+      manifest.set("size",
+        boost::filesystem::file_size(indexed_stream_path));
+      manifest.set("keyframes", (Integer) indexed_stream->index().size());
+    }
     manifest.save_as_karl(manifest_file + ".mf");
   }
 }
@@ -651,6 +1165,48 @@ int save_checkpoint(knowledge::KnowledgeBase * knowledge,
 }
 
 
+/**
+* Checks if a policy holds or drops messages, which has to be decided in
+* bag order on the main thread
+**/
+bool drops_messages(const gams::utility::ros::TopicPolicy & policy)
+{
+  return policy.latest_only || policy.decimation > 1 ||
+    policy.min_period > 0 || policy.average;
+}
+
+
+/**
+* Registers the message definitions, rename rules and capnproto schemas
+* with a parser
+**/
+void prepare_parser(gams::utility::ros::RosParser & parser,
+  rosbag::View & view,
+  const std::map<std::string, std::map<std::string, std::string>> &
+    name_substitution_map,
+  const std::vector<std::string> & schema_files)
+{
+  // Register ros message types to prepare the parser's introspection features
+  for (const rosbag::ConnectionInfo* connection: view.getConnections() )
+  {
+    const std::string  topic_name =  connection->topic;
+    const std::string  datatype   =  connection->datatype;
+    const std::string  definition =  connection->msg_def;
+    // register the type using the topic_name as identifier.
+    parser.registerMessageDefinition(topic_name,
+      RosIntrospection::ROSType(datatype), definition);
+  }
+
+  parser.register_rename_rules(name_substitution_map);
+
+  // Load the capnproto schemas
+  for (std::string path : schema_files)
+  {
+    parser.load_capn_schema(madara::utility::expand_envs(path));
+  }
+}
+
+
 /**
 * Parses the agent id based on the rostopic name
 **/
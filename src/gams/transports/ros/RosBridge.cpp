@@ -5,13 +5,19 @@
 
 namespace knowledge = madara::knowledge;
 
+// maximum number of memoized key resolutions
+#define MAX_RESOLVED_KEYS 100000
+
 gams::transports::RosBridge::RosBridge(
   const std::string & id,
   madara::transport::TransportSettings & new_settings,
   knowledge::KnowledgeBase & knowledge,
   std::vector<std::string> topics,
   std::map<std::string,std::string> topic_map,
-  std::map<std::string, std::string> pub_topic_types)
+  std::map<std::string, std::string> pub_topic_types,
+  std::map<std::string, gams::utility::ros::TopicPolicy> topic_policies,
+  std::map<std::string, std::string> capnp_types,
+  std::vector<std::string> schema_files)
 : madara::transport::Base(id, new_settings, knowledge.get_context()),
   topics_(topics), topic_map_(topic_map), pub_topic_types_(pub_topic_types),
   message_count_(0)
@@ -25,6 +31,12 @@ gams::transports::RosBridge::RosBridge(
   ros::NodeHandle node;
 
   parser_ = new gams::utility::ros::GamsParser(&knowledge);
+
+  // index the published containers by name, the first topic wins
+  for (auto & topic : topic_map_)
+  {
+    container_topics_.insert(std::make_pair(topic.second, topic.first));
+  }
   
   // set the data plane for read threads
   read_threads_.set_data_plane(knowledge);
@@ -44,7 +56,7 @@ gams::transports::RosBridge::RosBridge(
   read_thread_ = new RosBridgeReadThread(
       id_, new_settings, 
       send_monitor_, receive_monitor_, packet_scheduler_,
-      topics_, topic_map_);
+      topics_, topic_map_, topic_policies, capnp_types, schema_files);
   // start the thread at the specified hertz
   read_threads_.run(
     hertz,
@@ -54,7 +66,7 @@ gams::transports::RosBridge::RosBridge(
 
 gams::transports::RosBridge::~RosBridge()
 {
-  delete[] parser_;
+  delete parser_;
 }
 
 long
@@ -63,59 +75,83 @@ gams::transports::RosBridge::send_data(
 {
   long result(0);
 
+  // Group the modified keys, so that each topic is serialized once per
+  // batch no matter how many of its fields changed
+  std::set<std::pair<std::string, std::string>> messages;
+  std::set<std::pair<std::string, std::string>> transforms;
+
   for (
     madara::knowledge::KnowledgeMap::const_iterator it = modifieds.begin();
     it != modifieds.end(); it++)
   {
-    const char * key = it->first.c_str();
-    std::pair<std::string, std::string> names = get_update_container_pair_(key);
+    const std::pair<std::string, std::string> & names =
+      get_update_container_pair_(it->first);
 
     if (names.first != "")
     {
-      std::map<std::string, std::string>::iterator type_it =
-        pub_topic_types_.find(names.first);
-      if (type_it != pub_topic_types_.end())
+      if (pub_topic_types_.find(names.first) != pub_topic_types_.end())
       {
-        parser_->parse_message(names.second, names.first, type_it->second);
-        message_count_++;
+        messages.insert(names);
       }
       else if (names.first == "/tf")
       {
-        std::string frame_name = std::string(key).substr(
-          names.second.length()+1);
+        std::string frame_name = it->first.substr(names.second.length()+1);
         frame_name = frame_name.substr(0, frame_name.find("."));
-        message_count_ += parser_->publish_transform(frame_name, names.second);
+        transforms.insert(std::make_pair(frame_name, names.second));
       }
     }
   }
+
+  for (auto & message : messages)
+  {
+    parser_->parse_message(message.second, message.first,
+      pub_topic_types_[message.first]);
+    message_count_++;
+  }
+
+  for (auto & transform : transforms)
+  {
+    message_count_ +=
+      parser_->publish_transform(transform.first, transform.second);
+  }
   return result;
 }
 
-std::pair<std::string, std::string>
+const std::pair<std::string, std::string> &
 gams::transports::RosBridge::get_update_container_pair_(
-  const char * container_name)
+  const std::string & container_name)
 {
+  auto resolved = resolved_keys_.find(container_name);
+  if (resolved != resolved_keys_.end())
+  {
+    return resolved->second;
+  }
+
+  if (resolved_keys_.size() >= MAX_RESOLVED_KEYS)
+  {
+    resolved_keys_.clear();
+  }
+
+  // find the longest published container that prefixes the key
+  std::pair<std::string, std::string> & names =
+    resolved_keys_[container_name];
   std::string current_key = container_name;
   while ( true )
   {
-    std::map<std::string, std::string>::iterator top_it;
-    std::string container;
-    for (top_it = topic_map_.begin(); top_it != topic_map_.end(); ++top_it)
+    auto container = container_topics_.find(current_key);
+    if (container != container_topics_.end())
     {
-      if (top_it->second == current_key)
-      {
-        container = top_it->second;
-        return std::make_pair(top_it->first, top_it->second);
-      }
+      names = std::make_pair(container->second, container->first);
+      break;
     }
     size_t delim_pos = current_key.find_last_of('.');
     if (delim_pos == std::string::npos)
     {
       break;
     }
-    current_key = current_key.substr(0, delim_pos);
+    current_key.resize(delim_pos);
   }
-  return std::make_pair("", "");
+  return names;
 }
 
 unsigned int gams::transports::RosBridge::in_message_count()
@@ -2,6 +2,9 @@
 #ifndef   _TRANSPORT_ROSBRIDGE_H_
 #define   _TRANSPORT_ROSBRIDGE_H_
 
+#include <set>
+#include <unordered_map>
+
 #include "madara/transport/Transport.h"
 #include "madara/threads/Threader.h"
 #include "RosBridgeReadThread.h"
@@ -25,13 +28,24 @@ namespace gams
        * @param   topics            vector of topics to subscribe
        * @param   topic_map         map from ros topic name to madara var name
        * @param   pub_topic_types   map from ros topic name to ros topic type
+       * @param   topic_policies    downsampling and rate limiting policies
+       *                            of received topics by ros topic name
+       * @param   capnp_types       map from ros topic type to the capnp
+       *                            schema its messages are stored as
+       * @param   schema_files      paths of binary capnp schemas to load
        **/
       RosBridge(const std::string & id,
         madara::transport::TransportSettings & new_settings,
         madara::knowledge::KnowledgeBase & context,
         std::vector<std::string> topics,
         std::map<std::string, std::string> topic_map,
-        std::map<std::string, std::string> pub_topic_types);
+        std::map<std::string, std::string> pub_topic_types,
+        std::map<std::string, gams::utility::ros::TopicPolicy>
+          topic_policies =
+            std::map<std::string, gams::utility::ros::TopicPolicy>(),
+        std::map<std::string, std::string> capnp_types =
+          std::map<std::string, std::string>(),
+        std::vector<std::string> schema_files = std::vector<std::string>());
 
       /**
        * Destructor
@@ -63,8 +77,20 @@ namespace gams
       std::map<std::string, std::string> pub_topic_types_;
       gams::utility::ros::GamsParser * parser_;
 
-      std::pair<std::string, std::string> get_update_container_pair_(
-        const char * container_name);
+      /**
+       * Resolves a modified key to its publish topic and container
+       * @param  container_name  the modified key
+       * @return (topic, container) or empty strings if not published
+       **/
+      const std::pair<std::string, std::string> & get_update_container_pair_(
+        const std::string & container_name);
+
+      // Container name to topic, built from topic_map_
+      std::unordered_map<std::string, std::string> container_topics_;
+
+      // Memoized results of get_update_container_pair_ by key
+      std::unordered_map<std::string,
+        std::pair<std::string, std::string>> resolved_keys_;
       
       unsigned int message_count_;
     };
@@ -1,6 +1,8 @@
 
 #include "gams/loggers/GlobalLogger.h"
 #include "RosBridgeReadThread.h"
+#include "madara/knowledge/ContextGuard.h"
+#include "madara/utility/Utility.h"
 
 namespace knowledge = madara::knowledge;
 
@@ -9,7 +11,10 @@ void gams::transports::RosBridgeReadThread::messageCallback(
   const topic_tools::ShapeShifter::ConstPtr& msg,
   const std::string &topic_name )
 {
-  std::cout << "CALLBACK FROM "  << topic_name << " <" << msg->getDataType() << "> " << msg << std::endl;
+  madara_logger_ptr_log(gams::loggers::global_logger.get(),
+    gams::loggers::LOG_DETAILED,
+    "gams::transports::RosBridgeReadThread::messageCallback:" \
+    " received %s <%s>\n", topic_name.c_str(), msg->getDataType().c_str());
   message_count_++;
   //std::string container = gams::utility::ros::ros_to_gams_name(topic_name);
   //Check if topic is in the topic mapping
@@ -25,7 +30,17 @@ void gams::transports::RosBridgeReadThread::messageCallback(
     container = gams::utility::ros::ros_to_gams_name(topic_name);
   }
 
-  parser_->parse_message(msg, container);
+  // capnp types are introspected, which needs the message definition.
+  // Subscribed topics only provide it with their first message.
+  if (capnp_types_.find(msg->getDataType()) != capnp_types_.end() &&
+    defined_topics_.insert(topic_name).second)
+  {
+    parser_->registerMessageDefinition(topic_name,
+      RosIntrospection::ROSType(msg->getDataType()),
+      msg->getMessageDefinition());
+  }
+
+  parser_->parse_message(msg, container, topic_name);
 }
 
 // constructor
@@ -36,12 +51,18 @@ gams::transports::RosBridgeReadThread::RosBridgeReadThread(
   madara::transport::BandwidthMonitor & receive_monitor,
   madara::transport::PacketScheduler & packet_scheduler,
   std::vector<std::string> topics,
-  std::map<std::string,std::string> topic_map)
+  std::map<std::string,std::string> topic_map,
+  std::map<std::string, gams::utility::ros::TopicPolicy> topic_policies,
+  std::map<std::string, std::string> capnp_types,
+  std::vector<std::string> schema_files)
 : send_monitor_(send_monitor),
   receive_monitor_(receive_monitor),
   packet_scheduler_(packet_scheduler),
   topics_(topics),
   topic_map_(topic_map),
+  topic_policies_(topic_policies),
+  capnp_types_(capnp_types),
+  schema_files_(schema_files),
   message_count_(0)
 {
 }
@@ -49,7 +70,7 @@ gams::transports::RosBridgeReadThread::RosBridgeReadThread(
 // destructor
 gams::transports::RosBridgeReadThread::~RosBridgeReadThread()
 {
-  delete[] parser_;
+  delete parser_;
 }
 
 /**
@@ -72,21 +93,30 @@ gams::transports::RosBridgeReadThread::init(knowledge::KnowledgeBase & knowledge
 
   std::map<std::string, std::string>::iterator frame_prefix =
     topic_map_.find("/tf");
-  std::map<std::string, std::string> capnp_types;
   std::map<std::string, std::pair<std::string, std::string>> plugin_types;
   std::map<std::string, int> circular_prefs;
   knowledge::EvalSettings eval_settings(true, true, false, false, false);
   if (frame_prefix != topic_map_.end())
   {
     parser_ = new gams::utility::ros::RosParser(&knowledge, "world", "frame1",
-      capnp_types, plugin_types, circular_prefs, eval_settings,
+      capnp_types_, plugin_types, circular_prefs, eval_settings,
       frame_prefix->second);
   }
   else
   {
     parser_ = new gams::utility::ros::RosParser(&knowledge, "world", "frame1",
-      capnp_types, plugin_types, circular_prefs, eval_settings);
+      capnp_types_, plugin_types, circular_prefs, eval_settings);
+  }
+
+  // load the schemas of the mapped capnp types
+  for (const std::string & path : schema_files_)
+  {
+    parser_->load_capn_schema(madara::utility::expand_envs(path));
   }
+  parser_->register_schemas();
+
+  // policies drop or hold messages before they are parsed
+  parser_->set_topic_policies(topic_policies_);
 
   for (const std::string topic_name: topics_ )
   {
@@ -105,7 +135,12 @@ gams::transports::RosBridgeReadThread::init(knowledge::KnowledgeBase & knowledge
 void
 gams::transports::RosBridgeReadThread::run(void)
 {
+  // all callbacks of this spin update the knowledge base under one lock
+  madara::knowledge::ContextGuard guard(*context_);
   ros::spinOnce();
+
+  // topics with a latest_only policy write once per spin
+  parser_->flush_held();
 }
 
 unsigned int gams::transports::RosBridgeReadThread::message_count()
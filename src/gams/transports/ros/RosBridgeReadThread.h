@@ -2,6 +2,7 @@
 #ifndef   _TRANSPORT_ROSBRIDGEREADTHREAD_H_
 #define   _TRANSPORT_ROSBRIDGEREADTHREAD_H_
 
+#include <set>
 #include <string>
 
 #include "madara/threads/BaseThread.h"
@@ -42,7 +43,13 @@ namespace gams
         madara::transport::BandwidthMonitor & receive_monitor,
         madara::transport::PacketScheduler & packet_scheduler,
         std::vector<std::string> topics,
-        std::map<std::string,std::string> topic_map);
+        std::map<std::string,std::string> topic_map,
+        std::map<std::string, gams::utility::ros::TopicPolicy>
+          topic_policies =
+            std::map<std::string, gams::utility::ros::TopicPolicy>(),
+        std::map<std::string, std::string> capnp_types =
+          std::map<std::string, std::string>(),
+        std::vector<std::string> schema_files = std::vector<std::string>());
       
       /**
        * Destructor
@@ -98,6 +105,14 @@ namespace gams
       std::vector<std::string> topics_;
       // Topic map
       std::map<std::string,std::string> topic_map_;
+      // Downsampling and rate limiting policies by topic
+      std::map<std::string, gams::utility::ros::TopicPolicy> topic_policies_;
+      // Capnp schema names by ros type
+      std::map<std::string, std::string> capnp_types_;
+      // Binary capnp schemas to load
+      std::vector<std::string> schema_files_;
+      // Topics whose message definitions are registered with the parser
+      std::set<std::string> defined_topics_;
 
       unsigned int message_count_;
 
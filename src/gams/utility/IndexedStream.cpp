@@ -0,0 +1,415 @@
+/**
+ * Copyright (c) 2019 James Edmondson. All Rights Reserved.
+ *
+ **/
+
+/**
+ * @file IndexedStream.cpp
+ * @author James Edmondson <jedmondson@gmail.com>
+ *
+ * This file contains a single-file stream of timestamped knowledge base
+ * updates with a keyframe index for seeking
+ **/
+
+#include "IndexedStream.h"
+#include "gams/loggers/GlobalLogger.h"
+
+#include <algorithm>
+#include <cstring>
+
+// The file starts with STREAM_MAGIC, followed by frames and the index.
+// A frame is a header (type, timestamp, payload size, record count) and
+// the encoded records. The index is a list of keyframe timestamps and
+// offsets, followed by a trailer (index offset, entry count, INDEX_MAGIC).
+#define STREAM_MAGIC "GAMSSTK1"
+#define INDEX_MAGIC "GSTKINDX"
+#define MAGIC_SIZE 8
+#define FRAME_HEADER_SIZE 24
+#define INDEX_ENTRY_SIZE 16
+#define TRAILER_SIZE 24
+
+// frame types
+#define FRAME_UPDATES 0
+#define FRAME_KEYFRAME 1
+
+namespace
+{
+  template <typename T>
+  void encode_value (char * buffer, T value)
+  {
+    memcpy (buffer, &value, sizeof (T));
+  }
+
+  template <typename T>
+  T decode_value (const char * buffer)
+  {
+    T value;
+    memcpy (&value, buffer, sizeof (T));
+    return value;
+  }
+}
+
+gams::utility::IndexedStreamWriter::IndexedStreamWriter (
+  const std::string & filename, uint64_t keyframe_interval,
+  size_t buffer_size)
+  : buffer_size_ (buffer_size), keyframe_interval_ (keyframe_interval)
+{
+  file_.open (filename.c_str (),
+    std::ios::out | std::ios::binary | std::ios::trunc);
+
+  if (!file_)
+  {
+    madara_logger_ptr_log (gams::loggers::global_logger.get (),
+      gams::loggers::LOG_ERROR,
+      "gams::utility::IndexedStreamWriter::constructor: " \
+      "ERROR: unable to open %s\n", filename.c_str ());
+    closed_ = true;
+    return;
+  }
+
+  buffer_.reserve (buffer_size_ + buffer_size_ / 4);
+  buffer_.insert (buffer_.end (), STREAM_MAGIC, STREAM_MAGIC + MAGIC_SIZE);
+  offset_ = MAGIC_SIZE;
+}
+
+gams::utility::IndexedStreamWriter::~IndexedStreamWriter ()
+{
+  close ();
+}
+
+bool
+gams::utility::IndexedStreamWriter::is_open (void) const
+{
+  return !closed_;
+}
+
+void
+gams::utility::IndexedStreamWriter::enqueue (const char * name,
+  const madara::knowledge::KnowledgeRecord & record)
+{
+  std::lock_guard<std::mutex> guard (mutex_);
+  pending_[name] = record;
+}
+
+int
+gams::utility::IndexedStreamWriter::write_frame (uint64_t timestamp)
+{
+  std::lock_guard<std::mutex> guard (mutex_);
+
+  if (closed_)
+  {
+    return -1;
+  }
+
+  for (auto & update : pending_)
+  {
+    state_[update.first] = update.second;
+  }
+
+  if (index_.empty () ||
+    timestamp >= index_.back ().timestamp + keyframe_interval_)
+  {
+    index_.push_back (IndexedStreamEntry {timestamp, offset_});
+    encode_frame (FRAME_KEYFRAME, timestamp, state_);
+  }
+  else
+  {
+    encode_frame (FRAME_UPDATES, timestamp, pending_);
+  }
+
+  pending_.clear ();
+  ++frames_;
+
+  if (buffer_.size () >= buffer_size_)
+  {
+    return flush ();
+  }
+  return 0;
+}
+
+int
+gams::utility::IndexedStreamWriter::close (void)
+{
+  std::lock_guard<std::mutex> guard (mutex_);
+
+  if (closed_)
+  {
+    return 0;
+  }
+  closed_ = true;
+
+  const uint64_t index_offset = offset_;
+  size_t pos = buffer_.size ();
+  buffer_.resize (pos + index_.size () * INDEX_ENTRY_SIZE + TRAILER_SIZE);
+
+  for (const IndexedStreamEntry & entry : index_)
+  {
+    encode_value (buffer_.data () + pos, entry.timestamp);
+    encode_value (buffer_.data () + pos + 8, entry.offset);
+    pos += INDEX_ENTRY_SIZE;
+  }
+
+  encode_value (buffer_.data () + pos, index_offset);
+  encode_value (buffer_.data () + pos + 8, (uint64_t)index_.size ());
+  memcpy (buffer_.data () + pos + 16, INDEX_MAGIC, MAGIC_SIZE);
+
+  int result = flush ();
+  file_.close ();
+
+  madara_logger_ptr_log (gams::loggers::global_logger.get (),
+    gams::loggers::LOG_MAJOR,
+    "gams::utility::IndexedStreamWriter::close: " \
+    "wrote %d frames with %d keyframes\n",
+    (int)frames_, (int)index_.size ());
+
+  return result;
+}
+
+size_t
+gams::utility::IndexedStreamWriter::frames (void) const
+{
+  return frames_;
+}
+
+const std::vector<gams::utility::IndexedStreamEntry> &
+gams::utility::IndexedStreamWriter::index (void) const
+{
+  return index_;
+}
+
+void
+gams::utility::IndexedStreamWriter::encode_frame (uint32_t type,
+  uint64_t timestamp, const madara::knowledge::KnowledgeMap & records)
+{
+  const size_t start = buffer_.size ();
+  buffer_.resize (start + FRAME_HEADER_SIZE);
+
+  for (auto & record : records)
+  {
+    int64_t size = record.second.get_encoded_size (record.first);
+    size_t pos = buffer_.size ();
+    buffer_.resize (pos + size);
+    record.second.write (buffer_.data () + pos, record.first, size);
+
+    // size now holds the unused bytes
+    buffer_.resize (buffer_.size () - size);
+  }
+
+  const uint64_t payload = buffer_.size () - start - FRAME_HEADER_SIZE;
+  char * header = buffer_.data () + start;
+  encode_value (header, type);
+  encode_value (header + 4, timestamp);
+  encode_value (header + 12, payload);
+  encode_value (header + 20, (uint32_t)records.size ());
+
+  offset_ += FRAME_HEADER_SIZE + payload;
+}
+
+int
+gams::utility::IndexedStreamWriter::flush (void)
+{
+  file_.write (buffer_.data (), buffer_.size ());
+  buffer_.clear ();
+
+  if (!file_)
+  {
+    madara_logger_ptr_log (gams::loggers::global_logger.get (),
+      gams::loggers::LOG_ERROR,
+      "gams::utility::IndexedStreamWriter::flush: " \
+      "ERROR: unable to write frames\n");
+    return -1;
+  }
+  return 0;
+}
+
+gams::utility::IndexedStreamReader::IndexedStreamReader (
+  const std::string & filename, size_t buffer_size)
+  : file_buffer_ (buffer_size)
+{
+  file_.rdbuf ()->pubsetbuf (file_buffer_.data (), file_buffer_.size ());
+  file_.open (filename.c_str (), std::ios::in | std::ios::binary);
+
+  char magic[MAGIC_SIZE];
+  if (!file_.read (magic, MAGIC_SIZE) ||
+    memcmp (magic, STREAM_MAGIC, MAGIC_SIZE) != 0)
+  {
+    madara_logger_ptr_log (gams::loggers::global_logger.get (),
+      gams::loggers::LOG_ERROR,
+      "gams::utility::IndexedStreamReader::constructor: " \
+      "ERROR: %s is not an indexed stream\n", filename.c_str ());
+    return;
+  }
+  open_ = true;
+
+  file_.seekg (0, std::ios::end);
+  const uint64_t size = file_.tellg ();
+
+  // read the index through the trailer
+  char trailer[TRAILER_SIZE] = {};
+  if (size >= MAGIC_SIZE + TRAILER_SIZE)
+  {
+    file_.seekg (size - TRAILER_SIZE);
+    file_.read (trailer, TRAILER_SIZE);
+  }
+
+  const uint64_t index_offset = decode_value<uint64_t> (trailer);
+  const uint64_t count = decode_value<uint64_t> (trailer + 8);
+
+  if (file_ && size >= MAGIC_SIZE + TRAILER_SIZE &&
+    memcmp (trailer + 16, INDEX_MAGIC, MAGIC_SIZE) == 0 &&
+    index_offset + count * INDEX_ENTRY_SIZE + TRAILER_SIZE == size)
+  {
+    std::vector<char> entries (count * INDEX_ENTRY_SIZE);
+    file_.seekg (index_offset);
+    file_.read (entries.data (), entries.size ());
+
+    index_.resize (count);
+    for (uint64_t i = 0; i < count; ++i)
+    {
+      index_[i].timestamp =
+        decode_value<uint64_t> (entries.data () + i * INDEX_ENTRY_SIZE);
+      index_[i].offset =
+        decode_value<uint64_t> (entries.data () + i * INDEX_ENTRY_SIZE + 8);
+    }
+    end_ = index_offset;
+  }
+  else
+  {
+    madara_logger_ptr_log (gams::loggers::global_logger.get (),
+      gams::loggers::LOG_MAJOR,
+      "gams::utility::IndexedStreamReader::constructor: " \
+      "%s has no index, scanning frames\n", filename.c_str ());
+
+    file_.clear ();
+    end_ = size;
+    scan ();
+  }
+
+  file_.clear ();
+  file_.seekg (MAGIC_SIZE);
+}
+
+bool
+gams::utility::IndexedStreamReader::is_open (void) const
+{
+  return open_;
+}
+
+bool
+gams::utility::IndexedStreamReader::seek (uint64_t timestamp)
+{
+  auto keyframe = std::upper_bound (index_.begin (), index_.end (),
+    timestamp, [] (uint64_t time, const IndexedStreamEntry & entry)
+    {
+      return time < entry.timestamp;
+    });
+
+  if (keyframe == index_.begin ())
+  {
+    return false;
+  }
+  --keyframe;
+
+  file_.clear ();
+  file_.seekg (keyframe->offset);
+  return true;
+}
+
+bool
+gams::utility::IndexedStreamReader::next (uint64_t & timestamp,
+  madara::knowledge::KnowledgeMap & records, bool & keyframe)
+{
+  records.clear ();
+
+  if (!open_ || (uint64_t)file_.tellg () + FRAME_HEADER_SIZE > end_)
+  {
+    return false;
+  }
+
+  char header[FRAME_HEADER_SIZE];
+  if (!file_.read (header, FRAME_HEADER_SIZE))
+  {
+    return false;
+  }
+
+  keyframe = decode_value<uint32_t> (header) == FRAME_KEYFRAME;
+  timestamp = decode_value<uint64_t> (header + 4);
+  int64_t remaining = decode_value<uint64_t> (header + 12);
+  const uint32_t count = decode_value<uint32_t> (header + 20);
+
+  frame_.resize (remaining);
+  if (!file_.read (frame_.data (), remaining))
+  {
+    return false;
+  }
+
+  const char * current = frame_.data ();
+  std::string key;
+  for (uint32_t i = 0; i < count && current && remaining > 0; ++i)
+  {
+    madara::knowledge::KnowledgeRecord record;
+    current = record.read (current, key, remaining);
+    records[key] = record;
+  }
+  return true;
+}
+
+size_t
+gams::utility::IndexedStreamReader::load (
+  madara::knowledge::KnowledgeBase & knowledge, uint64_t timestamp)
+{
+  size_t applied = 0;
+
+  if (!seek (timestamp))
+  {
+    return applied;
+  }
+
+  uint64_t time;
+  bool keyframe;
+  madara::knowledge::KnowledgeMap records;
+  while (next (time, records, keyframe) && time <= timestamp)
+  {
+    for (auto & record : records)
+    {
+      knowledge.set (knowledge.get_ref (record.first), record.second);
+    }
+    ++applied;
+  }
+  return applied;
+}
+
+const std::vector<gams::utility::IndexedStreamEntry> &
+gams::utility::IndexedStreamReader::index (void) const
+{
+  return index_;
+}
+
+void
+gams::utility::IndexedStreamReader::scan (void)
+{
+  uint64_t offset = MAGIC_SIZE;
+  char header[FRAME_HEADER_SIZE];
+
+  file_.seekg (offset);
+  while (offset + FRAME_HEADER_SIZE <= end_ &&
+    file_.read (header, FRAME_HEADER_SIZE))
+  {
+    const uint64_t payload = decode_value<uint64_t> (header + 12);
+    if (offset + FRAME_HEADER_SIZE + payload > end_)
+    {
+      // the last frame was not completely written
+      break;
+    }
+
+    if (decode_value<uint32_t> (header) == FRAME_KEYFRAME)
+    {
+      index_.push_back (IndexedStreamEntry {
+        decode_value<uint64_t> (header + 4), offset});
+    }
+
+    offset += FRAME_HEADER_SIZE + payload;
+    file_.seekg (offset);
+  }
+  end_ = offset;
+}
@@ -0,0 +1,235 @@
+/**
+ * Copyright (c) 2019 James Edmondson. All Rights Reserved.
+ *
+ **/
+
+/**
+ * @file IndexedStream.h
+ * @author James Edmondson <jedmondson@gmail.com>
+ *
+ * This file contains a single-file stream of timestamped knowledge base
+ * updates with a keyframe index for seeking
+ **/
+
+#ifndef _GAMS_UTILITY_INDEXED_STREAM_H_
+#define _GAMS_UTILITY_INDEXED_STREAM_H_
+
+#include <fstream>
+#include <map>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include "gams/GamsExport.h"
+#include "madara/knowledge/BaseStreamer.h"
+#include "madara/knowledge/KnowledgeBase.h"
+#include "madara/knowledge/KnowledgeRecord.h"
+
+namespace gams
+{
+  namespace utility
+  {
+    /**
+     * Position of a keyframe within an indexed stream
+     **/
+    struct IndexedStreamEntry
+    {
+      /// timestamp of the keyframe
+      uint64_t timestamp;
+
+      /// byte offset of the keyframe within the file
+      uint64_t offset;
+    };
+
+    /**
+     * Appends knowledge base updates to a single file. Attach the writer
+     * to a knowledge base with attach_streamer and call write_frame
+     * whenever the updates since the last frame should be stored. Once
+     * per keyframe interval, the frame holds the complete state instead of
+     * the updates and is added to an index written by close. Frames are
+     * gathered in a large buffer before they are written to the file.
+     **/
+    class GAMS_EXPORT IndexedStreamWriter :
+      public madara::knowledge::BaseStreamer
+    {
+      public:
+        /**
+         * Constructor. Truncates the file.
+         * @param filename           file to write
+         * @param keyframe_interval  nanoseconds between keyframes
+         * @param buffer_size        bytes gathered before a file write
+         **/
+        IndexedStreamWriter (const std::string & filename,
+          uint64_t keyframe_interval = 1000000000,
+          size_t buffer_size = 16 * 1024 * 1024);
+
+        /**
+         * Destructor. Closes the stream.
+         **/
+        ~IndexedStreamWriter ();
+
+        /**
+         * Checks if the file could be opened
+         **/
+        bool is_open (void) const;
+
+        /**
+         * Records an update. Called by the knowledge base.
+         * @param name    the updated variable
+         * @param record  the new value
+         **/
+        void enqueue (const char * name,
+          const madara::knowledge::KnowledgeRecord & record) override;
+
+        /**
+         * Writes the updates since the last frame, or a keyframe if the
+         * keyframe interval has passed
+         * @param timestamp  time of the frame in nanoseconds. Timestamps
+         *                   must not decrease between frames.
+         * @return 0 on success, -1 if the frame could not be written
+         **/
+        int write_frame (uint64_t timestamp);
+
+        /**
+         * Writes the keyframe index and closes the file. Called by the
+         * destructor if not called explicitly.
+         * @return 0 on success, -1 if the file could not be written
+         **/
+        int close (void);
+
+        /**
+         * Returns the number of frames written
+         **/
+        size_t frames (void) const;
+
+        /**
+         * Returns the keyframe index written so far
+         **/
+        const std::vector<IndexedStreamEntry> & index (void) const;
+
+      private:
+        /**
+         * Encodes a frame into the write buffer
+         **/
+        void encode_frame (uint32_t type, uint64_t timestamp,
+          const madara::knowledge::KnowledgeMap & records);
+
+        /**
+         * Writes the buffer to the file
+         **/
+        int flush (void);
+
+        /// guards pending_, since the knowledge base may call from any thread
+        std::mutex mutex_;
+
+        /// updates since the last frame
+        madara::knowledge::KnowledgeMap pending_;
+
+        /// complete state as of the last frame
+        madara::knowledge::KnowledgeMap state_;
+
+        /// the keyframe index
+        std::vector<IndexedStreamEntry> index_;
+
+        /// frames not yet written to the file
+        std::vector<char> buffer_;
+
+        /// the output file
+        std::ofstream file_;
+
+        /// bytes gathered before a file write
+        size_t buffer_size_;
+
+        /// nanoseconds between keyframes
+        uint64_t keyframe_interval_;
+
+        /// offset of the next frame within the file
+        uint64_t offset_ = 0;
+
+        /// number of frames written
+        size_t frames_ = 0;
+
+        /// true once close was called
+        bool closed_ = false;
+    };
+
+    /**
+     * Reads a stream written by IndexedStreamWriter. Streams without an
+     * index (e.g., from an interrupted conversion) are indexed by a
+     * sequential scan when opened.
+     **/
+    class GAMS_EXPORT IndexedStreamReader
+    {
+      public:
+        /**
+         * Constructor. Opens the file and reads the keyframe index.
+         * @param filename     file to read
+         * @param buffer_size  bytes read from the file at once
+         **/
+        IndexedStreamReader (const std::string & filename,
+          size_t buffer_size = 16 * 1024 * 1024);
+
+        /**
+         * Checks if the file is a readable stream
+         **/
+        bool is_open (void) const;
+
+        /**
+         * Positions the reader at the last keyframe at or before a time
+         * @param timestamp  time in nanoseconds
+         * @return false if the stream has no such keyframe
+         **/
+        bool seek (uint64_t timestamp);
+
+        /**
+         * Reads the next frame
+         * @param timestamp  time of the frame
+         * @param records    the updates of the frame
+         * @param keyframe   true if the records are the complete state
+         * @return false at the end of the stream
+         **/
+        bool next (uint64_t & timestamp,
+          madara::knowledge::KnowledgeMap & records, bool & keyframe);
+
+        /**
+         * Loads the state at a given time into a knowledge base
+         * @param knowledge  the knowledge base to update
+         * @param timestamp  time in nanoseconds
+         * @return the number of frames applied
+         **/
+        size_t load (madara::knowledge::KnowledgeBase & knowledge,
+          uint64_t timestamp);
+
+        /**
+         * Returns the keyframe index
+         **/
+        const std::vector<IndexedStreamEntry> & index (void) const;
+
+      private:
+        /**
+         * Rebuilds the index by scanning all frames
+         **/
+        void scan (void);
+
+        /// the input file
+        std::ifstream file_;
+
+        /// buffer used by the file stream
+        std::vector<char> file_buffer_;
+
+        /// buffer of the current frame
+        std::vector<char> frame_;
+
+        /// the keyframe index
+        std::vector<IndexedStreamEntry> index_;
+
+        /// offset of the index, or the end of the frames
+        uint64_t end_ = 0;
+
+        /// true if the file is a readable stream
+        bool open_ = false;
+    };
+  }
+}
+
+#endif // _GAMS_UTILITY_INDEXED_STREAM_H_
@@ -0,0 +1,197 @@
+/**
+ * Copyright (c) 2019 James Edmondson. All Rights Reserved.
+ *
+ **/
+
+/**
+ * @file IoReactor.cpp
+ * @author James Edmondson <jedmondson@gmail.com>
+ *
+ * This file contains a process-wide, single-threaded I/O reactor that
+ * dispatches readable file descriptors (sockets, devices) to handlers
+ **/
+
+#include "IoReactor.h"
+#include "gams/loggers/GlobalLogger.h"
+
+#ifdef __linux__
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <unistd.h>
+#include <errno.h>
+#endif // __linux__
+
+// maximum events processed per epoll_wait
+#define MAX_REACTOR_EVENTS 32
+
+gams::utility::IoReactor::IoReactor()
+{
+#ifdef __linux__
+  epoll_handle_ = epoll_create1(EPOLL_CLOEXEC);
+  interrupt_handle_ = eventfd(0, EFD_CLOEXEC | EFD_NONBLOCK);
+
+  if (epoll_handle_ >= 0 && interrupt_handle_ >= 0)
+  {
+    epoll_event event = {};
+    event.events = EPOLLIN;
+    event.data.fd = interrupt_handle_;
+    epoll_ctl(epoll_handle_, EPOLL_CTL_ADD, interrupt_handle_, &event);
+  }
+  else
+  {
+    madara_logger_ptr_log(gams::loggers::global_logger.get(),
+      gams::loggers::LOG_ERROR,
+      "gams::utility::IoReactor::constructor: " \
+      "ERROR: unable to create epoll instance (errno %d)\n",
+      errno);
+  }
+#endif // __linux__
+}
+
+gams::utility::IoReactor::~IoReactor()
+{
+#ifdef __linux__
+  terminated_ = true;
+
+  if (thread_.joinable())
+  {
+    uint64_t signal = 1;
+    if (write(interrupt_handle_, &signal, sizeof(signal)) < 0)
+    {
+      madara_logger_ptr_log(gams::loggers::global_logger.get(),
+        gams::loggers::LOG_ERROR,
+        "gams::utility::IoReactor::destructor: " \
+        "ERROR: unable to interrupt reactor thread\n");
+    }
+
+    thread_.join();
+  }
+
+  if (interrupt_handle_ >= 0)
+  {
+    close(interrupt_handle_);
+  }
+
+  if (epoll_handle_ >= 0)
+  {
+    close(epoll_handle_);
+  }
+#endif // __linux__
+}
+
+gams::utility::IoReactor &
+gams::utility::IoReactor::instance(void)
+{
+  static IoReactor reactor;
+  return reactor;
+}
+
+bool
+gams::utility::IoReactor::is_supported(void) const
+{
+  return epoll_handle_ >= 0 && interrupt_handle_ >= 0;
+}
+
+bool
+gams::utility::IoReactor::add_handler(int handle, Handler handler)
+{
+  bool result = false;
+
+#ifdef __linux__
+  if (is_supported() && handle >= 0)
+  {
+    std::lock_guard<std::mutex> guard(mutex_);
+
+    epoll_event event = {};
+    event.events = EPOLLIN;
+    event.data.fd = handle;
+
+    if (epoll_ctl(epoll_handle_, EPOLL_CTL_ADD, handle, &event) == 0)
+    {
+      handlers_[handle] = handler;
+      result = true;
+
+      if (!thread_.joinable())
+      {
+        thread_ = std::thread(&IoReactor::run, this);
+      }
+    }
+
+    madara_logger_ptr_log(gams::loggers::global_logger.get(),
+      gams::loggers::LOG_MAJOR,
+      "gams::utility::IoReactor::add_handler: " \
+      "handle %d registration %s\n",
+      handle, result ? "succeeded" : "failed");
+  }
+#else
+  (void)handle;
+  (void)handler;
+#endif // __linux__
+
+  return result;
+}
+
+void
+gams::utility::IoReactor::remove_handler(int handle)
+{
+#ifdef __linux__
+  if (is_supported())
+  {
+    // holding the lock guarantees the handler is not mid-dispatch
+    std::lock_guard<std::mutex> guard(mutex_);
+
+    epoll_ctl(epoll_handle_, EPOLL_CTL_DEL, handle, 0);
+    handlers_.erase(handle);
+
+    madara_logger_ptr_log(gams::loggers::global_logger.get(),
+      gams::loggers::LOG_MAJOR,
+      "gams::utility::IoReactor::remove_handler: " \
+      "removed handle %d\n",
+      handle);
+  }
+#else
+  (void)handle;
+#endif // __linux__
+}
+
+void
+gams::utility::IoReactor::run(void)
+{
+#ifdef __linux__
+  epoll_event events[MAX_REACTOR_EVENTS];
+
+  while (!terminated_)
+  {
+    int count = epoll_wait(epoll_handle_, events, MAX_REACTOR_EVENTS, -1);
+
+    if (count < 0 && errno != EINTR)
+    {
+      madara_logger_ptr_log(gams::loggers::global_logger.get(),
+        gams::loggers::LOG_ERROR,
+        "gams::utility::IoReactor::run: " \
+        "ERROR: epoll_wait failed (errno %d). Stopping reactor.\n",
+        errno);
+      break;
+    }
+
+    for (int i = 0; i < count && !terminated_; ++i)
+    {
+      int handle = events[i].data.fd;
+
+      if (handle == interrupt_handle_)
+      {
+        continue;
+      }
+
+      std::lock_guard<std::mutex> guard(mutex_);
+
+      // the handle may have been removed after epoll_wait returned
+      auto found = handlers_.find(handle);
+      if (found != handlers_.end())
+      {
+        found->second(handle);
+      }
+    }
+  }
+#endif // __linux__
+}
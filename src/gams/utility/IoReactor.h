@@ -0,0 +1,107 @@
+/**
+ * Copyright (c) 2019 James Edmondson. All Rights Reserved.
+ *
+ **/
+
+/**
+ * @file IoReactor.h
+ * @author James Edmondson <jedmondson@gmail.com>
+ *
+ * This file contains a process-wide, single-threaded I/O reactor that
+ * dispatches readable file descriptors (sockets, devices) to handlers
+ **/
+
+#ifndef _GAMS_UTILITY_IO_REACTOR_H_
+#define _GAMS_UTILITY_IO_REACTOR_H_
+
+#include <atomic>
+#include <functional>
+#include <map>
+#include <mutex>
+#include <thread>
+
+#include "gams/GamsExport.h"
+
+namespace gams
+{
+  namespace utility
+  {
+    /**
+     * An epoll-based reactor that calls a handler whenever a registered
+     * handle becomes readable. Handlers run on the reactor thread and
+     * should decode data and publish it (e.g., via LatestValue) rather
+     * than touch knowledge bases or platform state directly. On systems
+     * without epoll, add_handler fails and callers should poll instead.
+     **/
+    class GAMS_EXPORT IoReactor
+    {
+      public:
+        /// handler called with the readable handle
+        typedef std::function<void(int)> Handler;
+
+        /**
+         * Constructor
+         **/
+        IoReactor ();
+
+        /**
+         * Destructor. Stops the reactor thread.
+         **/
+        ~IoReactor ();
+
+        /**
+         * Returns the process-wide reactor
+         **/
+        static IoReactor & instance (void);
+
+        /**
+         * Checks if the reactor can be used on this system
+         * @return true if handlers can be registered
+         **/
+        bool is_supported (void) const;
+
+        /**
+         * Registers a handler for a readable handle. Starts the reactor
+         * thread if it is not already running.
+         * @param handle   the file descriptor to watch
+         * @param handler  the function to call when handle is readable
+         * @return true if the handle was registered
+         **/
+        bool add_handler (int handle, Handler handler);
+
+        /**
+         * Unregisters a handle. When this returns, the handler is not
+         * running and will not be called again. Do not call from within
+         * a handler.
+         * @param handle   the file descriptor to stop watching
+         **/
+        void remove_handler (int handle);
+
+      private:
+        /**
+         * The reactor thread's event loop
+         **/
+        void run (void);
+
+        /// guards handlers_ and is held while a handler runs
+        std::mutex mutex_;
+
+        /// registered handlers by handle
+        std::map<int, Handler> handlers_;
+
+        /// the epoll instance
+        int epoll_handle_ = -1;
+
+        /// event handle used to interrupt the reactor thread on shutdown
+        int interrupt_handle_ = -1;
+
+        /// the reactor thread
+        std::thread thread_;
+
+        /// true when the reactor thread should exit
+        std::atomic<bool> terminated_ {false};
+    };
+  }
+}
+
+#endif // _GAMS_UTILITY_IO_REACTOR_H_
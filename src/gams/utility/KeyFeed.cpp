@@ -0,0 +1,193 @@
+/**
+ * Copyright (c) 2019 James Edmondson. All Rights Reserved.
+ *
+ **/
+
+/**
+ * @file KeyFeed.cpp
+ * @author James Edmondson <jedmondson@gmail.com>
+ *
+ * This file contains a transport filter that notifies indexes of the
+ * knowledge base keys that change under their prefixes
+ **/
+
+#include <algorithm>
+#include <memory>
+
+#include "KeyFeed.h"
+#include "gams/loggers/GlobalLogger.h"
+
+namespace
+{
+  typedef std::map<madara::knowledge::ThreadSafeContext *,
+    std::unique_ptr<gams::utility::KeyFeed>> FeedRegistry;
+
+  std::mutex registry_lock;
+
+  FeedRegistry & registry(void)
+  {
+    static FeedRegistry feeds;
+    return feeds;
+  }
+}
+
+gams::utility::KeyFeed::KeyFeed()
+{
+}
+
+gams::utility::KeyFeed::~KeyFeed()
+{
+}
+
+gams::utility::KeyFeed &
+gams::utility::KeyFeed::get(madara::knowledge::KnowledgeBase & knowledge)
+{
+  std::lock_guard<std::mutex> guard(registry_lock);
+
+  std::unique_ptr<KeyFeed> & feed = registry()[&knowledge.get_context()];
+
+  if (!feed)
+  {
+    feed.reset(new KeyFeed());
+  }
+
+  return *feed;
+}
+
+void
+gams::utility::KeyFeed::release(madara::knowledge::KnowledgeBase & knowledge)
+{
+  std::lock_guard<std::mutex> guard(registry_lock);
+
+  registry().erase(&knowledge.get_context());
+}
+
+void
+gams::utility::KeyFeed::attach(
+  madara::transport::QoSTransportSettings & settings)
+{
+  settings.add_receive_filter(this);
+  settings.add_send_filter(this);
+
+  std::lock_guard<std::mutex> guard(mutex_);
+  attached_ = true;
+}
+
+bool
+gams::utility::KeyFeed::is_attached(void) const
+{
+  std::lock_guard<std::mutex> guard(mutex_);
+  return attached_;
+}
+
+void
+gams::utility::KeyFeed::filter(madara::knowledge::KnowledgeMap & records,
+  const madara::transport::TransportContext &,
+  madara::knowledge::Variables &)
+{
+  std::lock_guard<std::mutex> guard(mutex_);
+
+  if (prefixes_.empty())
+  {
+    return;
+  }
+
+  for (const auto & record : records)
+  {
+    add_(record.first);
+  }
+}
+
+void
+gams::utility::KeyFeed::add(const std::string & key)
+{
+  std::lock_guard<std::mutex> guard(mutex_);
+  add_(key);
+}
+
+void
+gams::utility::KeyFeed::add_(const std::string & key)
+{
+  // a key can only match prefixes that end at one of its '.'s
+  for (std::string::size_type pos = key.find('.');
+    pos != std::string::npos; pos = key.find('.', pos + 1))
+  {
+    auto found = prefixes_.find(key.substr(0, pos + 1));
+
+    if (found != prefixes_.end())
+    {
+      for (auto subscription : found->second)
+      {
+        subscribers_[subscription].keys.insert(key);
+      }
+    }
+  }
+}
+
+gams::utility::KeyFeed::Subscription
+gams::utility::KeyFeed::subscribe(const std::string & prefix)
+{
+  std::lock_guard<std::mutex> guard(mutex_);
+
+  if (prefix.empty() || prefix[prefix.size() - 1] != '.')
+  {
+    madara_logger_ptr_log(gams::loggers::global_logger.get(),
+      gams::loggers::LOG_ERROR,
+      "gams::utility::KeyFeed::subscribe: " \
+      "prefix %s does not end with a '.' and will never match\n",
+      prefix.c_str());
+  }
+
+  Subscription subscription = next_++;
+  subscribers_[subscription].prefix = prefix;
+  prefixes_[prefix].push_back(subscription);
+
+  return subscription;
+}
+
+void
+gams::utility::KeyFeed::unsubscribe(Subscription subscription)
+{
+  std::lock_guard<std::mutex> guard(mutex_);
+
+  auto found = subscribers_.find(subscription);
+
+  if (found != subscribers_.end())
+  {
+    auto prefix = prefixes_.find(found->second.prefix);
+
+    if (prefix != prefixes_.end())
+    {
+      prefix->second.erase(std::remove(prefix->second.begin(),
+        prefix->second.end(), subscription), prefix->second.end());
+
+      if (prefix->second.empty())
+      {
+        prefixes_.erase(prefix);
+      }
+    }
+
+    subscribers_.erase(found);
+  }
+}
+
+bool
+gams::utility::KeyFeed::take(Subscription subscription,
+  std::vector<std::string> & keys)
+{
+  keys.clear();
+
+  std::lock_guard<std::mutex> guard(mutex_);
+
+  auto found = subscribers_.find(subscription);
+
+  if (found == subscribers_.end())
+  {
+    return false;
+  }
+
+  keys.assign(found->second.keys.begin(), found->second.keys.end());
+  found->second.keys.clear();
+
+  return true;
+}
@@ -0,0 +1,167 @@
+/**
+ * Copyright (c) 2019 James Edmondson. All Rights Reserved.
+ *
+ **/
+
+/**
+ * @file KeyFeed.h
+ * @author James Edmondson <jedmondson@gmail.com>
+ *
+ * This file contains a transport filter that notifies indexes of the
+ * knowledge base keys that change under their prefixes
+ **/
+
+#ifndef _GAMS_UTILITY_KEY_FEED_H_
+#define _GAMS_UTILITY_KEY_FEED_H_
+
+#include <map>
+#include <mutex>
+#include <set>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "madara/filters/AggregateFilter.h"
+#include "madara/knowledge/KnowledgeBase.h"
+#include "madara/transport/QoSTransportSettings.h"
+
+#include "gams/GamsExport.h"
+
+namespace gams
+{
+  namespace utility
+  {
+    /**
+     * Records the names of the variables that a knowledge base receives
+     * from and sends to its transports, and hands them to subscribers by
+     * prefix. Indexes over a prefix (ballots, bids, group members) use it
+     * to apply only the keys that changed instead of rescanning the
+     * prefix with get_matches on every query.
+     *
+     * The feed only sees what passes through the transports it was
+     * attached to. Variables that are deleted, or written locally without
+     * being sent, are not reported, so indexes still provide a sync
+     * that rescans their prefix.
+     **/
+    class GAMS_EXPORT KeyFeed : public madara::filters::AggregateFilter
+    {
+      public:
+        /// identifies a subscriber
+        typedef size_t Subscription;
+
+        /**
+         * Constructor
+         **/
+        KeyFeed ();
+
+        /**
+         * Destructor
+         **/
+        virtual ~KeyFeed ();
+
+        /**
+         * Returns the feed of a knowledge base, creating it on first use.
+         * Copies of a knowledge base share the same feed.
+         * @param knowledge  the knowledge base
+         * @return the feed of the knowledge base
+         **/
+        static KeyFeed & get (madara::knowledge::KnowledgeBase & knowledge);
+
+        /**
+         * Destroys the feed of a knowledge base. Only call this once the
+         * transports the feed was attached to have been closed and no
+         * index holds a subscription.
+         * @param knowledge  the knowledge base
+         **/
+        static void release (madara::knowledge::KnowledgeBase & knowledge);
+
+        /**
+         * Adds the feed as a receive and send filter. Must be called
+         * before the transport is attached to the knowledge base.
+         * @param settings  the settings of the transport to watch
+         **/
+        void attach (madara::transport::QoSTransportSettings & settings);
+
+        /**
+         * Checks if the feed watches any transports. Subscribers that
+         * depend on remote changes should rescan when it does not.
+         * @return true if attach has been called
+         **/
+        bool is_attached (void) const;
+
+        /**
+         * Records the names of received or sent records
+         * @param records            the records passing the transport
+         * @param transport_context  context of the send or receive
+         * @param vars               interface to the knowledge base
+         **/
+        virtual void filter (madara::knowledge::KnowledgeMap & records,
+          const madara::transport::TransportContext & transport_context,
+          madara::knowledge::Variables & vars);
+
+        /**
+         * Records a changed key. Used for changes that do not pass
+         * through a transport.
+         * @param key  the name of the changed variable
+         **/
+        void add (const std::string & key);
+
+        /**
+         * Subscribes to the keys under a prefix. Only keys that change
+         * after the subscription are reported.
+         * @param prefix  the prefix of interest, ending with a '.'
+         * @return the subscription for take and unsubscribe
+         **/
+        Subscription subscribe (const std::string & prefix);
+
+        /**
+         * Ends a subscription
+         * @param subscription  the subscription to end
+         **/
+        void unsubscribe (Subscription subscription);
+
+        /**
+         * Moves the keys that changed since the last take into keys.
+         * Each key is reported once, however often it changed.
+         * @param subscription  the subscription to read
+         * @param keys          the changed keys, in name order
+         * @return false if the subscription does not exist
+         **/
+        bool take (Subscription subscription, std::vector<std::string> & keys);
+
+      private:
+        /**
+         * Records a changed key. mutex_ must be held.
+         * @param key  the name of the changed variable
+         **/
+        void add_ (const std::string & key);
+
+        /// a subscriber's prefix and its changed keys
+        struct Subscriber
+        {
+          /// the prefix of interest
+          std::string prefix;
+
+          /// keys changed since the last take
+          std::set<std::string> keys;
+        };
+
+        /// guards the subscriptions
+        mutable std::mutex mutex_;
+
+        /// true once the feed is a filter on a transport
+        bool attached_ = false;
+
+        /// the next subscription identifier
+        Subscription next_ = 0;
+
+        /// subscribers by subscription
+        std::map<Subscription, Subscriber> subscribers_;
+
+        /// subscriptions by prefix
+        std::unordered_map<std::string, std::vector<Subscription> > prefixes_;
+    };
+  }
+}
+
+#endif // _GAMS_UTILITY_KEY_FEED_H_
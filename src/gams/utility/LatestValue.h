@@ -0,0 +1,95 @@
+/**
+ * Copyright (c) 2019 James Edmondson. All Rights Reserved.
+ *
+ **/
+
+/**
+ * @file LatestValue.h
+ * @author James Edmondson <jedmondson@gmail.com>
+ *
+ * This file contains a lock-free, single-writer/single-reader slot that
+ * always holds the most recently written value
+ **/
+
+#ifndef _GAMS_UTILITY_LATEST_VALUE_H_
+#define _GAMS_UTILITY_LATEST_VALUE_H_
+
+#include <atomic>
+
+namespace gams
+{
+  namespace utility
+  {
+    /**
+     * A triple-buffered slot for passing the latest value of a sensor
+     * from one producer thread (e.g., an I/O reactor) to one consumer
+     * thread (e.g., a platform's sense method). Neither side blocks, and
+     * the reader never sees a partially written value.
+     **/
+    template <typename T>
+    class LatestValue
+    {
+      public:
+        /**
+         * Publishes a new value. Only call from the producer thread.
+         * @param value   the value to publish
+         **/
+        void write (const T & value)
+        {
+          buffers_[back_] = value;
+
+          // swap the back buffer with the shared one and mark it fresh
+          back_ = middle_.exchange (back_ | FRESH) & INDEX;
+        }
+
+        /**
+         * Reads the latest value if one was published since the last read.
+         * Only call from the consumer thread.
+         * @param value   the value to overwrite with the latest value
+         * @return true if value was updated
+         **/
+        bool read (T & value)
+        {
+          if ((middle_.load () & FRESH) == 0)
+          {
+            return false;
+          }
+
+          front_ = middle_.exchange (front_) & INDEX;
+          value = buffers_[front_];
+
+          return true;
+        }
+
+        /**
+         * Checks if a value was published since the last read
+         * @return true if read would return a new value
+         **/
+        bool is_fresh (void) const
+        {
+          return (middle_.load () & FRESH) != 0;
+        }
+
+      private:
+        /// mask for the buffer index stored in middle_
+        static const unsigned char INDEX = 0x03;
+
+        /// flag in middle_ that signals an unread value
+        static const unsigned char FRESH = 0x04;
+
+        /// the three buffers rotated between writer, reader and middle
+        T buffers_[3];
+
+        /// index (and fresh flag) of the buffer shared between threads
+        std::atomic<unsigned char> middle_ {1};
+
+        /// index of the buffer owned by the writer
+        unsigned char back_ = 0;
+
+        /// index of the buffer owned by the reader
+        unsigned char front_ = 2;
+    };
+  }
+}
+
+#endif // _GAMS_UTILITY_LATEST_VALUE_H_
@@ -12,100 +12,240 @@
  **/
 
 #include "OscUdp.h"
+#include <cstring>
+#include <iterator>
+
 #include "osc/OscOutboundPacketStream.h"
 
-#define OUTPUT_BUFFER_SIZE 1024
+namespace
+{
+  /**
+   * Exposes the native socket of a MADARA ASIO-based transport
+   **/
+  template <typename TransportType>
+  class HandleTransport : public TransportType
+  {
+  public:
+    using TransportType::TransportType;
+
+    /**
+     * Returns the native socket handle. On Windows, handles do not fit
+     * in an int, but the IoReactor is only supported on Linux.
+     **/
+    int get_handle (void)
+    {
+      return (int)this->socket_.native_handle();
+    }
+  };
+}
 
-size_t
-gams::utility::OscUdp::pack(void *buffer, size_t size, const OscMap &map)
+int
+gams::utility::OscUdp::classify_address(const std::string & address)
 {
-  size_t result = 0;
+  int result = OSC_ADDRESS_UNKNOWN;
+
+  if (madara::utility::ends_with(address, "/velocity/xy"))
+  {
+    result = OSC_ADDRESS_VELOCITY_XY;
+  }
+  else if (madara::utility::ends_with(address, "/velocity/z"))
+  {
+    result = OSC_ADDRESS_VELOCITY_Z;
+  }
+  else if (madara::utility::ends_with(address, "/yaw"))
+  {
+    result = OSC_ADDRESS_YAW;
+  }
+  else if (madara::utility::begins_with(address, "/spawn"))
+  {
+    result = OSC_ADDRESS_SPAWN;
+  }
+  else if (madara::utility::ends_with(address, "/pos"))
+  {
+    result = OSC_ADDRESS_POS;
+  }
+  else if (madara::utility::ends_with(address, "/rot"))
+  {
+    result = OSC_ADDRESS_ROT;
+  }
+
+  return result;
+}
+
+int
+gams::utility::OscUdp::register_address(const std::string & address)
+{
+  int type = classify_address(address);
+  address_types_[address] = type;
+
+  madara_logger_ptr_log(gams::loggers::global_logger.get(),
+    gams::loggers::LOG_MAJOR,
+    "gams::utility::OscUdp::register_address: " \
+    "%s resolved to type %d\n",
+    address.c_str(), type);
+
+  return type;
+}
 
-  char bundle_buffer[OUTPUT_BUFFER_SIZE];
-  osc::OutboundPacketStream bundle(bundle_buffer, OUTPUT_BUFFER_SIZE);
-  bundle << osc::BeginBundle();
+int
+gams::utility::OscUdp::get_address_type(const std::string & address) const
+{
+  auto found = address_types_.find(address);
 
-  for (auto i : map)
+  if (found != address_types_.end())
   {
-    if (madara::utility::ends_with(i.first, "/velocity/xy"))
-    {
-      madara_logger_ptr_log(gams::loggers::global_logger.get(),
-        gams::loggers::LOG_MINOR,
-        "gams::utility::OscUdp::pack: " \
-        "PACK XY: %s\n",
-        i.first.c_str());
+    return found->second;
+  }
 
-      std::vector<double> values = i.second.to_doubles();
+  return classify_address(address);
+}
 
-      if (values.size() >= 2)
-      {
-        bundle
-            << osc::BeginMessage(i.first.c_str())
-            << (float)values[0] << (float)values[1]
-            << osc::EndMessage;
-      }
-    }
-    else if (madara::utility::ends_with(i.first, "/velocity/z"))
-    {
-      madara_logger_ptr_log(gams::loggers::global_logger.get(),
-        gams::loggers::LOG_MINOR,
-        "gams::utility::OscUdp::pack: " \
-        "PACK Z: %s\n",
-        i.first.c_str());
+// bytes in "#bundle\0" plus the bundle time tag
+#define OSC_BUNDLE_HEADER_SIZE 16
+
+// bytes taken by a message (or blob) of length size after 4-byte alignment
+static inline size_t osc_align(size_t size)
+{
+  return (size + 3) & ~((size_t)3);
+}
 
-      std::vector<double> values = i.second.to_doubles();
+size_t
+gams::utility::OscUdp::get_packed_size(const std::string & address,
+  const madara::knowledge::KnowledgeRecord & value) const
+{
+  size_t args = 0;
+  size_t arg_bytes = 0;
 
-      if (values.size() >= 1)
-      {
-        bundle
-            << osc::BeginMessage(i.first.c_str())
-            << (float)values[0]
-            << osc::EndMessage;
-      }
-    }
-    else if (madara::utility::ends_with(i.first, "/yaw"))
-    {
-      madara_logger_ptr_log(gams::loggers::global_logger.get(),
-        gams::loggers::LOG_MINOR,
-        "gams::utility::OscUdp::pack: " \
-        "PACK YAW: %s\n",
-        i.first.c_str());
+  switch (get_address_type(address))
+  {
+  case OSC_ADDRESS_VELOCITY_XY:
+    if (value.size() < 2)
+      return 0;
+    args = 2;
+    arg_bytes = 8;
+    break;
+  case OSC_ADDRESS_VELOCITY_Z:
+  case OSC_ADDRESS_YAW:
+    if (value.size() < 1)
+      return 0;
+    args = 1;
+    arg_bytes = 4;
+    break;
+  case OSC_ADDRESS_SPAWN:
+    args = 1;
+    arg_bytes = 4 + osc_align(value.to_string().size());
+    break;
+  default:
+    return 0;
+  }
 
-      std::vector<double> values = i.second.to_doubles();
+  // element size + address + type tags (",f" plus null) + arguments
+  return 4 + osc_align(address.size() + 1) + osc_align(args + 2) + arg_bytes;
+}
 
-      if (values.size() >= 1)
+template <typename Iterator>
+size_t
+gams::utility::OscUdp::pack_range(void *buffer, size_t size,
+  Iterator begin, Iterator end)
+{
+  size_t result = 0;
+
+  try
+  {
+    // stream directly into the caller's buffer to avoid a copy
+    osc::OutboundPacketStream bundle((char *)buffer, size);
+    bundle << osc::BeginBundle();
+
+    for (Iterator i = begin; i != end; ++i)
+    {
+      const madara::knowledge::KnowledgeRecord & value = i->second;
+
+      switch (get_address_type(i->first))
       {
+      case OSC_ADDRESS_VELOCITY_XY:
+        madara_logger_ptr_log(gams::loggers::global_logger.get(),
+          gams::loggers::LOG_MINOR,
+          "gams::utility::OscUdp::pack: " \
+          "PACK XY: %s\n",
+          i->first.c_str());
+
+        if (value.size() >= 2)
+        {
+          bundle
+              << osc::BeginMessage(i->first.c_str())
+              << (float)value.retrieve_index(0).to_double()
+              << (float)value.retrieve_index(1).to_double()
+              << osc::EndMessage;
+        }
+        break;
+      case OSC_ADDRESS_VELOCITY_Z:
+      case OSC_ADDRESS_YAW:
+        madara_logger_ptr_log(gams::loggers::global_logger.get(),
+          gams::loggers::LOG_MINOR,
+          "gams::utility::OscUdp::pack: " \
+          "PACK SCALAR: %s\n",
+          i->first.c_str());
+
+        if (value.size() >= 1)
+        {
+          bundle
+              << osc::BeginMessage(i->first.c_str())
+              << (float)value.retrieve_index(0).to_double()
+              << osc::EndMessage;
+        }
+        break;
+      case OSC_ADDRESS_SPAWN:
+      {
+        madara_logger_ptr_log(gams::loggers::global_logger.get(),
+          gams::loggers::LOG_MINOR,
+          "gams::utility::OscUdp::pack: " \
+          "PACK SPAWN: %s\n",
+          i->first.c_str());
+
+        std::string spawn = value.to_string();
+
         bundle
-            << osc::BeginMessage(i.first.c_str())
-            << (float)values[0]
+            << osc::BeginMessage(i->first.c_str())
+            << osc::Blob(spawn.c_str(), spawn.size())
             << osc::EndMessage;
+        break;
+      }
+      default:
+        break;
       }
     }
-    else if (madara::utility::begins_with(i.first, "/spawn"))
-    {
-      madara_logger_ptr_log(gams::loggers::global_logger.get(),
-        gams::loggers::LOG_MINOR,
-        "gams::utility::OscUdp::pack: " \
-        "PACK SPAWN: %s\n",
-        i.first.c_str());
 
-      std::string value = i.second.to_string();
-
-      bundle
-          << osc::BeginMessage(i.first.c_str())
-          << osc::Blob(value.c_str(), value.size())
-          << osc::EndMessage;
-    }
+    bundle << osc::EndBundle;
+    result = bundle.Size();
   }
+  catch (const osc::OutOfBufferMemoryException &)
+  {
+    madara_logger_ptr_log(gams::loggers::global_logger.get(),
+      gams::loggers::LOG_ERROR,
+      "gams::utility::OscUdp::pack: " \
+      "ERROR: %zu values do not fit in %zu byte buffer\n",
+      (size_t)std::distance(begin, end), size);
 
-  bundle << osc::EndBundle;
-  result = bundle.Size();
-  memcpy(buffer, bundle.Data(), bundle.Size());
+    result = 0;
+  }
 
   // return the size written
   return result;
 }
 
+size_t
+gams::utility::OscUdp::pack(void *buffer, size_t size, const OscMap &map)
+{
+  return pack_range(buffer, size, map.begin(), map.end());
+}
+
+size_t
+gams::utility::OscUdp::pack(void *buffer, size_t size,
+  OscMap::const_iterator begin, OscMap::const_iterator end)
+{
+  return pack_range(buffer, size, begin, end);
+}
+
 void gams::utility::OscUdp::process_bundle(const osc::ReceivedBundle &b, OscMap &map)
 {
   // ignore bundle time tag for now
@@ -122,43 +262,26 @@ void gams::utility::OscUdp::process_bundle(const osc::ReceivedBundle &b, OscMap
 void gams::utility::OscUdp::process_message(const osc::ReceivedMessage &m, OscMap &map)
 {
   auto it = map.find(m.AddressPattern());
-  if (it != map.end())
+
+  // positions and rotations are both three floats, so the layout is
+  // resolved from the type tags instead of a second address lookup
+  if (it != map.end() && m.ArgumentCount() == 3 &&
+    std::strncmp(m.TypeTags(), "fff", 3) == 0)
   {
     osc::ReceivedMessageArgumentStream args = m.ArgumentStream();
-    if (madara::utility::ends_with(it->first, "/pos"))
-    {
-      float x, y, z;
-      args >> x >> y >> z >> osc::EndMessage;
-
-      // set in reverse, simply so we are only creating the vector once
-      it->second.set_index(2, z);
-      it->second.set_index(1, y);;
-      it->second.set_index(0, x);
-      
-      madara_logger_ptr_log(gams::loggers::global_logger.get(),
-        gams::loggers::LOG_MINOR,
-        "gams::utility::OscUdp::process_message: " \
-        "UNPACK POS: %s=>[%f, %f, %f]\n",
-        it->first.c_str(), x, y, z);
-    }
-    else if (madara::utility::ends_with(it->first, "/rot"))
-    {
-      float roll, pitch, yaw;
-      args >> roll >> pitch >> yaw >> osc::EndMessage;
+    float x, y, z;
+    args >> x >> y >> z >> osc::EndMessage;
 
-      // set in reverse, simply so we are only creating the vector once
-      it->second.set_index(2, yaw);
-      it->second.set_index(1, pitch);
-      it->second.set_index(0, roll);
-      
-      // it->second = {roll, pitch, yaw};
+    // set in reverse, simply so we are only creating the vector once
+    it->second.set_index(2, z);
+    it->second.set_index(1, y);
+    it->second.set_index(0, x);
 
-      madara_logger_ptr_log(gams::loggers::global_logger.get(),
-        gams::loggers::LOG_MINOR,
-        "gams::utility::OscUdp::process_message: " \
-        "UNPACK ROT: %s=>[%f, %f, %f]\n",
-        it->first.c_str(), roll, pitch, yaw);
-    }
+    madara_logger_ptr_log(gams::loggers::global_logger.get(),
+      gams::loggers::LOG_MINOR,
+      "gams::utility::OscUdp::process_message: " \
+      "UNPACK: %s=>[%f, %f, %f]\n",
+      it->first.c_str(), x, y, z);
   }
 }
 
@@ -196,21 +319,27 @@ void gams::utility::OscUdp::create_socket(
 
   if (settings.type == madara::transport::UDP)
   {
-    transport_ =
-        std::make_shared<madara::transport::UdpTransport>(
+    auto transport =
+        std::make_shared<HandleTransport<madara::transport::UdpTransport>>(
             "", kb_.get_context(), settings_, true);
+    socket_handle_ = transport->get_handle();
+    transport_ = transport;
   }
   else if (settings.type == madara::transport::MULTICAST)
   {
-    transport_ =
-        std::make_shared<madara::transport::MulticastTransport>(
+    auto transport = std::make_shared<
+      HandleTransport<madara::transport::MulticastTransport>>(
             "", kb_.get_context(), settings_, true);
+    socket_handle_ = transport->get_handle();
+    transport_ = transport;
   }
   else if (settings.type == madara::transport::BROADCAST)
   {
-    transport_ =
-        std::make_shared<madara::transport::BroadcastTransport>(
+    auto transport = std::make_shared<
+      HandleTransport<madara::transport::BroadcastTransport>>(
             "", kb_.get_context(), settings_, true);
+    socket_handle_ = transport->get_handle();
+    transport_ = transport;
   }
 }
 
@@ -252,32 +381,73 @@ int gams::utility::OscUdp::receive(OscMap &values, double max_wait_seconds)
   return result;
 }
 
-int gams::utility::OscUdp::send(const OscMap &values)
+template <typename Iterator>
+int gams::utility::OscUdp::send_range(Iterator begin, Iterator end,
+  size_t max_bundle_size)
 {
   int result = 0;
-  std::string remote;
   size_t max_send = 64000;
   size_t packed_bytes;
 
+  if (max_bundle_size == 0 || max_bundle_size > max_send)
+  {
+    max_bundle_size = max_send;
+  }
+
   if (has_socket())
   {
     const std::vector<boost::asio::ip::udp::endpoint> &addresses =
         transport_->get_udp_endpoints();
 
-    packed_bytes = pack(buffer_.get(), max_send, values);
+    while (begin != end)
+    {
+      // find the largest run of messages that fits in one bundle. The
+      // first message is always included so we make progress.
+      size_t bundle_size = OSC_BUNDLE_HEADER_SIZE +
+        get_packed_size(begin->first, begin->second);
+      Iterator last = begin;
 
-    madara_logger_ptr_log(gams::loggers::global_logger.get(),
-                          gams::loggers::LOG_MAJOR,
-                          "gams::utility::OscUdp::send: "
-                          " sending %zu bytes\n",
-                          packed_bytes);
+      for (++last; last != end; ++last)
+      {
+        size_t message_size = get_packed_size(last->first, last->second);
 
-    for (size_t i = 1; i < addresses.size(); ++i)
-    {
-      result = transport_->send_buffer(
-          addresses[i], buffer_.get(), packed_bytes);
+        if (bundle_size + message_size > max_bundle_size)
+        {
+          break;
+        }
+
+        bundle_size += message_size;
+      }
+
+      packed_bytes = pack_range(send_buffer_.get(), max_send, begin, last);
+
+      madara_logger_ptr_log(gams::loggers::global_logger.get(),
+                            gams::loggers::LOG_MAJOR,
+                            "gams::utility::OscUdp::send: "
+                            " sending %zu bytes\n",
+                            packed_bytes);
+
+      for (size_t i = 1; packed_bytes > 0 && i < addresses.size(); ++i)
+      {
+        result = transport_->send_buffer(
+            addresses[i], send_buffer_.get(), packed_bytes);
+      }
+
+      begin = last;
     }
   }
 
   return result;
 }
+
+int gams::utility::OscUdp::send(const OscMap &values,
+  size_t max_bundle_size)
+{
+  return send_range(values.begin(), values.end(), max_bundle_size);
+}
+
+int gams::utility::OscUdp::send(const OscMessages &values,
+  size_t max_bundle_size)
+{
+  return send_range(values.begin(), values.end(), max_bundle_size);
+}
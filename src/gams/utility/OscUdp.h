@@ -17,6 +17,7 @@
 
 #include <memory>
 #include <map>
+#include <unordered_map>
 #include <vector>
 #include <string>
 
@@ -48,14 +49,43 @@ namespace gams
         /// basically unused
         madara::knowledge::KnowledgeBase kb_;
 
-        /// buffer for sending/receiving
+        /// buffer for receiving
         madara::utility::ScopedArray<char> buffer_ =
           new char[64000];
+
+        /// buffer for sending, separate so a reactor thread may receive
+        madara::utility::ScopedArray<char> send_buffer_ =
+          new char[64000];
+
+        /// native handle of the underlying socket (-1 if unavailable)
+        int socket_handle_ = -1;
+
+        /// cache of OSC addresses to their resolved OscAddressTypes. Only
+        /// register_address changes it, and only send and pack read it.
+        std::unordered_map<std::string, int> address_types_;
         
       public:
         typedef  std::map<std::string,
           madara::knowledge::KnowledgeRecord>  OscMap;
 
+        /// messages in send order. An address may appear more than once.
+        typedef  std::vector<std::pair<std::string,
+          madara::knowledge::KnowledgeRecord>>  OscMessages;
+
+        /**
+         * Types of OSC addresses that can be packed or unpacked
+         **/
+        enum OscAddressTypes
+        {
+          OSC_ADDRESS_UNKNOWN = 0,
+          OSC_ADDRESS_VELOCITY_XY = 1,
+          OSC_ADDRESS_VELOCITY_Z = 2,
+          OSC_ADDRESS_YAW = 3,
+          OSC_ADDRESS_SPAWN = 4,
+          OSC_ADDRESS_POS = 5,
+          OSC_ADDRESS_ROT = 6
+        };
+
         /**
          * Constructor
          **/
@@ -68,15 +98,64 @@ namespace gams
         }
 
         /**
-         * Processes OSC packets and places them into an OSC map
+         * Determines the address type from the address suffix/prefix
+         * @param address  the OSC address
+         * @return the type of the address. @see OscAddressTypes
+         **/
+        static int classify_address (const std::string & address);
+
+        /**
+         * Resolves the type of an address once and caches it, so that
+         * subsequent pack calls need not compare strings. Must not be
+         * called while another thread sends or packs with this object.
+         * Receiving does not use the cache.
+         * @param address  the OSC address
+         * @return the type of the address. @see OscAddressTypes
+         **/
+        int register_address (const std::string & address);
+
+        /**
+         * Returns the cached type of an address. Unregistered addresses
+         * are classified without being added to the cache.
+         * @param address  the OSC address
+         * @return the type of the address. @see OscAddressTypes
+         **/
+        int get_address_type (const std::string & address) const;
+
+        /**
+         * Packs an OSC map into an OSC bundle written directly into buffer
          * @param buffer   the buffer to pack into
          * @param size     the size of the buffer
-         * @param map      a map updated with recent messages
+         * @param map      the messages to pack
+         * @return the number of bytes written (0 if buffer is too small)
          **/
         size_t pack (void* buffer, size_t size, const OscMap& map);
 
         /**
-         * Processes OSC packets and places them into an OSC map
+         * Packs a range of an OSC map into an OSC bundle
+         * @param buffer   the buffer to pack into
+         * @param size     the size of the buffer
+         * @param begin    the first message to pack
+         * @param end      one past the last message to pack
+         * @return the number of bytes written (0 if buffer is too small)
+         **/
+        size_t pack (void* buffer, size_t size,
+          OscMap::const_iterator begin, OscMap::const_iterator end);
+
+        /**
+         * Calculates the bytes a message will add to a packed bundle
+         * @param address  the OSC address of the message
+         * @param value    the value of the message
+         * @return the size of the bundle element (0 if it will not be packed)
+         **/
+        size_t get_packed_size (const std::string & address,
+          const madara::knowledge::KnowledgeRecord & value) const;
+
+        /**
+         * Processes OSC packets and places them into an OSC map. Only
+         * addresses already in the map are updated. Positions and
+         * rotations share a layout of three floats, so any message with
+         * that layout is decoded as a 3-vector and others are ignored.
          * @param buffer   the buffer to unpack from
          * @param size     the size of the buffer
          * @param map      a map updated with recent messages
@@ -91,6 +170,16 @@ namespace gams
           return transport_.get() != 0;
         }
 
+        /**
+         * Returns the native handle of the socket, e.g., for registering
+         * with an IoReactor
+         * @return the socket handle or -1 if no socket has been created
+         **/
+        inline int get_socket_handle (void) const
+        {
+          return socket_handle_;
+        }
+
         /**
          * Creates and configures the underlying transport
          * @param config   the configuration of the network. For UDP,
@@ -109,12 +198,42 @@ namespace gams
         int receive (OscMap & values, double max_wait_seconds = 0.5);
 
         /**
-         * Sends a map of messages and args over the transport 
+         * Sends a map of messages and args over the transport. Messages
+         * are split across as many bundles as necessary to keep each
+         * datagram at or below max_bundle_size.
          * @param values   the values to send
+         * @param max_bundle_size  the maximum bytes per bundle (e.g., MTU)
+         * @return 0 if success, -1 if bad transport, 1 or 2 for socket issues
+         **/
+        int send (const OscMap & values, size_t max_bundle_size = 64000);
+
+        /**
+         * Sends a list of messages over the transport, e.g., the messages
+         * of several agents that share an address
+         * @param values   the messages to send
+         * @param max_bundle_size  the maximum bytes per bundle (e.g., MTU)
          * @return 0 if success, -1 if bad transport, 1 or 2 for socket issues
          **/
-        int send (const OscMap & values);
+        int send (const OscMessages & values,
+          size_t max_bundle_size = 64000);
 
+      private:
+        /**
+         * Packs a range of (address, value) pairs into an OSC bundle
+         **/
+        template <typename Iterator>
+        size_t pack_range (void* buffer, size_t size,
+          Iterator begin, Iterator end);
+
+        /**
+         * Sends a range of (address, value) pairs in as many bundles as
+         * max_bundle_size requires
+         **/
+        template <typename Iterator>
+        int send_range (Iterator begin, Iterator end,
+          size_t max_bundle_size);
+
+      public:
 
         void process_bundle(const osc::ReceivedBundle& b, OscMap & map);
         void process_message(const osc::ReceivedMessage& m, OscMap & map);
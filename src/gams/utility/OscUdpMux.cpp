@@ -0,0 +1,311 @@
+/**
+ * Copyright (c) 2019 James Edmondson. All Rights Reserved.
+ *
+ **/
+
+/**
+ * @file OscUdpMux.cpp
+ * @author James Edmondson <jedmondson@gmail.com>
+ *
+ * This file contains a process-wide OSC UDP transport that batches
+ * the messages of many agents into shared bundles
+ **/
+
+#include "OscUdpMux.h"
+
+gams::utility::OscUdpMux::OscUdpMux(
+  const madara::transport::QoSTransportSettings & settings)
+{
+  madara::transport::QoSTransportSettings copy(settings);
+  osc_.create_socket(copy);
+}
+
+std::shared_ptr<gams::utility::OscUdpMux>
+gams::utility::OscUdpMux::get(
+  const madara::transport::QoSTransportSettings & settings)
+{
+  static std::mutex registry_lock;
+  static std::map<std::string, std::weak_ptr<OscUdpMux>> registry;
+
+  // agents share a multiplexer only if all of their endpoints match
+  std::string key;
+  for (auto host : settings.hosts)
+  {
+    key += host;
+    key += ",";
+  }
+
+  std::lock_guard<std::mutex> guard(registry_lock);
+
+  std::shared_ptr<OscUdpMux> result = registry[key].lock();
+
+  if (!result)
+  {
+    madara_logger_ptr_log(gams::loggers::global_logger.get(),
+      gams::loggers::LOG_MAJOR,
+      "gams::utility::OscUdpMux::get: " \
+      "creating shared OSC transport for %s\n",
+      key.c_str());
+
+    result = std::make_shared<OscUdpMux>(settings);
+    registry[key] = result;
+  }
+
+  return result;
+}
+
+void
+gams::utility::OscUdpMux::register_addresses(
+  const std::vector<std::string> & addresses)
+{
+  for (auto address : addresses)
+  {
+    osc_.register_address(address);
+  }
+}
+
+size_t
+gams::utility::OscUdpMux::add_participant(
+  const std::vector<std::string> & addresses)
+{
+  std::lock_guard<std::mutex> guard(mutex_);
+
+  register_addresses(addresses);
+
+  // the next receive adds them to incoming_, so joining never waits on
+  // a socket read in progress
+  for (auto address : addresses)
+  {
+    registered_.insert(address);
+    latest_[address];
+    new_incoming_.push_back(address);
+  }
+
+  queued_.push_back(false);
+  pending_.emplace_back();
+  ++num_participants_;
+
+  madara_logger_ptr_log(gams::loggers::global_logger.get(),
+    gams::loggers::LOG_MAJOR,
+    "gams::utility::OscUdpMux::add_participant: " \
+    "added participant %zu (%zu active)\n",
+    queued_.size() - 1, num_participants_);
+
+  return queued_.size() - 1;
+}
+
+void
+gams::utility::OscUdpMux::remove_participant(size_t id,
+  const std::vector<std::string> & addresses)
+{
+  std::lock_guard<std::mutex> guard(mutex_);
+
+  for (auto address : addresses)
+  {
+    latest_.erase(address);
+  }
+
+  if (id < queued_.size() && num_participants_ > 0)
+  {
+    // the messages already queued by this participant are still sent
+    if (queued_[id])
+    {
+      queued_[id] = false;
+      --num_queued_;
+    }
+
+    --num_participants_;
+  }
+
+  // don't leave the remaining participants waiting on this one
+  if (num_queued_ > 0 && num_queued_ >= num_participants_)
+  {
+    flush_unlocked();
+  }
+}
+
+int
+gams::utility::OscUdpMux::send(size_t id, const OscMap & values)
+{
+  std::lock_guard<std::mutex> guard(mutex_);
+
+  if (id >= pending_.size())
+  {
+    return -1;
+  }
+
+  // resolve new addresses (e.g., /spawn/<type>) before the first send.
+  // Only sends read the address cache, and they all hold mutex_.
+  std::vector<std::string> addresses;
+  for (auto & value : values)
+  {
+    if (registered_.insert(value.first).second)
+    {
+      addresses.push_back(value.first);
+    }
+  }
+  if (addresses.size() > 0)
+  {
+    register_addresses(addresses);
+  }
+
+  if (num_pending_ == 0)
+  {
+    batch_timer_.start();
+  }
+
+  // a participant's later value for an address replaces its earlier one
+  OscMap & pending = pending_[id];
+  for (auto & value : values)
+  {
+    auto inserted = pending.insert(value);
+    if (inserted.second)
+    {
+      ++num_pending_;
+    }
+    else
+    {
+      inserted.first->second = value.second;
+    }
+  }
+
+  if (!queued_[id])
+  {
+    queued_[id] = true;
+    ++num_queued_;
+  }
+
+  batch_timer_.stop();
+
+  if (num_queued_ >= num_participants_ ||
+      batch_timer_.duration_ds() >= flush_period_)
+  {
+    return flush_unlocked();
+  }
+
+  return 0;
+}
+
+int
+gams::utility::OscUdpMux::flush(void)
+{
+  std::lock_guard<std::mutex> guard(mutex_);
+
+  return flush_unlocked();
+}
+
+int
+gams::utility::OscUdpMux::flush_unlocked(void)
+{
+  int result = 0;
+
+  if (num_pending_ > 0)
+  {
+    madara_logger_ptr_log(gams::loggers::global_logger.get(),
+      gams::loggers::LOG_MAJOR,
+      "gams::utility::OscUdpMux::flush: " \
+      "sending %zu messages from %zu participants\n",
+      num_pending_, num_queued_);
+
+    batch_.clear();
+    for (auto & pending : pending_)
+    {
+      batch_.insert(batch_.end(), pending.begin(), pending.end());
+      pending.clear();
+    }
+    num_pending_ = 0;
+
+    result = osc_.send(batch_, max_bundle_size_);
+  }
+
+  queued_.assign(queued_.size(), false);
+  num_queued_ = 0;
+
+  return result;
+}
+
+int
+gams::utility::OscUdpMux::receive(OscMap & values, double max_wait_seconds)
+{
+  std::vector<std::string> new_incoming;
+  {
+    std::lock_guard<std::mutex> guard(mutex_);
+
+    new_incoming.swap(new_incoming_);
+
+    // don't let a partial batch go stale while agents are sensing
+    if (num_pending_ > 0)
+    {
+      batch_timer_.stop();
+
+      if (batch_timer_.duration_ds() >= flush_period_)
+      {
+        flush_unlocked();
+      }
+    }
+  }
+
+  // read the socket without mutex_, so other agents can send meanwhile
+  OscMap received;
+  int result;
+  {
+    std::lock_guard<std::mutex> guard(receive_mutex_);
+
+    for (auto & address : new_incoming)
+    {
+      incoming_[address];
+    }
+
+    result = osc_.receive(incoming_, max_wait_seconds);
+
+    for (auto & value : incoming_)
+    {
+      if (value.second.exists())
+      {
+        received[value.first] = value.second;
+        value.second = madara::knowledge::KnowledgeRecord();
+      }
+    }
+  }
+
+  std::lock_guard<std::mutex> guard(mutex_);
+
+  for (auto & value : received)
+  {
+    auto found = latest_.find(value.first);
+
+    if (found != latest_.end())
+    {
+      found->second = value.second;
+    }
+  }
+
+  for (auto & value : values)
+  {
+    auto found = latest_.find(value.first);
+
+    if (found != latest_.end() && found->second.exists())
+    {
+      value.second = found->second;
+      found->second = madara::knowledge::KnowledgeRecord();
+    }
+  }
+
+  return result;
+}
+
+void
+gams::utility::OscUdpMux::set_max_bundle_size(size_t size)
+{
+  std::lock_guard<std::mutex> guard(mutex_);
+
+  max_bundle_size_ = size;
+}
+
+void
+gams::utility::OscUdpMux::set_flush_period(double seconds)
+{
+  std::lock_guard<std::mutex> guard(mutex_);
+
+  flush_period_ = seconds;
+}
@@ -0,0 +1,181 @@
+/**
+ * Copyright (c) 2019 James Edmondson. All Rights Reserved.
+ *
+ **/
+
+/**
+ * @file OscUdpMux.h
+ * @author James Edmondson <jedmondson@gmail.com>
+ *
+ * This file contains a process-wide OSC UDP transport that batches
+ * the messages of many agents into shared bundles
+ **/
+
+
+#ifndef _GAMS_UTILITY_OSC_UDP_MUX_H_
+#define _GAMS_UTILITY_OSC_UDP_MUX_H_
+
+#include <memory>
+#include <mutex>
+#include <map>
+#include <set>
+#include <vector>
+#include <string>
+
+#include "madara/utility/Timer.h"
+
+#include "gams/GamsExport.h"
+#include "gams/utility/OscUdp.h"
+
+namespace gams
+{
+  namespace utility
+  {
+    /**
+     * An OSC transport shared by all agents in a process that use the
+     * same endpoints. Outgoing messages are aggregated into as few
+     * bundles as the max bundle size allows, and received bundles are
+     * demultiplexed to the agents that registered each address.
+     **/
+    class GAMS_EXPORT OscUdpMux
+    {
+      public:
+        typedef OscUdp::OscMap OscMap;
+
+        /**
+         * Constructor
+         * @param settings   the transport settings for the shared socket
+         **/
+        OscUdpMux (const madara::transport::QoSTransportSettings & settings);
+
+        /**
+         * Returns the multiplexer for the endpoints in settings, creating
+         * it if no other agent in the process currently uses them
+         * @param settings   the transport settings for the shared socket
+         * @return the shared multiplexer
+         **/
+        static std::shared_ptr<OscUdpMux> get (
+          const madara::transport::QoSTransportSettings & settings);
+
+        /**
+         * Adds an agent to the multiplexer
+         * @param addresses  the OSC addresses the agent receives
+         * @return the participant id to use in send
+         **/
+        size_t add_participant (const std::vector<std::string> & addresses);
+
+        /**
+         * Removes an agent from the multiplexer
+         * @param id         the id returned from add_participant
+         * @param addresses  the OSC addresses the agent receives
+         **/
+        void remove_participant (size_t id,
+          const std::vector<std::string> & addresses);
+
+        /**
+         * Queues messages for the next batched send. Messages of different
+         * participants are all sent, even if their addresses are the same
+         * (e.g., /spawn/<type>). The batch is sent
+         * once all participants have queued messages or the flush
+         * period has elapsed since the first message was queued.
+         * @param id       the id returned from add_participant
+         * @param values   the values to send
+         * @return 0 if success, -1 if bad transport, 1 or 2 for socket issues
+         **/
+        int send (size_t id, const OscMap & values);
+
+        /**
+         * Sends all queued messages immediately
+         * @return 0 if success, -1 if bad transport, 1 or 2 for socket issues
+         **/
+        int flush (void);
+
+        /**
+         * Reads pending datagrams from the shared socket and returns the
+         * latest values for the requested addresses. Values are handed
+         * out once, so an empty record means nothing new was received.
+         * The socket is read without blocking sends of other agents.
+         * @param values   the addresses to fill with received values
+         * @param max_wait_seconds the max wait time in seconds (can be <1)
+         * @return 0 if success, -1 if bad transport, 1 or 2 for socket issues
+         **/
+        int receive (OscMap & values, double max_wait_seconds = 0.5);
+
+        /**
+         * Sets the maximum size of an outgoing bundle
+         * @param size   the maximum bytes per datagram (e.g., MTU)
+         **/
+        void set_max_bundle_size (size_t size);
+
+        /**
+         * Sets the longest time a queued message may wait for a batch
+         * @param seconds   the flush period in seconds
+         **/
+        void set_flush_period (double seconds);
+
+      private:
+        /**
+         * Sends all queued messages. Caller must hold mutex_.
+         **/
+        int flush_unlocked (void);
+
+        /**
+         * Resolves the address types used to pack sends. Caller must hold
+         * mutex_, which all sends hold. Receives do not read the address
+         * cache, so a new address never waits on a socket read.
+         **/
+        void register_addresses (const std::vector<std::string> & addresses);
+
+        /// protects all members but those guarded by receive_mutex_.
+        /// Never locked while receive_mutex_ is held.
+        std::mutex mutex_;
+
+        /// protects socket reads and incoming_
+        std::mutex receive_mutex_;
+
+        /// the shared socket
+        OscUdp osc_;
+
+        /// messages queued for the next batch, by participant id
+        std::vector<OscMap> pending_;
+
+        /// number of messages queued for the next batch
+        size_t num_pending_ = 0;
+
+        /// the messages of a batch in send order, reused across flushes
+        OscUdp::OscMessages batch_;
+
+        /// addresses registered with osc_ so far
+        std::set<std::string> registered_;
+
+        /// values decoded by the last socket read
+        OscMap incoming_;
+
+        /// addresses added by participants but not yet to incoming_
+        std::vector<std::string> new_incoming_;
+
+        /// latest received values for all registered addresses
+        OscMap latest_;
+
+        /// whether each participant has queued since the last flush
+        std::vector<bool> queued_;
+
+        /// number of participants that have queued since the last flush
+        size_t num_queued_ = 0;
+
+        /// number of active participants
+        size_t num_participants_ = 0;
+
+        /// max bytes per outgoing bundle
+        size_t max_bundle_size_ = 1400;
+
+        /// max seconds a queued message waits before being flushed
+        double flush_period_ = 0.05;
+
+        /// timer started when the first message of a batch is queued
+        madara::utility::Timer<madara::utility::Clock> batch_timer_;
+    };
+  }
+}
+
+#endif // _GAMS_UTILITY_OSC_UDP_MUX_H_
@@ -0,0 +1,475 @@
+/**
+ * Copyright (c) 2019 James Edmondson. All Rights Reserved.
+ *
+ **/
+
+/**
+ * @file SensorRecord.cpp
+ * @author James Edmondson <jedmondson@gmail.com>
+ *
+ * This file contains binary knowledge records for point clouds and laser
+ * scans, and helpers to decode them into point batches
+ **/
+
+#include "SensorRecord.h"
+
+#include <cmath>
+#include <cstring>
+#include <memory>
+#include <unordered_set>
+
+// A record starts with the record header (magic, type, timestamp, count,
+// step). Point records follow with height, width, field count, flags,
+// the field table and the points. Scan records follow with the seven
+// float32 scan parameters, the ranges and the intensities.
+#define SENSOR_RECORD_MAGIC 0x31525347
+#define RECORD_HEADER_SIZE 24
+#define POINTS_HEADER_SIZE 16
+#define SCAN_HEADER_SIZE 28
+
+// point record flags
+#define POINTS_BIGENDIAN 1
+#define POINTS_DENSE 2
+
+namespace
+{
+  template <typename T>
+  void append_value (std::vector<unsigned char> & buffer, T value)
+  {
+    size_t pos = buffer.size ();
+    buffer.resize (pos + sizeof (T));
+    memcpy (buffer.data () + pos, &value, sizeof (T));
+  }
+
+  template <typename T>
+  T read_value (const unsigned char * buffer)
+  {
+    T value;
+    memcpy (&value, buffer, sizeof (T));
+    return value;
+  }
+
+  void append_header (std::vector<unsigned char> & buffer, uint32_t type,
+    uint64_t timestamp, uint32_t count, uint32_t step)
+  {
+    append_value (buffer, (uint32_t)SENSOR_RECORD_MAGIC);
+    append_value (buffer, type);
+    append_value (buffer, timestamp);
+    append_value (buffer, count);
+    append_value (buffer, step);
+  }
+
+  const gams::utility::PointField * find_field (
+    const std::vector<gams::utility::PointField> & fields,
+    const char * name, uint8_t datatype)
+  {
+    for (const gams::utility::PointField & field : fields)
+    {
+      if (field.name == name && field.count == 1 &&
+        (datatype == 0 || field.datatype == datatype))
+      {
+        return &field;
+      }
+    }
+    return 0;
+  }
+
+  double read_coordinate (const unsigned char * point,
+    const gams::utility::PointField & field)
+  {
+    if (field.datatype == gams::utility::PointField::FLOAT64)
+    {
+      return read_value<double> (point + field.offset);
+    }
+    return read_value<float> (point + field.offset);
+  }
+
+  /**
+   * Copies a binary knowledge record into a buffer
+   **/
+  std::unique_ptr<unsigned char[]> to_buffer (
+    const madara::knowledge::KnowledgeRecord & record, size_t & size)
+  {
+    size = 0;
+    if (!record.is_binary_file_type ())
+    {
+      return std::unique_ptr<unsigned char[]> ();
+    }
+    return std::unique_ptr<unsigned char[]> (
+      record.to_unmanaged_buffer (size));
+  }
+}
+
+void
+gams::utility::encode_point_cloud (const PointCloudRecord & cloud,
+  const unsigned char * data, size_t size,
+  std::vector<unsigned char> & buffer)
+{
+  const uint32_t points =
+    cloud.point_step > 0 ? uint32_t (size / cloud.point_step) : 0;
+
+  // float32 x, y, z and intensity are packed, anything else is kept raw
+  const PointField * xyzi[4] = {
+    find_field (cloud.fields, "x", PointField::FLOAT32),
+    find_field (cloud.fields, "y", PointField::FLOAT32),
+    find_field (cloud.fields, "z", PointField::FLOAT32),
+    find_field (cloud.fields, "intensity", PointField::FLOAT32)
+  };
+  const bool packed =
+    !cloud.is_bigendian && xyzi[0] && xyzi[1] && xyzi[2];
+  const uint32_t packed_fields = xyzi[3] ? 4 : 3;
+
+  uint32_t type = SENSOR_POINTS_RAW;
+  uint32_t step = cloud.point_step;
+  std::vector<PointField> packed_layout;
+  const std::vector<PointField> * fields = &cloud.fields;
+
+  if (packed)
+  {
+    type = packed_fields == 4 ? SENSOR_POINTS_XYZI : SENSOR_POINTS_XYZ;
+    step = packed_fields * sizeof (float);
+    for (uint32_t i = 0; i < packed_fields; ++i)
+    {
+      packed_layout.push_back (*xyzi[i]);
+      packed_layout.back ().offset = i * sizeof (float);
+    }
+    fields = &packed_layout;
+  }
+
+  size_t table_size = 0;
+  for (const PointField & field : *fields)
+  {
+    table_size += 10 + field.name.size ();
+  }
+
+  buffer.clear ();
+  buffer.reserve (RECORD_HEADER_SIZE + POINTS_HEADER_SIZE + table_size +
+    size_t (points) * step);
+
+  append_header (buffer, type, cloud.timestamp, points, step);
+  append_value (buffer, cloud.height);
+  append_value (buffer, cloud.width);
+  append_value (buffer, (uint32_t)fields->size ());
+  append_value (buffer, (uint32_t)(
+    (cloud.is_bigendian ? POINTS_BIGENDIAN : 0) |
+    (cloud.is_dense ? POINTS_DENSE : 0)));
+
+  for (const PointField & field : *fields)
+  {
+    append_value (buffer, field.offset);
+    append_value (buffer, field.count);
+    append_value (buffer, field.datatype);
+    append_value (buffer, (uint8_t)field.name.size ());
+    buffer.insert (buffer.end (), field.name.begin (), field.name.end ());
+  }
+
+  const size_t start = buffer.size ();
+  buffer.resize (start + size_t (points) * step);
+  unsigned char * target = buffer.data () + start;
+
+  bool contiguous = step == cloud.point_step;
+  for (uint32_t i = 0; packed && contiguous && i < packed_fields; ++i)
+  {
+    contiguous = xyzi[i]->offset == i * sizeof (float);
+  }
+
+  if (!packed || contiguous)
+  {
+    memcpy (target, data, size_t (points) * step);
+  }
+  else
+  {
+    for (uint32_t p = 0; p < points; ++p)
+    {
+      const unsigned char * point = data + size_t (p) * cloud.point_step;
+      for (uint32_t i = 0; i < packed_fields; ++i)
+      {
+        memcpy (target, point + xyzi[i]->offset, sizeof (float));
+        target += sizeof (float);
+      }
+    }
+  }
+}
+
+bool
+gams::utility::voxel_filter (const PointCloudRecord & cloud,
+  const unsigned char * data, size_t size, double voxel_size,
+  std::vector<unsigned char> & buffer)
+{
+  const PointField * coordinates[3] = {
+    find_field (cloud.fields, "x", 0),
+    find_field (cloud.fields, "y", 0),
+    find_field (cloud.fields, "z", 0)
+  };
+
+  if (cloud.is_bigendian || cloud.point_step == 0 || voxel_size <= 0)
+  {
+    return false;
+  }
+  for (const PointField * field : coordinates)
+  {
+    if (!field || (field->datatype != PointField::FLOAT32 &&
+      field->datatype != PointField::FLOAT64))
+    {
+      return false;
+    }
+  }
+
+  const size_t count = size / cloud.point_step;
+  std::unordered_set<uint64_t> voxels;
+  voxels.reserve (count / 4);
+  buffer.clear ();
+
+  for (size_t i = 0; i < count; ++i)
+  {
+    const unsigned char * point = data + i * cloud.point_step;
+
+    // 21 bits per axis, voxels further apart alias
+    uint64_t key = 0;
+    bool valid = true;
+    for (const PointField * field : coordinates)
+    {
+      const double value = read_coordinate (point, *field);
+      valid = valid && std::isfinite (value);
+      const int64_t index = valid ?
+        (int64_t)std::floor (value / voxel_size) : 0;
+      key = (key << 21) | (uint64_t (index) & 0x1FFFFF);
+    }
+
+    if (valid && voxels.insert (key).second)
+    {
+      buffer.insert (buffer.end (), point, point + cloud.point_step);
+    }
+  }
+  return true;
+}
+
+void
+gams::utility::encode_laser_scan (const LaserScanRecord & scan,
+  const float * ranges, size_t count,
+  const float * intensities, size_t intensity_count,
+  std::vector<unsigned char> & buffer)
+{
+  buffer.clear ();
+  buffer.reserve (RECORD_HEADER_SIZE + SCAN_HEADER_SIZE +
+    (count + intensity_count) * sizeof (float));
+
+  append_header (buffer, SENSOR_SCAN, scan.timestamp, (uint32_t)count,
+    (uint32_t)intensity_count);
+  append_value (buffer, scan.angle_min);
+  append_value (buffer, scan.angle_max);
+  append_value (buffer, scan.angle_increment);
+  append_value (buffer, scan.time_increment);
+  append_value (buffer, scan.scan_time);
+  append_value (buffer, scan.range_min);
+  append_value (buffer, scan.range_max);
+
+  const size_t start = buffer.size ();
+  buffer.resize (start + (count + intensity_count) * sizeof (float));
+  if (count > 0)
+  {
+    memcpy (buffer.data () + start, ranges, count * sizeof (float));
+  }
+  if (intensity_count > 0)
+  {
+    memcpy (buffer.data () + start + count * sizeof (float), intensities,
+      intensity_count * sizeof (float));
+  }
+}
+
+size_t
+gams::utility::decode_point_cloud (const unsigned char * buffer,
+  size_t size, PointCloudRecord & cloud)
+{
+  if (size < RECORD_HEADER_SIZE + POINTS_HEADER_SIZE ||
+    read_value<uint32_t> (buffer) != SENSOR_RECORD_MAGIC)
+  {
+    return 0;
+  }
+
+  cloud.type = read_value<uint32_t> (buffer + 4);
+  if (cloud.type < SENSOR_POINTS_XYZ || cloud.type > SENSOR_POINTS_RAW)
+  {
+    return 0;
+  }
+
+  cloud.timestamp = read_value<uint64_t> (buffer + 8);
+  const uint32_t points = read_value<uint32_t> (buffer + 16);
+  cloud.point_step = read_value<uint32_t> (buffer + 20);
+  cloud.height = read_value<uint32_t> (buffer + 24);
+  cloud.width = read_value<uint32_t> (buffer + 28);
+  const uint32_t field_count = read_value<uint32_t> (buffer + 32);
+  const uint32_t flags = read_value<uint32_t> (buffer + 36);
+  cloud.is_bigendian = (flags & POINTS_BIGENDIAN) != 0;
+  cloud.is_dense = (flags & POINTS_DENSE) != 0;
+
+  size_t pos = RECORD_HEADER_SIZE + POINTS_HEADER_SIZE;
+  cloud.fields.resize (field_count);
+  for (PointField & field : cloud.fields)
+  {
+    if (pos + 10 > size)
+    {
+      return 0;
+    }
+    field.offset = read_value<uint32_t> (buffer + pos);
+    field.count = read_value<uint32_t> (buffer + pos + 4);
+    field.datatype = buffer[pos + 8];
+    const size_t length = buffer[pos + 9];
+    pos += 10;
+
+    if (pos + length > size)
+    {
+      return 0;
+    }
+    field.name.assign ((const char *)buffer + pos, length);
+    pos += length;
+  }
+
+  if (pos + size_t (points) * cloud.point_step > size)
+  {
+    return 0;
+  }
+  return pos;
+}
+
+bool
+gams::utility::decode_points (const unsigned char * buffer, size_t size,
+  std::vector<pose::Position> & points, std::vector<float> * intensities,
+  const pose::ReferenceFrame & frame)
+{
+  PointCloudRecord cloud;
+  const size_t start = decode_point_cloud (buffer, size, cloud);
+
+  const PointField * x = find_field (cloud.fields, "x", 0);
+  const PointField * y = find_field (cloud.fields, "y", 0);
+  const PointField * z = find_field (cloud.fields, "z", 0);
+  const PointField * intensity =
+    find_field (cloud.fields, "intensity", PointField::FLOAT32);
+
+  if (start == 0 || cloud.is_bigendian || !x || !y || !z ||
+    cloud.point_step == 0)
+  {
+    return false;
+  }
+
+  const PointField * coordinates[3] = {x, y, z};
+  for (const PointField * field : coordinates)
+  {
+    if (field->datatype != PointField::FLOAT32 &&
+      field->datatype != PointField::FLOAT64)
+    {
+      return false;
+    }
+  }
+
+  const size_t count = (size - start) / cloud.point_step;
+  points.clear ();
+  points.reserve (count);
+  if (intensities)
+  {
+    intensities->clear ();
+    if (intensity)
+    {
+      intensities->reserve (count);
+    }
+  }
+
+  for (size_t i = 0; i < count; ++i)
+  {
+    const unsigned char * point = buffer + start + i * cloud.point_step;
+    points.emplace_back (frame, read_coordinate (point, *x),
+      read_coordinate (point, *y), read_coordinate (point, *z));
+
+    if (intensities && intensity)
+    {
+      intensities->push_back (read_value<float> (point + intensity->offset));
+    }
+  }
+  return true;
+}
+
+bool
+gams::utility::decode_points (
+  const madara::knowledge::KnowledgeRecord & record,
+  std::vector<pose::Position> & points, std::vector<float> * intensities,
+  const pose::ReferenceFrame & frame)
+{
+  size_t size;
+  std::unique_ptr<unsigned char[]> buffer = to_buffer (record, size);
+  return buffer && decode_points (buffer.get (), size, points, intensities,
+    frame);
+}
+
+bool
+gams::utility::decode_laser_scan (const unsigned char * buffer,
+  size_t size, LaserScanRecord & scan)
+{
+  if (size < RECORD_HEADER_SIZE + SCAN_HEADER_SIZE ||
+    read_value<uint32_t> (buffer) != SENSOR_RECORD_MAGIC ||
+    read_value<uint32_t> (buffer + 4) != SENSOR_SCAN)
+  {
+    return false;
+  }
+
+  scan.timestamp = read_value<uint64_t> (buffer + 8);
+  const size_t count = read_value<uint32_t> (buffer + 16);
+  const size_t intensity_count = read_value<uint32_t> (buffer + 20);
+
+  const unsigned char * parameters = buffer + RECORD_HEADER_SIZE;
+  scan.angle_min = read_value<float> (parameters);
+  scan.angle_max = read_value<float> (parameters + 4);
+  scan.angle_increment = read_value<float> (parameters + 8);
+  scan.time_increment = read_value<float> (parameters + 12);
+  scan.scan_time = read_value<float> (parameters + 16);
+  scan.range_min = read_value<float> (parameters + 20);
+  scan.range_max = read_value<float> (parameters + 24);
+
+  const size_t start = RECORD_HEADER_SIZE + SCAN_HEADER_SIZE;
+  if (start + (count + intensity_count) * sizeof (float) > size)
+  {
+    return false;
+  }
+
+  scan.ranges.resize (count);
+  scan.intensities.resize (intensity_count);
+  if (count > 0)
+  {
+    memcpy (scan.ranges.data (), buffer + start, count * sizeof (float));
+  }
+  if (intensity_count > 0)
+  {
+    memcpy (scan.intensities.data (),
+      buffer + start + count * sizeof (float),
+      intensity_count * sizeof (float));
+  }
+  return true;
+}
+
+bool
+gams::utility::decode_laser_scan (
+  const madara::knowledge::KnowledgeRecord & record, LaserScanRecord & scan)
+{
+  size_t size;
+  std::unique_ptr<unsigned char[]> buffer = to_buffer (record, size);
+  return buffer && decode_laser_scan (buffer.get (), size, scan);
+}
+
+void
+gams::utility::scan_to_points (const LaserScanRecord & scan,
+  std::vector<pose::Position> & points, const pose::ReferenceFrame & frame)
+{
+  points.clear ();
+  points.reserve (scan.ranges.size ());
+
+  for (size_t i = 0; i < scan.ranges.size (); ++i)
+  {
+    const double range = scan.ranges[i];
+    if (range < scan.range_min || range > scan.range_max)
+    {
+      continue;
+    }
+
+    const double angle = scan.angle_min + i * scan.angle_increment;
+    points.emplace_back (frame, range * cos (angle), range * sin (angle), 0);
+  }
+}
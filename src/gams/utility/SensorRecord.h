@@ -0,0 +1,244 @@
+/**
+ * Copyright (c) 2019 James Edmondson. All Rights Reserved.
+ *
+ **/
+
+/**
+ * @file SensorRecord.h
+ * @author James Edmondson <jedmondson@gmail.com>
+ *
+ * This file contains binary knowledge records for point clouds and laser
+ * scans, and helpers to decode them into point batches
+ *
+ * Compatibility: ros2gams and the ROS bridge used to store a LaserScan as
+ * separate {name}.ranges, {name}.intensities, {name}.angle_min, ...
+ * variables and a PointCloud2 as {name}.data, {name}.fields.{i}.*,
+ * {name}.width, ... variables. Both are now a single file record named
+ * {name}. Consumers of checkpoints or streams written before this change
+ * must keep reading the old variables, and new consumers decode {name}
+ * with decode_laser_scan or decode_point_cloud/decode_points.
+ **/
+
+#ifndef _GAMS_UTILITY_SENSOR_RECORD_H_
+#define _GAMS_UTILITY_SENSOR_RECORD_H_
+
+#include <string>
+#include <vector>
+
+#include "gams/GamsExport.h"
+#include "gams/pose/Pose.h"
+#include "madara/knowledge/KnowledgeRecord.h"
+
+namespace gams
+{
+  namespace utility
+  {
+    /**
+     * Layouts of binary sensor records. Point records start with the
+     * record header and the point cloud header. XYZ and XYZI records
+     * hold packed float32 points, raw records hold a field table and the
+     * unmodified point data. Scan records hold the scan parameters and
+     * the float32 ranges and intensities.
+     **/
+    enum SensorRecordType
+    {
+      SENSOR_POINTS_XYZ = 1,
+      SENSOR_POINTS_XYZI = 2,
+      SENSOR_POINTS_RAW = 3,
+      SENSOR_SCAN = 4
+    };
+
+    /**
+     * Field of a point, using the datatype values of sensor_msgs/PointField
+     **/
+    struct PointField
+    {
+      /// datatypes of point fields
+      enum
+      {
+        INT8 = 1, UINT8 = 2, INT16 = 3, UINT16 = 4,
+        INT32 = 5, UINT32 = 6, FLOAT32 = 7, FLOAT64 = 8
+      };
+
+      /// name of the field (e.g., "x")
+      std::string name;
+
+      /// byte offset within a point
+      uint32_t offset = 0;
+
+      /// datatype of the field
+      uint8_t datatype = 0;
+
+      /// number of elements
+      uint32_t count = 1;
+    };
+
+    /**
+     * Description of a point cloud record
+     **/
+    struct PointCloudRecord
+    {
+      /// the SensorRecordType of the record
+      uint32_t type = 0;
+
+      /// time of the measurement in nanoseconds
+      uint64_t timestamp = 0;
+
+      /// rows of the cloud
+      uint32_t height = 0;
+
+      /// points per row
+      uint32_t width = 0;
+
+      /// bytes per stored point
+      uint32_t point_step = 0;
+
+      /// true if the stored points are big endian
+      bool is_bigendian = false;
+
+      /// true if the cloud has no invalid points
+      bool is_dense = false;
+
+      /// fields of a stored point
+      std::vector<PointField> fields;
+    };
+
+    /**
+     * Contents of a laser scan record
+     **/
+    struct LaserScanRecord
+    {
+      /// time of the measurement in nanoseconds
+      uint64_t timestamp = 0;
+
+      float angle_min = 0;
+      float angle_max = 0;
+      float angle_increment = 0;
+      float time_increment = 0;
+      float scan_time = 0;
+      float range_min = 0;
+      float range_max = 0;
+
+      /// measured ranges
+      std::vector<float> ranges;
+
+      /// measured intensities (may be empty)
+      std::vector<float> intensities;
+    };
+
+    /**
+     * Encodes a point cloud. Clouds with float32 x, y, z (and intensity)
+     * fields are packed into XYZ(I) records, others are stored raw.
+     * @param cloud   description of the cloud data
+     * @param data    the points, cloud.point_step bytes each
+     * @param size    bytes of data
+     * @param buffer  the encoded record. Its capacity is reused.
+     **/
+    GAMS_EXPORT void encode_point_cloud (const PointCloudRecord & cloud,
+      const unsigned char * data, size_t size,
+      std::vector<unsigned char> & buffer);
+
+    /**
+     * Downsamples points to the first point within every voxel. The kept
+     * points are copied with all their fields.
+     * @param cloud       description of the cloud data. The points need
+     *                    x, y and z fields of type float32 or float64 and
+     *                    must be little endian.
+     * @param data        the points, cloud.point_step bytes each
+     * @param size        bytes of data
+     * @param voxel_size  edge length of a voxel
+     * @param buffer      the kept points. Its capacity is reused.
+     * @return false if the points cannot be downsampled
+     **/
+    GAMS_EXPORT bool voxel_filter (const PointCloudRecord & cloud,
+      const unsigned char * data, size_t size, double voxel_size,
+      std::vector<unsigned char> & buffer);
+
+    /**
+     * Encodes a laser scan
+     * @param scan         the scan parameters. ranges and intensities
+     *                     are ignored.
+     * @param ranges       the ranges
+     * @param count        number of ranges
+     * @param intensities  the intensities
+     * @param intensity_count  number of intensities
+     * @param buffer       the encoded record. Its capacity is reused.
+     **/
+    GAMS_EXPORT void encode_laser_scan (const LaserScanRecord & scan,
+      const float * ranges, size_t count,
+      const float * intensities, size_t intensity_count,
+      std::vector<unsigned char> & buffer);
+
+    /**
+     * Decodes the description of a point cloud record
+     * @param buffer  the encoded record
+     * @param size    bytes of the record
+     * @param cloud   the description
+     * @return offset of the point data, or 0 if this is no point record
+     **/
+    GAMS_EXPORT size_t decode_point_cloud (const unsigned char * buffer,
+      size_t size, PointCloudRecord & cloud);
+
+    /**
+     * Decodes the points of a point cloud record. Points of raw records
+     * need x, y and z fields of type float32 or float64.
+     * @param buffer       the encoded record
+     * @param size         bytes of the record
+     * @param points       the decoded points
+     * @param intensities  the decoded intensities, if not null
+     * @param frame        the frame of the points
+     * @return false if the record has no points to decode
+     **/
+    GAMS_EXPORT bool decode_points (const unsigned char * buffer,
+      size_t size, std::vector<pose::Position> & points,
+      std::vector<float> * intensities = 0,
+      const pose::ReferenceFrame & frame = pose::default_frame ());
+
+    /**
+     * Decodes the points of a point cloud record
+     * @param record       a binary knowledge record
+     * @param points       the decoded points
+     * @param intensities  the decoded intensities, if not null
+     * @param frame        the frame of the points
+     * @return false if the record has no points to decode
+     **/
+    GAMS_EXPORT bool decode_points (
+      const madara::knowledge::KnowledgeRecord & record,
+      std::vector<pose::Position> & points,
+      std::vector<float> * intensities = 0,
+      const pose::ReferenceFrame & frame = pose::default_frame ());
+
+    /**
+     * Decodes a laser scan record
+     * @param buffer  the encoded record
+     * @param size    bytes of the record
+     * @param scan    the decoded scan
+     * @return false if this is no scan record
+     **/
+    GAMS_EXPORT bool decode_laser_scan (const unsigned char * buffer,
+      size_t size, LaserScanRecord & scan);
+
+    /**
+     * Decodes a laser scan record
+     * @param record  a binary knowledge record
+     * @param scan    the decoded scan
+     * @return false if this is no scan record
+     **/
+    GAMS_EXPORT bool decode_laser_scan (
+      const madara::knowledge::KnowledgeRecord & record,
+      LaserScanRecord & scan);
+
+    /**
+     * Converts the ranges of a scan to points in the scan's plane. Ranges
+     * outside of [range_min, range_max] are skipped.
+     * @param scan    the scan
+     * @param points  the points
+     * @param frame   the frame of the scanner
+     **/
+    GAMS_EXPORT void scan_to_points (const LaserScanRecord & scan,
+      std::vector<pose::Position> & points,
+      const pose::ReferenceFrame & frame = pose::default_frame ());
+  }
+}
+
+#endif // _GAMS_UTILITY_SENSOR_RECORD_H_
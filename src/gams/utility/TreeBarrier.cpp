@@ -0,0 +1,371 @@
+/**
+ * Copyright(c) 2014 Carnegie Mellon University. All Rights Reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ * 
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following acknowledgments and disclaimers.
+ * 
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ * 
+ * 3. The names "Carnegie Mellon University," "SEI" and/or "Software
+ *    Engineering Institute" shall not be used to endorse or promote products
+ *    derived from this software without prior written permission. For written
+ *    permission, please contact permission@sei.cmu.edu.
+ * 
+ * 4. Products derived from this software may not be called "SEI" nor may "SEI"
+ *    appear in their names without prior written permission of
+ *    permission@sei.cmu.edu.
+ * 
+ * 5. Redistributions of any form whatsoever must retain the following
+ *    acknowledgment:
+ * 
+ *      This material is based upon work funded and supported by the Department
+ *      of Defense under Contract No. FA8721-05-C-0003 with Carnegie Mellon
+ *      University for the operation of the Software Engineering Institute, a
+ *      federally funded research and development center. Any opinions,
+ *      findings and conclusions or recommendations expressed in this material
+ *      are those of the author(s) and do not necessarily reflect the views of
+ *      the United States Department of Defense.
+ * 
+ *      NO WARRANTY. THIS CARNEGIE MELLON UNIVERSITY AND SOFTWARE ENGINEERING
+ *      INSTITUTE MATERIAL IS FURNISHED ON AN "AS-IS" BASIS. CARNEGIE MELLON
+ *      UNIVERSITY MAKES NO WARRANTIES OF ANY KIND, EITHER EXPRESSED OR
+ *      IMPLIED, AS TO ANY MATTER INCLUDING, BUT NOT LIMITED TO, WARRANTY OF
+ *      FITNESS FOR PURPOSE OR MERCHANTABILITY, EXCLUSIVITY, OR RESULTS
+ *      OBTAINED FROM USE OF THE MATERIAL. CARNEGIE MELLON UNIVERSITY DOES
+ *      NOT MAKE ANY WARRANTY OF ANY KIND WITH RESPECT TO FREEDOM FROM PATENT,
+ *      TRADEMARK, OR COPYRIGHT INFRINGEMENT.
+ * 
+ *      This material has been approved for public release and unlimited
+ *      distribution.
+ **/
+
+/**
+ * @file TreeBarrier.cpp
+ * @author James Edmondson <jedmondson@gmail.com>
+ *
+ * Implementation of the fan-in tree barrier
+ **/
+
+#include <sstream>
+
+#include "gams/utility/TreeBarrier.h"
+#include "gams/loggers/GlobalLogger.h"
+
+namespace knowledge = madara::knowledge;
+
+typedef knowledge::KnowledgeRecord::Integer Integer;
+
+gams::utility::TreeBarrier::TreeBarrier()
+  : knowledge_(0), id_(0), participants_(1), fan_in_(0),
+  round_(0), aggregate_(-1), release_(0), waiting_(false),
+  last_wait_(0), max_wait_(0), total_wait_(0), waits_(0)
+{
+  settings_.delay_sending_modifieds = true;
+}
+
+gams::utility::TreeBarrier::~TreeBarrier()
+{
+}
+
+void
+gams::utility::TreeBarrier::set_name(const std::string & name,
+  knowledge::KnowledgeBase & knowledge,
+  int id, int participants, int fan_in)
+{
+  knowledge_ = &knowledge;
+  name_ = name;
+  id_ = id;
+  participants_ = participants > 0 ? participants : 1;
+  fan_in_ = fan_in > 1 ? fan_in : 0;
+  aggregate_ = -1;
+  release_ = 0;
+  child_refs_.clear();
+
+  if (!is_hierarchical())
+  {
+    madara_logger_ptr_log(gams::loggers::global_logger.get(),
+      gams::loggers::LOG_MAJOR,
+      "gams::utility::TreeBarrier::set_name:" \
+      " %s: %d of %d participants in a flat barrier\n",
+      name.c_str(), id, participants_);
+
+    flat_.set_name(name, knowledge, id, participants_);
+    round_ = flat_.get_round();
+    return;
+  }
+
+  knowledge::ContextGuard guard(knowledge);
+
+  std::stringstream buffer;
+  buffer << name << "." << id;
+  aggregate_ref_ = knowledge.get_ref(buffer.str());
+  release_ref_ = knowledge.get_ref(name + ".release");
+
+  // children of node i are i * fan_in + 1 through i * fan_in + fan_in
+  for (int i = 1; i <= fan_in_; ++i)
+  {
+    int child = id * fan_in_ + i;
+
+    if (child >= participants_)
+    {
+      break;
+    }
+
+    buffer.str("");
+    buffer << name << "." << child;
+    child_refs_.push_back(knowledge.get_ref(buffer.str()));
+  }
+
+  madara_logger_ptr_log(gams::loggers::global_logger.get(),
+    gams::loggers::LOG_MAJOR,
+    "gams::utility::TreeBarrier::set_name:" \
+    " %s: %d of %d participants, fan-in %d, parent %d, %d children\n",
+    name.c_str(), id, participants_, fan_in_, get_parent(),
+    (int)child_refs_.size());
+
+  refresh();
+}
+
+void
+gams::utility::TreeBarrier::set(Integer round)
+{
+  round_ = round;
+  waiting_ = false;
+
+  if (!is_hierarchical())
+  {
+    if (knowledge_)
+    {
+      flat_.set(round);
+    }
+  }
+  else
+  {
+    refresh();
+  }
+}
+
+Integer
+gams::utility::TreeBarrier::next(void)
+{
+  ++round_;
+
+  waiting_ = true;
+  wait_start_ = std::chrono::steady_clock::now();
+
+  if (!is_hierarchical())
+  {
+    if (knowledge_)
+    {
+      flat_.next();
+    }
+  }
+  else
+  {
+    refresh();
+  }
+
+  return round_;
+}
+
+Integer
+gams::utility::TreeBarrier::get_round(void) const
+{
+  return round_;
+}
+
+bool
+gams::utility::TreeBarrier::is_done(void)
+{
+  bool result = false;
+
+  if (!knowledge_)
+  {
+    return result;
+  }
+
+  if (!is_hierarchical())
+  {
+    result = flat_.is_done();
+  }
+  else
+  {
+    refresh();
+    result = release_ >= round_;
+  }
+
+  if (result)
+  {
+    finish_wait();
+  }
+
+  return result;
+}
+
+void
+gams::utility::TreeBarrier::modify(void)
+{
+  if (!knowledge_)
+  {
+    return;
+  }
+
+  if (!is_hierarchical())
+  {
+    flat_.modify();
+  }
+  else
+  {
+    refresh(true);
+  }
+}
+
+bool
+gams::utility::TreeBarrier::is_hierarchical(void) const
+{
+  return fan_in_ > 1;
+}
+
+int
+gams::utility::TreeBarrier::get_parent(void) const
+{
+  return is_hierarchical() && id_ > 0 ? (id_ - 1) / fan_in_ : -1;
+}
+
+double
+gams::utility::TreeBarrier::get_last_wait(void) const
+{
+  return last_wait_;
+}
+
+double
+gams::utility::TreeBarrier::get_max_wait(void) const
+{
+  return max_wait_;
+}
+
+double
+gams::utility::TreeBarrier::get_average_wait(void) const
+{
+  return waits_ > 0 ? total_wait_ / waits_ : 0;
+}
+
+size_t
+gams::utility::TreeBarrier::get_completed_rounds(void) const
+{
+  return waits_;
+}
+
+std::string
+gams::utility::TreeBarrier::get_debug_info(void)
+{
+  if (!is_hierarchical())
+  {
+    return knowledge_ ? flat_.get_debug_info() : std::string();
+  }
+
+  std::stringstream buffer;
+
+  buffer << "TreeBarrier: " << name_ << ", id=" << id_ <<
+    ", participants=" << participants_ << ", fan_in=" << fan_in_ <<
+    ", parent=" << get_parent() << ", round=" << round_ <<
+    ", aggregate=" << aggregate_ << ", release=" << release_ <<
+    ", children=[";
+
+  knowledge::ContextGuard guard(*knowledge_);
+
+  for (size_t i = 0; i < child_refs_.size(); ++i)
+  {
+    if (i != 0)
+    {
+      buffer << ", ";
+    }
+    buffer << child_refs_[i].get_name() << "=" <<
+      knowledge_->get(child_refs_[i]).to_integer();
+  }
+
+  buffer << "]\n";
+
+  return buffer.str();
+}
+
+void
+gams::utility::TreeBarrier::refresh(bool force)
+{
+  if (!knowledge_)
+  {
+    return;
+  }
+
+  knowledge::ContextGuard guard(*knowledge_);
+
+  // the subtree has reached the lowest round of this node and its children
+  Integer aggregate = round_;
+
+  for (size_t i = 0; i < child_refs_.size(); ++i)
+  {
+    Integer child = knowledge_->get(child_refs_[i]).to_integer();
+    aggregate = child < aggregate ? child : aggregate;
+  }
+
+  bool changed = false;
+
+  if (aggregate != aggregate_ || force)
+  {
+    aggregate_ = aggregate;
+    knowledge_->set(aggregate_ref_, aggregate_, settings_);
+    changed = true;
+  }
+
+  if (id_ == 0)
+  {
+    // the root's subtree is every participant, so it decides release
+    if (aggregate_ != release_ || force)
+    {
+      release_ = aggregate_;
+      knowledge_->set(release_ref_, release_, settings_);
+      changed = true;
+    }
+  }
+  else
+  {
+    release_ = knowledge_->get(release_ref_).to_integer();
+  }
+
+  if (changed)
+  {
+    madara_logger_ptr_log(gams::loggers::global_logger.get(),
+      gams::loggers::LOG_DETAILED,
+      "gams::utility::TreeBarrier::refresh:" \
+      " %s.%d: round %d, aggregate %d, release %d\n",
+      name_.c_str(), id_, (int)round_, (int)aggregate_, (int)release_);
+  }
+}
+
+void
+gams::utility::TreeBarrier::finish_wait(void)
+{
+  if (waiting_)
+  {
+    waiting_ = false;
+
+    last_wait_ = std::chrono::duration<double>(
+      std::chrono::steady_clock::now() - wait_start_).count();
+
+    max_wait_ = last_wait_ > max_wait_ ? last_wait_ : max_wait_;
+    total_wait_ += last_wait_;
+    ++waits_;
+
+    madara_logger_ptr_log(gams::loggers::global_logger.get(),
+      gams::loggers::LOG_MINOR,
+      "gams::utility::TreeBarrier::finish_wait:" \
+      " %s.%d: round %d completed after %.4fs (max %.4fs, avg %.4fs)\n",
+      name_.c_str(), id_, (int)round_, last_wait_, max_wait_,
+      get_average_wait());
+  }
+}
@@ -0,0 +1,257 @@
+/**
+ * Copyright(c) 2014 Carnegie Mellon University. All Rights Reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ * 
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following acknowledgments and disclaimers.
+ * 
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ * 
+ * 3. The names "Carnegie Mellon University," "SEI" and/or "Software
+ *    Engineering Institute" shall not be used to endorse or promote products
+ *    derived from this software without prior written permission. For written
+ *    permission, please contact permission@sei.cmu.edu.
+ * 
+ * 4. Products derived from this software may not be called "SEI" nor may "SEI"
+ *    appear in their names without prior written permission of
+ *    permission@sei.cmu.edu.
+ * 
+ * 5. Redistributions of any form whatsoever must retain the following
+ *    acknowledgment:
+ * 
+ *      This material is based upon work funded and supported by the Department
+ *      of Defense under Contract No. FA8721-05-C-0003 with Carnegie Mellon
+ *      University for the operation of the Software Engineering Institute, a
+ *      federally funded research and development center. Any opinions,
+ *      findings and conclusions or recommendations expressed in this material
+ *      are those of the author(s) and do not necessarily reflect the views of
+ *      the United States Department of Defense.
+ * 
+ *      NO WARRANTY. THIS CARNEGIE MELLON UNIVERSITY AND SOFTWARE ENGINEERING
+ *      INSTITUTE MATERIAL IS FURNISHED ON AN "AS-IS" BASIS. CARNEGIE MELLON
+ *      UNIVERSITY MAKES NO WARRANTIES OF ANY KIND, EITHER EXPRESSED OR
+ *      IMPLIED, AS TO ANY MATTER INCLUDING, BUT NOT LIMITED TO, WARRANTY OF
+ *      FITNESS FOR PURPOSE OR MERCHANTABILITY, EXCLUSIVITY, OR RESULTS
+ *      OBTAINED FROM USE OF THE MATERIAL. CARNEGIE MELLON UNIVERSITY DOES
+ *      NOT MAKE ANY WARRANTY OF ANY KIND WITH RESPECT TO FREEDOM FROM PATENT,
+ *      TRADEMARK, OR COPYRIGHT INFRINGEMENT.
+ * 
+ *      This material has been approved for public release and unlimited
+ *      distribution.
+ **/
+
+/**
+ * @file TreeBarrier.h
+ * @author James Edmondson <jedmondson@gmail.com>
+ *
+ * This file contains a barrier that aggregates rounds over a fan-in tree
+ **/
+
+#ifndef  _GAMS_UTILITY_TREE_BARRIER_H_
+#define  _GAMS_UTILITY_TREE_BARRIER_H_
+
+#include "gams/GamsExport.h"
+
+#include <chrono>
+#include <string>
+#include <vector>
+
+#include "madara/knowledge/KnowledgeBase.h"
+#include "madara/knowledge/containers/Barrier.h"
+
+namespace gams
+{
+  namespace utility
+  {
+    /**
+    * A barrier with the interface of the MADARA Barrier container that
+    * can organize participants into a fan-in tree. Each participant
+    * publishes the minimum round reached by its subtree, and the root
+    * publishes a release round that all participants read. A round
+    * therefore costs O(n) total updates and completes in O(log n) hops,
+    * rather than every participant reading every other participant.
+    *
+    * A fan-in of 0 or 1 uses a flat MADARA Barrier.
+    *
+    * Updates are written with delayed sending, so they go out with the
+    * next send of the controller (or whoever owns the knowledge base).
+    **/
+    class GAMS_EXPORT TreeBarrier
+    {
+    public:
+      /// the type of barrier rounds
+      typedef madara::knowledge::KnowledgeRecord::Integer Integer;
+
+      /**
+       * Constructor
+       **/
+      TreeBarrier();
+
+      /**
+       * Destructor
+       **/
+      ~TreeBarrier();
+
+      /**
+       * Sets the variable name and participants of the barrier
+       * @param  name          the name of the barrier in the knowledge base
+       * @param  knowledge     the knowledge base to use
+       * @param  id            the id of this participant, [0, participants)
+       * @param  participants  the number of participants
+       * @param  fan_in        the number of children per tree node. 0 or 1
+       *                       uses a flat barrier.
+       **/
+      void set_name(const std::string & name,
+        madara::knowledge::KnowledgeBase & knowledge,
+        int id, int participants, int fan_in = 0);
+
+      /**
+       * Sets the round of this participant
+       * @param  round   the round to set
+       **/
+      void set(Integer round);
+
+      /**
+       * Moves this participant to the next round
+       * @return  the new round
+       **/
+      Integer next(void);
+
+      /**
+       * Gets the round of this participant
+       * @return  the current round
+       **/
+      Integer get_round(void) const;
+
+      /**
+       * Checks whether all participants have reached this round. In tree
+       * mode, this also forwards the subtree aggregate to the parent.
+       * @return  true if the barrier for the current round is done
+       **/
+      bool is_done(void);
+
+      /**
+       * Resends the values published by this participant
+       **/
+      void modify(void);
+
+      /**
+       * Returns true if the barrier is organized as a tree
+       * @return  true if fan-in is greater than 1
+       **/
+      bool is_hierarchical(void) const;
+
+      /**
+       * Gets the parent of this participant in the tree
+       * @return  the parent id, or -1 for the root or a flat barrier
+       **/
+      int get_parent(void) const;
+
+      /**
+       * Gets the seconds spent waiting in the last completed round
+       * @return  the last wait time in seconds
+       **/
+      double get_last_wait(void) const;
+
+      /**
+       * Gets the longest wait for any completed round
+       * @return  the maximum wait time in seconds
+       **/
+      double get_max_wait(void) const;
+
+      /**
+       * Gets the mean wait over all completed rounds
+       * @return  the average wait time in seconds
+       **/
+      double get_average_wait(void) const;
+
+      /**
+       * Gets the number of rounds for which waits were measured
+       * @return  the number of completed rounds
+       **/
+      size_t get_completed_rounds(void) const;
+
+      /**
+       * Gets debug information about the barrier state
+       * @return  a printable summary of the barrier
+       **/
+      std::string get_debug_info(void);
+
+    protected:
+      /**
+       * Reads child aggregates and the release round, publishing
+       * this participant's aggregate if it changed
+       * @param  force  if true, resend even if nothing changed
+       **/
+      void refresh(bool force = false);
+
+      /**
+       * Records the wait time when the current round completes
+       **/
+      void finish_wait(void);
+
+      /// the knowledge base holding barrier variables
+      madara::knowledge::KnowledgeBase * knowledge_;
+
+      /// the barrier name
+      std::string name_;
+
+      /// this participant's id
+      int id_;
+
+      /// the number of participants
+      int participants_;
+
+      /// children per tree node
+      int fan_in_;
+
+      /// the current round of this participant
+      Integer round_;
+
+      /// the last subtree aggregate published by this participant
+      Integer aggregate_;
+
+      /// the last release round seen or published
+      Integer release_;
+
+      /// the flat barrier, used when fan-in is less than 2
+      madara::knowledge::containers::Barrier flat_;
+
+      /// this participant's subtree aggregate, {name}.{id}
+      madara::knowledge::VariableReference aggregate_ref_;
+
+      /// the release round published by the root, {name}.release
+      madara::knowledge::VariableReference release_ref_;
+
+      /// subtree aggregates of this participant's children
+      std::vector<madara::knowledge::VariableReference> child_refs_;
+
+      /// settings that leave updates for the controller to send
+      madara::knowledge::EvalSettings settings_;
+
+      /// true while waiting for the current round to complete
+      bool waiting_;
+
+      /// when the current wait started
+      std::chrono::steady_clock::time_point wait_start_;
+
+      /// the last completed wait, in seconds
+      double last_wait_;
+
+      /// the longest completed wait, in seconds
+      double max_wait_;
+
+      /// the sum of completed waits, in seconds
+      double total_wait_;
+
+      /// the number of completed waits
+      size_t waits_;
+    };
+  }
+}
+
+#endif // _GAMS_UTILITY_TREE_BARRIER_H_
@@ -31,7 +31,7 @@ void gams::utility::ros::GamsParser::parse_message(std::string container_name,
   }
   else if (topic_type == "sensor_msgs/PointCloud2")
   {
-    publish_laserscan(container_name, topic_name);
+    publish_pointcloud2(container_name, topic_name);
   }
   else if (topic_type == "sensor_msgs/CompressedImage")
   {
@@ -152,38 +152,26 @@ void gams::utility::ros::GamsParser::publish_laserscan(
 {
   global_ros::Publisher pub =
     node_.advertise<sensor_msgs::LaserScan>(topic_name, 100);
+
+  // the scan is stored as one binary record
+  gams::utility::LaserScanRecord record;
+  if (!gams::utility::decode_laser_scan(knowledge_->get(container_name),
+    record))
+  {
+    return;
+  }
+
   sensor_msgs::LaserScan scan;
   scan.header.stamp = global_ros::Time::now();
-  //Ranges
-  containers::NativeDoubleVector ranges(container_name + ".ranges",
-    *knowledge_, -1);
-  parse_float64_array(&scan.ranges, &ranges);
-  //Intensities
-  containers::NativeDoubleVector intensities(container_name + ".intensities",
-    *knowledge_, -1, eval_settings_);
-  parse_float64_array(&scan.intensities, &intensities);
-  //Parameters
-  containers::Double angle_min(container_name + ".angle_min", *knowledge_,
-    eval_settings_);
-  scan.angle_min = *angle_min;
-  containers::Double angle_max(container_name + ".angle_max", *knowledge_,
-    eval_settings_);
-  scan.angle_max = *angle_max;
-  containers::Double angle_increment(
-    container_name + ".angle_increment", *knowledge_, eval_settings_);
-  scan.angle_increment = *angle_increment;
-  containers::Double time_increment(container_name + ".time_increment",
-    *knowledge_, eval_settings_);
-   scan.time_increment = *time_increment;
-  containers::Double scan_time(container_name + ".scan_time", *knowledge_,
-    eval_settings_);
-  scan.scan_time = *scan_time;
-  containers::Double range_min(container_name + ".range_min", *knowledge_,
-    eval_settings_);
-  scan.range_min = *range_min;
-  containers::Double range_max(container_name + ".range_max", *knowledge_,
-    eval_settings_);
-   scan.range_max = *range_max;
+  scan.ranges.swap(record.ranges);
+  scan.intensities.swap(record.intensities);
+  scan.angle_min = record.angle_min;
+  scan.angle_max = record.angle_max;
+  scan.angle_increment = record.angle_increment;
+  scan.time_increment = record.time_increment;
+  scan.scan_time = record.scan_time;
+  scan.range_min = record.range_min;
+  scan.range_max = record.range_max;
   
   pub.publish(scan);
 }
@@ -193,31 +181,44 @@ void gams::utility::ros::GamsParser::publish_pointcloud2(
 {
   global_ros::Publisher pub =
     node_.advertise<sensor_msgs::PointCloud2>(topic_name, 100);
+
+  // the cloud is stored as one binary record with its field layout
+  size_t size = 0;
+  knowledge::KnowledgeRecord record = knowledge_->get(container_name);
+  if (!record.is_binary_file_type())
+  {
+    return;
+  }
+  std::unique_ptr<unsigned char[]> buffer(record.to_unmanaged_buffer(size));
+
+  gams::utility::PointCloudRecord layout;
+  size_t start = gams::utility::decode_point_cloud(buffer.get(), size,
+    layout);
+  if (start == 0)
+  {
+    return;
+  }
+
   sensor_msgs::PointCloud2 cloud;
   cloud.header.stamp = global_ros::Time::now();
-  containers::Integer height(container_name + ".height", *knowledge_,
-    eval_settings_);
-  cloud.height = *height;
-  containers::Integer width(container_name + ".width", *knowledge_,
-    eval_settings_);
-  cloud.width = *width;
-  containers::Integer point_step(container_name + ".point_step", *knowledge_,
-    eval_settings_);
-  cloud.point_step = *point_step;
-  containers::Integer row_step(container_name + ".row_step", *knowledge_,
-    eval_settings_);
-  cloud.row_step = *row_step;
-
-  containers::NativeIntegerVector data(container_name + ".data",
-    *knowledge_, -1, eval_settings_);
-  parse_int_array(&cloud.data, &data);
+  cloud.height = layout.height;
+  cloud.width = layout.width;
+  cloud.point_step = layout.point_step;
+  cloud.row_step = layout.point_step * layout.width;
+  cloud.is_bigendian = layout.is_bigendian;
+  cloud.is_dense = layout.is_dense;
+
+  cloud.fields.resize(layout.fields.size());
+  for (size_t i = 0; i < layout.fields.size(); ++i)
+  {
+    cloud.fields[i].name = layout.fields[i].name;
+    cloud.fields[i].offset = layout.fields[i].offset;
+    cloud.fields[i].datatype = layout.fields[i].datatype;
+    cloud.fields[i].count = layout.fields[i].count;
+  }
+  cloud.data.assign(buffer.get() + start, buffer.get() + size);
 
-  containers::Integer is_bigendian(container_name + ".is_bigendian",
-    *knowledge_, eval_settings_);
-  cloud.is_bigendian = *is_bigendian;
-  containers::Integer is_dense(container_name + ".is_dense", *knowledge_,
-    eval_settings_);
-  cloud.is_dense = *is_dense;
+  pub.publish(cloud);
 }
 
 void gams::utility::ros::GamsParser::publish_compressed_image(
@@ -11,6 +11,7 @@
 #include "gams/pose/ReferenceFrame.h"
 #include "gams/pose/Pose.h"
 #include "gams/pose/Quaternion.h"
+#include "gams/utility/SensorRecord.h"
 
 #ifdef __GNUC__
 #pragma GCC diagnostic push
@@ -5,9 +5,247 @@
  * This file contains parsing functionality for ROS topics
  **/
 #include "RosParser.h"
+#include <algorithm>
 #include <cmath>
+#include <mutex>
 #include <dlfcn.h>
 
+#ifdef _GAMS_TYPES_
+#include <geometry_msgs/PoseStamped.h>
+#include "gams/types/Header.capnp.h"
+#include "gams/types/Imu.capnp.h"
+#include "gams/types/Odometry.capnp.h"
+#include "gams/types/Point.capnp.h"
+#include "gams/types/Pose.capnp.h"
+#include "gams/types/PoseStamped.capnp.h"
+#include "gams/types/PoseWithCovariance.capnp.h"
+#include "gams/types/Quaternion.capnp.h"
+#include "gams/types/Twist.capnp.h"
+#include "gams/types/TwistWithCovariance.capnp.h"
+#include "gams/types/Vector3.capnp.h"
+#endif
+
+namespace
+{
+  typedef void(*compiled_any_t)(std::vector<uint8_t> & parser_buffer,
+    capnp::MallocMessageBuilder & builder);
+
+  /**
+   * A ros type with a generated capnproto type in the types library
+   **/
+  struct CompiledType
+  {
+    std::string schema_name;
+    capnp::Schema schema;
+    compiled_any_t convert;
+  };
+
+  /**
+   * Capnproto schemas shared by all parsers of the process. Schema files
+   * are parsed and schemas are registered with madara::knowledge::Any once,
+   * no matter how many parsers(e.g., parser threads) use them.
+   **/
+  struct SchemaCache
+  {
+    SchemaCache();
+
+    std::mutex mutex;
+    capnp::SchemaLoader loader;
+    // schema names by loaded file
+    std::map<std::string, std::vector<std::string>> files;
+    std::map<std::string, capnp::Schema> schemas;
+    // ids of the schemas registered with madara::knowledge::Any by name
+    std::map<std::string, uint64_t> registered;
+    // compiled types by ros datatype
+    std::map<std::string, CompiledType> compiled;
+  };
+
+  SchemaCache & schema_cache()
+  {
+    static SchemaCache cache;
+    return cache;
+  }
+
+  void register_any_schema(const std::string & name, capnp::Schema schema)
+  {
+    SchemaCache & cache = schema_cache();
+    std::lock_guard<std::mutex> guard(cache.mutex);
+    uint64_t id = schema.getProto().getId();
+    auto found = cache.registered.find(name);
+    if (found == cache.registered.end())
+    {
+      madara::knowledge::Any::register_schema(name.c_str(),
+        schema.asStruct());
+      cache.registered[name] = id;
+    }
+    else if (found->second != id)
+    {
+      std::cerr << "Schema " << name << " is already registered with a "
+        "different definition, keeping the first one" << std::endl;
+    }
+  }
+
+  /**
+   * Checks if a flattened message has the fields of the saved leaves. A
+   * leaf is a node of the message definition and its array indices, so
+   * this compares the field names without building them.
+   **/
+  template <typename FlatValues>
+  bool same_leaves(
+    const std::vector<RosIntrospection::StringTreeLeaf> & leaves,
+    const FlatValues & values)
+  {
+    if (leaves.size() != values.size())
+    {
+      return false;
+    }
+    for (size_t i = 0; i < leaves.size(); ++i)
+    {
+      const RosIntrospection::StringTreeLeaf & leaf = values[i].first;
+      if (leaves[i].node_ptr != leaf.node_ptr ||
+        leaves[i].index_array.size() != leaf.index_array.size() ||
+        !std::equal(leaf.index_array.begin(), leaf.index_array.end(),
+          leaves[i].index_array.begin()))
+      {
+        return false;
+      }
+    }
+    return true;
+  }
+
+#ifdef _GAMS_TYPES_
+  // The fill functions map ros messages to the generated types the same
+  // way parse_any maps them dynamically without renaming rules
+
+  void fill(gams::types::Header::Builder builder,
+    const std_msgs::Header & header)
+  {
+    builder.setStamp(header.stamp.toSec());
+    builder.setFrameId(header.frame_id.c_str());
+    builder.setSeq(header.seq);
+  }
+
+  void fill(gams::types::Point::Builder builder,
+    const geometry_msgs::Point & point)
+  {
+    builder.setX(point.x);
+    builder.setY(point.y);
+    builder.setZ(point.z);
+  }
+
+  void fill(gams::types::Vector3::Builder builder,
+    const geometry_msgs::Vector3 & vector)
+  {
+    builder.setX(vector.x);
+    builder.setY(vector.y);
+    builder.setZ(vector.z);
+  }
+
+  void fill(gams::types::Quaternion::Builder builder,
+    const geometry_msgs::Quaternion & quat)
+  {
+    builder.setX(quat.x);
+    builder.setY(quat.y);
+    builder.setZ(quat.z);
+    builder.setW(quat.w);
+  }
+
+  template <size_t N>
+  void fill(capnp::List<double>::Builder builder,
+    const boost::array<double, N> & values)
+  {
+    for (size_t i = 0; i < N; ++i)
+    {
+      builder.set(i, values[i]);
+    }
+  }
+
+  void fill(gams::types::Pose::Builder builder,
+    const geometry_msgs::Pose & pose)
+  {
+    fill(builder.initPosition(), pose.position);
+    fill(builder.initOrientation(), pose.orientation);
+  }
+
+  void fill(gams::types::Twist::Builder builder,
+    const geometry_msgs::Twist & twist)
+  {
+    fill(builder.initLinear(), twist.linear);
+    fill(builder.initAngular(), twist.angular);
+  }
+
+  void fill(gams::types::PoseStamped::Builder builder,
+    const geometry_msgs::PoseStamped & pose)
+  {
+    fill(builder.initHeader(), pose.header);
+    fill(builder.initPose(), pose.pose);
+  }
+
+  void fill(gams::types::Odometry::Builder builder,
+    const nav_msgs::Odometry & odom)
+  {
+    fill(builder.initHeader(), odom.header);
+    builder.setChildFrameId(odom.child_frame_id.c_str());
+    fill(builder.initPose().initPose(), odom.pose.pose);
+    fill(builder.getPose().initCovariance(36), odom.pose.covariance);
+    fill(builder.initTwist().initTwist(), odom.twist.twist);
+    fill(builder.getTwist().initCovariance(36), odom.twist.covariance);
+  }
+
+  void fill(gams::types::Imu::Builder builder, const sensor_msgs::Imu & imu)
+  {
+    fill(builder.initHeader(), imu.header);
+    fill(builder.initOrientation(), imu.orientation);
+    fill(builder.initOrientationCovariance(9), imu.orientation_covariance);
+    fill(builder.initAngularVelocity(), imu.angular_velocity);
+    fill(builder.initAngularVelocityCovariance(9),
+      imu.angular_velocity_covariance);
+    fill(builder.initLinearAcceleration(), imu.linear_acceleration);
+    fill(builder.initLinearAccelerationCovariance(9),
+      imu.linear_acceleration_covariance);
+  }
+
+  template <class RosType, class CapnType>
+  void convert_compiled(std::vector<uint8_t> & parser_buffer,
+    capnp::MallocMessageBuilder & builder)
+  {
+    RosType message;
+    global_ros::serialization::IStream stream(parser_buffer.data(),
+      parser_buffer.size());
+    global_ros::serialization::deserialize(stream, message);
+    fill(builder.initRoot<CapnType>(), message);
+  }
+
+  template <class RosType, class CapnType>
+  void add_compiled(SchemaCache & cache, const std::string & schema_name)
+  {
+    // registered with Any like any other schema once a parser uses it,
+    // so a schema file that defines the same name can take its place
+    cache.compiled[global_ros::message_traits::datatype<RosType>()] =
+      CompiledType{schema_name, capnp::Schema::from<CapnType>(),
+        &convert_compiled<RosType, CapnType>};
+  }
+#endif
+
+  SchemaCache::SchemaCache()
+  {
+#ifdef _GAMS_TYPES_
+    add_compiled<geometry_msgs::Point, gams::types::Point>(*this, "Point");
+    add_compiled<geometry_msgs::Vector3, gams::types::Vector3>(*this,
+      "Vector3");
+    add_compiled<geometry_msgs::Quaternion, gams::types::Quaternion>(*this,
+      "Quaternion");
+    add_compiled<geometry_msgs::Pose, gams::types::Pose>(*this, "Pose");
+    add_compiled<geometry_msgs::Twist, gams::types::Twist>(*this, "Twist");
+    add_compiled<geometry_msgs::PoseStamped, gams::types::PoseStamped>(
+      *this, "PoseStamped");
+    add_compiled<nav_msgs::Odometry, gams::types::Odometry>(*this,
+      "Odometry");
+    add_compiled<sensor_msgs::Imu, gams::types::Imu>(*this, "Imu");
+#endif
+  }
+}
+
 gams::utility::ros::RosParser::RosParser(knowledge::KnowledgeBase * kb,
   std::string world_frame, std::string base_frame,
   std::map<std::string, std::string> capnp_types,
@@ -23,6 +261,12 @@ gams::utility::ros::RosParser::RosParser(knowledge::KnowledgeBase * kb,
   plugin_map_ = plugin_types;
   circular_container_stats_ = circular_containers;
 
+  // compiled types are available without loading their schema files
+  for (auto & compiled : schema_cache().compiled)
+  {
+    schemas_[compiled.second.schema_name] = compiled.second.schema;
+  }
+
   if ( world_frame != "" )
   {
     gams::pose::ReferenceFrame frame(world_frame,
@@ -41,11 +285,46 @@ gams::utility::ros::RosParser::~RosParser()
 
 
 
-void gams::utility::ros::RosParser::parse_message(
+bool gams::utility::ros::RosParser::parse_message(
   const rosbag::MessageInstance m, std::string container_name)
 {
   //Update sim time before parsing
   set_sim_time(m.getTime());
+
+  auto policy = policies_.find(m.getTopic());
+  if (policy != policies_.end())
+  {
+    PolicyState & state = policy->second;
+    if (state.policy.latest_only)
+    {
+      // replaces the held message if it was not flushed yet
+      state.held_bag.reset(new rosbag::MessageInstance(m));
+      state.held_shape.reset();
+      state.held_container = container_name;
+      return false;
+    }
+    if (state.policy.average && m.isType<sensor_msgs::Imu>())
+    {
+      average_imu(state, *m.instantiate<sensor_msgs::Imu>());
+    }
+    if (!admit_message(state, m.getTime().toNSec()))
+    {
+      return false;
+    }
+    if (state.imu_count > 0)
+    {
+      parse_averaged_imu(state, container_name);
+      return true;
+    }
+  }
+
+  dispatch_message(m, container_name);
+  return true;
+}
+
+void gams::utility::ros::RosParser::dispatch_message(
+  const rosbag::MessageInstance & m, const std::string & container_name)
+{
   //Parse the message
   std::string datatype = m.getDataType();
 
@@ -95,7 +374,7 @@ void gams::utility::ros::RosParser::parse_message(
   else if (m.isType<sensor_msgs::PointCloud2>())
   {
     parse_pointcloud2(m.instantiate<sensor_msgs::PointCloud2>().get(),
-        container_name);
+        container_name, get_voxel_size(m.getTopic()));
   }
   else if (m.isType<sensor_msgs::Range>())
   {
@@ -119,13 +398,58 @@ void gams::utility::ros::RosParser::parse_message(
 
 
 
-void gams::utility::ros::RosParser::parse_message(
+bool gams::utility::ros::RosParser::parse_message(
   const topic_tools::ShapeShifter::ConstPtr& m,
-  std::string container_name)
+  std::string container_name, const std::string & topic_name)
 {
-  // TODO: HANDLE CAPNP ANY TYPES!!!
+  auto policy = policies_.find(topic_name);
+  if (policy != policies_.end())
+  {
+    PolicyState & state = policy->second;
+    if (state.policy.latest_only)
+    {
+      // replaces the held message if it was not flushed yet
+      state.held_shape = m;
+      state.held_bag.reset();
+      state.held_container = container_name;
+      return false;
+    }
+    if (state.policy.average && m->getDataType() == "sensor_msgs/Imu")
+    {
+      average_imu(state, *m->instantiate<sensor_msgs::Imu>());
+    }
+    if (!admit_message(state, global_ros::WallTime::now().toNSec()))
+    {
+      return false;
+    }
+    if (state.imu_count > 0)
+    {
+      parse_averaged_imu(state, container_name);
+      return true;
+    }
+  }
+
+  dispatch_message(m, container_name, topic_name);
+  return true;
+}
 
-  if (m->getDataType() == "std_msgs/Int32")
+void gams::utility::ros::RosParser::dispatch_message(
+  const topic_tools::ShapeShifter::ConstPtr& m,
+  const std::string & container_name, const std::string & topic_name)
+{
+  if (topic_name != "" &&
+    capnp_types_.find(m->getDataType()) != capnp_types_.end())
+  {
+    parse_any(topic_name, *m, container_name);
+  }
+  else if (get_plugin_flags(m->getDataType()) & PLUGIN_TYPED_OUTPUT)
+  {
+    // legacy plugins need a rosbag::MessageInstance and are bag only
+    plugin_output_.clear();
+    run_plugin(m->getDataType(), *m, container_name, plugin_output_);
+    apply_plugin_output(plugin_output_);
+  }
+  else if (m->getDataType() == "std_msgs/Int32")
   {
     int value = m->instantiate<std_msgs::Int32>()->data;
     knowledge_->set(container_name, value, eval_settings_);
@@ -163,7 +487,7 @@ void gams::utility::ros::RosParser::parse_message(
   else if (m->getDataType() == "sensor_msgs/PointCloud2")
   {
     parse_pointcloud2(m->instantiate<sensor_msgs::PointCloud2>().get(),
-        container_name);
+        container_name, get_voxel_size(topic_name));
   }
   else if (m->getDataType() == "sensor_msgs/Range")
   {
@@ -181,6 +505,138 @@ void gams::utility::ros::RosParser::parse_message(
   }
 }
 
+void gams::utility::ros::RosParser::set_topic_policies(
+  const std::map<std::string, TopicPolicy> & policies)
+{
+  policies_.clear();
+  for (auto & policy : policies)
+  {
+    policies_[policy.first].policy = policy.second;
+  }
+}
+
+bool gams::utility::ros::RosParser::has_held() const
+{
+  for (auto & policy : policies_)
+  {
+    if (policy.second.held_bag || policy.second.held_shape)
+    {
+      return true;
+    }
+  }
+  return false;
+}
+
+size_t gams::utility::ros::RosParser::flush_held()
+{
+  size_t flushed = 0;
+  for (auto & policy : policies_)
+  {
+    PolicyState & state = policy.second;
+    if (state.held_bag)
+    {
+      dispatch_message(*state.held_bag, state.held_container);
+      state.held_bag.reset();
+      ++flushed;
+    }
+    else if (state.held_shape)
+    {
+      dispatch_message(state.held_shape, state.held_container, policy.first);
+      state.held_shape.reset();
+      ++flushed;
+    }
+  }
+  return flushed;
+}
+
+bool gams::utility::ros::RosParser::admit_message(PolicyState & state,
+  uint64_t time)
+{
+  ++state.count;
+  if (state.policy.decimation > 1 &&
+    (state.count - 1) % state.policy.decimation != 0)
+  {
+    return false;
+  }
+  if (state.policy.min_period > 0 && state.count > 1 &&
+    time < state.last_written + state.policy.min_period)
+  {
+    return false;
+  }
+  state.last_written = time;
+  return true;
+}
+
+void gams::utility::ros::RosParser::average_imu(PolicyState & state,
+  const sensor_msgs::Imu & imu)
+{
+  sensor_msgs::Imu & sum = state.imu_sum;
+  if (state.imu_count == 0)
+  {
+    sum = imu;
+  }
+  else
+  {
+    // q and -q are the same orientation, add the one closer to the sum
+    double sign = sum.orientation.x * imu.orientation.x +
+      sum.orientation.y * imu.orientation.y +
+      sum.orientation.z * imu.orientation.z +
+      sum.orientation.w * imu.orientation.w < 0 ? -1 : 1;
+    sum.orientation.x += sign * imu.orientation.x;
+    sum.orientation.y += sign * imu.orientation.y;
+    sum.orientation.z += sign * imu.orientation.z;
+    sum.orientation.w += sign * imu.orientation.w;
+    sum.angular_velocity.x += imu.angular_velocity.x;
+    sum.angular_velocity.y += imu.angular_velocity.y;
+    sum.angular_velocity.z += imu.angular_velocity.z;
+    sum.linear_acceleration.x += imu.linear_acceleration.x;
+    sum.linear_acceleration.y += imu.linear_acceleration.y;
+    sum.linear_acceleration.z += imu.linear_acceleration.z;
+
+    // the header and covariances are taken from the latest message
+    sum.header = imu.header;
+    sum.orientation_covariance = imu.orientation_covariance;
+    sum.angular_velocity_covariance = imu.angular_velocity_covariance;
+    sum.linear_acceleration_covariance = imu.linear_acceleration_covariance;
+  }
+  ++state.imu_count;
+}
+
+void gams::utility::ros::RosParser::parse_averaged_imu(PolicyState & state,
+  const std::string & container_name)
+{
+  sensor_msgs::Imu imu = state.imu_sum;
+  const double count = state.imu_count;
+  state.imu_count = 0;
+
+  double norm = std::sqrt(imu.orientation.x * imu.orientation.x +
+    imu.orientation.y * imu.orientation.y +
+    imu.orientation.z * imu.orientation.z +
+    imu.orientation.w * imu.orientation.w);
+  if (norm > 0)
+  {
+    imu.orientation.x /= norm;
+    imu.orientation.y /= norm;
+    imu.orientation.z /= norm;
+    imu.orientation.w /= norm;
+  }
+  imu.angular_velocity.x /= count;
+  imu.angular_velocity.y /= count;
+  imu.angular_velocity.z /= count;
+  imu.linear_acceleration.x /= count;
+  imu.linear_acceleration.y /= count;
+  imu.linear_acceleration.z /= count;
+
+  parse_imu(&imu, container_name);
+}
+
+double gams::utility::ros::RosParser::get_voxel_size(
+  const std::string & topic) const
+{
+  auto policy = policies_.find(topic);
+  return policy != policies_.end() ? policy->second.policy.voxel_size : 0;
+}
+
 /**
 * Parses unknown messages using ros_type_introspection
 * DO NOT USE THIS FOR TYPES WITH LARGE ARRAYS
@@ -352,45 +808,27 @@ void gams::utility::ros::RosParser::parse_imu(sensor_msgs::Imu *imu,
 /**
 * Parses a ROS LaserScan Message
 * @param  laser         the sensor_msgs::LaserScan message
-* @param  knowledge     Knowledgbase
-* @param  container_name    container namespace(e.g. "laser")
+* @param  container_name    name of the binary scan record(e.g. "laser")
 **/
 void gams::utility::ros::RosParser::parse_laserscan(
   sensor_msgs::LaserScan * laser, std::string container_name)
 {
-  //Ranges
-  int ranges_size = laser->ranges.size();
-  containers::NativeDoubleVector ranges(container_name + ".ranges",
-    *knowledge_, ranges_size, eval_settings_);
-  parse_float64_array(&laser->ranges, &ranges);
-  //Intensities
-  int intensities_size = laser->intensities.size();
-  containers::NativeDoubleVector intensities(container_name + ".intensities",
-    *knowledge_, intensities_size, eval_settings_);
-  parse_float64_array(&laser->intensities, &intensities);
-  //Parameters
-  containers::Double angle_min(container_name + ".angle_min", *knowledge_,
-    eval_settings_);
-  angle_min = laser->angle_min;
-  containers::Double angle_max(container_name + ".angle_max", *knowledge_,
-    eval_settings_);
-  angle_max = laser->angle_max;
-  containers::Double angle_increment(
-    container_name + ".angle_increment", *knowledge_, eval_settings_);
-  angle_increment = laser->angle_increment;
-  containers::Double time_increment(container_name + ".time_increment",
-    *knowledge_, eval_settings_);
-  time_increment = laser->time_increment;
-  containers::Double scan_time(container_name + ".scan_time", *knowledge_,
-    eval_settings_);
-  scan_time = laser->scan_time;
-  containers::Double range_min(container_name + ".range_min", *knowledge_,
-    eval_settings_);
-  range_min = laser->range_min;
-  containers::Double range_max(container_name + ".range_max", *knowledge_,
-    eval_settings_);
-  range_max = laser->range_max;
-
+  // Parameters, ranges and intensities are stored as one binary record
+  gams::utility::LaserScanRecord scan;
+  scan.timestamp = laser->header.stamp.toNSec();
+  scan.angle_min = laser->angle_min;
+  scan.angle_max = laser->angle_max;
+  scan.angle_increment = laser->angle_increment;
+  scan.time_increment = laser->time_increment;
+  scan.scan_time = laser->scan_time;
+  scan.range_min = laser->range_min;
+  scan.range_max = laser->range_max;
+
+  gams::utility::encode_laser_scan(scan,
+    laser->ranges.data(), laser->ranges.size(),
+    laser->intensities.data(), laser->intensities.size(), sensor_buffer_);
+  knowledge_->set_file(container_name, sensor_buffer_.data(),
+    sensor_buffer_.size(), eval_settings_);
 }
 
 /**
@@ -458,161 +896,236 @@ void gams::utility::ros::RosParser::parse_compressed_image(
 }
 
 /**
-* Parses a ROS TF Message
+* Parses a ROS TF Message. Only the newest transform of each child frame is
+* saved and all frames are written in one knowledgebase transaction. The
+* transform tree is reloaded only if its topology changed, otherwise the
+* agent pose is composed from the latest transforms.
 * @param  tf           the tf2_msgs::TFMessage message
-* @param  knowledge     Knowledgbase
 **/
 void gams::utility::ros::RosParser::parse_tf_message(tf2_msgs::TFMessage * tf)
 {
   // Expire frames after 0.1 seconds
   gams::pose::ReferenceFrame::default_expiry(10000000000);
-  uint64_t max_timestamp = 0;
-  for (tf2_msgs::TFMessage::_transforms_type::iterator iter =
-    tf->transforms.begin(); iter != tf->transforms.end(); ++iter)
+
+  // drop transforms superseded by a newer one of the same child frame
+  std::map<std::string, const geometry_msgs::TransformStamped *> latest;
+  for (const geometry_msgs::TransformStamped & transform : tf->transforms)
   {
-    // read frame names_ 
-    std::string frame_id = iter->header.frame_id;
-    std::string child_frame_id = iter->child_frame_id;
-    std::replace( frame_id.begin(), frame_id.end(), '/', '_');
+    std::string child_frame_id = transform.child_frame_id;
     std::replace( child_frame_id.begin(), child_frame_id.end(), '/', '_');
 
-    // parse the rotation and orientation
-    gams::pose::ReferenceFrame parent;
-    try
+    const geometry_msgs::TransformStamped *& entry = latest[child_frame_id];
+    if (entry == nullptr || !(transform.header.stamp < entry->header.stamp))
     {
-      parent = gams::pose::ReferenceFrame::load(
-        *knowledge_, frame_id);
+      entry = &transform;
     }
-    catch (gams::exceptions::ReferenceFrameException)
+  }
+
+  madara::knowledge::ContextGuard guard(*knowledge_);
+
+  for (auto & entry : latest)
+  {
+    const geometry_msgs::TransformStamped & transform = *entry.second;
+
+    // read frame names_ 
+    std::string frame_id = transform.header.frame_id;
+    std::replace( frame_id.begin(), frame_id.end(), '/', '_');
+
+    TfTransform & cached = tf_transforms_[entry.first];
+    if (cached.parent != frame_id)
     {
-      parent = gams::pose::ReferenceFrame(frame_id,
-        gams::pose::Pose(gams::pose::ReferenceFrame(), 0, 0));
+      cached.parent = frame_id;
+      tf_topology_changed_ = true;
     }
 
-    gams::pose::Quaternion quat(iter->transform.rotation.x,
-                  iter->transform.rotation.y,
-                  iter->transform.rotation.z,
-                  iter->transform.rotation.w);
-    gams::pose::PositionVector position(
-                    iter->transform.translation.x,
-                    iter->transform.translation.y,
-                    iter->transform.translation.z);
-
-    gams::pose::Pose pose(parent, position,
-        gams::pose::OrientationVector(quat));
-    uint64_t timestamp = iter->header.stamp.sec;
-    timestamp = timestamp*1000000000 + iter->header.stamp.nsec;
-    gams::pose::ReferenceFrame child_frame(child_frame_id, pose, timestamp);
+    // parse the rotation and orientation
+    gams::pose::Quaternion quat(transform.transform.rotation.x,
+                  transform.transform.rotation.y,
+                  transform.transform.rotation.z,
+                  transform.transform.rotation.w);
+    gams::pose::OrientationVector orientation(quat);
+    cached.position = gams::pose::PositionVector(
+                    transform.transform.translation.x,
+                    transform.transform.translation.y,
+                    transform.transform.translation.z);
+    cached.rotation = gams::pose::Quaternion(orientation);
+    cached.timestamp = transform.header.stamp.sec;
+    cached.timestamp = cached.timestamp*1000000000 +
+      transform.header.stamp.nsec;
+
+    gams::pose::Pose pose(get_tf_frame(frame_id), cached.position,
+        orientation);
+    gams::pose::ReferenceFrame child_frame(entry.first, pose,
+      cached.timestamp);
 
     child_frame.save(*knowledge_,
       gams::pose::FrameEvalSettings(frame_prefix_, eval_settings_));
-    if (timestamp > max_timestamp)
-      max_timestamp = timestamp;
   }
   if (base_frame_ != "" && world_frame_ != "")
   {
     // World and base frames are defined so we can calculate the agent
     // location and orientation
-    gams::pose::ReferenceFrame world;
-    gams::pose::ReferenceFrame base;
-    try
+    gams::pose::PositionVector location_vec;
+    gams::pose::OrientationVector orientation_vec;
+    gams::pose::Quaternion rotation;
+
+    if (!tf_topology_changed_ && compose_tf_chain(location_vec, rotation))
     {
-      std::vector<std::string> ids = {base_frame_, world_frame_};
-      std::vector<gams::pose::ReferenceFrame> frames = 
-        gams::pose::ReferenceFrame::load_tree(*knowledge_, ids);
-      for (gams::pose::ReferenceFrame frame : frames)
+      orientation_vec = gams::pose::OrientationVector(rotation);
+    }
+    else
+    {
+      gams::pose::ReferenceFrame world;
+      gams::pose::ReferenceFrame base;
+      try
       {
-        if (frame.id() == base_frame_)
+        std::vector<std::string> ids = {base_frame_, world_frame_};
+        std::vector<gams::pose::ReferenceFrame> frames = 
+          gams::pose::ReferenceFrame::load_tree(*knowledge_, ids);
+        for (gams::pose::ReferenceFrame frame : frames)
         {
-          base = frame;
-        }
-        else if (frame.id() == world_frame_)
-        {
-          world = frame;
+          if (frame.id() == base_frame_)
+          {
+            base = frame;
+          }
+          else if (frame.id() == world_frame_)
+          {
+            world = frame;
+          }
         }
       }
+      catch (gams::exceptions::ReferenceFrameException ex)
+      {
+        return;
+      }
+      try
+      {
+        auto base_origin = base.origin();
+        gams::pose::Pose base_pose = base_origin.transform_to(world);
+        location_vec = base_pose.as_location_vec();
+        orientation_vec = base_pose.as_orientation_vec();
+      }
+      catch (gams::pose::unrelated_frames ex)
+      {
+        return;
+      }
+      // the tree is consistent, later poses are composed in memory
+      tf_topology_changed_ = false;
     }
-    catch (gams::exceptions::ReferenceFrameException ex)
-    {
-      return;
-    }
-    try
+
+    containers::NativeDoubleVector location("agent.0.location",
+      *knowledge_, 3, eval_settings_);
+    containers::NativeDoubleVector orientation("agent.0.orientation",
+      *knowledge_, 3, eval_settings_);
+    location.set(0, location_vec.get(0), eval_settings_);
+    location.set(1, location_vec.get(1), eval_settings_);
+    location.set(2, location_vec.get(2), eval_settings_);
+    orientation.set(0, orientation_vec.get(0), eval_settings_);
+    orientation.set(1, orientation_vec.get(1), eval_settings_);
+    orientation.set(2, orientation_vec.get(2), eval_settings_);
+  }
+}
+
+gams::pose::ReferenceFrame gams::utility::ros::RosParser::get_tf_frame(
+  const std::string & id)
+{
+  auto found = tf_frames_.find(id);
+  if (found != tf_frames_.end())
+  {
+    return found->second;
+  }
+
+  // saved children only reference the parent id, so the first version
+  // of a frame serves all later transforms
+  gams::pose::ReferenceFrame frame;
+  try
+  {
+    frame = gams::pose::ReferenceFrame::load(*knowledge_, id);
+  }
+  catch (gams::exceptions::ReferenceFrameException)
+  {
+    frame = gams::pose::ReferenceFrame(id,
+      gams::pose::Pose(gams::pose::ReferenceFrame(), 0, 0));
+  }
+  tf_frames_[id] = frame;
+  return frame;
+}
+
+bool gams::utility::ros::RosParser::compose_tf_chain(
+  gams::pose::PositionVector & position, gams::pose::Quaternion & rotation)
+{
+  position = gams::pose::PositionVector(0, 0, 0);
+  rotation = gams::pose::Quaternion(0, 0, 0, 1);
+
+  // walk up from the base frame, at most once through every frame
+  std::string current = base_frame_;
+  for (size_t depth = 0; current != world_frame_; ++depth)
+  {
+    auto found = tf_transforms_.find(current);
+    if (found == tf_transforms_.end() || depth > tf_transforms_.size())
     {
-      auto base_origin = base.origin();
-      gams::pose::Pose base_pose = base_origin.transform_to(world);
-      containers::NativeDoubleVector location("agent.0.location",
-        *knowledge_, 3, eval_settings_);
-      containers::NativeDoubleVector orientation("agent.0.orientation",
-        *knowledge_, 3, eval_settings_);
-      location.set(0, base_pose.as_location_vec().get(0), eval_settings_);
-      location.set(1, base_pose.as_location_vec().get(1), eval_settings_);
-      location.set(2, base_pose.as_location_vec().get(2), eval_settings_);
-      orientation.set(0, base_pose.as_orientation_vec().get(0),
-        eval_settings_);
-      orientation.set(1, base_pose.as_orientation_vec().get(1),
-        eval_settings_);
-      orientation.set(2, base_pose.as_orientation_vec().get(2),
-        eval_settings_);
+      return false;
     }
-    catch (gams::pose::unrelated_frames ex)
-    {}
+    const TfTransform & transform = found->second;
+
+    // express the pose so far in the parent frame
+    gams::pose::Quaternion offset(position);
+    offset.orient_by(transform.rotation);
+    offset.to_linear_vector(position);
+    position = gams::pose::PositionVector(
+      position.get(0) + transform.position.get(0),
+      position.get(1) + transform.position.get(1),
+      position.get(2) + transform.position.get(2));
+    rotation.pre_multiply(transform.rotation);
+
+    current = transform.parent;
   }
+  return true;
 }
 
 
 /**
 * Parses a ROS PointCloud2 Message
-* @param  laser         the sensor_msgs::PointCloud2 message
-* @param  knowledge     Knowledgbase
-* @param  container_name    container namespace(e.g. "pointcloud")
+* @param  pointcloud    the sensor_msgs::PointCloud2 message
+* @param  container_name    name of the binary cloud record(e.g. "pointcloud")
+* @param  voxel_size        keeps one point per voxel of this size if > 0
 **/
 void gams::utility::ros::RosParser::parse_pointcloud2(sensor_msgs::PointCloud2 * pointcloud,
-  std::string container_name)
+  std::string container_name, double voxel_size)
 {
-  containers::Integer height(container_name + ".height", *knowledge_,
-    eval_settings_);
-  height = pointcloud->height;
-  containers::Integer width(container_name + ".width", *knowledge_,
-    eval_settings_);
-  width = pointcloud->width;
-  containers::Integer point_step(container_name + ".point_step", *knowledge_,
-    eval_settings_);
-  point_step = pointcloud->point_step;
-  containers::Integer row_step(container_name + ".row_step", *knowledge_,
-    eval_settings_);
-  row_step = pointcloud->row_step;
-
-  //TODO: data is a vector of int8 which is parsed into an NativeIntegerVector
-  //-> change to NativeCharVector etc???
-  int len = pointcloud->data.size();
-  containers::NativeIntegerVector data(container_name + ".data",
-    *knowledge_, len, eval_settings_);
-  parse_int_array(&pointcloud->data, &data);
+  // The cloud is stored as one binary record with its field layout
+  gams::utility::PointCloudRecord cloud;
+  cloud.timestamp = pointcloud->header.stamp.toNSec();
+  cloud.height = pointcloud->height;
+  cloud.width = pointcloud->width;
+  cloud.point_step = pointcloud->point_step;
+  cloud.is_bigendian = pointcloud->is_bigendian;
+  cloud.is_dense = pointcloud->is_dense;
+
+  cloud.fields.resize(pointcloud->fields.size());
+  for (size_t i = 0; i < pointcloud->fields.size(); ++i)
+  {
+    cloud.fields[i].name = pointcloud->fields[i].name;
+    cloud.fields[i].offset = pointcloud->fields[i].offset;
+    cloud.fields[i].datatype = pointcloud->fields[i].datatype;
+    cloud.fields[i].count = pointcloud->fields[i].count;
+  }
 
-  int field_index = 0;
-  for (sensor_msgs::PointCloud2::_fields_type::iterator iter =
-        pointcloud->fields.begin(); iter != pointcloud->fields.end(); ++iter)
+  const unsigned char * data = pointcloud->data.data();
+  size_t size = pointcloud->data.size();
+  if (voxel_size > 0 && gams::utility::voxel_filter(cloud, data, size,
+    voxel_size, voxel_buffer_))
   {
-    std::string name = container_name +
-      ".fields." + std::to_string(field_index);
-    containers::Integer offset(name + ".offset", *knowledge_, eval_settings_);
-    offset = iter->offset;
-    containers::Integer datatype(name + ".datatype", *knowledge_,
-      eval_settings_);
-    datatype = iter->datatype;
-    containers::Integer count(name + ".count", *knowledge_, eval_settings_);
-    count = iter->count;
-    containers::String fieldname(name + ".name", *knowledge_, eval_settings_);
-    fieldname = iter->name;
-    ++field_index;
+    // the kept points form an unorganized cloud
+    data = voxel_buffer_.data();
+    size = voxel_buffer_.size();
+    cloud.height = 1;
+    cloud.width = size / cloud.point_step;
   }
 
-  containers::Integer is_bigendian(container_name + ".is_bigendian",
-    *knowledge_, eval_settings_);
-  is_bigendian = pointcloud->is_bigendian;
-  containers::Integer is_dense(container_name + ".is_dense", *knowledge_,
-    eval_settings_);
-  is_dense = pointcloud->is_dense;
+  gams::utility::encode_point_cloud(cloud, data, size, sensor_buffer_);
+  knowledge_->set_file(container_name, sensor_buffer_.data(),
+    sensor_buffer_.size(), eval_settings_);
 }
 
 /**
@@ -779,20 +1292,35 @@ std::string gams::utility::ros::ros_to_gams_name(std::string ros_topic_name)
  **/
 void gams::utility::ros::RosParser::load_capn_schema(std::string path)
 {
-  try{
-    int fd = open(path.c_str(), 0, O_RDONLY);
-    capnp::StreamFdMessageReader schema_message_reader(fd);
-    auto schema_reader = 
-      schema_message_reader.getRoot<capnp::schema::CodeGeneratorRequest>();
-  
-    for (auto schema : schema_reader.getNodes()) {
-      std::string schema_name = cleanCapnpSchemaName(schema.getDisplayName());
-      schemas_[schema_name] = capnp_loader_.load(schema);
+  SchemaCache & cache = schema_cache();
+  std::lock_guard<std::mutex> guard(cache.mutex);
+
+  auto file = cache.files.find(path);
+  if (file == cache.files.end())
+  {
+    std::vector<std::string> & names = cache.files[path];
+    try{
+      int fd = open(path.c_str(), 0, O_RDONLY);
+      capnp::StreamFdMessageReader schema_message_reader(fd);
+      auto schema_reader = 
+        schema_message_reader.getRoot<capnp::schema::CodeGeneratorRequest>();
+    
+      for (auto schema : schema_reader.getNodes()) {
+        std::string schema_name = cleanCapnpSchemaName(schema.getDisplayName());
+        cache.schemas[schema_name] = cache.loader.load(schema);
+        names.push_back(schema_name);
+      }
     }
+    catch (...)
+    {
+      std::cout << "Could not load schema " << path << "!" << std::endl;
+    }
+    file = cache.files.find(path);
   }
-  catch (...)
+
+  for (const std::string & schema_name : file->second)
   {
-    std::cout << "Could not load schema " << path << "!" << std::endl;
+    schemas_[schema_name] = cache.schemas[schema_name];
   }
 }
 
@@ -808,6 +1336,40 @@ void gams::utility::ros::RosParser::print_schemas()
   }
 }
 
+bool gams::utility::ros::RosParser::is_compiled(
+  const std::string & topic_name) const
+{
+  auto plan = any_plans_.find(topic_name);
+  return plan != any_plans_.end() && plan->second.compiled != nullptr;
+}
+
+/**
+ * Registers the schemas of all mapped Any types
+ **/
+void gams::utility::ros::RosParser::register_schemas()
+{
+  for (auto type : capnp_types_)
+  {
+    auto schema = schemas_.find(type.second);
+    if (schema != schemas_.end())
+    {
+      register_any_schema(type.second, schema->second);
+    }
+  }
+}
+
+/**
+ * Applies a value parsed by another parser instance
+ **/
+void gams::utility::ros::RosParser::apply_parsed(global_ros::Time time,
+  const std::string & container_name,
+  const knowledge::KnowledgeRecord & value)
+{
+  set_sim_time(time);
+  knowledge_->set(knowledge_->get_ref(container_name, eval_settings_),
+    value, eval_settings_);
+}
+
 /*
 Searches for a given name in the schema builder and returns the new builder
 */
@@ -874,29 +1436,7 @@ void gams::utility::ros::RosParser::set_dyn_capnp_value(
   T val,
   unsigned int array_size)
 {
-    //remove _ values from the name string and change it to camelcase
-    std::stringstream camelcase;
-    for (unsigned int i = 0; i < name.size(); i++)
-    {
-      if (name[i] == '_')
-      {
-        camelcase.put(toupper(name[i + 1]));
-        i++;
-      }
-      else
-      {
-        if ( i == 0 )
-        {
-          // first character has to be lowercase
-          camelcase.put(tolower(name[i]));
-        }
-        else
-        {
-          camelcase.put(name[i]);
-        }
-      }
-    }
-    name = camelcase.str();
+    name = to_capnp_name(name);
 
     int struct_end = name.find_last_of("/");
     std::string struct_name = name.substr(0,struct_end);
@@ -943,6 +1483,37 @@ void gams::utility::ros::RosParser::set_dyn_capnp_value(
 }
 
 
+/*
+Removes _ values from the name string and changes it to camelcase
+*/
+std::string gams::utility::ros::RosParser::to_capnp_name(
+  const std::string & name)
+{
+  std::string camelcase;
+  camelcase.reserve(name.size());
+  for (unsigned int i = 0; i < name.size(); i++)
+  {
+    if (name[i] == '_')
+    {
+      if (i + 1 < name.size())
+      {
+        camelcase.push_back(toupper(name[i + 1]));
+      }
+      i++;
+    }
+    else if ( i == 0 )
+    {
+      // first character has to be lowercase
+      camelcase.push_back(tolower(name[i]));
+    }
+    else
+    {
+      camelcase.push_back(name[i]);
+    }
+  }
+  return camelcase;
+}
+
 /*
   Determines the size of an ros introspection array
 */
@@ -984,28 +1555,199 @@ unsigned int gams::utility::ros::RosParser::get_array_size(std::string var_name,
   return len;
 }
 
+/*
+Resolves a flattened ros field to the capnproto member it is written to
+*/
+bool gams::utility::ros::RosParser::compile_any_field(
+  const std::string & datatype, const std::string & topic_name,
+  capnp::StructSchema schema, unsigned int array_size, AnyFieldPlan & plan)
+{
+  std::string name = plan.key.substr(topic_name.length());
+
+  // Apply name substitution rules from the mapfile
+  name = substitute_name(datatype, name);
+  if (name == IGNORE_MARKER)
+  {
+    // This member is marked as to be ignored
+    plan.ignore = true;
+    return true;
+  }
+  else if (
+    strncmp(name.c_str(), NSEC_MARKER.c_str(), NSEC_MARKER.size()) == 0)
+  {
+    // This member has to be converted to nsec
+    plan.nsec = true;
+    // remove NSEC marker
+    name = name.substr(NSEC_MARKER.size());
+  }
+
+  name = to_capnp_name(name);
+
+  std::size_t struct_end = name.find_last_of("/");
+  std::string struct_name = "";
+  std::string var_name = name;
+  if (struct_end != std::string::npos)
+  {
+    struct_name = name.substr(0, struct_end);
+    var_name = name.substr(struct_end + 1);
+  }
+
+  //Members start with lower case so set this for the varname
+  if (var_name.size() > 0)
+  {
+    var_name[0] = tolower(var_name[0]);
+  }
+
+  std::size_t dot_pos = var_name.find(".");
+  if (dot_pos != std::string::npos)
+  {
+    //This is a list
+    plan.index = std::stoi(var_name.substr(dot_pos + 1));
+    plan.array_size = array_size;
+    var_name = var_name.substr(0, dot_pos);
+  }
+
+  try
+  {
+    // resolve the struct members once instead of per message
+    std::istringstream f(struct_name.size() > 0 ?
+      struct_name.substr(1) : struct_name);
+    std::string segment;
+    while (getline(f, segment, '/'))
+    {
+      plan.path.push_back(schema.getFieldByName(segment));
+      schema = plan.path.back().getType().asStruct();
+    }
+
+    plan.field = schema.getFieldByName(var_name);
+    plan.type = plan.field.getType().which();
+  }
+  catch (kj::Exception ex)
+  {
+    std::cout << "Failed to map " << name << " from topic " <<
+      topic_name << "(" << datatype << ")!(" <<
+      std::string(ex.getDescription()) << ")" << std::endl;
+    plan.ignore = true;
+    return false;
+  }
+
+  return true;
+}
+
+void gams::utility::ros::RosParser::compile_any_plan(
+  const std::string & datatype, const std::string & topic_name,
+  RosIntrospection::FlatMessage & flat_container,
+  RosIntrospection::RenamedValues & renamed_values,
+  AnyMappingPlan & plan)
+{
+  plan.values.clear();
+  plan.names.clear();
+  plan.value_leaves.clear();
+  plan.name_leaves.clear();
+
+  for (const auto & value : flat_container.value)
+  {
+    plan.value_leaves.push_back(value.first);
+  }
+  for (const auto & name : flat_container.name)
+  {
+    plan.name_leaves.push_back(name.first);
+  }
+
+  plan.values.resize(renamed_values.size());
+  for (size_t i = 0; i < renamed_values.size(); ++i)
+  {
+    plan.values[i].key = renamed_values[i].first;
+    compile_any_field(datatype, topic_name, plan.schema,
+      get_array_size(plan.values[i].key, &renamed_values), plan.values[i]);
+  }
+  ros_array_sizes_.clear();
+
+  // string lists are sized by the string values, not the renamed values
+  std::map<std::string, unsigned int> name_array_sizes;
+  plan.names.resize(flat_container.name.size());
+  for (size_t i = 0; i < flat_container.name.size(); ++i)
+  {
+    plan.names[i].key = flat_container.name[i].first.toStdString();
+
+    std::size_t dot_pos = plan.names[i].key.find(".");
+    if (dot_pos != std::string::npos)
+    {
+      ++name_array_sizes[plan.names[i].key.substr(0, dot_pos)];
+    }
+  }
+  for (size_t i = 0; i < plan.names.size(); ++i)
+  {
+    std::size_t dot_pos = plan.names[i].key.find(".");
+    unsigned int array_size = dot_pos == std::string::npos ? 1 :
+      name_array_sizes[plan.names[i].key.substr(0, dot_pos)];
+
+    compile_any_field(datatype, topic_name, plan.schema, array_size,
+      plan.names[i]);
+  }
+}
+
+/*
+Returns the struct builder that holds the member of a compiled field
+*/
+capnp::DynamicStruct::Builder gams::utility::ros::RosParser::get_dyn_capnp_struct(
+  capnp::DynamicStruct::Builder builder, const AnyFieldPlan & plan)
+{
+  for (const capnp::StructSchema::Field & field : plan.path)
+  {
+    builder = builder.get(field).as<capnp::DynamicStruct>();
+  }
+  return builder;
+}
+
 void gams::utility::ros::RosParser::parse_any( std::string datatype,
   std::string topic_name,
   std::vector<uint8_t> & parser_buffer,
   std::string container_name)
 {
   // This method uses ros_type_introspection to dynamically map values from
-  // ros messages to capnproto schemas
+  // ros messages to capnproto schemas. The mapping is compiled per topic.
 
-  std::string schema_name = capnp_types_[datatype];
-  capnp::MallocMessageBuilder buffer;
-  capnp::DynamicStruct::Builder capnp_builder;
-  try
+  AnyMappingPlan & plan = any_plans_[topic_name];
+  if (plan.schema_name == "")
   {
-    auto schema = schemas_.at(schema_name).asStruct();
-    capnp_builder = buffer.initRoot<capnp::DynamicStruct>(schema);
-    madara::knowledge::Any::register_schema(schema_name.c_str(), schema);
+    std::string schema_name = capnp_types_[datatype];
+    try
+    {
+      plan.schema = schemas_.at(schema_name).asStruct();
+    }
+    catch (...)
+    {
+      std::cout << "Schema with name " << schema_name << "not found!"
+        << std::endl;
+      exit(1);
+    }
+    plan.schema_name = schema_name;
+    register_any_schema(schema_name, plan.schema);
+
+    // known types without renaming rules use their compiled conversion.
+    // Schemas loaded from files are copies, so they are compared by id.
+    auto compiled = schema_cache().compiled.find(datatype);
+    if (compiled != schema_cache().compiled.end() &&
+      plan.schema.getProto().getId() ==
+        compiled->second.schema.getProto().getId() &&
+      name_substitution_map_.find(datatype) == name_substitution_map_.end())
+    {
+      plan.compiled = compiled->second.convert;
+    }
   }
-  catch (...)
+
+  if (plan.compiled)
   {
-    std::cout << "Schema with name " << schema_name << "not found!"
-      << std::endl;
-    exit(1);
+    capnp::MallocMessageBuilder buffer(std::max(plan.message_words,
+      (size_t)capnp::SUGGESTED_FIRST_SEGMENT_WORDS));
+    plan.compiled(parser_buffer, buffer);
+    plan.message_words = capnp::computeSerializedSizeInWords(buffer);
+
+    madara::knowledge::GenericCapnObject any(plan.schema_name.c_str(),
+      buffer);
+    store_any(container_name, any);
+    return;
   }
 
   RosIntrospection::FlatMessage& flat_container =
@@ -1028,88 +1770,143 @@ void gams::utility::ros::RosParser::parse_any( std::string datatype,
   parser_.applyNameTransform( topic_name,
     flat_container, &renamed_values );
 
-
-  // Save the content of the message to the knowledgebase
-  int topic_len = topic_name.length();
-  for (auto it: renamed_values)
+  // the plan holds as long as the message has the same flattened fields.
+  // Renaming rules may substitute string values into the names, so the
+  // renamed names are only compared for types with rules.
+  bool compiled = plan.values.size() == renamed_values.size() &&
+    same_leaves(plan.value_leaves, flat_container.value) &&
+    same_leaves(plan.name_leaves, flat_container.name);
+  if (compiled &&
+    name_substitution_map_.find(datatype) != name_substitution_map_.end())
   {
-    const std::string& key = it.first;
-    const RosIntrospection::Variant& value   = it.second;
-
-    int array_size = get_array_size(key, &renamed_values);
+    for (size_t i = 0; compiled && i < renamed_values.size(); ++i)
+    {
+      compiled = plan.values[i].key == renamed_values[i].first;
+    }
+  }
+  if (!compiled)
+  {
+    compile_any_plan(datatype, topic_name, flat_container, renamed_values,
+      plan);
+  }
 
-    std::string name = key.substr(topic_len);
+  // size the first segment after the last message to avoid regrowing
+  capnp::MallocMessageBuilder buffer(std::max(plan.message_words,
+    (size_t)capnp::SUGGESTED_FIRST_SEGMENT_WORDS));
+  capnp::DynamicStruct::Builder capnp_builder =
+    buffer.initRoot<capnp::DynamicStruct>(plan.schema);
 
+  // Save the content of the message to the knowledgebase
+  for (size_t i = 0; i < renamed_values.size(); ++i)
+  {
+    const AnyFieldPlan & field = plan.values[i];
+    if (field.ignore)
+    {
+      continue;
+    }
 
     double val = NAN;
     try
     {
-      val = value.convert<double>();
+      val = renamed_values[i].second.convert<double>();
     }
     catch ( const std::exception& e )
     {
       // Value is NAN if it is not readable
     }
-    // Apply name substitution rules from the mapfile
-    name = substitute_name(datatype, name);
-    if (name == IGNORE_MARKER)
-    {
-      // This member is marked as to be ignored
-      continue;
-    } else if (
-      strncmp(name.c_str(), NSEC_MARKER.c_str(), NSEC_MARKER.size()) == 0)
+    if (field.nsec)
     {
-      // This member has to be converted to nsec
       val =(unsigned long)(val * 1e9);
-      // remove NSEC marker
-      name = name.substr(NSEC_MARKER.size());
     }
+
     try
     {
-      set_dyn_capnp_value<double>(capnp_builder, name, val, array_size);
+      auto dynvalue = get_dyn_capnp_struct(capnp_builder, field);
+      if (field.index >= 0)
+      {
+        if (field.index == 0)
+        {
+          // First element so init
+          dynvalue.init(field.field, field.array_size);
+        }
+        dynvalue.get(field.field).as<capnp::DynamicList>().set(
+          field.index, val);
+      }
+      else if (field.type == capnp::schema::Type::BOOL)
+      {
+        // We need to specifically cast bool values before asignment
+        dynvalue.set(field.field, (bool)val);
+      }
+      else if (field.type == capnp::schema::Type::ENUM)
+      {
+        dynvalue.set(field.field, capnp::DynamicEnum(
+          field.field.getType().asEnum(), (uint16_t)val));
+      }
+      else
+      {
+        dynvalue.set(field.field, val);
+      }
     }
     catch (kj::Exception ex)
     {
-      std::cout << "Failed to set " << name << " from topic " <<
+      std::cout << "Failed to set " << field.key << " from topic " <<
         topic_name << "(" << datatype << ")!(" <<
         std::string(ex.getDescription()) << ")" << std::endl;
     }
-    
   }
-  for (auto it: flat_container.name)
+  for (size_t i = 0; i < flat_container.name.size(); ++i)
   {
-    const std::string& key    = it.first.toStdString();
-    const std::string& value  = it.second;
-
-    int array_size = get_array_size(key, &renamed_values);
-
-    auto val = strdup(value.c_str());
-    std::string name = key.substr(topic_len);
-
-    // Apply name substitution rules from the mapfile
-    name = substitute_name(datatype, name);
-    if (name == IGNORE_MARKER)
+    const AnyFieldPlan & field = plan.names[i];
+    if (field.ignore)
     {
-      // This member is marked as to be ignored
       continue;
     }
+
+    const std::string & value = flat_container.name[i].second;
     try
     {
-      set_dyn_capnp_value<char*>(capnp_builder, name, val, array_size);
+      auto dynvalue = get_dyn_capnp_struct(capnp_builder, field);
+      if (field.index >= 0)
+      {
+        if (field.index == 0)
+        {
+          // First element so init
+          dynvalue.init(field.field, field.array_size);
+        }
+        dynvalue.get(field.field).as<capnp::DynamicList>().set(
+          field.index, capnp::Text::Reader(value.c_str()));
+      }
+      else if (field.type == capnp::schema::Type::ENUM)
+      {
+        // We need to check for the enumerants
+        dynvalue.set(field.field, capnp::DynamicEnum(
+          field.field.getType().asEnum().getEnumerantByName(
+            kj::StringPtr(value.c_str()))));
+      }
+      else
+      {
+        dynvalue.set(field.field, capnp::Text::Reader(value.c_str()));
+      }
     }
     catch (kj::Exception ex)
     {
-      std::cout << "Failed to set " << name << " from topic " <<
+      std::cout << "Failed to set " << field.key << " from topic " <<
         topic_name << "(" << datatype << ")!(" <<
         std::string(ex.getDescription()) << ")" << std::endl;
     }
   }
-  // Clear the array size cache
-  ros_array_sizes_.clear();
+
+  plan.message_words = capnp::computeSerializedSizeInWords(buffer);
 
   // Write to the Any object
-  madara::knowledge::GenericCapnObject any(schema_name.c_str(), buffer);
+  madara::knowledge::GenericCapnObject any(plan.schema_name.c_str(), buffer);
+  store_any(container_name, any);
+}
 
+void gams::utility::ros::RosParser::store_any(
+  const std::string & container_name,
+  madara::knowledge::GenericCapnObject & any)
+{
   // Check if this has to be stored in CircularBuffers
   // TODO: remove this once the NativeCircularBuffers ar ready for use
   auto search = circular_container_stats_.find(container_name);
@@ -1147,11 +1944,10 @@ void gams::utility::ros::RosParser::parse_any(std::string topic,
   const topic_tools::ShapeShifter & m,
   std::string container_name)
 {
-  // write the message into the buffer
-  const size_t msg_size  = m.size();
-  std::vector<uint8_t> parser_buffer;
+  // write the message into the topic's buffer
+  std::vector<uint8_t> & parser_buffer = message_buffers_[topic];
 
-  parser_buffer.resize(msg_size);
+  parser_buffer.resize(m.size());
   global_ros::serialization::OStream stream(parser_buffer.data(),
     parser_buffer.size());
   m.write(stream);
@@ -1166,13 +1962,11 @@ void gams::utility::ros::RosParser::parse_any(std::string topic,
 void gams::utility::ros::RosParser::parse_any(const rosbag::MessageInstance & m,
   std::string container_name)
 {
-  // write the message into the buffer
+  // write the message into the topic's buffer
   const std::string& topic  = m.getTopic();
+  std::vector<uint8_t> & parser_buffer = message_buffers_[topic];
 
-  const size_t msg_size  = m.size();
-  std::vector<uint8_t> parser_buffer;
-
-  parser_buffer.resize(msg_size);
+  parser_buffer.resize(m.size());
   global_ros::serialization::OStream stream(parser_buffer.data(),
     parser_buffer.size());
   m.write(stream);
@@ -1186,12 +1980,106 @@ void gams::utility::ros::RosParser::parse_external(
   std::string container_name)
 {
   std::string datatype = m.getDataType();
-  auto plugin = plugin_map_.find(datatype);
-  if (plugin == plugin_map_.end())
+  if (plugin_map_.find(datatype) == plugin_map_.end())
   {
     return;
   }
 
+  const Plugin & plugin = load_plugin(datatype);
+  if (plugin.flags & PLUGIN_TYPED_OUTPUT)
+  {
+    // run the plugin and apply its values right away
+    plugin_output_.clear();
+    run_plugin(datatype, *m.instantiate<topic_tools::ShapeShifter>(),
+      container_name, plugin_output_);
+    apply_plugin_output(plugin_output_);
+  }
+  else
+  {
+    // call the external function
+    ((plugin_t)plugin.func)(&m, knowledge_, container_name);
+  }
+}
+
+unsigned int gams::utility::ros::RosParser::get_plugin_flags(
+  const std::string & datatype)
+{
+  if (plugin_map_.find(datatype) == plugin_map_.end())
+  {
+    return 0;
+  }
+  return load_plugin(datatype).flags;
+}
+
+void gams::utility::ros::RosParser::run_plugin(const std::string & datatype,
+  const topic_tools::ShapeShifter & m, const std::string & container_name,
+  PluginOutput & output)
+{
+  // plugins_ is only modified while loading, which is done by
+  // get_plugin_flags before a plugin is run concurrently
+  auto plugin = plugins_.find(datatype);
+  const Plugin & loaded = plugin != plugins_.end() ?
+    plugin->second : load_plugin(datatype);
+
+  ((plugin_output_t)loaded.func)(&m, &output, container_name);
+}
+
+bool gams::utility::ros::RosParser::is_stateless(const std::string & datatype)
+{
+  return datatype == "nav_msgs/Odometry" ||
+    datatype == "sensor_msgs/Imu" ||
+    datatype == "sensor_msgs/LaserScan" ||
+    datatype == "geometry_msgs/Pose" ||
+    datatype == "geometry_msgs/PoseStamped" ||
+    datatype == "sensor_msgs/CompressedImage" ||
+    datatype == "sensor_msgs/PointCloud2" ||
+    datatype == "sensor_msgs/Range" ||
+    datatype == "sensor_msgs/FluidPressure";
+}
+
+void gams::utility::ros::RosParser::parse_stateless(
+  const topic_tools::ShapeShifter::ConstPtr& m,
+  const std::string & container_name, const std::string & topic_name,
+  PluginOutput & output)
+{
+  // the parsers only write, so the scratch knowledge base holds exactly
+  // the values of this message
+  knowledge_->clear();
+  dispatch_message(m, container_name, topic_name);
+
+  for (auto & record : knowledge_->to_map(""))
+  {
+    output.set(record.first, record.second);
+  }
+}
+
+void gams::utility::ros::RosParser::apply_plugin_output(
+  const PluginOutput & output)
+{
+  madara::knowledge::ContextGuard guard(*knowledge_);
+  for (auto & record : output.records())
+  {
+    knowledge_->set(knowledge_->get_ref(record.first, eval_settings_),
+      record.second, eval_settings_);
+  }
+}
+
+void gams::utility::ros::RosParser::apply_plugin_output(
+  global_ros::Time time, const PluginOutput & output)
+{
+  set_sim_time(time);
+  apply_plugin_output(output);
+}
+
+const gams::utility::ros::RosParser::Plugin &
+gams::utility::ros::RosParser::load_plugin(const std::string & datatype)
+{
+  auto loaded = plugins_.find(datatype);
+  if (loaded != plugins_.end())
+  {
+    return loaded->second;
+  }
+
   std::string path = madara::utility::expand_envs(plugin_map_[datatype].first);
   std::string func = plugin_map_[datatype].second;
 
@@ -1213,8 +2101,9 @@ void gams::utility::ros::RosParser::parse_external(
   }
 
   // load the symbol
+  Plugin plugin;
   dlerror();
-  plugin_t ext_func =(plugin_t) dlsym(handle, func.c_str());
+  plugin.func = dlsym(handle, func.c_str());
   const char *dlsym_error = dlerror();
   if (dlsym_error)
   {
@@ -1223,8 +2112,16 @@ void gams::utility::ros::RosParser::parse_external(
     exit(0);
   }
 
-  // call the external function
-  ext_func(&m, knowledge_, container_name);
+  // the flags are optional, legacy plugins do not export them
+  plugin_flags_t flags =
+    (plugin_flags_t) dlsym(handle, (func + "_flags").c_str());
+  if (flags)
+  {
+    plugin.flags = flags();
+  }
+  dlerror();
+
+  return plugins_[datatype] = plugin;
 }
 
 /**
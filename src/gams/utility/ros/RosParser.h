@@ -9,6 +9,7 @@
 #define   _GAMS_UTILITY_ROS_ROS_PARSER_
 
 #include "madara/knowledge/KnowledgeBase.h"
+#include "madara/knowledge/ContextGuard.h"
 #include "madara/knowledge/containers/NativeDoubleVector.h"
 #include "madara/knowledge/containers/NativeIntegerVector.h"
 #include "madara/knowledge/containers/Double.h"
@@ -24,6 +25,8 @@
 #include "gams/pose/Pose.h"
 #include "gams/pose/Quaternion.h"
 #include "gams/exceptions/ReferenceFrameException.h"
+#include "gams/utility/SensorRecord.h"
+#include "gams/utility/ros/RosPlugin.h"
 
 #ifdef __GNUC__
 #pragma GCC diagnostic push
@@ -68,7 +71,9 @@
 #endif
 
 #include <math.h>
+#include <memory>
 #include <string>
+#include <set>
 #include <regex>
 #include <iostream>
 #include <sys/types.h>
@@ -99,6 +104,25 @@ namespace gams
         std::copy(begin, end, std::back_inserter(tokens));
         return tokens.back();
       }
+
+      /**
+       * Downsampling and rate limiting of a topic, applied before its
+       * messages are written to the knowledgebase
+       **/
+      struct TopicPolicy
+      {
+        // hold only the latest message until the parser is flushed
+        bool latest_only = false;
+        // write every nth message
+        unsigned int decimation = 1;
+        // minimum nsec between written messages(0 writes all)
+        uint64_t min_period = 0;
+        // voxel edge length for PointCloud2 messages(0 keeps all points)
+        double voxel_size = 0;
+        // write Imu messages averaged over the dropped messages
+        bool average = false;
+      };
+
       class RosParser
       {
         public:
@@ -118,11 +142,48 @@ namespace gams
                 gams::pose::ReferenceFrame::default_prefix());
           ~RosParser();
 
-          void parse_message(const rosbag::MessageInstance m,
-            std::string container_name);
-          void parse_message(const topic_tools::ShapeShifter::ConstPtr& m,
+          /**
+           * Parses a message from a bag
+           * @param  m               the message
+           * @param  container_name  name of the madara variable
+           * @return false if the message was dropped or held by the
+           *         policy of its topic
+           **/
+          bool parse_message(const rosbag::MessageInstance m,
             std::string container_name);
 
+          /**
+           * Parses a message received from a subscription
+           * @param  m               the message
+           * @param  container_name  name of the madara variable
+           * @param  topic_name      topic of the message, needed to parse
+           *                         defined Any types and to apply the
+           *                         topic policy
+           * @return false if the message was dropped or held by the
+           *         policy of its topic
+           **/
+          bool parse_message(const topic_tools::ShapeShifter::ConstPtr& m,
+            std::string container_name, const std::string & topic_name = "");
+
+          /**
+           * Sets the downsampling and rate limiting policies
+           * @param  policies        policies by topic name
+           **/
+          void set_topic_policies(
+            const std::map<std::string, TopicPolicy> & policies);
+
+          /**
+           * Checks if latest_only policies hold messages
+           **/
+          bool has_held() const;
+
+          /**
+           * Parses the messages held by latest_only policies. Call this
+           * once per tick(e.g., before a checkpoint is written).
+           * @return the number of parsed messages
+           **/
+          size_t flush_held();
+
           // Parsing for unknown types
           void registerMessageDefinition(std::string topic_name,
             RosIntrospection::ROSType type, std::string definition);
@@ -169,6 +230,25 @@ namespace gams
             std::vector<uint8_t> & parser_buffer,
             std::string container_name);
 
+          /**
+           * Registers the schemas of all mapped Any types with
+           * madara::knowledge::Any. This is done implicitly by parse_any.
+           * Schemas are registered once per process, compiled types from
+           * the types library(if built with it) are registered upfront.
+           **/
+          void register_schemas();
+
+          /**
+           * Applies a value which was parsed by another parser instance
+           * (e.g., a parser worker thread) to this parser's knowledge base
+           * @param  time            ros time of the parsed message
+           * @param  container_name  name of the madara variable
+           * @param  value           the parsed value
+           **/
+          void apply_parsed(global_ros::Time time,
+            const std::string & container_name,
+            const knowledge::KnowledgeRecord & value);
+
           /**
            * Parse with external plugin
            * @param  m               rosbag::MessageInstance to parse
@@ -177,10 +257,68 @@ namespace gams
           void parse_external(const rosbag::MessageInstance & m,
             std::string container_name);
 
+          /**
+           * Returns the flags of the plugin of a ros datatype(e.g.,
+           * PLUGIN_THREAD_SAFE), loading the plugin if necessary
+           * @param  datatype        the ros datatype
+           **/
+          unsigned int get_plugin_flags(const std::string & datatype);
+
+          /**
+           * Runs a plugin with PLUGIN_TYPED_OUTPUT without touching the
+           * knowledge base. Thread safe if the plugin is.
+           * @param  datatype        the ros datatype
+           * @param  m               the message
+           * @param  container_name  name of the madara variable
+           * @param  output          the converted values
+           **/
+          void run_plugin(const std::string & datatype,
+            const topic_tools::ShapeShifter & m,
+            const std::string & container_name, PluginOutput & output);
+
+          /**
+           * Checks if a built-in type is parsed without reading the
+           * knowledge base(e.g., Odometry or PointCloud2 but not
+           * TFMessage). Mapped capnp types and plugins are not built-in.
+           * @param  datatype        the ros datatype
+           **/
+          static bool is_stateless(const std::string & datatype);
+
+          /**
+           * Parses a message of a stateless built-in type into output
+           * instead of the knowledge base. The knowledge base of this
+           * parser is cleared and used as scratch space, so a parser that
+           * does this must not be shared. Topic policies only provide the
+           * voxel size and drop nothing.
+           * @param  m               the message
+           * @param  container_name  name of the madara variable
+           * @param  topic_name      topic of the message
+           * @param  output          the converted values
+           **/
+          void parse_stateless(const topic_tools::ShapeShifter::ConstPtr& m,
+            const std::string & container_name,
+            const std::string & topic_name, PluginOutput & output);
+
+          /**
+           * Applies the values converted by a plugin to the knowledge base
+           * in one transaction
+           * @param  output          the converted values
+           **/
+          void apply_plugin_output(const PluginOutput & output);
+
+          /**
+           * Applies the values converted by a plugin from a bag message
+           * @param  time            ros time of the message
+           * @param  output          the converted values
+           **/
+          void apply_plugin_output(global_ros::Time time,
+            const PluginOutput & output);
+
 
           /**
            * Loads a Capnproto schema from disk for later usage
-           * Only Capnproto binary schemas are supported
+           * Only Capnproto binary schemas are supported. Every file is
+           * parsed once per process and shared by all parsers.
            * @param  path        string with the path to the schema file
            **/
           void load_capn_schema(std::string path);
@@ -212,7 +350,7 @@ namespace gams
           void parse_compressed_image(sensor_msgs::CompressedImage * img,
             std::string container_name);
           void parse_pointcloud2(sensor_msgs::PointCloud2 * pointcloud,
-            std::string container_name);
+            std::string container_name, double voxel_size = 0);
           void parse_range(sensor_msgs::Range * range,
             std::string container_name);
           void parse_tf_message(tf2_msgs::TFMessage * tf);
@@ -239,13 +377,203 @@ namespace gams
            */
           void print_schemas();
 
+          /**
+           * Checks if a topic's Any conversion uses a compiled type from
+           * the types library rather than mapping fields dynamically
+           * @param  topic_name  the topic of interest
+           * @return true if parse_any converted the topic with a compiled
+           *         type
+           */
+          bool is_compiled(const std::string & topic_name) const;
+
         protected:
+          /**
+           * Runtime state of a topic policy
+           **/
+          struct PolicyState
+          {
+            TopicPolicy policy;
+            // number of messages seen
+            uint64_t count = 0;
+            // time of the last written message in nsec
+            uint64_t last_written = 0;
+            // sums of the Imu messages to average
+            sensor_msgs::Imu imu_sum;
+            unsigned int imu_count = 0;
+            // the message held by latest_only
+            std::unique_ptr<rosbag::MessageInstance> held_bag;
+            topic_tools::ShapeShifter::ConstPtr held_shape;
+            std::string held_container;
+          };
+
+          /**
+           * Applies decimation and the rate limit to a message
+           * @return false if the message is dropped
+           **/
+          bool admit_message(PolicyState & state, uint64_t time);
+
+          /**
+           * Adds an Imu message to the average of a topic
+           **/
+          void average_imu(PolicyState & state, const sensor_msgs::Imu & imu);
+
+          /**
+           * Writes the averaged Imu messages of a topic and resets them
+           **/
+          void parse_averaged_imu(PolicyState & state,
+            const std::string & container_name);
+
+          /**
+           * Returns the voxel size of a topic(0 if none)
+           **/
+          double get_voxel_size(const std::string & topic) const;
+
+          /**
+           * Parses a bag message regardless of its topic policy
+           **/
+          void dispatch_message(const rosbag::MessageInstance & m,
+            const std::string & container_name);
+
+          /**
+           * Parses a subscribed message regardless of its topic policy
+           **/
+          void dispatch_message(const topic_tools::ShapeShifter::ConstPtr& m,
+            const std::string & container_name,
+            const std::string & topic_name);
+
+          // topic policies by topic name
+          std::map<std::string, PolicyState> policies_;
+
+          // Downsampled points, reused across messages
+          std::vector<unsigned char> voxel_buffer_;
+
+          /**
+           * Converts a serialized ros message into the generated capnproto
+           * type of the types library
+           **/
+          typedef void(*compiled_any_t)(std::vector<uint8_t> & parser_buffer,
+            capnp::MallocMessageBuilder & builder);
+
+          /**
+           * A flattened ros field resolved to a member of a capnproto schema
+           **/
+          struct AnyFieldPlan
+          {
+            // the flattened ros field name(e.g. /odom/header/stamp)
+            std::string key;
+            // true if the field is ignored or could not be resolved
+            bool ignore = false;
+            // true if the value is converted from seconds to nsec
+            bool nsec = false;
+            // the struct members leading to the struct holding the member
+            std::vector<capnp::StructSchema::Field> path;
+            // the member
+            capnp::StructSchema::Field field;
+            // the type of the member
+            capnp::schema::Type::Which type = capnp::schema::Type::VOID;
+            // the list index of the value or -1 if the member is no list
+            int index = -1;
+            // the list size to initialize at index 0
+            unsigned int array_size = 1;
+          };
+
+          /**
+           * The mapping of one topic into its capnproto schema. The plan is
+           * compiled from the first message and reused as long as later
+           * messages flatten to the same fields(i.e., the same leaves).
+           **/
+          struct AnyMappingPlan
+          {
+            std::string schema_name;
+            capnp::StructSchema schema;
+            // plans in the order of the renamed values
+            std::vector<AnyFieldPlan> values;
+            // plans in the order of the string values
+            std::vector<AnyFieldPlan> names;
+            // the fields the plans were compiled for, compared per message
+            // instead of the field names
+            std::vector<RosIntrospection::StringTreeLeaf> value_leaves;
+            std::vector<RosIntrospection::StringTreeLeaf> name_leaves;
+            // the size of the last message to preallocate the builder
+            size_t message_words = 0;
+            // the compiled conversion, replaces the field plans if set
+            compiled_any_t compiled = nullptr;
+          };
+
+          /**
+           * Compiles the field plans of a topic from its current message
+           **/
+          void compile_any_plan(const std::string & datatype,
+            const std::string & topic_name,
+            RosIntrospection::FlatMessage & flat_container,
+            RosIntrospection::RenamedValues & renamed_values,
+            AnyMappingPlan & plan);
+
+          /**
+           * Resolves a flattened ros field to a capnproto schema member
+           * @param  plan   the field plan with its key set
+           * @return false if the member does not exist in the schema
+           **/
+          bool compile_any_field(const std::string & datatype,
+            const std::string & topic_name, capnp::StructSchema schema,
+            unsigned int array_size, AnyFieldPlan & plan);
+
+          /**
+           * Returns the struct builder holding the member of a field plan
+           **/
+          capnp::DynamicStruct::Builder get_dyn_capnp_struct(
+            capnp::DynamicStruct::Builder builder, const AnyFieldPlan & plan);
+
+          /**
+           * The latest transform of a tf child frame
+           **/
+          struct TfTransform
+          {
+            // the parent frame id
+            std::string parent;
+            // the translation within the parent frame
+            gams::pose::PositionVector position;
+            // the normalized rotation within the parent frame
+            gams::pose::Quaternion rotation;
+            // the time of the transform in nsec
+            uint64_t timestamp = 0;
+          };
+
+          /**
+           * Returns a tf parent frame. Frames are loaded from the
+           * knowledgebase(or created) once and reused for later transforms.
+           **/
+          gams::pose::ReferenceFrame get_tf_frame(const std::string & id);
+
+          /**
+           * Composes the latest transforms from the base frame up to the
+           * world frame
+           * @return false if the world frame is no ancestor of the base frame
+           **/
+          bool compose_tf_chain(gams::pose::PositionVector & position,
+            gams::pose::Quaternion & rotation);
+
+          /**
+           * Stores a converted Any type in its container or circular buffer
+           **/
+          void store_any(const std::string & container_name,
+            madara::knowledge::GenericCapnObject & any);
+
+          // compiled capnproto mappings by topic
+          std::map<std::string, AnyMappingPlan> any_plans_;
+
           // ros introspection parser for unknown types
           RosIntrospection::Parser parser_;
 
           //to reduce the amount of memory allocations these maps are reused for
           //all unknown topic types which are not parsed directly
           std::map<std::string, RosIntrospection::FlatMessage> flat_containers_;
+
+          // Encoding buffer for binary sensor records, reused across messages
+          std::vector<unsigned char> sensor_buffer_;
+
+          // Serialized messages for parse_any by topic, reused across messages
+          std::map<std::string, std::vector<uint8_t>> message_buffers_;
           std::map<std::string, RosIntrospection::RenamedValues> renamed_vectors_;
           std::vector<uint8_t> parser_buffer_;
           std::map<std::string, unsigned int> ros_array_sizes_;
@@ -254,10 +582,18 @@ namespace gams
           std::string world_frame_;
           std::string base_frame_;
 
+          // Latest tf transforms by child frame id
+          std::map<std::string, TfTransform> tf_transforms_;
+          // tf parent frames by id
+          std::map<std::string, gams::pose::ReferenceFrame> tf_frames_;
+          // true if a child frame got a new parent since the last tree load
+          bool tf_topology_changed_ = true;
+
           // Capnproto
           std::map<std::string, std::string> capnp_types_;
+          // schemas by name. The schemas are owned by the process wide
+          // schema cache.
           std::map<std::string, capnp::Schema> schemas_;
-          capnp::SchemaLoader capnp_loader_;
 
 
 
@@ -284,6 +620,25 @@ namespace gams
             std::string);
           std::map<std::string, void*> plugin_cache_;
 
+          // A resolved plugin function
+          struct Plugin
+          {
+            // plugin_t or plugin_output_t, depending on the flags
+            void * func = nullptr;
+            unsigned int flags = 0;
+          };
+
+          /**
+           * Loads the plugin of a datatype once and returns it
+           **/
+          const Plugin & load_plugin(const std::string & datatype);
+
+          // resolved plugins by ros datatype
+          std::map<std::string, Plugin> plugins_;
+
+          // output of plugins run on the parsing thread, reused
+          PluginOutput plugin_output_;
+
 
 
 
@@ -322,6 +677,11 @@ namespace gams
            **/ 
           std::string substitute_name(std::string type, std::string name);
 
+          /**
+           * Converts a ros member name to capnproto camelcase
+           **/
+          std::string to_capnp_name(const std::string & name);
+
           /*
           Sets the current time to the ros header time if the simtime feature is
           activated.
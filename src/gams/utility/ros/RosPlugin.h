@@ -0,0 +1,137 @@
+/**
+ * @file RosPlugin.h
+ * @author Jakob Auer <jakob.auer@gmail.com>
+ *
+ * This file contains the interface of ros2gams parser plugins
+ **/
+
+#ifndef   _GAMS_UTILITY_ROS_ROS_PLUGIN_
+#define   _GAMS_UTILITY_ROS_ROS_PLUGIN_
+
+#include <map>
+#include <string>
+#include <vector>
+
+#include "madara/knowledge/KnowledgeRecord.h"
+
+#ifdef __GNUC__
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wpedantic"
+#pragma GCC diagnostic ignored "-Wreorder"
+#pragma GCC diagnostic ignored "-Wnon-virtual-dtor"
+#endif
+
+#include <topic_tools/shape_shifter.h>
+
+#ifdef __GNUC__
+#pragma GCC diagnostic pop
+#endif
+
+/**
+ * A plugin is a shared library with a parse function named in the
+ * plugin_map of the ros2gams map file. A plugin may export a second
+ * function named <func>_flags which returns a combination of the flags
+ * below. Without it, func has the legacy signature
+ *
+ *   void func(const rosbag::MessageInstance*, KnowledgeBase*, std::string)
+ *
+ * and writes into the knowledge base directly. Plugins with
+ * PLUGIN_TYPED_OUTPUT have the signature of plugin_output_t and return
+ * their values in a PluginOutput instead.
+ **/
+
+namespace gams
+{
+  namespace utility
+  {
+    namespace ros
+    {
+      // func has the plugin_output_t signature
+      const unsigned int PLUGIN_TYPED_OUTPUT = 1;
+
+      // func may be called concurrently for different messages. Only
+      // used together with PLUGIN_TYPED_OUTPUT.
+      const unsigned int PLUGIN_THREAD_SAFE = 2;
+
+      /**
+       * Values converted by a plugin. The values are applied to the
+       * knowledge base by the caller, in the order of the messages, so
+       * plugins never share the knowledge base with other threads.
+       * Arrays are stored as one record each.
+       **/
+      class PluginOutput
+      {
+        public:
+          void set(const std::string & name, int64_t value)
+          {
+            records_[name].set_value(value);
+          }
+
+          void set(const std::string & name, double value)
+          {
+            records_[name].set_value(value);
+          }
+
+          void set(const std::string & name, const std::string & value)
+          {
+            records_[name].set_value(value);
+          }
+
+          void set(const std::string & name, std::vector<int64_t> values)
+          {
+            records_[name].set_value(std::move(values));
+          }
+
+          void set(const std::string & name, std::vector<double> values)
+          {
+            records_[name].set_value(std::move(values));
+          }
+
+          void set_file(const std::string & name,
+            const unsigned char * data, size_t size)
+          {
+            records_[name].set_file(data, size);
+          }
+
+          void set(const std::string & name,
+            const madara::knowledge::KnowledgeRecord & record)
+          {
+            records_[name] = record;
+          }
+
+          /**
+           * Returns the values by variable name
+           **/
+          const std::map<std::string, madara::knowledge::KnowledgeRecord> &
+            records() const
+          {
+            return records_;
+          }
+
+          void clear()
+          {
+            records_.clear();
+          }
+
+        private:
+          std::map<std::string, madara::knowledge::KnowledgeRecord> records_;
+      };
+
+      /**
+       * Signature of plugins with PLUGIN_TYPED_OUTPUT
+       * @param  m               the message
+       * @param  output          the converted values
+       * @param  container_name  name of the madara variable
+       **/
+      typedef void(*plugin_output_t)(const topic_tools::ShapeShifter * m,
+        PluginOutput * output, const std::string & container_name);
+
+      /**
+       * Signature of the optional <func>_flags function
+       **/
+      typedef unsigned int(*plugin_flags_t)(void);
+    }
+  }
+}
+
+#endif // _GAMS_UTILITY_ROS_ROS_PLUGIN_
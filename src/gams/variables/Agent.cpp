@@ -51,6 +51,7 @@
 using std::string;
 
 gams::variables::Agent::Agent()
+  : agent_id(-1)
 {
 }
 
@@ -95,6 +96,7 @@ gams::variables::Agent::operator=(const Agent & agent)
     this->loop_hz = agent.loop_hz;
     this->send_hz = agent.send_hz;
     this->prefix = agent.prefix;
+    this->agent_id = agent.agent_id;
     this->velocity = agent.velocity;
   }
 }
@@ -104,11 +106,15 @@ gams::variables::Agent::init_vars(
   madara::knowledge::KnowledgeBase & knowledge,
   const std::string & prefix)
 {
+  // frequently read variable names are built once per agent
+  agent_id = agent_names().intern(prefix);
+  const AgentName & name = agent_names().get(agent_id);
+
   // initialize the variable containers
   acceleration.set_name(prefix + ".acceleration", knowledge);
   min_alt.set_name(prefix + ".min_alt", knowledge);
-  location.set_name(prefix + ".location", knowledge);
-  orientation.set_name(prefix + ".orientation", knowledge);
+  location.set_name(name.location, knowledge);
+  orientation.set_name(name.orientation, knowledge);
   desired_altitude.set_name(prefix + ".desired_altitude", knowledge);
   is_mobile.set_name(prefix + ".mobile", knowledge);
   battery_remaining.set_name(prefix + ".battery", knowledge);
@@ -127,17 +133,17 @@ gams::variables::Agent::init_vars(
   last_algorithm_id.set_name(prefix + ".algorithm.last.id", knowledge);
   last_algorithm_args.set_name(prefix + ".algorithm.last.args", knowledge);
   variables::init_vars(accents, knowledge, prefix);
-  home.set_name(prefix + ".home", knowledge);
-  source.set_name(prefix + ".source", knowledge);
+  home.set_name(name.home, knowledge);
+  source.set_name(name.source, knowledge);
   source_orientation.set_name(prefix + ".source_orientation", knowledge);
   dest_orientation.set_name(prefix + ".dest_orientation", knowledge);
-  dest.set_name(prefix + ".dest", knowledge);
+  dest.set_name(name.dest, knowledge);
   temperature.set_name(prefix + ".temperature", knowledge);
   madara_debug_level.set_name(prefix + ".madara_debug_level", knowledge);
   gams_debug_level.set_name(prefix + ".gams_debug_level", knowledge);
   loop_hz.set_name(prefix + ".loop_hz", knowledge);
   send_hz.set_name(prefix + ".send_hz", knowledge);
-  velocity.set_name(prefix + ".velocity", knowledge);
+  velocity.set_name(name.velocity, knowledge);
 
   this->prefix = prefix;
 
@@ -151,7 +157,7 @@ gams::variables::Agent::init_vars(
   const madara::knowledge::KnowledgeRecord::Integer& id)
 {
   // create the agent name string identifier('agent.{id}')
-  prefix = make_variable_name(id);
+  prefix = agent_names().get_prefix(agent_names().intern(id));
 
   init_vars(knowledge, prefix);
 }
@@ -162,16 +168,17 @@ gams::variables::Agent::init_vars(
   const madara::knowledge::KnowledgeRecord::Integer& id)
 {
   // create the agent name string identifier('agent.{id}')
-  string agent_name(make_variable_name(id));
-  string local_agent_name("." + agent_name);
+  agent_id = agent_names().intern(id);
+  const AgentName & name = agent_names().get(agent_id);
+  const string & agent_name = name.prefix;
 
   prefix = agent_name;
 
   // initialize the variable containers
   acceleration.set_name(agent_name + ".acceleration", knowledge);
   min_alt.set_name(agent_name + ".min_alt", knowledge);
-  location.set_name(agent_name + ".location", knowledge, 3);
-  orientation.set_name(agent_name + ".orientation", knowledge, 3);
+  location.set_name(name.location, knowledge, 3);
+  orientation.set_name(name.orientation, knowledge, 3);
   desired_altitude.set_name(agent_name + ".desired_altitude", knowledge);
   is_mobile.set_name(agent_name + ".mobile", knowledge);
   battery_remaining.set_name(agent_name + ".battery", knowledge);
@@ -190,17 +197,17 @@ gams::variables::Agent::init_vars(
   last_algorithm_id.set_name(agent_name + ".algorithm.last.id", knowledge);
   last_algorithm_args.set_name(agent_name + ".algorithm.last.args", knowledge);
   variables::init_vars(accents, knowledge, agent_name);
-  home.set_name(agent_name + ".home", knowledge);
-  source.set_name(agent_name + ".source", knowledge);
+  home.set_name(name.home, knowledge);
+  source.set_name(name.source, knowledge);
   source_orientation.set_name(agent_name + ".source_orientation", knowledge);
-  dest.set_name(agent_name + ".dest", knowledge);
+  dest.set_name(name.dest, knowledge);
   dest_orientation.set_name(agent_name + ".dest_orientation", knowledge);
   temperature.set_name(agent_name + ".temperature", knowledge);
   madara_debug_level.set_name(agent_name + ".madara_debug_level", knowledge);
   gams_debug_level.set_name(agent_name + ".gams_debug_level", knowledge);
   loop_hz.set_name(agent_name + ".loop_hz", knowledge);
   send_hz.set_name(agent_name + ".send_hz", knowledge);
-  velocity.set_name(agent_name + ".velocity", knowledge);
+  velocity.set_name(name.velocity, knowledge);
 
   // init settings
   init_variable_settings();
@@ -67,6 +67,7 @@
 #include "madara/knowledge/containers/Map.h"
 #include "madara/knowledge/KnowledgeBase.h"
 #include "AccentStatus.h"
+#include "AgentNames.h"
 #include "gams/groups/GroupBase.h"
 
 namespace gams
@@ -225,6 +226,9 @@ namespace gams
       /// the prefix for this agent
       std::string prefix;
 
+      /// the id of prefix in agent_names, or -1 before init_vars
+      AgentId agent_id;
+
     protected:
       /**
        * Create agent/local agent name
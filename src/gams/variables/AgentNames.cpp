@@ -0,0 +1,253 @@
+/**
+ * Copyright(c) 2014-2018 Carnegie Mellon University. All Rights Reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ * 
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following acknowledgments and disclaimers.
+ * 
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ * 
+ * 3. The names "Carnegie Mellon University," "SEI" and/or "Software
+ *    Engineering Institute" shall not be used to endorse or promote products
+ *    derived from this software without prior written permission. For written
+ *    permission, please contact permission@sei.cmu.edu.
+ * 
+ * 4. Products derived from this software may not be called "SEI" nor may "SEI"
+ *    appear in their names without prior written permission of
+ *    permission@sei.cmu.edu.
+ * 
+ * 5. Redistributions of any form whatsoever must retain the following
+ *    acknowledgment:
+ * 
+ *      This material is based upon work funded and supported by the Department
+ *      of Defense under Contract No. FA8721-05-C-0003 with Carnegie Mellon
+ *      University for the operation of the Software Engineering Institute, a
+ *      federally funded research and development center. Any opinions,
+ *      findings and conclusions or recommendations expressed in this material
+ *      are those of the author(s) and do not necessarily reflect the views of
+ *      the United States Department of Defense.
+ * 
+ *      NO WARRANTY. THIS CARNEGIE MELLON UNIVERSITY AND SOFTWARE ENGINEERING
+ *      INSTITUTE MATERIAL IS FURNISHED ON AN "AS-IS" BASIS. CARNEGIE MELLON
+ *      UNIVERSITY MAKES NO WARRANTIES OF ANY KIND, EITHER EXPRESSED OR
+ *      IMPLIED, AS TO ANY MATTER INCLUDING, BUT NOT LIMITED TO, WARRANTY OF
+ *      FITNESS FOR PURPOSE OR MERCHANTABILITY, EXCLUSIVITY, OR RESULTS
+ *      OBTAINED FROM USE OF THE MATERIAL. CARNEGIE MELLON UNIVERSITY DOES
+ *      NOT MAKE ANY WARRANTY OF ANY KIND WITH RESPECT TO FREEDOM FROM PATENT,
+ *      TRADEMARK, OR COPYRIGHT INFRINGEMENT.
+ * 
+ *      This material has been approved for public release and unlimited
+ *      distribution.
+ **/
+#include "AgentNames.h"
+#include "gams/loggers/GlobalLogger.h"
+
+#include <sstream>
+
+gams::variables::AgentNameTable::AgentNameTable(size_t capacity)
+  : capacity_(capacity), count_(0), ids_(std::make_shared<IdMap>()),
+    chunks_(new std::atomic<AgentName *>[
+      (capacity + CHUNK_SIZE - 1) / CHUNK_SIZE])
+{
+  for (size_t i = 0; i < (capacity_ + CHUNK_SIZE - 1) / CHUNK_SIZE; ++i)
+  {
+    chunks_[i].store(0, std::memory_order_relaxed);
+  }
+}
+
+gams::variables::AgentNameTable::~AgentNameTable()
+{
+  for (size_t i = 0; i < (capacity_ + CHUNK_SIZE - 1) / CHUNK_SIZE; ++i)
+  {
+    delete [] chunks_[i].load(std::memory_order_relaxed);
+  }
+}
+
+gams::variables::AgentId
+gams::variables::AgentNameTable::add_(const std::string & prefix)
+{
+  size_t index = count_.load(std::memory_order_relaxed);
+
+  if (index >= capacity_)
+  {
+    madara_logger_ptr_log(gams::loggers::global_logger.get(),
+      gams::loggers::LOG_ERROR,
+      "gams::variables::AgentNameTable::add_:" \
+      " cannot intern %s, all %zu agent names are in use\n",
+      prefix.c_str(), capacity_);
+
+    return -1;
+  }
+
+  AgentName * chunk = chunks_[index / CHUNK_SIZE].load(
+    std::memory_order_relaxed);
+
+  if (chunk == 0)
+  {
+    chunk = new AgentName[CHUNK_SIZE];
+    chunks_[index / CHUNK_SIZE].store(chunk, std::memory_order_relaxed);
+  }
+
+  AgentName & name = chunk[index % CHUNK_SIZE];
+  name.prefix = prefix;
+  name.location = prefix + ".location";
+  name.orientation = prefix + ".orientation";
+  name.velocity = prefix + ".velocity";
+  name.dest = prefix + ".dest";
+  name.home = prefix + ".home";
+  name.source = prefix + ".source";
+
+  AgentId id = (AgentId)index;
+
+  // publish the name before any snapshot that maps to it
+  count_.store(index + 1, std::memory_order_release);
+
+  std::shared_ptr<IdMap> ids = std::make_shared<IdMap>(*ids_);
+  (*ids)[prefix] = id;
+  std::atomic_store(&ids_, std::shared_ptr<const IdMap>(ids));
+
+  madara_logger_ptr_log(gams::loggers::global_logger.get(),
+    gams::loggers::LOG_DETAILED,
+    "gams::variables::AgentNameTable::add_:" \
+    " interned %s as %d\n", prefix.c_str(), id);
+
+  return id;
+}
+
+gams::variables::AgentId
+gams::variables::AgentNameTable::intern_(const std::string & prefix)
+{
+  AgentId id = find(prefix);
+
+  if (id < 0)
+  {
+    std::lock_guard<std::mutex> guard(mutex_);
+
+    // another thread may have added it since the lookup
+    std::shared_ptr<const IdMap> ids = std::atomic_load(&ids_);
+    IdMap::const_iterator found = ids->find(prefix);
+
+    id = found != ids->end() ? found->second : add_(prefix);
+  }
+
+  return id;
+}
+
+gams::variables::AgentId
+gams::variables::AgentNameTable::intern(const std::string & prefix)
+{
+  return intern_(prefix);
+}
+
+const gams::variables::AgentName &
+gams::variables::AgentNameTable::intern_name(const std::string & prefix)
+{
+  return get(intern_(prefix));
+}
+
+gams::variables::AgentId
+gams::variables::AgentNameTable::intern(
+  const madara::knowledge::KnowledgeRecord::Integer & number)
+{
+  // only small, non-negative numbers are cached by number
+  bool cached = number >= 0 && number < MAX_NUMBERED_AGENTS;
+  size_t index = cached ? (size_t)number : 0;
+
+  std::lock_guard<std::mutex> guard(mutex_);
+
+  if (cached && index < numbered_.size() && numbered_[index] >= 0)
+  {
+    return numbered_[index];
+  }
+
+  std::stringstream buffer;
+  buffer << "agent.";
+  buffer << number;
+
+  std::string prefix = buffer.str();
+  std::shared_ptr<const IdMap> ids = std::atomic_load(&ids_);
+  IdMap::const_iterator found = ids->find(prefix);
+
+  AgentId id = found != ids->end() ? found->second : add_(prefix);
+
+  if (cached && id >= 0)
+  {
+    if (index >= numbered_.size())
+    {
+      numbered_.resize(index + 1, -1);
+    }
+    numbered_[index] = id;
+  }
+
+  return id;
+}
+
+void
+gams::variables::AgentNameTable::intern(
+  const std::vector<std::string> & prefixes, std::vector<AgentId> & ids)
+{
+  ids.resize(prefixes.size());
+
+  for (size_t i = 0; i < prefixes.size(); ++i)
+  {
+    ids[i] = intern_(prefixes[i]);
+  }
+}
+
+gams::variables::AgentId
+gams::variables::AgentNameTable::find(const std::string & prefix) const
+{
+  std::shared_ptr<const IdMap> ids = std::atomic_load(&ids_);
+  IdMap::const_iterator found = ids->find(prefix);
+
+  return found != ids->end() ? found->second : -1;
+}
+
+const gams::variables::AgentName &
+gams::variables::AgentNameTable::get(AgentId id) const
+{
+  static const AgentName unknown;
+
+  if (id < 0 || (size_t)id >= count_.load(std::memory_order_acquire))
+  {
+    madara_logger_ptr_log(gams::loggers::global_logger.get(),
+      gams::loggers::LOG_ERROR,
+      "gams::variables::AgentNameTable::get:" \
+      " %d is not an interned agent id\n", id);
+
+    return unknown;
+  }
+
+  return chunks_[(size_t)id / CHUNK_SIZE].load(std::memory_order_relaxed)[
+    (size_t)id % CHUNK_SIZE];
+}
+
+const std::string &
+gams::variables::AgentNameTable::get_prefix(AgentId id) const
+{
+  return get(id).prefix;
+}
+
+size_t
+gams::variables::AgentNameTable::size(void) const
+{
+  return count_.load(std::memory_order_acquire);
+}
+
+size_t
+gams::variables::AgentNameTable::capacity(void) const
+{
+  return capacity_;
+}
+
+gams::variables::AgentNameTable &
+gams::variables::agent_names(void)
+{
+  static AgentNameTable table;
+
+  return table;
+}
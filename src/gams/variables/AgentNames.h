@@ -0,0 +1,258 @@
+/**
+ * Copyright(c) 2014-2018 Carnegie Mellon University. All Rights Reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ * 
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following acknowledgments and disclaimers.
+ * 
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ * 
+ * 3. The names "Carnegie Mellon University," "SEI" and/or "Software
+ *    Engineering Institute" shall not be used to endorse or promote products
+ *    derived from this software without prior written permission. For written
+ *    permission, please contact permission@sei.cmu.edu.
+ * 
+ * 4. Products derived from this software may not be called "SEI" nor may "SEI"
+ *    appear in their names without prior written permission of
+ *    permission@sei.cmu.edu.
+ * 
+ * 5. Redistributions of any form whatsoever must retain the following
+ *    acknowledgment:
+ * 
+ *      This material is based upon work funded and supported by the Department
+ *      of Defense under Contract No. FA8721-05-C-0003 with Carnegie Mellon
+ *      University for the operation of the Software Engineering Institute, a
+ *      federally funded research and development center. Any opinions,
+ *      findings and conclusions or recommendations expressed in this material
+ *      are those of the author(s) and do not necessarily reflect the views of
+ *      the United States Department of Defense.
+ * 
+ *      NO WARRANTY. THIS CARNEGIE MELLON UNIVERSITY AND SOFTWARE ENGINEERING
+ *      INSTITUTE MATERIAL IS FURNISHED ON AN "AS-IS" BASIS. CARNEGIE MELLON
+ *      UNIVERSITY MAKES NO WARRANTIES OF ANY KIND, EITHER EXPRESSED OR
+ *      IMPLIED, AS TO ANY MATTER INCLUDING, BUT NOT LIMITED TO, WARRANTY OF
+ *      FITNESS FOR PURPOSE OR MERCHANTABILITY, EXCLUSIVITY, OR RESULTS
+ *      OBTAINED FROM USE OF THE MATERIAL. CARNEGIE MELLON UNIVERSITY DOES
+ *      NOT MAKE ANY WARRANTY OF ANY KIND WITH RESPECT TO FREEDOM FROM PATENT,
+ *      TRADEMARK, OR COPYRIGHT INFRINGEMENT.
+ * 
+ *      This material has been approved for public release and unlimited
+ *      distribution.
+ **/
+
+/**
+ * @file AgentNames.h
+ * @author James Edmondson <jedmondson@gmail.com>
+ *
+ * This file contains a process-wide table of interned agent prefixes
+ **/
+
+#ifndef   _GAMS_VARIABLES_AGENT_NAMES_H_
+#define   _GAMS_VARIABLES_AGENT_NAMES_H_
+
+#include <atomic>
+#include <vector>
+#include <string>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+
+#include "gams/GamsExport.h"
+#include "madara/knowledge/KnowledgeRecord.h"
+
+namespace gams
+{
+  namespace variables
+  {
+    /// a dense, process-wide id for an agent prefix. -1 is invalid.
+    typedef int AgentId;
+
+    /// agent numbers at or above this are interned by prefix only
+    const madara::knowledge::KnowledgeRecord::Integer
+      MAX_NUMBERED_AGENTS = 65536;
+
+    /// default number of prefixes the process-wide table can intern
+    const size_t MAX_AGENT_NAMES = 65536;
+
+    /**
+     * The prefix of an interned agent and the names of its most
+     * frequently accessed variables, built once per agent
+     **/
+    struct AgentName
+    {
+      /// the agent prefix(e.g. agent.0)
+      std::string prefix;
+
+      /// {prefix}.location
+      std::string location;
+
+      /// {prefix}.orientation
+      std::string orientation;
+
+      /// {prefix}.velocity
+      std::string velocity;
+
+      /// {prefix}.dest
+      std::string dest;
+
+      /// {prefix}.home
+      std::string home;
+
+      /// {prefix}.source
+      std::string source;
+    };
+
+    /**
+     * Maps agent prefixes to dense ids. Ids are never reused or removed,
+     * so they may be cached for the life of the process, and the names
+     * returned by get and intern_name remain valid. Because nothing is
+     * freed, the table holds at most a fixed number of prefixes, and
+     * interning more fails.
+     *
+     * All methods are thread-safe. Lookups of interned prefixes, ids and
+     * names do not lock. Only adding a prefix and interning by agent
+     * number take the table's mutex. Callers in a loop should still cache
+     * the id or the AgentName reference instead of hashing the prefix
+     * each time.
+     **/
+    class GAMS_EXPORT AgentNameTable
+    {
+    public:
+      /**
+       * Constructor
+       * @param  capacity  the most prefixes the table can intern
+       **/
+      AgentNameTable(size_t capacity = MAX_AGENT_NAMES);
+
+      /**
+       * Destructor
+       **/
+      ~AgentNameTable();
+
+      /**
+       * Interns an agent prefix
+       * @param  prefix  the agent prefix(e.g. agent.0)
+       * @return the id of the prefix, or -1 if the table is full
+       **/
+      AgentId intern(const std::string & prefix);
+
+      /**
+       * Interns the prefix of a numbered agent without building the
+       * prefix if it has already been interned. Numbers outside of
+       * [0, MAX_NUMBERED_AGENTS) are interned through their prefix.
+       * @param  number  the agent number(e.g. 0 for agent.0)
+       * @return the id of agent.{number}, or -1 if the table is full
+       **/
+      AgentId intern(
+        const madara::knowledge::KnowledgeRecord::Integer & number);
+
+      /**
+       * Interns an agent prefix and gets its names in one lookup
+       * @param  prefix  the agent prefix(e.g. agent.0)
+       * @return the agent's prefix and variable names, or empty names
+       *         if the table is full
+       **/
+      const AgentName & intern_name(const std::string & prefix);
+
+      /**
+       * Finds an agent prefix without interning it
+       * @param  prefix  the agent prefix(e.g. agent.0)
+       * @return the id of the prefix, or -1 if it is not interned
+       **/
+      AgentId find(const std::string & prefix) const;
+
+      /**
+       * Gets the names of an interned agent
+       * @param  id  an id returned by intern
+       * @return the agent's prefix and variable names, or empty names
+       *         if id was not returned by intern
+       **/
+      const AgentName & get(AgentId id) const;
+
+      /**
+       * Gets the prefix of an interned agent
+       * @param  id  an id returned by intern
+       * @return the agent prefix(e.g. agent.0)
+       **/
+      const std::string & get_prefix(AgentId id) const;
+
+      /**
+       * Interns a list of agent prefixes
+       * @param  prefixes  the agent prefixes
+       * @param  ids       the ids of the prefixes, in the same order. An
+       *                   id is -1 if the table was full.
+       **/
+      void intern(const std::vector<std::string> & prefixes,
+        std::vector<AgentId> & ids);
+
+      /**
+       * Returns the number of interned agents
+       * @return the number of agents
+       **/
+      size_t size(void) const;
+
+      /**
+       * Returns the most prefixes the table can intern
+       * @return the capacity of the table
+       **/
+      size_t capacity(void) const;
+
+    private:
+      /// prefix to id
+      typedef std::unordered_map<std::string, AgentId> IdMap;
+
+      /// number of names allocated at once
+      static const size_t CHUNK_SIZE = 256;
+
+      AgentNameTable(const AgentNameTable &) = delete;
+      AgentNameTable & operator=(const AgentNameTable &) = delete;
+
+      /**
+       * Finds the id of a prefix, adding it if it is new. Does not lock
+       * if the prefix is already interned.
+       * @param  prefix  the agent prefix
+       * @return the id of the prefix, or -1 if the table is full
+       **/
+      AgentId intern_(const std::string & prefix);
+
+      /**
+       * Adds a new prefix. The mutex must be held.
+       * @param  prefix  the agent prefix
+       * @return the id of the new prefix, or -1 if the table is full
+       **/
+      AgentId add_(const std::string & prefix);
+
+      /// serializes adding prefixes and guards numbered_
+      mutable std::mutex mutex_;
+
+      /// the most prefixes the table can intern
+      const size_t capacity_;
+
+      /// number of interned prefixes. Names below it are complete.
+      std::atomic<size_t> count_;
+
+      /// prefix to id. Adding a prefix publishes a new copy, so lookups
+      /// read a snapshot through std::atomic_load without locking.
+      std::shared_ptr<const IdMap> ids_;
+
+      /// chunks of CHUNK_SIZE names, allocated as the table grows. Names
+      /// never move, so references to them stay valid.
+      std::unique_ptr<std::atomic<AgentName *>[]> chunks_;
+
+      /// ids of agent.{number} by number, -1 if not yet interned
+      std::vector<AgentId> numbered_;
+    };
+
+    /**
+     * Returns the process-wide agent name table
+     * @return the agent name table
+     **/
+    GAMS_EXPORT AgentNameTable & agent_names(void);
+  }
+}
+
+#endif // _GAMS_VARIABLES_AGENT_NAMES_H_
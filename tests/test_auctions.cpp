@@ -56,9 +56,11 @@
 #include "gams/auctions/AuctionMaximumBid.h"
 #include "gams/auctions/AuctionMinimumBid.h"
 #include "gams/auctions/AuctionMinimumDistance.h"
+#include "gams/auctions/AuctionCBBA.h"
 #include "gams/auctions/AuctionFactoryRepository.h"
 #include "gams/groups/GroupFixedList.h"
 #include "gams/platforms/NullPlatform.h"
+#include "gams/utility/KeyFeed.h"
 
 namespace loggers = gams::loggers;
 namespace auctions = gams::auctions;
@@ -151,6 +153,92 @@ void test_minimum_auction(knowledge::KnowledgeBase & knowledge)
       leader.c_str());
     ++gams_fails;
   }
+
+  auctions::AuctionBids bids;
+  auction.get_top_bids(bids, 2);
+
+  if (bids.size() == 2 &&
+    bids[0].bidder == "agent.2" && bids[1].bidder == "agent.0")
+  {
+    loggers::global_logger->log(
+      loggers::LOG_ALWAYS, "  Top 2 bids == agent.2, agent.0: SUCCESS\n");
+  }
+  else
+  {
+    loggers::global_logger->log(
+      loggers::LOG_ALWAYS, "  Top 2 bids: FAIL\n");
+    ++gams_fails;
+  }
+
+  auction.get_bids_within(bids, 7.0);
+
+  if (bids.size() == 3)
+  {
+    loggers::global_logger->log(
+      loggers::LOG_ALWAYS, "  Bids within 7.0 == 3: SUCCESS\n");
+  }
+  else
+  {
+    loggers::global_logger->log(
+      loggers::LOG_ALWAYS, "  Bids within 7.0 == %d: FAIL\n",
+      (int)bids.size());
+    ++gams_fails;
+  }
+
+  // bids changed outside of the auction are seen without a sync
+  agent3bid = 0.5;
+  leader = auction.get_leader();
+
+  if (leader == "agent.3")
+  {
+    loggers::global_logger->log(
+      loggers::LOG_ALWAYS, "  Updated leader == agent.3: SUCCESS\n");
+  }
+  else
+  {
+    loggers::global_logger->log(
+      loggers::LOG_ALWAYS, "  Updated leader == %s: FAIL\n",
+      leader.c_str());
+    ++gams_fails;
+  }
+
+  // expected bidders without bids do not get bid variables
+  gams::groups::GroupFixedList group;
+  gams::groups::AgentVector members;
+  members.push_back("agent.9");
+  group.add_members(members);
+  auction.add_group(&group);
+  auction.get_leader();
+
+  if (!knowledge.exists("auction.distances.0.agent.9"))
+  {
+    loggers::global_logger->log(
+      loggers::LOG_ALWAYS, "  No bid variable for agent.9: SUCCESS\n");
+  }
+  else
+  {
+    loggers::global_logger->log(
+      loggers::LOG_ALWAYS, "  No bid variable for agent.9: FAIL\n");
+    ++gams_fails;
+  }
+
+  // bids from other agents are seen without a sync
+  knowledge.set("auction.distances.0.agent.4", 0.1);
+  knowledge.set("auction.distances.0.agent.9", 0.2);
+  auction.get_top_bids(bids, 2);
+
+  if (bids.size() == 2 &&
+    bids[0].bidder == "agent.4" && bids[1].bidder == "agent.9")
+  {
+    loggers::global_logger->log(
+      loggers::LOG_ALWAYS, "  New bids == agent.4, agent.9: SUCCESS\n");
+  }
+  else
+  {
+    loggers::global_logger->log(
+      loggers::LOG_ALWAYS, "  New bids: FAIL\n");
+    ++gams_fails;
+  }
 }
 
 void test_maximum_auction(knowledge::KnowledgeBase & knowledge)
@@ -355,6 +443,229 @@ void test_minimum_distance_auction(knowledge::KnowledgeBase & knowledge)
   knowledge.print();
 }
 
+void test_bid_feed(knowledge::KnowledgeBase & knowledge)
+{
+  using madara::knowledge::KnowledgeRecord;
+
+  loggers::global_logger->log(
+    loggers::LOG_ALWAYS, "Testing auction bids with a KeyFeed\n");
+
+  knowledge.clear(true);
+
+  // the settings are never used for a transport, so received bids are
+  // simulated by adding their keys to the feed
+  madara::transport::QoSTransportSettings settings;
+  gams::utility::KeyFeed & feed = gams::utility::KeyFeed::get(knowledge);
+  feed.attach(settings);
+
+  {
+    knowledge.set("auction.feed.0.agent.1", 3.0);
+
+    auctions::AuctionMinimumBid auction(
+      "auction.feed", "agent.0", &knowledge);
+    auction.bid(KnowledgeRecord(2.0));
+
+    std::string leader = auction.get_leader();
+
+    if (leader == "agent.0")
+    {
+      loggers::global_logger->log(
+        loggers::LOG_ALWAYS, "  Testing initial scan: SUCCESS\n");
+    }
+    else
+    {
+      loggers::global_logger->log(
+        loggers::LOG_ALWAYS, "  Testing initial scan: FAIL (%s)\n",
+        leader.c_str());
+      ++gams_fails;
+    }
+
+    // a bid that was not received is not rescanned for
+    knowledge.set("auction.feed.0.agent.2", 1.0);
+    leader = auction.get_leader();
+
+    if (leader == "agent.0")
+    {
+      loggers::global_logger->log(
+        loggers::LOG_ALWAYS, "  Testing no rescan: SUCCESS\n");
+    }
+    else
+    {
+      loggers::global_logger->log(
+        loggers::LOG_ALWAYS, "  Testing no rescan: FAIL (%s)\n",
+        leader.c_str());
+      ++gams_fails;
+    }
+
+    feed.add("auction.feed.0.agent.2");
+    leader = auction.get_leader();
+
+    if (leader == "agent.2")
+    {
+      loggers::global_logger->log(
+        loggers::LOG_ALWAYS, "  Testing received bid: SUCCESS\n");
+    }
+    else
+    {
+      loggers::global_logger->log(
+        loggers::LOG_ALWAYS, "  Testing received bid: FAIL (%s)\n",
+        leader.c_str());
+      ++gams_fails;
+    }
+
+    // a deleted bid and a new one keep the number of bids the same
+    knowledge.delete_variable("auction.feed.0.agent.2");
+    knowledge.set("auction.feed.0.agent.3", 2.5);
+    feed.add("auction.feed.0.agent.2");
+    feed.add("auction.feed.0.agent.3");
+
+    // group members without bid variables are not reported as bidders
+    gams::groups::GroupFixedList group;
+    gams::groups::AgentVector members;
+    members.push_back("agent.9");
+    group.add_members(members);
+    auction.add_group(&group);
+
+    auctions::AuctionBids bids;
+    auction.get_bids(bids, true, true);
+    leader = auction.get_leader();
+
+    bool agent3_found = false;
+    for (size_t i = 0; i < bids.size(); ++i)
+    {
+      agent3_found = agent3_found || bids[i].bidder == "agent.3";
+    }
+
+    if (bids.size() == 3 && agent3_found && leader == "agent.0")
+    {
+      loggers::global_logger->log(
+        loggers::LOG_ALWAYS, "  Testing deleted and added bids: SUCCESS\n");
+    }
+    else
+    {
+      loggers::global_logger->log(
+        loggers::LOG_ALWAYS, "  Testing deleted and added bids: FAIL\n");
+      ++gams_fails;
+    }
+  }
+
+  // later tests use the same knowledge base without a feed
+  gams::utility::KeyFeed::release(knowledge);
+}
+
+void test_cbba_auction(knowledge::KnowledgeBase & knowledge)
+{
+  loggers::global_logger->log(
+    loggers::LOG_ALWAYS, "Testing AuctionCBBA\n");
+
+  knowledge.clear(true);
+
+  gams::groups::GroupFixedList group;
+  gams::groups::AgentVector members;
+  members.push_back("agent.0");
+  members.push_back("agent.1");
+  members.push_back("agent.2");
+  group.add_members(members);
+
+  std::vector<std::string> tasks;
+  tasks.push_back("task.0");
+  tasks.push_back("task.1");
+  tasks.push_back("task.2");
+  tasks.push_back("task.3");
+
+  // each agent prefers a different task, and agent.0 also wants task.3
+  double scores[3][4] = {
+    {10, 1, 1, 8},
+    {1, 10, 1, 4},
+    {1, 1, 10, 2}
+  };
+
+  auctions::AuctionCBBA auction0("auction.tasks", "agent.0", &knowledge);
+  auctions::AuctionCBBA auction1("auction.tasks", "agent.1", &knowledge);
+  auctions::AuctionCBBA auction2("auction.tasks", "agent.2", &knowledge);
+  auctions::AuctionCBBA * auctions_list[3] = {&auction0, &auction1, &auction2};
+
+  for (size_t i = 0; i < 3; ++i)
+  {
+    auctions_list[i]->add_group(&group);
+    auctions_list[i]->set_tasks(tasks);
+
+    for (size_t j = 0; j < tasks.size(); ++j)
+    {
+      auctions_list[i]->set_score(tasks[j], scores[i][j]);
+    }
+  }
+
+  int iterations = 0;
+  bool converged = false;
+
+  while (!converged && iterations < 20)
+  {
+    converged = true;
+
+    for (size_t i = 0; i < 3; ++i)
+    {
+      auctions_list[i]->iterate();
+      converged = auctions_list[i]->is_converged() && converged;
+    }
+
+    ++iterations;
+  }
+
+  std::map<std::string, std::string> assignments0, assignments2;
+  auction0.get_assignments(assignments0);
+  auction2.get_assignments(assignments2);
+
+  if (converged && assignments0 == assignments2 &&
+    assignments0["task.0"] == "agent.0" &&
+    assignments0["task.1"] == "agent.1" &&
+    assignments0["task.2"] == "agent.2" &&
+    assignments0["task.3"] == "agent.0")
+  {
+    loggers::global_logger->log(
+      loggers::LOG_ALWAYS, "  Converged allocation in %d iterations: SUCCESS\n",
+      iterations);
+  }
+  else
+  {
+    loggers::global_logger->log(
+      loggers::LOG_ALWAYS, "  Allocation after %d iterations(converged=%d): FAIL\n",
+      iterations, (int)converged);
+    ++gams_fails;
+  }
+
+  if (auction0.get_bundle().size() == 2 && auction1.get_bundle().size() == 1)
+  {
+    loggers::global_logger->log(
+      loggers::LOG_ALWAYS, "  Bundle sizes == 2, 1: SUCCESS\n");
+  }
+  else
+  {
+    loggers::global_logger->log(
+      loggers::LOG_ALWAYS, "  Bundle sizes == %d, %d: FAIL\n",
+      (int)auction0.get_bundle().size(), (int)auction1.get_bundle().size());
+    ++gams_fails;
+  }
+
+  // published consensus state is not reported as bids
+  auctions::AuctionBids bids;
+  auction0.get_bids(bids, true, true);
+
+  if (bids.size() == 0 &&
+    knowledge.exists("auction.tasks.cbba.0.agent.0.winners"))
+  {
+    loggers::global_logger->log(
+      loggers::LOG_ALWAYS, "  No bids from published state: SUCCESS\n");
+  }
+  else
+  {
+    loggers::global_logger->log(
+      loggers::LOG_ALWAYS, "  %d bids from published state: FAIL\n",
+      (int)bids.size());
+    ++gams_fails;
+  }
+}
+
 int
 main(int, char **)
 {
@@ -363,6 +674,8 @@ main(int, char **)
   test_minimum_auction(knowledge);
   test_maximum_auction(knowledge);
   test_minimum_distance_auction(knowledge);
+  test_bid_feed(knowledge);
+  test_cbba_auction(knowledge);
 
   if (gams_fails > 0)
   {
@@ -53,6 +53,8 @@
 
 #include "madara/knowledge/KnowledgeBase.h"
 #include "gams/controllers/BaseController.h"
+#include "gams/controllers/AdaptiveRate.h"
+#include "gams/algorithms/NullAlgorithm.h"
 #include "madara/logger/GlobalLogger.h"
 
 // default transport settings
@@ -63,6 +65,7 @@ madara::transport::QoSTransportSettings settings;
 // create shortcuts to MADARA classes and namespaces
 namespace engine = madara::knowledge;
 namespace controllers = gams::controllers;
+namespace algorithms = gams::algorithms;
 typedef madara::knowledge::KnowledgeRecord   Record;
 typedef Record::Integer Integer;
 
@@ -268,11 +271,179 @@ void handle_arguments(int argc, char ** argv)
   }
 }
 
+void test_adaptive_rate(void)
+{
+  controllers::ControllerSettings rate_settings;
+  rate_settings.adaptive_rates = true;
+  rate_settings.min_loop_hertz = 1.0;
+  rate_settings.max_loop_hertz = 20.0;
+  rate_settings.min_send_hertz = 0.5;
+  rate_settings.max_send_hertz = 10.0;
+  rate_settings.cpu_budget = 0.5;
+
+  controllers::AdaptiveRate rate(rate_settings);
+
+  // holding with a cheap loop should decay to the minimum rates
+  for (int i = 0; i < 100; ++i)
+  {
+    rate.update(0.001, 10, false);
+  }
+
+  if (rate.get_loop_hz() == 1.0 && rate.get_send_hz() == 0.5)
+  {
+    std::cerr << "SUCCESS: adaptive rates decay when holding\n";
+  }
+  else
+  {
+    std::cerr << "FAIL: adaptive rates are " << rate.get_loop_hz() <<
+      " and " << rate.get_send_hz() << " when holding\n";
+    ++gams_fails;
+  }
+
+  // moving should immediately return to the maximum rates
+  rate.update(0.001, 10, true);
+
+  if (rate.get_loop_hz() == 20.0 && rate.get_send_hz() == 10.0)
+  {
+    std::cerr << "SUCCESS: adaptive rates jump when moving\n";
+  }
+  else
+  {
+    std::cerr << "FAIL: adaptive rates are " << rate.get_loop_hz() <<
+      " and " << rate.get_send_hz() << " when moving\n";
+    ++gams_fails;
+  }
+
+  // a loop taking 100ms can only run at 5hz within a 50% budget
+  for (int i = 0; i < 100; ++i)
+  {
+    rate.update(0.1, 10, true);
+  }
+
+  if (rate.get_loop_hz() < 5.01 && rate.get_send_hz() <= rate.get_loop_hz())
+  {
+    std::cerr << "SUCCESS: adaptive loop rate respects cpu budget\n";
+  }
+  else
+  {
+    std::cerr << "FAIL: adaptive loop rate is " << rate.get_loop_hz() <<
+      " with a 100ms loop\n";
+    ++gams_fails;
+  }
+
+  // the decay is tunable like the bounds
+  rate_settings.adaptive_decay = 0.5;
+  controllers::AdaptiveRate fast_decay(rate_settings);
+  fast_decay.update(0.001, 10, false);
+
+  if (fast_decay.get_loop_hz() == 10.0 && fast_decay.get_send_hz() == 5.0)
+  {
+    std::cerr << "SUCCESS: adaptive rates use the configured decay\n";
+  }
+  else
+  {
+    std::cerr << "FAIL: adaptive rates are " << fast_decay.get_loop_hz() <<
+      " and " << fast_decay.get_send_hz() << " with a 0.5 decay\n";
+    ++gams_fails;
+  }
+}
+
+/**
+ * An algorithm that only does work in plan
+ **/
+class PlanningAlgorithm : public algorithms::BaseAlgorithm
+{
+public:
+  PlanningAlgorithm(engine::KnowledgeBase * knowledge,
+    gams::variables::Self * self)
+    : algorithms::BaseAlgorithm(knowledge, 0, 0, self), plans(0)
+  {
+  }
+
+  virtual int analyze(void)
+  {
+    return 0;
+  }
+
+  virtual int execute(void)
+  {
+    return 0;
+  }
+
+  virtual int plan(void)
+  {
+    ++plans;
+    return 0;
+  }
+
+  virtual int get_phases(void) const
+  {
+    return algorithms::PHASE_PLAN;
+  }
+
+  int plans;
+};
+
+void test_pipeline(void)
+{
+  controllers::ControllerSettings pipeline_settings;
+  pipeline_settings.profile_pipeline = true;
+
+  engine::KnowledgeBase knowledge;
+  controllers::BaseController loop(knowledge, pipeline_settings);
+  loop.init_vars(0, 1);
+
+  gams::variables::Self self;
+  self.init_vars(knowledge, 0);
+
+  loop.init_algorithm(new algorithms::NullAlgorithm(&knowledge, 0, 0, &self));
+  loop.plan();
+
+  if (loop.get_pipeline(algorithms::PHASE_PLAN).size() == 0 &&
+    loop.get_pipeline(algorithms::PHASE_ANALYZE).size() == 1)
+  {
+    std::cerr << "SUCCESS: pipeline skips phases an algorithm declares\n";
+  }
+  else
+  {
+    std::cerr << "FAIL: NullAlgorithm has " <<
+      loop.get_pipeline(algorithms::PHASE_PLAN).size() << " plan stages\n";
+    ++gams_fails;
+  }
+
+  PlanningAlgorithm * planning = new PlanningAlgorithm(&knowledge, &self);
+  loop.init_algorithm(planning);
+  loop.plan();
+  loop.plan();
+
+  const controllers::BaseController::Pipeline & plans =
+    loop.get_pipeline(algorithms::PHASE_PLAN);
+
+  if (planning->plans == 2 && plans.size() == 1 && plans[0].primary &&
+    plans[0].calls == 2 && plans[0].total_duration >= plans[0].last_duration &&
+    loop.get_pipeline(algorithms::PHASE_ANALYZE).size() == 0 &&
+    loop.get_pipeline(algorithms::PHASE_EXECUTE).size() == 0)
+  {
+    std::cerr << "SUCCESS: pipeline profiles a declared plan\n";
+  }
+  else
+  {
+    std::cerr << "FAIL: plan was called " << planning->plans <<
+      " times with " << plans.size() << " plan stages\n";
+    ++gams_fails;
+  }
+
+  loop.log_pipeline_profile();
+}
+
 // perform main logic of program
 int main(int argc, char ** argv)
 {
   handle_arguments(argc, argv);
 
+  test_adaptive_rate();
+  test_pipeline();
+
   // create knowledge base and a control loop
   engine::KnowledgeBase knowledge;
   controllers::BaseController loop(knowledge);
@@ -55,6 +55,8 @@
 
 #include "gams/elections/ElectionPlurality.h"
 #include "gams/elections/ElectionCumulative.h"
+#include "gams/elections/ElectionService.h"
+#include "gams/utility/KeyFeed.h"
 
 namespace loggers = gams::loggers;
 namespace elections = gams::elections;
@@ -194,6 +196,50 @@ void test_cumulative(void)
       leaders.size());
     ++gams_fails;
   }
+
+  loggers::global_logger->log(
+    loggers::LOG_ALWAYS, "  Changing agent.1 ballot outside of election...\n");
+
+  // ballot values changed directly in the knowledge base are picked up
+  agent1vote = 5;
+
+  std::string leader = election.get_leader();
+
+  if (leader == "Donald")
+  {
+    loggers::global_logger->log(
+      loggers::LOG_ALWAYS, "  Leader == Donald: SUCCESS\n");
+  }
+  else
+  {
+    loggers::global_logger->log(
+      loggers::LOG_ALWAYS, "  Leader == %s: FAIL\n",
+      leader.c_str());
+    ++gams_fails;
+  }
+
+  loggers::global_logger->log(
+    loggers::LOG_ALWAYS, "  Adding new ballot for agent.7 without sync...\n");
+
+  // new ballots from other agents are indexed by the next query
+  containers::Integer agent7vote(
+    "election.president.0.agent.7->Bernie", knowledge);
+  agent7vote = 10;
+
+  leader = election.get_leader();
+
+  if (leader == "Bernie")
+  {
+    loggers::global_logger->log(
+      loggers::LOG_ALWAYS, "  Leader == Bernie: SUCCESS\n");
+  }
+  else
+  {
+    loggers::global_logger->log(
+      loggers::LOG_ALWAYS, "  Leader == %s: FAIL\n",
+      leader.c_str());
+    ++gams_fails;
+  }
 }
 
 void test_plurality(void)
@@ -293,11 +339,184 @@ void test_plurality(void)
   }
 }
 
+void test_key_feed(void)
+{
+  loggers::global_logger->log(
+    loggers::LOG_ALWAYS, "Testing elections with a KeyFeed\n");
+
+  knowledge::KnowledgeBase knowledge;
+
+  // the settings are never used for a transport, so received ballots are
+  // simulated by adding their keys to the feed
+  madara::transport::QoSTransportSettings settings;
+  gams::utility::KeyFeed & feed = gams::utility::KeyFeed::get(knowledge);
+  feed.attach(settings);
+
+  {
+    knowledge.set("election.mayor.0.agent.1->agent.1",
+      knowledge::KnowledgeRecord::Integer(1));
+
+    elections::ElectionCumulative election(
+      "election.mayor", "agent.0", &knowledge);
+    election.vote("agent.2", 2);
+
+    std::string leader = election.get_leader();
+
+    if (leader == "agent.2")
+    {
+      loggers::global_logger->log(
+        loggers::LOG_ALWAYS, "  Testing initial scan: SUCCESS\n");
+    }
+    else
+    {
+      loggers::global_logger->log(
+        loggers::LOG_ALWAYS, "  Testing initial scan: FAIL (%s)\n",
+        leader.c_str());
+      ++gams_fails;
+    }
+
+    // a ballot that was not received is not rescanned for
+    knowledge.set("election.mayor.0.agent.3->agent.3",
+      knowledge::KnowledgeRecord::Integer(5));
+
+    leader = election.get_leader();
+
+    if (leader == "agent.2")
+    {
+      loggers::global_logger->log(
+        loggers::LOG_ALWAYS, "  Testing no rescan: SUCCESS\n");
+    }
+    else
+    {
+      loggers::global_logger->log(
+        loggers::LOG_ALWAYS, "  Testing no rescan: FAIL (%s)\n",
+        leader.c_str());
+      ++gams_fails;
+    }
+
+    feed.add("election.mayor.0.agent.3->agent.3");
+    leader = election.get_leader();
+
+    if (leader == "agent.3")
+    {
+      loggers::global_logger->log(
+        loggers::LOG_ALWAYS, "  Testing received ballot: SUCCESS\n");
+    }
+    else
+    {
+      loggers::global_logger->log(
+        loggers::LOG_ALWAYS, "  Testing received ballot: FAIL (%s)\n",
+        leader.c_str());
+      ++gams_fails;
+    }
+
+    // a deleted ballot and a new one keep the ballot count the same
+    knowledge.delete_variable("election.mayor.0.agent.3->agent.3");
+    knowledge.set("election.mayor.0.agent.4->agent.1",
+      knowledge::KnowledgeRecord::Integer(4));
+    feed.add("election.mayor.0.agent.3->agent.3");
+    feed.add("election.mayor.0.agent.4->agent.1");
+
+    // keys of other elections and rounds are not delivered
+    feed.add("election.mayor.1.agent.5->agent.5");
+    feed.add("election.mayoral.0.agent.5->agent.5");
+
+    elections::CandidateVotes votes;
+    election.get_votes(votes);
+
+    if (votes.size() == 2 && votes["agent.1"] == 5 && votes["agent.2"] == 2)
+    {
+      loggers::global_logger->log(
+        loggers::LOG_ALWAYS, "  Testing deleted and added ballots: SUCCESS\n");
+    }
+    else
+    {
+      loggers::global_logger->log(
+        loggers::LOG_ALWAYS, "  Testing deleted and added ballots: FAIL\n");
+      ++gams_fails;
+    }
+  }
+
+  // the knowledge base's address may be reused by later tests
+  gams::utility::KeyFeed::release(knowledge);
+}
+
+void test_service(void)
+{
+  loggers::global_logger->log(
+    loggers::LOG_ALWAYS, "Testing ElectionService\n");
+
+  knowledge::KnowledgeBase knowledge;
+
+  elections::ElectionPlurality sector0(
+    "election.sector.0", "agent.0", &knowledge);
+  elections::ElectionCumulative sector1(
+    "election.sector.1", "agent.0", &knowledge);
+  elections::ElectionPlurality sector2(
+    "election.sector.2", "agent.0", &knowledge);
+
+  sector0.vote("agent.1", "agent.3", 1);
+  sector0.vote("agent.2", "agent.3", 1);
+  sector0.vote("agent.3", "agent.1", 1);
+  sector1.vote("agent.1", "agent.2", 5);
+  sector1.vote("agent.2", "agent.1", 3);
+
+  elections::ElectionService service(&knowledge);
+  service.add(&sector0);
+  service.add(&sector1, 2);
+  service.add(&sector2);
+
+  service.evaluate();
+
+  elections::CandidateList leaders = service.get_leaders("election.sector.1");
+
+  if (service.get_leader("election.sector.0") == "agent.3" &&
+    leaders.size() == 2 && leaders[0] == "agent.2" &&
+    leaders[1] == "agent.1" &&
+    service.get_leader("election.sector.2") == "" &&
+    service.get_evaluations() == 1)
+  {
+    loggers::global_logger->log(
+      loggers::LOG_ALWAYS, "  Testing leaderboard: SUCCESS\n");
+  }
+  else
+  {
+    loggers::global_logger->log(
+      loggers::LOG_ALWAYS, "  Testing leaderboard: FAIL\n");
+    ++gams_fails;
+  }
+
+  // a remote vote arrives while a reader holds the old leaderboard
+  std::shared_ptr <const elections::Leaderboard> old_board =
+    service.get_leaderboard();
+
+  knowledge.set("election.sector.2.0.agent.4->agent.5",
+    knowledge::KnowledgeRecord::Integer(1));
+  service.remove("election.sector.1");
+  service.evaluate();
+
+  if (service.get_leader("election.sector.2") == "agent.5" &&
+    service.get_leaders("election.sector.1").size() == 0 &&
+    old_board->find("election.sector.1") != old_board->end())
+  {
+    loggers::global_logger->log(
+      loggers::LOG_ALWAYS, "  Testing re-evaluation: SUCCESS\n");
+  }
+  else
+  {
+    loggers::global_logger->log(
+      loggers::LOG_ALWAYS, "  Testing re-evaluation: FAIL\n");
+    ++gams_fails;
+  }
+}
+
 int
 main(int, char **)
 {
   test_cumulative();
   test_plurality();
+  test_key_feed();
+  test_service();
   
   if (gams_fails > 0)
   {
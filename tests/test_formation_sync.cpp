@@ -1,4 +1,7 @@
+#include <iostream>
+
 #include "gams/algorithms/FormationSync.h"
+#include "gams/formations/FormationAssignment.h"
 #include "gams/platforms/DebugPlatform.h"
 #include "gams/loggers/GlobalLogger.h"
 #include "madara/knowledge/KnowledgeBase.h"
@@ -10,6 +13,9 @@ namespace variables = gams::variables;
 namespace platforms = gams::platforms;
 namespace transport = madara::transport;
 namespace containers = engine::containers;
+namespace formations = gams::formations;
+
+int gams_fails = 0;
 
 void test_defaults(void)
 {
@@ -380,6 +386,205 @@ void test_groups(void)
   loggers::global_logger->log(0, "  Finished group default formation sync");
 }
 
+void test_assignment(void)
+{
+  loggers::global_logger->log(0, "Testing FormationAssignment\n");
+
+  // agent 0 is next to slot 1 and agent 1 is next to slot 0
+  formations::CostMatrix costs(3, std::vector<double>(3));
+  costs[0][0] = 10; costs[0][1] = 1; costs[0][2] = 8;
+  costs[1][0] = 1; costs[1][1] = 10; costs[1][2] = 8;
+  costs[2][0] = 4; costs[2][1] = 4; costs[2][2] = 5;
+
+  formations::FormationAssignment total(formations::ASSIGN_MIN_TOTAL);
+  std::vector<int> result = total.solve(costs);
+
+  if (result[0] == 1 && result[1] == 0 && result[2] == 2 &&
+    total.get_total_cost() == 7)
+  {
+    loggers::global_logger->log(0, "  SUCCESS: minimum total assignment\n");
+  }
+  else
+  {
+    loggers::global_logger->log(0,
+      "  FAIL: minimum total assignment was [%d, %d, %d], cost %.2f\n",
+      result[0], result[1], result[2], total.get_total_cost());
+    ++gams_fails;
+  }
+
+  // a cheaper total with one long move loses to a shorter longest move
+  costs[0][0] = 0; costs[0][1] = 10;
+  costs[1][0] = 10; costs[1][1] = 19;
+  costs.resize(2);
+  costs[0].resize(2);
+  costs[1].resize(2);
+
+  formations::FormationAssignment max(formations::ASSIGN_MIN_MAX);
+  result = max.solve(costs);
+
+  if (result[0] == 1 && result[1] == 0 && max.get_max_cost() == 10)
+  {
+    loggers::global_logger->log(0, "  SUCCESS: minimum max assignment\n");
+  }
+  else
+  {
+    loggers::global_logger->log(0,
+      "  FAIL: minimum max assignment was [%d, %d], max %.2f\n",
+      result[0], result[1], max.get_max_cost());
+    ++gams_fails;
+  }
+
+  // agents join one at a time and then one leaves
+  formations::FormationAssignment incremental;
+  std::vector<double> row(3);
+  row[0] = 1; row[1] = 2; row[2] = 3;
+  incremental.add_agent(row);
+  row[0] = 1; row[1] = 5; row[2] = 9;
+  incremental.add_agent(row);
+  incremental.remove_agent(0);
+
+  if (incremental.get_assignment().size() == 1 &&
+    incremental.get_assignment()[0] == 0 &&
+    incremental.get_total_cost() == 1)
+  {
+    loggers::global_logger->log(0, "  SUCCESS: incremental assignment\n");
+  }
+  else
+  {
+    loggers::global_logger->log(0,
+      "  FAIL: incremental assignment had cost %.2f\n",
+      incremental.get_total_cost());
+    ++gams_fails;
+  }
+}
+
+void test_agreed_assignment(void)
+{
+  using Record = madara::knowledge::KnowledgeRecord;
+
+  loggers::global_logger->log(0, "Testing agreed slot assignment\n");
+
+  engine::KnowledgeBase knowledge;
+
+  containers::StringVector members("group.pair.members", knowledge);
+  members.push_back("agent.0");
+  members.push_back("agent.1");
+
+  variables::Self self0, self1;
+  self0.init_vars(knowledge, 0);
+  self1.init_vars(knowledge, 1);
+
+  variables::Sensors sensors;
+  variables::Agents agents;
+
+  variables::init_vars(agents, knowledge, 2);
+
+  std::vector <double> start, end;
+  start.push_back(40.437024);
+  start.push_back(-79.948909);
+
+  end.push_back(40.436834);
+  end.push_back(-79.947911);
+
+  madara::knowledge::KnowledgeMap args;
+  args["end"] = Record(end);
+  args["start"] = Record(start);
+  args["group"] = Record("pair");
+  args["assignment"] = Record("TOTAL");
+  args["barrier"] = Record("barrier.agreed");
+
+  platforms::DebugPlatform platform0(&knowledge, &sensors, 0, &self0);
+  platforms::DebugPlatform platform1(&knowledge, &sensors, 0, &self1);
+
+  // only the leader's location is known at first
+  std::vector <double> location(start);
+  location.push_back(0);
+  knowledge.set("agent.0.location", location);
+
+  // an assignment of the same size from an earlier run must not be used
+  std::vector <Record::Integer> stale(3, 0);
+  knowledge.set("barrier.agreed.assignment", stale);
+
+  algorithms::FormationSyncFactory factory;
+  algorithms::BaseAlgorithm * alg0 = factory.create(
+    args, &knowledge, &platform0, &sensors, &self0, &agents);
+  algorithms::BaseAlgorithm * alg1 = factory.create(
+    args, &knowledge, &platform1, &sensors, &self1, &agents);
+
+  alg1->analyze();
+  alg1->execute();
+
+  bool published =
+    knowledge.get("barrier.agreed.assignment").to_integers() != stale;
+  bool finished = alg1->get_algorithm_status()->finished.to_integer() != 0;
+
+  if (!published && !finished)
+  {
+    loggers::global_logger->log(0,
+      "  SUCCESS: members wait for all locations before assigning\n");
+  }
+  else
+  {
+    loggers::global_logger->log(0,
+      "  FAIL: assignment published %d, finished %d before all"
+      " locations were known\n", (int)published, (int)finished);
+    ++gams_fails;
+  }
+
+  location[1] += 0.0001;
+  knowledge.set("agent.1.location", location);
+
+  alg0->analyze();
+  alg1->analyze();
+  alg1->execute();
+
+  std::vector <Record::Integer> slots =
+    knowledge.get("barrier.agreed.assignment").to_integers();
+  finished = alg1->get_algorithm_status()->finished.to_integer() != 0;
+
+  // the assignment is the key of the member list and a slot per member
+  if (slots.size() == 3 && slots[0] != 0 && slots[1] + slots[2] == 1 &&
+    slots[1] != slots[2] && !finished)
+  {
+    loggers::global_logger->log(0,
+      "  SUCCESS: leader published [%d, %d] and members adopted it\n",
+      (int)slots[1], (int)slots[2]);
+  }
+  else
+  {
+    loggers::global_logger->log(0,
+      "  FAIL: published assignment had %d entries\n", (int)slots.size());
+    ++gams_fails;
+  }
+
+  // agent.2 replaces agent.1, so the member count stays the same
+  location[0] += 0.0001;
+  knowledge.set("agent.2.location", location);
+  members.set(1, "agent.2");
+
+  alg0->analyze();
+
+  std::vector <Record::Integer> replaced =
+    knowledge.get("barrier.agreed.assignment").to_integers();
+
+  if (replaced.size() == 3 && replaced[0] != slots[0] &&
+    replaced[1] + replaced[2] == 1 && replaced[1] != replaced[2])
+  {
+    loggers::global_logger->log(0,
+      "  SUCCESS: leader reassigned [%d, %d] after a membership change\n",
+      (int)replaced[1], (int)replaced[2]);
+  }
+  else
+  {
+    loggers::global_logger->log(0,
+      "  FAIL: assignment was not solved again for the new members\n");
+    ++gams_fails;
+  }
+
+  delete alg0;
+  delete alg1;
+}
+
 int main(int , char **)
 {
   madara::knowledge::KnowledgeRecord::set_precision(6);
@@ -389,6 +594,17 @@ int main(int , char **)
   test_triangle();
   test_defaults();
   test_groups();
+  test_assignment();
+  test_agreed_assignment();
+
+  if (gams_fails > 0)
+  {
+    std::cerr << "OVERALL: FAIL. " << gams_fails << " tests failed.\n";
+  }
+  else
+  {
+    std::cerr << "OVERALL: SUCCESS.\n";
+  }
 
-  return 0;
+  return gams_fails;
 }
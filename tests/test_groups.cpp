@@ -8,6 +8,7 @@
 #include "gams/groups/GroupTransient.h"
 #include "gams/groups/GroupFixedList.h"
 #include "gams/groups/GroupFactoryRepository.h"
+#include "gams/utility/KeyFeed.h"
 
 namespace loggers = gams::loggers;
 namespace knowledge = madara::knowledge;
@@ -252,6 +253,280 @@ void test_repository(knowledge::KnowledgeBase & knowledge)
   }
 }
 
+void test_member_index(knowledge::KnowledgeBase & knowledge)
+{
+  loggers::global_logger->log(
+    0, "Testing member index and version\n");
+
+  groups::AgentVector members;
+  members.push_back("agent.0");
+  members.push_back("agent.1");
+  members.push_back("agent.2");
+
+  groups::GroupFixedList fixed("group.indexed", &knowledge);
+  fixed.add_members(members);
+
+  uint64_t version = fixed.get_version();
+
+  // a sync with no changes to membership should not bump the version
+  fixed.sync();
+
+  if (fixed.get_member_index("agent.2") == 2 &&
+    fixed.get_member_index("agent.3") == -1 &&
+    groups::find_member_index("agent.1", fixed) == 1 &&
+    fixed.get_version() == version)
+  {
+    loggers::global_logger->log(
+      0, "  SUCCESS: fixed list index is correct and version is stable\n");
+  }
+  else
+  {
+    loggers::global_logger->log(
+      0, "  FAIL: fixed list index or version incorrect (version %d->%d)\n",
+      (int)version, (int)fixed.get_version());
+    ++gams_fails;
+  }
+
+  groups::AgentVector removed;
+  removed.push_back("agent.0");
+  fixed.remove_members(removed);
+
+  if (fixed.get_member_index("agent.0") == -1 &&
+    fixed.get_member_index("agent.2") == 1 &&
+    fixed.get_version() > version)
+  {
+    loggers::global_logger->log(
+      0, "  SUCCESS: fixed list index updated after removal\n");
+  }
+  else
+  {
+    loggers::global_logger->log(
+      0, "  FAIL: fixed list index not updated after removal\n");
+    ++gams_fails;
+  }
+
+  groups::GroupTransient transient("group.indexed_transient", &knowledge);
+  transient.add_members(members);
+  version = transient.get_version();
+
+  // a remote agent joins through the knowledge base
+  knowledge.set("group.indexed_transient.members.agent.10", 1);
+  transient.sync();
+
+  if (transient.get_member_index("agent.10") == 2 &&
+    transient.get_member_index("agent.2") == 3 &&
+    transient.get_version() > version)
+  {
+    loggers::global_logger->log(
+      0, "  SUCCESS: transient index updated after remote join\n");
+  }
+  else
+  {
+    loggers::global_logger->log(
+      0, "  FAIL: transient index not updated after remote join\n");
+    ++gams_fails;
+  }
+
+  version = transient.get_version();
+  transient.sync();
+
+  if (transient.get_version() == version)
+  {
+    loggers::global_logger->log(
+      0, "  SUCCESS: transient version is stable without changes\n");
+  }
+  else
+  {
+    loggers::global_logger->log(
+      0, "  FAIL: transient version changed without membership changes\n");
+    ++gams_fails;
+  }
+}
+
+void test_membership_changes(knowledge::KnowledgeBase & knowledge)
+{
+  loggers::global_logger->log(
+    0, "Testing membership changes and subscriptions\n");
+
+  groups::GroupFixedList fixed("group.deltas", &knowledge);
+
+  int notifications = 0;
+  size_t subscription = fixed.subscribe(
+    [&notifications](const groups::GroupBase &,
+      const groups::MembershipChange &)
+    {
+      ++notifications;
+    });
+
+  groups::AgentVector members;
+  members.push_back("agent.0");
+  members.push_back("agent.1");
+  fixed.add_members(members);
+
+  uint64_t version = fixed.get_version();
+
+  groups::AgentVector joining, leaving;
+  joining.push_back("agent.2");
+  joining.push_back("agent.3");
+  leaving.push_back("agent.0");
+  leaving.push_back("agent.3");
+
+  fixed.add_members(joining);
+  fixed.remove_members(leaving);
+
+  groups::AgentVector added, removed;
+
+  // agent.3 joined and left since version, so it is not in the delta
+  if (fixed.get_changes(version, added, removed) &&
+    added.size() == 1 && added[0] == "agent.2" &&
+    removed.size() == 1 && removed[0] == "agent.0" &&
+    notifications == 3)
+  {
+    loggers::global_logger->log(
+      0, "  SUCCESS: net delta and notifications are correct\n");
+  }
+  else
+  {
+    loggers::global_logger->log(
+      0, "  FAIL: delta had %d added, %d removed, %d notifications\n",
+      (int)added.size(), (int)removed.size(), notifications);
+    ++gams_fails;
+  }
+
+  fixed.unsubscribe(subscription);
+  fixed.set_history_size(1);
+  fixed.add_members(leaving);
+  fixed.add_members(members);
+
+  if (!fixed.get_changes(version, added, removed) && notifications == 3)
+  {
+    loggers::global_logger->log(
+      0, "  SUCCESS: expired history and unsubscribe are honored\n");
+  }
+  else
+  {
+    loggers::global_logger->log(
+      0, "  FAIL: expired history or unsubscribe not honored\n");
+    ++gams_fails;
+  }
+
+  // adding only duplicates records no change
+  version = fixed.get_version();
+  fixed.add_members(leaving);
+
+  std::vector<gams::variables::AgentId> ids;
+  fixed.get_member_ids(ids);
+  fixed.get_members(members);
+
+  if (fixed.get_version() == version && ids.size() == members.size())
+  {
+    loggers::global_logger->log(
+      0, "  SUCCESS: duplicates do not change the version\n");
+  }
+  else
+  {
+    loggers::global_logger->log(
+      0, "  FAIL: duplicates changed the version or ids are stale\n");
+    ++gams_fails;
+  }
+}
+
+void test_transient_feed(void)
+{
+  loggers::global_logger->log(
+    0, "Testing GroupTransient with a KeyFeed\n");
+
+  knowledge::KnowledgeBase knowledge;
+
+  // the settings are never used for a transport, so received members are
+  // simulated by adding their keys to the feed
+  transport::QoSTransportSettings settings;
+  gams::utility::KeyFeed & feed = gams::utility::KeyFeed::get(knowledge);
+  feed.attach(settings);
+
+  {
+    knowledge.set("group.fed.members.agent.0",
+      knowledge::KnowledgeRecord::Integer(1));
+
+    groups::GroupTransient group("group.fed", &knowledge);
+
+    // a member that was not received is not rescanned for
+    knowledge.set("group.fed.members.agent.1",
+      knowledge::KnowledgeRecord::Integer(1));
+    group.sync();
+
+    if (group.is_member("agent.0") && !group.is_member("agent.1"))
+    {
+      loggers::global_logger->log(
+        0, "  SUCCESS: initial scan without rescans\n");
+    }
+    else
+    {
+      loggers::global_logger->log(
+        0, "  FAIL: initial scan or rescan on sync\n");
+      ++gams_fails;
+    }
+
+    uint64_t version = group.get_version();
+
+    feed.add("group.fed.members.agent.1");
+    feed.add("group.other.members.agent.2");
+    group.sync();
+
+    if (group.is_member("agent.1") && !group.is_member("agent.2") &&
+      group.get_version() == version + 1)
+    {
+      loggers::global_logger->log(
+        0, "  SUCCESS: received member applied\n");
+    }
+    else
+    {
+      loggers::global_logger->log(
+        0, "  FAIL: received member not applied\n");
+      ++gams_fails;
+    }
+
+    knowledge.set("group.fed.members.agent.0",
+      knowledge::KnowledgeRecord::Integer(0));
+    feed.add("group.fed.members.agent.0");
+    group.sync();
+
+    groups::AgentVector members;
+    group.get_members(members);
+
+    if (members.size() == 1 && members[0] == "agent.1" &&
+      group.get_member_index("agent.1") == 0)
+    {
+      loggers::global_logger->log(
+        0, "  SUCCESS: received removal applied\n");
+    }
+    else
+    {
+      loggers::global_logger->log(
+        0, "  FAIL: received removal not applied\n");
+      ++gams_fails;
+    }
+
+    // members applied from the feed can be removed locally
+    group.remove_members(members);
+
+    if (group.size() == 0 &&
+      !knowledge.exists("group.fed.members.agent.1"))
+    {
+      loggers::global_logger->log(
+        0, "  SUCCESS: fed member removed from the knowledge base\n");
+    }
+    else
+    {
+      loggers::global_logger->log(
+        0, "  FAIL: fed member still in the knowledge base\n");
+      ++gams_fails;
+    }
+  }
+
+  gams::utility::KeyFeed::release(knowledge);
+}
+
 int main(int , char **)
 {
   knowledge::KnowledgeRecord::set_precision(6);
@@ -262,6 +537,9 @@ int main(int , char **)
   test_fixed_list(knowledge);
   test_transient(knowledge);
   test_repository(knowledge);
+  test_member_index(knowledge);
+  test_membership_changes(knowledge);
+  test_transient_feed();
 
   knowledge.print();
 
@@ -22,6 +22,7 @@
 #include "nav_msgs/Odometry.h"
 #include "sensor_msgs/RegionOfInterest.h"
 #include "sensor_msgs/CompressedImage.h"
+#include "sensor_msgs/Imu.h"
 
 
 const double TEST_epsilon = 0.0001;
@@ -139,6 +140,26 @@ void test_tf_tree()
 	TEST(origin.get(3), M_PI/2);
 	TEST(origin.get(4), 0.0);
 	TEST(origin.get(5), 0.0);
+
+	containers::NativeDoubleVector location("agent.0.location",
+		knowledge);
+	TEST(location[0], t.x);
+	TEST(location[1], t.y);
+	TEST(location[2], t.z);
+
+	// only the newest transform of a frame is used
+	geometry_msgs::TransformStamped newer = st;
+	newer.header.stamp = ros::Time(1);
+	newer.transform.translation.x = 4.0;
+	tf2_msgs::TFMessage batch;
+	batch.transforms.push_back(newer);
+	batch.transforms.push_back(st);
+
+	parser.parse_tf_message(&batch);
+
+	TEST(location[0], 4.0);
+	TEST(location[1], t.y);
+	TEST(location[2], t.z);
 }
 
 template <typename T>
@@ -231,6 +252,86 @@ void test_any_point()
 	TEST(capn_point2.getX(), x);
 	TEST(capn_point2.getY(), y);
 	TEST(capn_point2.getZ(), z);
+
+	// a second message on the topic reuses the compiled mapping
+	point.x = 4.0;
+	point.z = -6.0;
+	serialize_message_to_array(point, buffer);
+	ros::serialization::OStream stream2( buffer.data(), buffer.size() );
+	shape_shifter.read( stream2 );
+	parser.parse_any(topic_name, shape_shifter, container_name);
+
+	any = knowledge.get(container_name).to_any<madara::knowledge::GenericCapnObject>();
+	auto capn_point3 = any.reader<gams::types::Point>();
+	TEST(capn_point3.getX(), 4.0);
+	TEST(capn_point3.getY(), y);
+	TEST(capn_point3.getZ(), -6.0);
+
+	// the loaded schema file is a copy of the compiled Point schema
+	TEST(parser.is_compiled(topic_name), 1);
+
+	// a second parser shares the schema file loaded by the first one
+	knowledge::KnowledgeBase knowledge2;
+	gams::utility::ros::RosParser parser2 (&knowledge2, "", "", typemap,
+		plugin_types);
+	parser2.registerMessageDefinition (topic_name,
+		RosIntrospection::ROSType (datatype), definition);
+	parser2.load_capn_schema(point_schema_path);
+	parser2.parse_any(topic_name, shape_shifter, container_name);
+
+	any = knowledge2.get(container_name).to_any<madara::knowledge::GenericCapnObject>();
+	auto capn_point4 = any.reader<gams::types::Point>();
+	TEST(capn_point4.getX(), 4.0);
+	TEST(capn_point4.getY(), y);
+	TEST(capn_point4.getZ(), -6.0);
+}
+
+void test_compiled_point()
+{
+	// Types from the types library are converted by their compiled mapping
+	// without loading any schema files.
+
+	std::cout << std::endl << std::endl << "test_compiled_point" << std::endl << std::endl;
+
+	std::string container_name = "compiled_point";
+
+	geometry_msgs::Point point;
+	point.x = 7.0;
+	point.y = -8.0;
+	point.z = 9.0;
+
+	topic_tools::ShapeShifter shape_shifter;
+	shape_shifter.morph(
+		ros::message_traits::MD5Sum<geometry_msgs::Point>::value(),
+		ros::message_traits::DataType<geometry_msgs::Point>::value(),
+		ros::message_traits::Definition<geometry_msgs::Point>::value(),
+		"" );
+
+	std::vector<uint8_t> buffer;
+	serialize_message_to_array(point, buffer);
+	ros::serialization::OStream stream( buffer.data(), buffer.size() );
+	shape_shifter.read( stream );
+
+	std::map<std::string, std::string> typemap;
+	typemap["geometry_msgs/Point"] = "Point";
+
+	knowledge::KnowledgeBase knowledge;
+	gams::utility::ros::RosParser parser (&knowledge, "", "", typemap,
+		plugin_types);
+
+	const std::string topic_name = "compiled_point";
+	parser.registerMessageDefinition (topic_name,
+		RosIntrospection::ROSType (shape_shifter.getDataType()),
+		shape_shifter.getMessageDefinition());
+	parser.parse_any(topic_name, shape_shifter, container_name);
+
+	TEST(parser.is_compiled(topic_name), 1);
+
+	madara::knowledge::GenericCapnObject any = knowledge.get(container_name).to_any<madara::knowledge::GenericCapnObject>();
+	auto capn_point = any.reader<gams::types::Point>();
+	TEST(capn_point.getX(), 7.0);
+	TEST(capn_point.getY(), -8.0);
+	TEST(capn_point.getZ(), 9.0);
 }
 
 void test_any_bool()
@@ -525,15 +626,202 @@ void test_any_compressed_image()
 	std::cout << "Format: " << format << std::endl;
 }
 
+// exposes the policy state of the parser to the tests
+class PolicyParser : public gams::utility::ros::RosParser
+{
+public:
+	PolicyParser(knowledge::KnowledgeBase * kb)
+		: RosParser(kb, "", "", capnp_types, plugin_types)
+	{
+	}
+
+	using RosParser::PolicyState;
+	using RosParser::admit_message;
+	using RosParser::average_imu;
+	using RosParser::parse_averaged_imu;
+};
+
+topic_tools::ShapeShifter::ConstPtr make_imu_message(double acceleration,
+	double w = 1.0)
+{
+	sensor_msgs::Imu imu;
+	imu.header.frame_id = "imu";
+	imu.orientation.w = w;
+	imu.angular_velocity.z = 2 * acceleration;
+	imu.linear_acceleration.x = acceleration;
+
+	boost::shared_ptr<topic_tools::ShapeShifter> shape_shifter(
+		new topic_tools::ShapeShifter);
+  shape_shifter->morph(
+      ros::message_traits::MD5Sum<sensor_msgs::Imu>::value(),
+      ros::message_traits::DataType<sensor_msgs::Imu>::value(),
+      ros::message_traits::Definition<sensor_msgs::Imu>::value(),
+      "" );
+
+  std::vector<uint8_t> buffer;
+	serialize_message_to_array(imu, buffer);
+  ros::serialization::OStream stream( buffer.data(), buffer.size() );
+  shape_shifter->read( stream );
+
+	return shape_shifter;
+}
+
+void test_policy_none()
+{
+	std::cout << std::endl << std::endl << "test_policy_none" << std::endl << std::endl;
+
+	knowledge::KnowledgeBase knowledge;
+	PolicyParser parser (&knowledge);
+
+	// topics without a policy are written as they arrive
+	std::map<std::string, gams::utility::ros::TopicPolicy> policies;
+	policies["other"].latest_only = true;
+	parser.set_topic_policies(policies);
+
+	TEST(parser.parse_message(make_imu_message(1.0), "imu", "imu"), 1);
+	TEST(knowledge.get("imu.linear_acceleration").retrieve_index(0).to_double(), 1.0);
+	TEST(parser.parse_message(make_imu_message(2.0), "imu", "imu"), 1);
+	TEST(knowledge.get("imu.linear_acceleration").retrieve_index(0).to_double(), 2.0);
+	TEST(parser.has_held(), 0);
+}
+
+void test_policy_latest_only()
+{
+	std::cout << std::endl << std::endl << "test_policy_latest_only" << std::endl << std::endl;
+
+	knowledge::KnowledgeBase knowledge;
+	PolicyParser parser (&knowledge);
+
+	std::map<std::string, gams::utility::ros::TopicPolicy> policies;
+	policies["imu"].latest_only = true;
+	parser.set_topic_policies(policies);
+
+	// messages are held, each replacing the last, until the flush
+	TEST(parser.parse_message(make_imu_message(1.0), "imu", "imu"), 0);
+	TEST(parser.parse_message(make_imu_message(2.0), "imu", "imu"), 0);
+	TEST(parser.parse_message(make_imu_message(3.0), "imu", "imu"), 0);
+	TEST(knowledge.exists("imu.linear_acceleration"), 0);
+	TEST(parser.has_held(), 1);
+
+	TEST(parser.flush_held(), 1);
+	TEST(knowledge.get("imu.linear_acceleration").retrieve_index(0).to_double(), 3.0);
+	TEST(parser.has_held(), 0);
+	TEST(parser.flush_held(), 0);
+}
+
+void test_policy_decimation()
+{
+	std::cout << std::endl << std::endl << "test_policy_decimation" << std::endl << std::endl;
+
+	knowledge::KnowledgeBase knowledge;
+	PolicyParser parser (&knowledge);
+
+	std::map<std::string, gams::utility::ros::TopicPolicy> policies;
+	policies["imu"].decimation = 3;
+	parser.set_topic_policies(policies);
+
+	// the 1st, 4th and 7th messages are written
+	int written = 0;
+	for (int i = 1; i <= 7; ++i)
+	{
+		bool admitted = parser.parse_message(make_imu_message(i), "imu", "imu");
+		TEST(admitted, (i - 1) % 3 == 0 ? 1 : 0);
+		if (admitted)
+		{
+			++written;
+			TEST(knowledge.get("imu.linear_acceleration").retrieve_index(0).to_double(), i);
+		}
+	}
+	TEST(written, 3);
+}
+
+void test_policy_rate()
+{
+	std::cout << std::endl << std::endl << "test_policy_rate" << std::endl << std::endl;
+
+	knowledge::KnowledgeBase knowledge;
+	PolicyParser parser (&knowledge);
+
+	PolicyParser::PolicyState state;
+	state.policy.min_period = 100;
+
+	// the period is measured from the last written message
+	TEST(parser.admit_message(state, 1000), 1);
+	TEST(parser.admit_message(state, 1050), 0);
+	TEST(parser.admit_message(state, 1099), 0);
+	TEST(parser.admit_message(state, 1100), 1);
+	TEST(parser.admit_message(state, 1150), 0);
+	TEST(parser.admit_message(state, 1250), 1);
+	TEST(state.last_written, 1250);
+
+	// decimation is applied before the rate limit
+	PolicyParser::PolicyState both;
+	both.policy.decimation = 2;
+	both.policy.min_period = 100;
+	TEST(parser.admit_message(both, 0), 1);
+	TEST(parser.admit_message(both, 200), 0);
+	TEST(parser.admit_message(both, 250), 1);
+	TEST(parser.admit_message(both, 300), 0);
+	TEST(parser.admit_message(both, 320), 0);
+	TEST(parser.admit_message(both, 400), 0);
+	TEST(parser.admit_message(both, 500), 1);
+}
+
+void test_policy_average()
+{
+	std::cout << std::endl << std::endl << "test_policy_average" << std::endl << std::endl;
+
+	knowledge::KnowledgeBase knowledge;
+	PolicyParser parser (&knowledge);
+
+	std::map<std::string, gams::utility::ros::TopicPolicy> policies;
+	policies["imu"].average = true;
+	policies["imu"].decimation = 3;
+	parser.set_topic_policies(policies);
+
+	// the first message is written alone
+	TEST(parser.parse_message(make_imu_message(1.0), "imu", "imu"), 1);
+	TEST(knowledge.get("imu.linear_acceleration").retrieve_index(0).to_double(), 1.0);
+
+	// the next write averages the messages since the last one
+	TEST(parser.parse_message(make_imu_message(2.0, -1.0), "imu", "imu"), 0);
+	TEST(parser.parse_message(make_imu_message(3.0), "imu", "imu"), 0);
+	TEST(parser.parse_message(make_imu_message(7.0), "imu", "imu"), 1);
+	TEST(knowledge.get("imu.linear_acceleration").retrieve_index(0).to_double(), 4.0);
+	TEST(knowledge.get("imu.angular_velocity").retrieve_index(2).to_double(), 8.0);
+
+	// -q is added as q, so opposite signs do not cancel out
+	PolicyParser::PolicyState state;
+	sensor_msgs::Imu imu;
+	imu.orientation.w = 1.0;
+	imu.linear_acceleration.x = 5.0;
+	parser.average_imu(state, imu);
+	imu.orientation.w = -1.0;
+	parser.average_imu(state, imu);
+	TEST(state.imu_count, 2);
+	TEST(state.imu_sum.orientation.w, 2.0);
+
+	// averaging resets after each write
+	parser.parse_averaged_imu(state, "direct");
+	TEST(state.imu_count, 0);
+	TEST(knowledge.get("direct.linear_acceleration").retrieve_index(0).to_double(), 5.0);
+}
+
 int main (int, char **)
 {
 	std::cout << "Testing ros2gams" << std::endl;
 	//test_pose();
 	//test_tf_tree();
 	test_any_point();
+	test_compiled_point();
 	test_any_bool();
 	test_any_odom();
 	test_any_compressed_image();
+	test_policy_none();
+	test_policy_latest_only();
+	test_policy_decimation();
+	test_policy_rate();
+	test_policy_average();
 
   if (gams_fails > 0)
   {
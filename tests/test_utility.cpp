@@ -57,18 +57,37 @@
 #include <assert.h>
 #include <vector>
 #include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <atomic>
+#include <thread>
+
+#ifdef __linux__
+#include <unistd.h>
+#endif
 
 #include "gams/utility/OscUdp.h"
+#include "gams/utility/OscUdpMux.h"
+#include "osc/OscOutboundPacketStream.h"
 #include "gams/utility/Position.h"
 #include "gams/utility/GPSPosition.h"
+#include "gams/utility/TreeBarrier.h"
+#include "gams/utility/IndexedStream.h"
+#include "gams/utility/IoReactor.h"
+#include "gams/utility/LatestValue.h"
+#include "gams/utility/SensorRecord.h"
 #include "gams/pose/Region.h"
 #include "gams/pose/PrioritizedRegion.h"
 #include "gams/pose/SearchArea.h"
 
 #include "gams/loggers/GlobalLogger.h"
+#include "madara/utility/Utility.h"
 
 using gams::utility::GPSPosition;
 using gams::utility::Position;
+using gams::utility::TreeBarrier;
+using gams::utility::IndexedStreamReader;
+using gams::utility::IndexedStreamWriter;
 using gams::pose::PrioritizedRegion;
 using gams::pose::Region;
 using gams::pose::SearchArea;
@@ -79,6 +98,8 @@ using std::vector;
 
 typedef madara::knowledge::KnowledgeRecord KnowledgeRecord;
 
+int gams_fails = 0;
+
 void
 testing_output (const string& str, const unsigned int& tabs = 0)
 {
@@ -209,6 +230,572 @@ test_OscUdp ()
 
 }
 
+void
+test_OscUdp_addresses ()
+{
+  testing_output("gams::utility::OscUdp addresses and packing");
+
+  typedef gams::utility::OscUdp OscUdp;
+
+  testing_output ("testing classify_address", 1);
+
+  if (OscUdp::classify_address ("/agent/0/velocity/xy") ==
+        OscUdp::OSC_ADDRESS_VELOCITY_XY &&
+      OscUdp::classify_address ("/agent/0/velocity/z") ==
+        OscUdp::OSC_ADDRESS_VELOCITY_Z &&
+      OscUdp::classify_address ("/agent/0/velocity/yaw") ==
+        OscUdp::OSC_ADDRESS_YAW &&
+      OscUdp::classify_address ("/spawn/quadcopter") ==
+        OscUdp::OSC_ADDRESS_SPAWN &&
+      OscUdp::classify_address ("/agent/0/pos") ==
+        OscUdp::OSC_ADDRESS_POS &&
+      OscUdp::classify_address ("/agent/0/rot") ==
+        OscUdp::OSC_ADDRESS_ROT &&
+      OscUdp::classify_address ("/agent/0/battery") ==
+        OscUdp::OSC_ADDRESS_UNKNOWN)
+  {
+    cout << "    SUCCESS: addresses classified by prefix and suffix\n";
+  }
+  else
+  {
+    cout << "    FAIL: addresses misclassified\n";
+    ++gams_fails;
+  }
+
+  OscUdp osc;
+
+  // a lookup of an unregistered address classifies it without caching,
+  // so it stays safe to call while another thread reads the cache
+  const OscUdp & const_osc = osc;
+  if (const_osc.get_address_type ("/agent/1/velocity/z") ==
+        OscUdp::OSC_ADDRESS_VELOCITY_Z &&
+      osc.register_address ("/agent/1/yaw") == OscUdp::OSC_ADDRESS_YAW &&
+      const_osc.get_address_type ("/agent/1/yaw") == OscUdp::OSC_ADDRESS_YAW)
+  {
+    cout << "    SUCCESS: registered and unregistered types resolved\n";
+  }
+  else
+  {
+    cout << "    FAIL: address types not resolved\n";
+    ++gams_fails;
+  }
+
+  testing_output ("testing pack", 1);
+
+  OscUdp::OscMap source_map;
+  KnowledgeRecord record;
+
+  record.set_index (1, 0.75);
+  record.set_index (0, 1.0);
+  source_map["/agent/0/velocity/xy"] = record;
+
+  record.resize (1);
+  record.set_index (0, -0.25);
+  source_map["/agent/0/velocity/z"] = record;
+
+  // positions are received, never sent, so they are not packed
+  record.set_index (2, 3.0);
+  source_map["/agent/0/pos"] = record;
+
+  source_map["/spawn/quadcopter"] = KnowledgeRecord (std::string ("{}"));
+
+  size_t expected = 16;
+  for (auto & entry : source_map)
+  {
+    expected += osc.get_packed_size (entry.first, entry.second);
+  }
+
+  char buffer[1000];
+  size_t packed = osc.pack (buffer, sizeof (buffer), source_map);
+
+  size_t messages = 0;
+  bool values_match = true;
+
+  if (packed > 0)
+  {
+    osc::ReceivedPacket packet (buffer, packed);
+
+    if (packet.IsBundle ())
+    {
+      osc::ReceivedBundle bundle (packet);
+
+      for (auto i = bundle.ElementsBegin (); i != bundle.ElementsEnd (); ++i)
+      {
+        osc::ReceivedMessage message (*i);
+        std::string address = message.AddressPattern ();
+        osc::ReceivedMessage::const_iterator arg = message.ArgumentsBegin ();
+
+        ++messages;
+
+        if (address == "/agent/0/velocity/xy")
+        {
+          values_match = values_match && message.ArgumentCount () == 2 &&
+            arg->AsFloat () == 1.0f && (++arg)->AsFloat () == 0.75f;
+        }
+        else if (address == "/agent/0/velocity/z")
+        {
+          values_match = values_match && message.ArgumentCount () == 1 &&
+            arg->AsFloat () == -0.25f;
+        }
+        else if (address == "/spawn/quadcopter")
+        {
+          values_match = values_match && message.ArgumentCount () == 1 &&
+            arg->IsBlob ();
+        }
+        else
+        {
+          values_match = false;
+        }
+      }
+    }
+  }
+
+  if (packed == expected && messages == 3 && values_match)
+  {
+    cout << "    SUCCESS: packed " << packed << " bytes in 3 messages\n";
+  }
+  else
+  {
+    cout << "    FAIL: packed " << packed << " of " << expected <<
+      " bytes in " << messages << " messages\n";
+    ++gams_fails;
+  }
+
+  if (osc.pack (buffer, expected - 1, source_map) == 0)
+  {
+    cout << "    SUCCESS: pack into a short buffer fails\n";
+  }
+  else
+  {
+    cout << "    FAIL: pack into a short buffer succeeded\n";
+    ++gams_fails;
+  }
+
+  testing_output ("testing unpack", 1);
+
+  {
+    osc::OutboundPacketStream stream (buffer, sizeof (buffer));
+    stream << osc::BeginBundleImmediate
+      << osc::BeginMessage ("/agent/0/pos")
+      << 1.0f << 2.0f << 3.0f << osc::EndMessage
+      << osc::BeginMessage ("/agent/0/rot")
+      << 0.5f << 0.25f << 0.125f << osc::EndMessage
+      << osc::BeginMessage ("/agent/1/pos")
+      << 4.0f << 5.0f << 6.0f << osc::EndMessage
+      << osc::BeginMessage ("/agent/0/velocity/z")
+      << 7.0f << osc::EndMessage
+      << osc::EndBundle;
+
+    OscUdp::OscMap dest_map;
+    dest_map["/agent/0/pos"];
+    dest_map["/agent/0/rot"];
+    dest_map["/agent/0/velocity/z"];
+
+    osc.unpack (buffer, stream.Size (), dest_map);
+
+    // only requested addresses with the three float layout are decoded
+    if (dest_map.size () == 3 &&
+        dest_map["/agent/0/pos"].to_doubles () ==
+          std::vector<double> ({1.0, 2.0, 3.0}) &&
+        dest_map["/agent/0/rot"].to_doubles () ==
+          std::vector<double> ({0.5, 0.25, 0.125}) &&
+        !dest_map["/agent/0/velocity/z"].exists ())
+    {
+      cout << "    SUCCESS: positions and rotations unpacked\n";
+    }
+    else
+    {
+      cout << "    FAIL: unexpected unpacked values\n";
+      ++gams_fails;
+    }
+  }
+}
+
+/**
+ * Reads the datagrams that arrive at a socket
+ * @param socket    a non-blocking socket
+ * @param expected  the number of datagrams to wait for
+ * @param max_wait  the max wait time in seconds
+ * @return the datagrams received
+ **/
+std::vector<std::string>
+receive_datagrams (boost::asio::ip::udp::socket & socket,
+  size_t expected, double max_wait)
+{
+  std::vector<std::string> result;
+  std::vector<char> buffer (64000);
+
+  for (double waited = 0; result.size () < expected && waited < max_wait;)
+  {
+    boost::system::error_code error;
+    size_t bytes = socket.receive (
+      boost::asio::buffer (buffer.data (), buffer.size ()), 0, error);
+
+    if (!error)
+    {
+      result.emplace_back (buffer.data (), bytes);
+    }
+    else
+    {
+      madara::utility::sleep (0.01);
+      waited += 0.01;
+    }
+  }
+
+  return result;
+}
+
+/**
+ * Counts the messages in a datagram
+ **/
+size_t
+count_osc_messages (const std::string & datagram)
+{
+  size_t result = 0;
+  osc::ReceivedPacket packet (datagram.data (), datagram.size ());
+
+  if (packet.IsBundle ())
+  {
+    result = osc::ReceivedBundle (packet).ElementCount ();
+  }
+
+  return result;
+}
+
+void
+test_OscUdp_send ()
+{
+  testing_output("gams::utility::OscUdp bundle splitting");
+
+  boost::asio::io_service io_service;
+  boost::asio::ip::udp::socket server (io_service,
+    boost::asio::ip::udp::endpoint (
+      boost::asio::ip::address::from_string ("127.0.0.1"), 40702));
+  server.non_blocking (true);
+
+  madara::transport::QoSTransportSettings settings;
+  settings.hosts.push_back ("127.0.0.1:40701");
+  settings.hosts.push_back ("127.0.0.1:40702");
+  settings.type = madara::transport::UDP;
+
+  gams::utility::OscUdp osc;
+  osc.create_socket (settings);
+
+  gams::utility::OscUdp::OscMap source_map;
+  KnowledgeRecord record;
+  record.set_index (1, 0.5);
+  record.set_index (0, 1.0);
+
+  for (int i = 0; i < 10; ++i)
+  {
+    source_map["/agent/" + std::to_string (i) + "/velocity/xy"] = record;
+  }
+
+  // room for two messages and the bundle header, but not for three
+  size_t message_size =
+    osc.get_packed_size ("/agent/0/velocity/xy", record);
+  size_t max_bundle_size = 16 + message_size * 2 + message_size / 2;
+
+  osc.send (source_map, max_bundle_size);
+
+  std::vector<std::string> datagrams =
+    receive_datagrams (server, 5, 1.0);
+
+  size_t messages = 0;
+  bool sizes_ok = true;
+  for (auto & datagram : datagrams)
+  {
+    messages += count_osc_messages (datagram);
+    sizes_ok = sizes_ok && datagram.size () <= max_bundle_size;
+  }
+
+  if (datagrams.size () == 5 && messages == 10 && sizes_ok)
+  {
+    cout << "    SUCCESS: 10 messages sent in 5 bundles of at most " <<
+      max_bundle_size << " bytes\n";
+  }
+  else
+  {
+    cout << "    FAIL: " << messages << " messages sent in " <<
+      datagrams.size () << " bundles\n";
+    ++gams_fails;
+  }
+
+  // a message larger than the limit is still sent, alone
+  osc.send (source_map, 16);
+  datagrams = receive_datagrams (server, 10, 1.0);
+
+  if (datagrams.size () == 10 && count_osc_messages (datagrams[0]) == 1)
+  {
+    cout << "    SUCCESS: oversized messages sent one per bundle\n";
+  }
+  else
+  {
+    cout << "    FAIL: oversized messages sent in " << datagrams.size () <<
+      " bundles\n";
+    ++gams_fails;
+  }
+}
+
+void
+test_OscUdpMux ()
+{
+  testing_output("gams::utility::OscUdpMux");
+
+  boost::asio::io_service io_service;
+  boost::asio::ip::udp::endpoint server_endpoint (
+    boost::asio::ip::address::from_string ("127.0.0.1"), 40712);
+  boost::asio::ip::udp::socket server (io_service, server_endpoint);
+  server.non_blocking (true);
+
+  madara::transport::QoSTransportSettings settings;
+  settings.hosts.push_back ("127.0.0.1:40711");
+  settings.hosts.push_back ("127.0.0.1:40712");
+  settings.type = madara::transport::UDP;
+
+  std::shared_ptr<gams::utility::OscUdpMux> mux =
+    gams::utility::OscUdpMux::get (settings);
+
+  if (mux && gams::utility::OscUdpMux::get (settings) == mux)
+  {
+    cout << "    SUCCESS: agents with the same endpoints share a mux\n";
+  }
+  else
+  {
+    cout << "    FAIL: agents with the same endpoints do not share a mux\n";
+    ++gams_fails;
+  }
+
+  size_t agent0 = mux->add_participant ({"/agent/0/pos"});
+  size_t agent1 = mux->add_participant ({"/agent/1/pos"});
+
+  // only a complete batch is sent while the flush period is long
+  mux->set_flush_period (60);
+
+  testing_output ("testing batched send", 1);
+
+  KnowledgeRecord record;
+  record.set_index (0, 1.0);
+
+  gams::utility::OscUdp::OscMap values;
+  values["/agent/0/velocity/z"] = record;
+  mux->send (agent0, values);
+
+  size_t early = receive_datagrams (server, 1, 0.2).size ();
+
+  values.clear ();
+  values["/agent/1/velocity/z"] = record;
+  values["/spawn/quadcopter"] = KnowledgeRecord (std::string ("{}"));
+  mux->send (agent1, values);
+
+  std::vector<std::string> datagrams = receive_datagrams (server, 1, 1.0);
+
+  if (early == 0 && datagrams.size () == 1 &&
+      count_osc_messages (datagrams[0]) == 3)
+  {
+    cout << "    SUCCESS: messages of both agents sent in one bundle\n";
+  }
+  else
+  {
+    cout << "    FAIL: " << early << " early and " << datagrams.size () <<
+      " batched datagrams\n";
+    ++gams_fails;
+  }
+
+  testing_output ("testing demultiplexed receive", 1);
+
+  char buffer[1000];
+  osc::OutboundPacketStream stream (buffer, sizeof (buffer));
+  stream << osc::BeginBundleImmediate
+    << osc::BeginMessage ("/agent/0/pos")
+    << 1.0f << 2.0f << 3.0f << osc::EndMessage
+    << osc::BeginMessage ("/agent/1/pos")
+    << 4.0f << 5.0f << 6.0f << osc::EndMessage
+    << osc::EndBundle;
+
+  server.send_to (boost::asio::buffer (stream.Data (), stream.Size ()),
+    boost::asio::ip::udp::endpoint (
+      boost::asio::ip::address::from_string ("127.0.0.1"), 40711));
+
+  gams::utility::OscUdp::OscMap values0, values1, again;
+  values0["/agent/0/pos"];
+  values1["/agent/1/pos"];
+  again["/agent/0/pos"];
+
+  mux->receive (values0, 0.5);
+  mux->receive (values1, 0.1);
+  mux->receive (again, 0.1);
+
+  if (values0["/agent/0/pos"].to_doubles () ==
+        std::vector<double> ({1.0, 2.0, 3.0}) &&
+      values1["/agent/1/pos"].to_doubles () ==
+        std::vector<double> ({4.0, 5.0, 6.0}) &&
+      !again["/agent/0/pos"].exists ())
+  {
+    cout << "    SUCCESS: each agent received its own values once\n";
+  }
+  else
+  {
+    cout << "    FAIL: received values not demultiplexed\n";
+    ++gams_fails;
+  }
+
+  mux->remove_participant (agent0, {"/agent/0/pos"});
+  mux->remove_participant (agent1, {"/agent/1/pos"});
+}
+
+void
+test_LatestValue ()
+{
+  testing_output("gams::utility::LatestValue");
+
+  gams::utility::LatestValue<int> latest;
+  int value = -1;
+
+  bool empty_ok = !latest.is_fresh () && !latest.read (value) && value == -1;
+
+  latest.write (1);
+  latest.write (2);
+  bool fresh_ok = latest.is_fresh ();
+
+  // only the latest of several writes is read, and only once
+  bool read_ok = latest.read (value) && value == 2 &&
+    !latest.is_fresh () && !latest.read (value) && value == 2;
+
+  if (empty_ok && fresh_ok && read_ok)
+  {
+    cout << "    SUCCESS: the latest value is read once\n";
+  }
+  else
+  {
+    cout << "    FAIL: read the wrong values\n";
+    ++gams_fails;
+  }
+
+  // a reader racing a writer never sees a torn or older value
+  struct Pair
+  {
+    int first = 0;
+    int second = 0;
+  };
+
+  gams::utility::LatestValue<Pair> pairs;
+  const int writes = 100000;
+
+  std::thread writer ([&pairs, writes] () {
+    for (int i = 1; i <= writes; ++i)
+    {
+      Pair pair;
+      pair.first = i;
+      pair.second = -i;
+      pairs.write (pair);
+    }
+  });
+
+  Pair pair;
+  int last = 0;
+  bool consistent = true;
+
+  while (last < writes && consistent)
+  {
+    if (pairs.read (pair))
+    {
+      consistent = pair.first == -pair.second && pair.first > last;
+      last = pair.first;
+    }
+  }
+
+  writer.join ();
+
+  if (consistent && last == writes)
+  {
+    cout << "    SUCCESS: concurrent reads are whole and in order\n";
+  }
+  else
+  {
+    cout << "    FAIL: read [" << pair.first << ", " << pair.second <<
+      "] after " << last << "\n";
+    ++gams_fails;
+  }
+}
+
+void
+test_IoReactor ()
+{
+  testing_output("gams::utility::IoReactor");
+
+#ifdef __linux__
+  gams::utility::IoReactor reactor;
+
+  if (!reactor.is_supported ())
+  {
+    cout << "    FAIL: epoll is not available\n";
+    ++gams_fails;
+    return;
+  }
+
+  int pipe_handles[2];
+  if (pipe (pipe_handles) != 0)
+  {
+    cout << "    FAIL: cannot create a pipe\n";
+    ++gams_fails;
+    return;
+  }
+
+  std::atomic<int> calls (0);
+  gams::utility::LatestValue<char> received;
+
+  bool added = reactor.add_handler (pipe_handles[0],
+    [&calls, &received] (int handle) {
+      char byte;
+      if (read (handle, &byte, 1) == 1)
+      {
+        received.write (byte);
+        ++calls;
+      }
+    });
+
+  char byte = 'a';
+  bool written = write (pipe_handles[1], &byte, 1) == 1;
+
+  for (int i = 0; i < 100 && calls == 0; ++i)
+  {
+    madara::utility::sleep (0.01);
+  }
+
+  char value = 0;
+  if (added && written && calls == 1 && received.read (value) && value == 'a')
+  {
+    cout << "    SUCCESS: handler called with the readable data\n";
+  }
+  else
+  {
+    cout << "    FAIL: handler called " << calls << " times\n";
+    ++gams_fails;
+  }
+
+  // once removed, the handler is never called again
+  reactor.remove_handler (pipe_handles[0]);
+  written = write (pipe_handles[1], &byte, 1) == 1;
+  madara::utility::sleep (0.1);
+
+  if (written && calls == 1)
+  {
+    cout << "    SUCCESS: removed handlers are not called\n";
+  }
+  else
+  {
+    cout << "    FAIL: removed handler called " << calls << " times\n";
+    ++gams_fails;
+  }
+
+  close (pipe_handles[0]);
+  close (pipe_handles[1]);
+#else
+  cout << "    SKIPPED: the reactor needs epoll\n";
+#endif // __linux__
+}
+
 // TODO: fill out remaining Position function tests
 void
 test_Position ()
@@ -471,14 +1058,389 @@ test_SearchArea ()
 }
 */
 
+void
+test_TreeBarrier ()
+{
+  testing_output ("gams::utility::TreeBarrier");
+
+  // all participants share one knowledge base, as if fully connected
+  madara::knowledge::KnowledgeBase kb;
+  const int participants = 10;
+  vector <TreeBarrier> barriers (participants);
+
+  testing_output ("set_name", 1);
+  for (int i = 0; i < participants; ++i)
+  {
+    barriers[i].set_name ("barrier.tree_test", kb, i, participants, 3);
+    barriers[i].set (0);
+  }
+
+  if (barriers[0].is_hierarchical () && barriers[0].get_parent () == -1 &&
+    barriers[4].get_parent () == 1 && barriers[9].get_parent () == 2)
+  {
+    cout << "    SUCCESS: 10 participants form a tree with fan-in 3\n";
+  }
+  else
+  {
+    cout << "    FAIL: unexpected tree with parents " <<
+      barriers[0].get_parent () << ", " << barriers[4].get_parent () <<
+      ", " << barriers[9].get_parent () << "\n";
+    ++gams_fails;
+  }
+
+  testing_output ("is_done before all arrive", 1);
+  for (int i = 0; i < participants - 1; ++i)
+  {
+    barriers[i].next ();
+  }
+
+  int early = 0;
+  for (int i = 0; i < participants - 1; ++i)
+  {
+    bool done = barriers[i].is_done ();
+    if (done)
+    {
+      ++early;
+    }
+  }
+
+  if (early == 0)
+  {
+    cout << "    SUCCESS: no participant is released early\n";
+  }
+  else
+  {
+    cout << "    FAIL: " << early << " participants released early\n";
+    ++gams_fails;
+  }
+
+  testing_output ("is_done after all arrive", 1);
+  barriers[participants - 1].next ();
+
+  // aggregates move one tree level per check, leaves first
+  for (int pass = 0; pass < 3; ++pass)
+  {
+    for (int i = participants - 1; i >= 0; --i)
+    {
+      barriers[i].modify ();
+    }
+  }
+
+  int released = 0;
+  for (int i = 0; i < participants; ++i)
+  {
+    bool done = barriers[i].is_done ();
+    if (done && barriers[i].get_round () == 1 &&
+      barriers[i].get_completed_rounds () == 1 &&
+      barriers[i].get_max_wait () >= barriers[i].get_last_wait ())
+    {
+      ++released;
+    }
+  }
+
+  if (released == participants)
+  {
+    cout << "    SUCCESS: all participants released in round 1\n";
+  }
+  else
+  {
+    cout << "    FAIL: " << released << " of " << participants <<
+      " participants released in round 1\n";
+    ++gams_fails;
+  }
+
+  testing_output ("flat barrier", 1);
+  TreeBarrier flat;
+  flat.set_name ("barrier.flat_test", kb, 0, 1);
+  flat.set (0);
+  flat.next ();
+  bool flat_done = flat.is_done ();
+
+  if (!flat.is_hierarchical () && flat.get_parent () == -1 && flat_done)
+  {
+    cout << "    SUCCESS: a single participant uses a flat barrier\n";
+  }
+  else
+  {
+    cout << "    FAIL: flat barrier is hierarchical or not done\n";
+    ++gams_fails;
+  }
+}
+
+void
+test_IndexedStream ()
+{
+  testing_output ("gams::utility::IndexedStream");
+
+  const uint64_t second = 1000000000;
+  const string filename = "test_indexed_stream.gstk";
+
+  testing_output ("write_frame", 1);
+  {
+    // keyframes at 0, 3, 6 and 9 seconds
+    IndexedStreamWriter writer (filename, 3 * second, 64);
+    writer.enqueue ("constant", KnowledgeRecord (42.0));
+
+    int write_errors = 0;
+    for (int i = 0; i < 10; ++i)
+    {
+      writer.enqueue ("counter", KnowledgeRecord (double (i)));
+      int result = writer.write_frame (i * second);
+      if (result != 0)
+      {
+        ++write_errors;
+      }
+    }
+
+    size_t frames = writer.frames ();
+    size_t keyframes = writer.index ().size ();
+    int closed = writer.close ();
+
+    if (write_errors == 0 && frames == 10 && keyframes == 4 && closed == 0)
+    {
+      cout << "    SUCCESS: wrote 10 frames with 4 keyframes\n";
+    }
+    else
+    {
+      cout << "    FAIL: wrote " << frames << " frames with " << keyframes <<
+        " keyframes, " << write_errors << " write errors, close returned " <<
+        closed << "\n";
+      ++gams_fails;
+    }
+  }
+
+  testing_output ("seek", 1);
+  IndexedStreamReader reader (filename);
+  bool opened = reader.is_open ();
+  size_t keyframes = reader.index ().size ();
+  bool sought = reader.seek (5 * second);
+
+  uint64_t first_time = 0, second_time = 0;
+  bool first_keyframe = false, second_keyframe = true;
+  size_t first_size = 0, second_size = 0;
+  madara::knowledge::KnowledgeMap records;
+
+  bool first = reader.next (first_time, records, first_keyframe);
+  first_size = records.size ();
+  bool next = reader.next (second_time, records, second_keyframe);
+  second_size = records.size ();
+
+  if (opened && keyframes == 4 && sought &&
+    first && first_time == 3 * second && first_keyframe && first_size == 2 &&
+    next && second_time == 4 * second && !second_keyframe && second_size == 1)
+  {
+    cout << "    SUCCESS: seek starts at the keyframe before 5s\n";
+  }
+  else
+  {
+    cout << "    FAIL: seek read " << first_time << " (" << first_size <<
+      " records) then " << second_time << " (" << second_size <<
+      " records)\n";
+    ++gams_fails;
+  }
+
+  testing_output ("load", 1);
+  madara::knowledge::KnowledgeBase kb;
+  size_t loaded = reader.load (kb, 5 * second);
+  int64_t counter = kb.get ("counter").to_integer ();
+  int64_t constant = kb.get ("constant").to_integer ();
+
+  if (loaded == 3 && counter == 5 && constant == 42)
+  {
+    cout << "    SUCCESS: load replays to 5s from a keyframe\n";
+  }
+  else
+  {
+    cout << "    FAIL: load read " << loaded << " frames, counter is " <<
+      counter << ", constant is " << constant << "\n";
+    ++gams_fails;
+  }
+
+  loaded = reader.load (kb, 9 * second);
+  counter = kb.get ("counter").to_integer ();
+
+  if (loaded == 1 && counter == 9)
+  {
+    cout << "    SUCCESS: load from 9s reads only the keyframe\n";
+  }
+  else
+  {
+    cout << "    FAIL: load read " << loaded << " frames, counter is " <<
+      counter << "\n";
+    ++gams_fails;
+  }
+
+  std::remove (filename.c_str ());
+}
+
+void
+test_SensorRecord ()
+{
+  testing_output ("gams::utility::SensorRecord");
+
+  testing_output ("encode_point_cloud", 1);
+  // x, y, z, intensity with 4 bytes of padding, as written by pcl
+  gams::utility::PointCloudRecord cloud;
+  cloud.width = 3;
+  cloud.height = 1;
+  cloud.point_step = 20;
+  const char * names[] = {"x", "y", "z", "intensity"};
+  const uint32_t offsets[] = {0, 4, 8, 16};
+  for (int i = 0; i < 4; ++i)
+  {
+    gams::utility::PointField field;
+    field.name = names[i];
+    field.offset = offsets[i];
+    field.datatype = gams::utility::PointField::FLOAT32;
+    cloud.fields.push_back (field);
+  }
+
+  vector <unsigned char> data (cloud.width * cloud.point_step);
+  for (uint32_t p = 0; p < cloud.width; ++p)
+  {
+    float values[] = {float (p), float (p) * 2, float (p) * 3, 0, 0.5f};
+    memcpy (data.data () + p * cloud.point_step, values, sizeof (values));
+  }
+
+  vector <unsigned char> buffer;
+  gams::utility::encode_point_cloud (cloud, data.data (), data.size (),
+    buffer);
+
+  gams::utility::PointCloudRecord layout;
+  size_t header_size = gams::utility::decode_point_cloud (
+    buffer.data (), buffer.size (), layout);
+
+  if (header_size > 0 &&
+    layout.type == gams::utility::SENSOR_POINTS_XYZI &&
+    layout.point_step == 16 && layout.width == 3)
+  {
+    cout << "    SUCCESS: padded xyzi cloud packed to 16 byte points\n";
+  }
+  else
+  {
+    cout << "    FAIL: cloud decoded with type " << layout.type <<
+      ", point step " << layout.point_step << ", width " <<
+      layout.width << "\n";
+    ++gams_fails;
+  }
+
+  testing_output ("decode_points", 1);
+  vector <gams::pose::Position> points;
+  vector <float> intensities;
+  bool decoded_points = gams::utility::decode_points (
+    buffer.data (), buffer.size (), points, &intensities);
+
+  if (decoded_points && points.size () == 3 &&
+    points[2].x () == 2 && points[2].y () == 4 && points[2].z () == 6 &&
+    intensities.size () == 3 && intensities[1] == 0.5f)
+  {
+    cout << "    SUCCESS: points and intensities decoded\n";
+  }
+  else
+  {
+    cout << "    FAIL: decoded " << points.size () << " points and " <<
+      intensities.size () << " intensities\n";
+    ++gams_fails;
+  }
+
+  testing_output ("voxel_filter", 1);
+  vector <unsigned char> kept;
+  bool filtered = gams::utility::voxel_filter (
+    cloud, data.data (), data.size (), 10, kept);
+
+  if (filtered && kept.size () == cloud.point_step &&
+    memcmp (kept.data (), data.data (), cloud.point_step) == 0)
+  {
+    cout << "    SUCCESS: a large voxel keeps the first point\n";
+  }
+  else
+  {
+    cout << "    FAIL: a large voxel kept " << kept.size () << " bytes\n";
+    ++gams_fails;
+  }
+
+  filtered = gams::utility::voxel_filter (
+    cloud, data.data (), data.size (), 1.5, kept);
+  bool unfiltered = gams::utility::voxel_filter (
+    cloud, data.data (), data.size (), 0, kept);
+
+  if (filtered && kept.size () == data.size () && !unfiltered)
+  {
+    cout << "    SUCCESS: small voxels keep all points, 0 disables\n";
+  }
+  else
+  {
+    cout << "    FAIL: small voxels kept " << kept.size () <<
+      " bytes, voxel size 0 filtered " << unfiltered << "\n";
+    ++gams_fails;
+  }
+
+  testing_output ("encode_laser_scan", 1);
+  gams::utility::LaserScanRecord scan;
+  scan.angle_min = 0;
+  scan.angle_increment = float (M_PI / 2);
+  scan.range_min = 0.1f;
+  scan.range_max = 10;
+  const float ranges[] = {1, 20, 2};
+  gams::utility::encode_laser_scan (scan, ranges, 3, 0, 0, buffer);
+
+  gams::utility::LaserScanRecord decoded;
+  bool decoded_scan = gams::utility::decode_laser_scan (
+    buffer.data (), buffer.size (), decoded);
+
+  if (decoded_scan && decoded.ranges.size () == 3 &&
+    decoded.ranges[2] == 2 && decoded.intensities.empty ())
+  {
+    cout << "    SUCCESS: ranges decoded without intensities\n";
+  }
+  else
+  {
+    cout << "    FAIL: decoded " << decoded.ranges.size () << " ranges and " <<
+      decoded.intensities.size () << " intensities\n";
+    ++gams_fails;
+  }
+
+  testing_output ("scan_to_points", 1);
+  gams::utility::scan_to_points (decoded, points);
+
+  if (points.size () == 2 && std::abs (points[1].x () + 2) < 1e-5 &&
+    std::abs (points[1].y ()) < 1e-5)
+  {
+    cout << "    SUCCESS: out of range readings are dropped\n";
+  }
+  else
+  {
+    cout << "    FAIL: scan converted to " << points.size () << " points\n";
+    ++gams_fails;
+  }
+}
+
 int
 main (int /*argc*/, char ** /*argv*/)
 {
   gams::loggers::global_logger->set_level (-1);
   test_Position ();
   test_GPSPosition ();
+  test_TreeBarrier ();
+  test_IndexedStream ();
+  test_SensorRecord ();
+  test_OscUdp_addresses ();
+  test_OscUdp_send ();
+  test_OscUdpMux ();
+  test_LatestValue ();
+  test_IoReactor ();
   // test_OscUdp();
   //test_Region ();
   //test_SearchArea ();
-  return 0;
+
+  if (gams_fails > 0)
+  {
+    std::cerr << "OVERALL: FAIL. " << gams_fails << " tests failed.\n";
+  }
+  else
+  {
+    std::cerr << "OVERALL: SUCCESS.\n";
+  }
+
+  return gams_fails;
 }
@@ -53,6 +53,7 @@
  **/
 
 #include <iostream>
+#include <thread>
 
 #include "gams/pose/Position.h"
 #include "gams/platforms/BasePlatform.h"
@@ -62,6 +63,7 @@
 #include "gams/variables/Swarm.h"
 
 #include "gams/variables/AccentStatus.h"
+#include "gams/variables/AgentNames.h"
 
 namespace transport = madara::transport;
 namespace pose = gams::pose;
@@ -465,11 +467,194 @@ test_swarm(void)
    (swarm.size == 5 ? "SUCCESS\n" : "FAIL\n");
 }
 
+void
+test_agent_names(void)
+{
+  std::cout << "Testing AgentNameTable...\n";
+
+  variables::AgentNameTable table;
+
+  variables::AgentId first = table.intern("agent.3");
+  variables::AgentId numbered = table.intern(
+    madara::knowledge::KnowledgeRecord::Integer(3));
+  variables::AgentId second = table.intern("agent.leader");
+
+  std::cout << "  Testing numbered and named interning: ";
+  if (first == 0 && numbered == first && second == 1 && table.size() == 2 &&
+    table.find("agent.leader") == second && table.find("agent.4") == -1)
+  {
+    std::cout << "SUCCESS\n";
+  }
+  else
+  {
+    std::cout << "FAIL\n";
+    ++gams_fails;
+  }
+
+  std::cout << "  Testing precomputed names: ";
+  if (table.get(first).prefix == "agent.3" &&
+    table.get(first).location == "agent.3.location" &&
+    table.intern_name("agent.leader").velocity == "agent.leader.velocity" &&
+    table.size() == 2)
+  {
+    std::cout << "SUCCESS\n";
+  }
+  else
+  {
+    std::cout << "FAIL\n";
+    ++gams_fails;
+  }
+
+  knowledge::KnowledgeBase context;
+
+  variables::Agent agent;
+  agent.init_vars(context, "agent.names");
+
+  std::cout << "  Testing Agent.agent_id: ";
+  if (agent.agent_id >= 0 &&
+    variables::agent_names().get_prefix(agent.agent_id) == "agent.names" &&
+    agent.location.get_name() == "agent.names.location")
+  {
+    std::cout << "SUCCESS\n";
+  }
+  else
+  {
+    std::cout << "FAIL\n";
+    ++gams_fails;
+  }
+
+  variables::AgentId negative = table.intern(
+    madara::knowledge::KnowledgeRecord::Integer(-1));
+
+  std::cout << "  Testing negative agent numbers: ";
+  if (negative >= 0 && table.get(negative).prefix == "agent.-1" &&
+    table.find("agent.-1") == negative &&
+    table.get(-1).prefix == "" && table.get((variables::AgentId)table.size()).prefix == "")
+  {
+    std::cout << "SUCCESS\n";
+  }
+  else
+  {
+    std::cout << "FAIL\n";
+    ++gams_fails;
+  }
+
+  madara::knowledge::KnowledgeRecord::Integer huge = 2000000000000;
+  variables::AgentId large = table.intern(huge);
+  variables::AgentId above = table.intern(variables::MAX_NUMBERED_AGENTS);
+
+  std::cout << "  Testing large agent numbers: ";
+  if (large >= 0 && table.get(large).prefix == "agent.2000000000000" &&
+    table.intern(huge) == large &&
+    above >= 0 && table.find("agent.65536") == above)
+  {
+    std::cout << "SUCCESS\n";
+  }
+  else
+  {
+    std::cout << "FAIL\n";
+    ++gams_fails;
+  }
+
+  variables::Agent negative_agent;
+  negative_agent.init_vars(context,
+    madara::knowledge::KnowledgeRecord::Integer(-1));
+
+  std::cout << "  Testing Agent with a negative id: ";
+  if (negative_agent.prefix == "agent.-1" &&
+    negative_agent.location.get_name() == "agent.-1.location")
+  {
+    std::cout << "SUCCESS\n";
+  }
+  else
+  {
+    std::cout << "FAIL\n";
+    ++gams_fails;
+  }
+}
+
+void
+test_agent_name_limits(void)
+{
+  std::cout << "Testing AgentNameTable limits...\n";
+
+  variables::AgentNameTable small(2);
+  small.intern("agent.0");
+  small.intern("agent.1");
+
+  std::cout << "  Testing a full table: ";
+  if (small.intern("agent.2") == -1 &&
+    small.intern(madara::knowledge::KnowledgeRecord::Integer(2)) == -1 &&
+    small.intern_name("agent.2").prefix == "" &&
+    small.intern("agent.1") == 1 && small.size() == 2 &&
+    small.capacity() == 2 &&
+    variables::agent_names().capacity() == variables::MAX_AGENT_NAMES)
+  {
+    std::cout << "SUCCESS\n";
+  }
+  else
+  {
+    std::cout << "FAIL\n";
+    ++gams_fails;
+  }
+
+  // threads interning the same prefixes agree on their ids and names
+  variables::AgentNameTable table;
+  std::vector<std::vector<variables::AgentId> > ids(4);
+  std::vector<std::thread> threads;
+
+  for (size_t t = 0; t < ids.size(); ++t)
+  {
+    threads.push_back(std::thread([&table, &ids, t] () {
+      for (int i = 0; i < 1000; ++i)
+      {
+        std::string prefix = "agent." + std::to_string(i % 300);
+        variables::AgentId id = table.intern(prefix);
+
+        if (table.get(id).location != prefix + ".location")
+        {
+          id = -1;
+        }
+        ids[t].push_back(id);
+      }
+    }));
+  }
+
+  for (auto & thread : threads)
+  {
+    thread.join();
+  }
+
+  bool agree = table.size() == 300;
+  for (size_t t = 1; t < ids.size(); ++t)
+  {
+    agree = agree && ids[t] == ids[0];
+  }
+  for (size_t i = 0; i < ids[0].size(); ++i)
+  {
+    agree = agree && ids[0][i] >= 0 &&
+      table.find("agent." + std::to_string(i % 300)) == ids[0][i];
+  }
+
+  std::cout << "  Testing concurrent interning: ";
+  if (agree)
+  {
+    std::cout << "SUCCESS\n";
+  }
+  else
+  {
+    std::cout << "FAIL\n";
+    ++gams_fails;
+  }
+}
+
 int
 main(int /*argc*/, char ** /*argv*/)
 {
   test_accent();
   test_agent();
+  test_agent_names();
+  test_agent_name_limits();
   test_sensor();
   test_swarm();
 
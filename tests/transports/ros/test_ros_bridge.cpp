@@ -745,6 +745,45 @@ void test_imu(madara::knowledge::KnowledgeBase * knowledge,
   TEST(ang_vel[0], 17.0);
 }
 
+void test_imu_latest_only(madara::knowledge::KnowledgeBase * knowledge,
+  gams::transports::RosBridge * ros_bridge)
+{
+  std::cout << std::endl << std::endl <<
+    "##### TEST IMU LATEST ONLY #####" << std::endl;
+
+  unsigned int in_msg_count = ros_bridge->in_message_count();
+
+  ros::NodeHandle node;
+  ros::Publisher test_pub = node.advertise<sensor_msgs::Imu>("imu_latest", 10);
+  sensor_msgs::Imu imu;
+
+  imu.header.stamp = ros::Time::now();
+  imu.header.frame_id = "imu_latest";
+  imu.orientation.w = 1.0;
+
+  // wait for the subscriber of the bridge
+  while (test_pub.getNumSubscribers() == 0)
+  {
+    ros::Duration(0.1).sleep();
+  }
+
+  // every message is received, only the last one of a spin is written
+  for (int i = 1; i <= 3; ++i)
+  {
+    imu.linear_acceleration.x = i;
+    test_pub.publish(imu);
+  }
+  ros::spinOnce();
+  ros::Duration(1).sleep();
+
+  in_msg_count += 3;
+  TEST(ros_bridge->in_message_count(), in_msg_count);
+
+  containers::NativeDoubleVector lin_acc(
+    "sensors.imu_latest.linear_acceleration", *knowledge, -1);
+  TEST(lin_acc[0], 3.0);
+}
+
 
 // perform main logic of program
 int main(int argc, char ** argv)
@@ -801,17 +840,24 @@ int main(int argc, char ** argv)
   // add RosBridge factory
 
 
-  std::vector<std::string> selected_topics {"test1", "odom", "/tf", "imu"};
+  std::vector<std::string> selected_topics {"test1", "odom", "/tf", "imu",
+                                           "imu_latest"};
   std::map<std::string,std::string> topic_map = {{"odom", "sensors.odom"},
                                                  {"imu", "sensors.imu"},
+                                                 {"imu_latest",
+                                                  "sensors.imu_latest"},
                                                  {"/tf", "frames"}};
   std::map<std::string,std::string> pub_types = {{"odom", "nav_msgs/Odometry"},
                                                  {"imu", "sensor_msgs/Imu"}};
 
+  // imu_latest messages are held and written once per read thread spin
+  std::map<std::string, gams::utility::ros::TopicPolicy> topic_policies;
+  topic_policies["imu_latest"].latest_only = true;
+
   settings.read_threads = 1;
   gams::transports::RosBridge * ros_bridge = new gams::transports::RosBridge(
     knowledge.get_id(), settings, knowledge, selected_topics,
-    topic_map, pub_types);
+    topic_map, pub_types, topic_policies);
   knowledge.attach_transport(ros_bridge);
   // end transport creation
   
@@ -904,6 +950,7 @@ int main(int argc, char ** argv)
   usleep(1000);
 
   test_imu(&knowledge, ros_bridge);
+  test_imu_latest_only(&knowledge, ros_bridge);
   test_odometry(&knowledge, ros_bridge);
   test_tf(&knowledge, ros_bridge);
 